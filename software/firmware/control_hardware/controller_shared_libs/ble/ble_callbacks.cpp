@@ -1,5 +1,9 @@
 #include "ble_callbacks.h"
 
+#include <global_settings.h>
+
+#include "ble_link.h"
+
 #ifdef SENSINT_DEBUG
 #include <debug.h>
 #endif  // SENSINT_DEBUG
@@ -19,6 +23,14 @@ void BleConnectionCallback::onConnect(BLEServer *pServer) {
   connected_devices_++;
   BLEDevice::startAdvertising();
 }
+/**
+ * Called in addition to `onConnect(pServer)` with the connection parameters. The link parameters
+ * are requested for every connected device.
+ */
+void BleConnectionCallback::onConnect(BLEServer *pServer, esp_ble_gatts_cb_param_t *param) {
+  RequestLinkParameters(param->connect.remote_bda, settings::global::defaults::kLinkParameters);
+}
+
 void BleConnectionCallback::onDisconnect(BLEServer *pServer) {
   connected_devices_--;
   BLEDevice::startAdvertising();
@@ -36,7 +48,11 @@ void BleUInteger8Callback::onWrite(BLECharacteristic *pCharacteristic) {
   auto data_length = pCharacteristic->getValue().length();
   if (value_ && (data_length == sizeof(uint8_t))) {
     auto pData = pCharacteristic->getData();
-    *value_ = pData[0];
+    if (*value_ != pData[0]) {
+      *value_ = pData[0];
+      dirty_.Mark();
+    }
+    was_written_ = true;
 #ifdef SENSINT_DEBUG
     debug::Log("BleUInteger8Callback::onWrite", "data: " + String((int)*value_),
                debug::DebugLevel::verbose);
@@ -54,6 +70,19 @@ void BleUInteger8Callback::onWrite(BLECharacteristic *pCharacteristic) {
 
 void BleUInteger32Callback::onRead(BLECharacteristic *pCharacteristic) {}
 
+/**
+ * @return Whether the ble characteristic was written since the last function call
+ * or not.
+ */
+bool BleUInteger8Callback::WasWritten() {
+  if (was_written_) {
+    was_written_ = false;
+    return true;
+  } else {
+    return was_written_;
+  }
+}
+
 /******************************************************************************
                               BleUInteger32Callback
  ******************************************************************************/
@@ -67,7 +96,10 @@ void BleUInteger32Callback::onWrite(BLECharacteristic *pCharacteristic) {
   if (value_ && (data_length == sizeof(uint32_t))) {
     auto pData = pCharacteristic->getData();
     uint32_t tmp = pData[0] | (pData[1] << 8) | (pData[2] << 16) | (pData[3] << 24);
-    *value_ = tmp;
+    if (*value_ != tmp) {
+      *value_ = tmp;
+      dirty_.Mark();
+    }
 #ifdef SENSINT_DEBUG
     debug::Log("BleUInteger32Callback::onWrite", "data: " + String((int)tmp),
                debug::DebugLevel::verbose);
@@ -96,7 +128,11 @@ BleBooleanCallback::~BleBooleanCallback() {}
 void BleBooleanCallback::onWrite(BLECharacteristic *pCharacteristic) {
   was_written_ = true;
   if (value_) {
-    pCharacteristic->getData()[0] == 0 ? *value_ = false : *value_ = true;
+    const bool tmp = pCharacteristic->getData()[0] != 0;
+    if (*value_ != tmp) {
+      *value_ = tmp;
+      dirty_.Mark();
+    }
   }
 }
 
@@ -160,5 +196,110 @@ void BleByteArrayCallback::onWrite(BLECharacteristic *pCharacteristic) {
 
 void BleByteArrayCallback::onRead(BLECharacteristic *pCharacteristic) {}
 
+/******************************************************************************
+                              BleStreamCallback
+ ******************************************************************************/
+
+BleStreamCallback::BleStreamCallback() {}
+
+BleStreamCallback::~BleStreamCallback() {}
+
+void BleStreamCallback::onWrite(BLECharacteristic *pCharacteristic) {
+  auto data_length = pCharacteristic->getLength();
+  if (data_length < sizeof(stream::PacketHeader) || data_length > stream::kMaxPacketSize) {
+#ifdef SENSINT_DEBUG
+    debug::Log("BleStreamCallback::onWrite", "Invalid packet size: " + String(data_length),
+               debug::DebugLevel::verbose);
+#endif  // SENSINT_DEBUG
+    return;
+  }
+  // a full queue is counted by the queue itself
+  receiver_.Receive(pCharacteristic->getData(), data_length);
+}
+
+/**
+ * The read and the write callbacks are both called in the context of the BLE stack.
+ */
+void BleStreamCallback::onRead(BLECharacteristic *pCharacteristic) {
+  uint32_t next_sample = receiver_.GetNextSample();
+  pCharacteristic->setValue(next_sample);
+}
+
+/******************************************************************************
+                              BleTrackingCallback
+ ******************************************************************************/
+
+BleTrackingCallback::BleTrackingCallback() {}
+
+BleTrackingCallback::~BleTrackingCallback() {}
+
+void BleTrackingCallback::onWrite(BLECharacteristic *pCharacteristic) {
+  auto data_length = pCharacteristic->getLength();
+  if (value_ && tracking::Unpack(pCharacteristic->getData(), data_length, *value_)) {
+    was_written_ = true;
+#ifdef SENSINT_DEBUG
+    debug::Log("BleTrackingCallback::onWrite",
+               "connected IMUs: " + String(value_->connected_imus, BIN),
+               debug::DebugLevel::verbose);
+#endif  // SENSINT_DEBUG
+  }
+#ifdef SENSINT_DEBUG
+  else {
+    debug::Log("BleTrackingCallback::onWrite", "Invalid frame size: " + String(data_length),
+               debug::DebugLevel::verbose);
+  }
+#endif  // SENSINT_DEBUG
+}
+
+void BleTrackingCallback::onRead(BLECharacteristic *pCharacteristic) {}
+
+/**
+ * @return Whether the ble characteristic was written since the last function call
+ * or not.
+ */
+bool BleTrackingCallback::WasWritten() {
+  if (was_written_) {
+    was_written_ = false;
+    return true;
+  } else {
+    return was_written_;
+  }
+}
+
+/******************************************************************************
+                              BleClockSyncCallback
+ ******************************************************************************/
+
+BleClockSyncCallback::BleClockSyncCallback() {}
+
+BleClockSyncCallback::~BleClockSyncCallback() {}
+
+void BleClockSyncCallback::onWrite(BLECharacteristic *pCharacteristic) {
+  // the timestamp is taken first to keep the processing time out of the measurement
+  const uint32_t t2 = micros();
+  auto data_length = pCharacteristic->getLength();
+  if (data_length != sizeof(sync::ClockSyncPacket)) {
+#ifdef SENSINT_DEBUG
+    debug::Log("BleClockSyncCallback::onWrite",
+               "Wrong data length! Expected " + String(sizeof(sync::ClockSyncPacket)) +
+                   " bytes, got " + String(data_length),
+               debug::DebugLevel::verbose);
+#endif  // SENSINT_DEBUG
+    return;
+  }
+  sync::ClockSyncPacket packet;
+  memcpy(&packet, pCharacteristic->getData(), sizeof(sync::ClockSyncPacket));
+  packet.t2 = t2;
+  if (value_) {
+    *value_ = t2;
+  }
+  reports_.Push(packet);
+  packet.t3 = micros();
+  pCharacteristic->setValue((uint8_t *)&packet, sizeof(sync::ClockSyncPacket));
+  pCharacteristic->notify();
+}
+
+void BleClockSyncCallback::onRead(BLECharacteristic *pCharacteristic) {}
+
 }  // namespace ble
 }  // namespace sensint
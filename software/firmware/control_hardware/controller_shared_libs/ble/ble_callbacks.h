@@ -4,6 +4,14 @@
 #include <Arduino.h>
 #include <BLEDevice.h>
 #include <BLEUtils.h>
+#include <clock_sync.h>
+#include <spsc_queue.h>
+#include <stream_transport.h>
+
+#include <atomic>
+
+#include "ble_stream.h"
+#include "ble_tracking.h"
 
 namespace sensint {
 namespace ble {
@@ -13,17 +21,39 @@ class BleConnectionCallback : public BLEServerCallbacks {
   BleConnectionCallback();
   ~BleConnectionCallback();
   void onConnect(BLEServer *pServer);
+  void onConnect(BLEServer *pServer, esp_ble_gatts_cb_param_t *param);
   void onDisconnect(BLEServer *pServer);
   uint8_t connected_devices_ = 0;
 };
 
+/**
+ * @brief Marks a bit in a dirty mask that is shared with the application. The callbacks mark
+ * their bit when a write changed the value, so that the change is propagated to the other
+ * connected devices.
+ */
+struct BleDirtyFlag {
+  std::atomic<uint32_t> *mask = nullptr;
+  uint32_t bit = 0;
+
+  void Mark() const {
+    if (mask) {
+      mask->fetch_or(bit, std::memory_order_release);
+    }
+  }
+};
+
 class BleUInteger8Callback : public BLECharacteristicCallbacks {
  public:
   BleUInteger8Callback();
   ~BleUInteger8Callback();
   void onWrite(BLECharacteristic *pCharacteristic);
   void onRead(BLECharacteristic *pCharacteristic);
+  bool WasWritten();
   uint8_t *value_ = nullptr;
+  BleDirtyFlag dirty_;
+
+ private:
+  bool was_written_ = false;
 };
 
 class BleUInteger32Callback : public BLECharacteristicCallbacks {
@@ -33,6 +63,7 @@ class BleUInteger32Callback : public BLECharacteristicCallbacks {
   void onWrite(BLECharacteristic *pCharacteristic);
   void onRead(BLECharacteristic *pCharacteristic);
   uint32_t *value_ = nullptr;
+  BleDirtyFlag dirty_;
 };
 
 class BleBooleanCallback : public BLECharacteristicCallbacks {
@@ -44,6 +75,7 @@ class BleBooleanCallback : public BLECharacteristicCallbacks {
   bool WasWritten();
   bool WasRead();
   bool *value_ = nullptr;
+  BleDirtyFlag dirty_;
 
  private:
   bool was_written_ = false, was_read_ = false;
@@ -59,6 +91,54 @@ class BleByteArrayCallback : public BLECharacteristicCallbacks {
   uint16_t size_ = 0;
 };
 
+/**
+ * @brief Queues every packet written to a stream characteristic. The packets are written in the
+ * context of the BLE stack and consumed by the application. A read returns the index of the next
+ * expected sample, so that a reconnected shoe resends the samples that were lost in between.
+ */
+class BleStreamCallback : public BLECharacteristicCallbacks {
+ public:
+  BleStreamCallback();
+  ~BleStreamCallback();
+  void onWrite(BLECharacteristic *pCharacteristic);
+  void onRead(BLECharacteristic *pCharacteristic);
+  transport::StreamReceiver receiver_;
+};
+
+/**
+ * @brief Unpacks the frames of the motion tracking system into the slots of all IMUs.
+ */
+class BleTrackingCallback : public BLECharacteristicCallbacks {
+ public:
+  BleTrackingCallback();
+  ~BleTrackingCallback();
+  void onWrite(BLECharacteristic *pCharacteristic);
+  void onRead(BLECharacteristic *pCharacteristic);
+  bool WasWritten();
+  tracking::TrackingData *value_ = nullptr;
+
+ private:
+  bool was_written_ = false;
+};
+
+/**
+ * @brief Answers the clock synchronization requests of a shoe. The receive (t2) and transmit (t3)
+ * timestamps are added to the request, which is sent back as a notification. The estimate that is
+ * included in the request is queued to be reported by the application.
+ */
+class BleClockSyncCallback : public BLECharacteristicCallbacks {
+ public:
+  static constexpr size_t kQueueSize = 4;
+
+  BleClockSyncCallback();
+  ~BleClockSyncCallback();
+  void onWrite(BLECharacteristic *pCharacteristic);
+  void onRead(BLECharacteristic *pCharacteristic);
+  // the receive timestamp of the last request
+  uint32_t *value_ = nullptr;
+  pipeline::SpscQueue<sync::ClockSyncPacket, kQueueSize> reports_;
+};
+
 }  // namespace ble
 }  // namespace sensint
 
@@ -61,16 +61,20 @@ namespace ble {
 #define kBLE_CPF_UTF16S 0x1A
 #define kBLE_CPF_STRUCT 0x1B
 
+/**
+ * @brief Description of a characteristic. The descriptions are constant expressions (see
+ * ble_config.h), hence the strings are kept in flash and no UUID is built at runtime.
+ */
 struct BleCharacteristicDescription {
-  std::string user_description;
-  std::string uuid;
+  const char *user_description;
+  const char *uuid;
   uint32_t access_property;
   uint8_t cccd_values[2];
   uint8_t presentation_format;
 };
 
 void SetDecriptorsInBLECharacteristic(BLECharacteristic *characteristic,
-                                      BleCharacteristicDescription *description);
+                                      const BleCharacteristicDescription &description);
 
 }  // namespace ble
 }  // namespace sensint
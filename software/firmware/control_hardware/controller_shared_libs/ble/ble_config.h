@@ -1,7 +1,7 @@
 #ifndef __SENSINT_BLE_CONFIG_H__
 #define __SENSINT_BLE_CONFIG_H__
 
-#include <string>
+#include <global_settings.h>
 
 #include "ble_characteristic_description.h"
 
@@ -9,10 +9,10 @@ namespace sensint {
 namespace ble {
 namespace config {
 
-// this is the same for all UUIDs
-static const std::string kUUIDSuffix("-e3da-4a9a-9c2b-b8fe2dd451d1");
+// The UUIDs only differ in the group and characteristic (GGCC) and are composed at compile time.
+#define SENSINT_BLE_UUID(GGCC) "d0ff" GGCC "-e3da-4a9a-9c2b-b8fe2dd451d1"
 
-static const auto kServiceUUID = "d0ff495f" + kUUIDSuffix;
+static constexpr const char *kServiceUUID = SENSINT_BLE_UUID("495f");
 
 namespace characteristics {
 
@@ -29,211 +29,157 @@ namespace characteristics {
  *
  * Groups:
  *  00: status and config
- *  01: left shoe
- *  02: right shoe
+ *  S1: left shoe of subject S
+ *  S2: right shoe of subject S
  *  03: motion tracking system
+ *
+ * The shoe groups of the first subject (01 and 02) are the same as for a
+ * central with a single pair of shoes.
  ******************************************************************************/
 
-/*******************************************************************************
+/**
+ * @brief The characteristics of the status and config group and the tracking group. The value is
+ * the index in kCharacteristics.
+ */
+enum class Characteristic : uint8_t {
+  // status and config group
+  kRecordingStatus = 0,
+  kRecordingInterval,
+  kAugmentationActive,
+  kIMUReinitialize,
+  // tracking group
+  kTrackingConnected,
+  kTrackingNumberOfIMUs,
+  kTrackingDataSelection,
+  // the data of all connected IMUs is written as a single frame (see ble_tracking.h)
+  kTrackingIMUData,
+  kNumCharacteristics
+};
+
+static constexpr BleCharacteristicDescription kCharacteristics[] = {
+    /***************************************************************************
                               status and config group
- ******************************************************************************/
-static const BleCharacteristicDescription kRecordingStatus = {
-    "Recording Status",
-    std::string("d0ff0000" + kUUIDSuffix),
-    BLECharacteristic::PROPERTY_READ | BLECharacteristic::PROPERTY_WRITE |
-        BLECharacteristic::PROPERTY_NOTIFY,
-    {0x01, 0x01},
-    kBLE_CPF_UINT32};
-
-static const BleCharacteristicDescription kRecordingInterval = {
-    "Recording Interval",
-    std::string("d0ff0001" + kUUIDSuffix),
-    BLECharacteristic::PROPERTY_READ | BLECharacteristic::PROPERTY_WRITE |
-        BLECharacteristic::PROPERTY_NOTIFY,
-    {0x01, 0x01},
-    kBLE_CPF_UINT32};
-
-static const BleCharacteristicDescription kAugmentationActive = {
-    "Augmentation active",
-    std::string("d0ff0002" + kUUIDSuffix),
-    BLECharacteristic::PROPERTY_READ | BLECharacteristic::PROPERTY_WRITE |
-        BLECharacteristic::PROPERTY_NOTIFY,
-    {0x01, 0x01},
-    kBLE_CPF_BOOLEAN};
-
-static const BleCharacteristicDescription kIMUReinitialize = {
-    "IMU reinitialize",
-    std::string("d0ff0003" + kUUIDSuffix),
-    BLECharacteristic::PROPERTY_READ | BLECharacteristic::PROPERTY_WRITE |
-        BLECharacteristic::PROPERTY_NOTIFY,
-    {0x01, 0x01},
-    kBLE_CPF_BOOLEAN};
-
-/*******************************************************************************
-                                left shoe group
- ******************************************************************************/
-static const BleCharacteristicDescription kLeftShoeConnected = {
-    "Left Shoe connected",
-    std::string("d0ff01a0" + kUUIDSuffix),
-    BLECharacteristic::PROPERTY_READ | BLECharacteristic::PROPERTY_WRITE,
-    {0x01, 0x01},
-    kBLE_CPF_BOOLEAN};
-
-static const BleCharacteristicDescription kLeftShoeTimestamp = {
-    "Left Shoe Timestamp",
-    std::string("d0ff0100" + kUUIDSuffix),
-    BLECharacteristic::PROPERTY_READ | BLECharacteristic::PROPERTY_WRITE,
-    {0x01, 0x01},
-    kBLE_CPF_UINT32};
-
-static const BleCharacteristicDescription kLeftShoeSensorData = {
-    "Left Shoe Sensor Data",
-    std::string("d0ff0101" + kUUIDSuffix),
-    BLECharacteristic::PROPERTY_READ | BLECharacteristic::PROPERTY_WRITE,
-    {0x01, 0x01},
-    kBLE_CPF_STRUCT};
-
-static const BleCharacteristicDescription kLeftShoeIMU = {
-    "Left Shoe IMU",
-    std::string("d0ff0102" + kUUIDSuffix),
-    BLECharacteristic::PROPERTY_READ | BLECharacteristic::PROPERTY_WRITE,
-    {0x01, 0x01},
-    kBLE_CPF_STRUCT};
-
-static const BleCharacteristicDescription kLeftShoeSequence = {
-    "Left Shoe Sequence",
-    std::string("d0ff0103" + kUUIDSuffix),
-    BLECharacteristic::PROPERTY_READ | BLECharacteristic::PROPERTY_WRITE |
-        BLECharacteristic::PROPERTY_NOTIFY,
-    {0x01, 0x01},
-    kBLE_CPF_UINT8};
+     **************************************************************************/
+    {"Recording Status", SENSINT_BLE_UUID("0000"),
+     BLECharacteristic::PROPERTY_READ | BLECharacteristic::PROPERTY_WRITE |
+         BLECharacteristic::PROPERTY_NOTIFY,
+     {0x01, 0x01}, kBLE_CPF_UINT32},
+    {"Recording Interval", SENSINT_BLE_UUID("0001"),
+     BLECharacteristic::PROPERTY_READ | BLECharacteristic::PROPERTY_WRITE |
+         BLECharacteristic::PROPERTY_NOTIFY,
+     {0x01, 0x01}, kBLE_CPF_UINT32},
+    {"Augmentation active", SENSINT_BLE_UUID("0002"),
+     BLECharacteristic::PROPERTY_READ | BLECharacteristic::PROPERTY_WRITE |
+         BLECharacteristic::PROPERTY_NOTIFY,
+     {0x01, 0x01}, kBLE_CPF_BOOLEAN},
+    {"IMU reinitialize", SENSINT_BLE_UUID("0003"),
+     BLECharacteristic::PROPERTY_READ | BLECharacteristic::PROPERTY_WRITE |
+         BLECharacteristic::PROPERTY_NOTIFY,
+     {0x01, 0x01}, kBLE_CPF_BOOLEAN},
+    /***************************************************************************
+                                  tracking group
+     **************************************************************************/
+    {"Tracking connected", SENSINT_BLE_UUID("03a0"),
+     BLECharacteristic::PROPERTY_READ | BLECharacteristic::PROPERTY_WRITE, {0x01, 0x01},
+     kBLE_CPF_BOOLEAN},
+    {"Tracking Number of IMUs", SENSINT_BLE_UUID("03a1"),
+     BLECharacteristic::PROPERTY_READ | BLECharacteristic::PROPERTY_WRITE, {0x01, 0x01},
+     kBLE_CPF_UINT8},
+    {"Tracking Data Selection", SENSINT_BLE_UUID("03a3"),
+     BLECharacteristic::PROPERTY_READ | BLECharacteristic::PROPERTY_WRITE |
+         BLECharacteristic::PROPERTY_NOTIFY,
+     {0x01, 0x01}, kBLE_CPF_UINT8},
+    {"Tracking IMU Data", SENSINT_BLE_UUID("0300"),
+     BLECharacteristic::PROPERTY_READ | BLECharacteristic::PROPERTY_WRITE |
+         BLECharacteristic::PROPERTY_WRITE_NR,
+     {0x01, 0x01}, kBLE_CPF_STRUCT}};
+static_assert(sizeof(kCharacteristics) / sizeof(kCharacteristics[0]) ==
+                  static_cast<size_t>(Characteristic::kNumCharacteristics),
+              "a description is required for every characteristic");
+
+constexpr const BleCharacteristicDescription &GetCharacteristic(
+    const Characteristic characteristic) {
+  return kCharacteristics[static_cast<size_t>(characteristic)];
+}
 
 /*******************************************************************************
-                                right shoe group
+                                  shoe groups
  ******************************************************************************/
-static const BleCharacteristicDescription kRightShoeConnected = {
-    "Right Shoe connected",
-    std::string("d0ff02a0" + kUUIDSuffix),
-    BLECharacteristic::PROPERTY_READ | BLECharacteristic::PROPERTY_WRITE,
-    {0x01, 0x01},
-    kBLE_CPF_BOOLEAN};
-
-static const BleCharacteristicDescription kRightShoeTimestamp = {
-    "Right Shoe Timestamp",
-    std::string("d0ff0200" + kUUIDSuffix),
-    BLECharacteristic::PROPERTY_READ | BLECharacteristic::PROPERTY_WRITE,
-    {0x01, 0x01},
-    kBLE_CPF_UINT32};
-
-const BleCharacteristicDescription kRightShoeSensorData = {
-    "Right Shoe Sensor Data",
-    std::string("d0ff0201" + kUUIDSuffix),
-    BLECharacteristic::PROPERTY_READ | BLECharacteristic::PROPERTY_WRITE,
-    {0x01, 0x01},
-    kBLE_CPF_STRUCT};
-
-static const BleCharacteristicDescription kRightShoeIMU = {
-    "Left Shoe IMU",
-    std::string("d0ff0202" + kUUIDSuffix),
-    BLECharacteristic::PROPERTY_READ | BLECharacteristic::PROPERTY_WRITE,
-    {0x01, 0x01},
-    kBLE_CPF_STRUCT};
-
-static const BleCharacteristicDescription kRightShoeSequence = {
-    "Right Shoe Sequence",
-    std::string("d0ff0203" + kUUIDSuffix),
-    BLECharacteristic::PROPERTY_READ | BLECharacteristic::PROPERTY_WRITE |
-        BLECharacteristic::PROPERTY_NOTIFY,
-    {0x01, 0x01},
-    kBLE_CPF_UINT8};
-
-/*******************************************************************************
-                                 tracking group
- ******************************************************************************/
-static const BleCharacteristicDescription kTrackingConnected = {
-    "Tracking connected",
-    std::string("d0ff03a0" + kUUIDSuffix),
-    BLECharacteristic::PROPERTY_READ | BLECharacteristic::PROPERTY_WRITE,
-    {0x01, 0x01},
-    kBLE_CPF_BOOLEAN};
-
-static const BleCharacteristicDescription kTrackingNumberOfIMUs = {
-    "Tracking Number of IMUs",
-    std::string("d0ff03a1" + kUUIDSuffix),
-    BLECharacteristic::PROPERTY_READ | BLECharacteristic::PROPERTY_WRITE,
-    {0x01, 0x01},
-    kBLE_CPF_UINT8};
-
-static const BleCharacteristicDescription kTrackingConnectedIMUs = {
-    "Tracking connected IMU IDs",
-    std::string("d0ff03a2" + kUUIDSuffix),
-    BLECharacteristic::PROPERTY_READ | BLECharacteristic::PROPERTY_WRITE,
-    {0x01, 0x01},
-    kBLE_CPF_UINT8};
-
-static const BleCharacteristicDescription kTrackingDataSelection = {
-    "Tracking Data Selection",
-    std::string("d0ff03a3" + kUUIDSuffix),
-    BLECharacteristic::PROPERTY_READ | BLECharacteristic::PROPERTY_WRITE |
-        BLECharacteristic::PROPERTY_NOTIFY,
-    {0x01, 0x01},
-    kBLE_CPF_UINT8};
-
-static const BleCharacteristicDescription kTrackingIMU1 = {
-    "Tracking IMU 1",
-    std::string("d0ff0301" + kUUIDSuffix),
-    BLECharacteristic::PROPERTY_READ | BLECharacteristic::PROPERTY_WRITE,
-    {0x01, 0x01},
-    kBLE_CPF_STRUCT};
-
-static const BleCharacteristicDescription kTrackingIMU2 = {
-    "Tracking IMU 2",
-    std::string("d0ff0302" + kUUIDSuffix),
-    BLECharacteristic::PROPERTY_READ | BLECharacteristic::PROPERTY_WRITE,
-    {0x01, 0x01},
-    kBLE_CPF_STRUCT};
-
-static const BleCharacteristicDescription kTrackingIMU3 = {
-    "Tracking IMU 3",
-    std::string("d0ff0303" + kUUIDSuffix),
-    BLECharacteristic::PROPERTY_READ | BLECharacteristic::PROPERTY_WRITE,
-    {0x01, 0x01},
-    kBLE_CPF_STRUCT};
-
-static const BleCharacteristicDescription kTrackingIMU4 = {
-    "Tracking IMU 4",
-    std::string("d0ff0304" + kUUIDSuffix),
-    BLECharacteristic::PROPERTY_READ | BLECharacteristic::PROPERTY_WRITE,
-    {0x01, 0x01},
-    kBLE_CPF_STRUCT};
-
-static const BleCharacteristicDescription kTrackingIMU5 = {
-    "Tracking IMU 5",
-    std::string("d0ff0305" + kUUIDSuffix),
-    BLECharacteristic::PROPERTY_READ | BLECharacteristic::PROPERTY_WRITE,
-    {0x01, 0x01},
-    kBLE_CPF_STRUCT};
-
-static const BleCharacteristicDescription kTrackingIMU6 = {
-    "Tracking IMU 6",
-    std::string("d0ff0306" + kUUIDSuffix),
-    BLECharacteristic::PROPERTY_READ | BLECharacteristic::PROPERTY_WRITE,
-    {0x01, 0x01},
-    kBLE_CPF_STRUCT};
-
-static const BleCharacteristicDescription kTrackingIMU7 = {
-    "Tracking IMU 7",
-    std::string("d0ff0307" + kUUIDSuffix),
-    BLECharacteristic::PROPERTY_READ | BLECharacteristic::PROPERTY_WRITE,
-    {0x01, 0x01},
-    kBLE_CPF_STRUCT};
-
-static const BleCharacteristicDescription kTrackingIMU8 = {
-    "Tracking IMU 8",
-    std::string("d0ff0308" + kUUIDSuffix),
-    BLECharacteristic::PROPERTY_READ | BLECharacteristic::PROPERTY_WRITE,
-    {0x01, 0x01},
-    kBLE_CPF_STRUCT};
+enum class ShoeSide : uint8_t { kLeft = 0, kRight = 1 };
+
+enum class ShoeCharacteristic : uint8_t {
+  kConnected = 0,
+  // the clock synchronization requests are answered via notifications (see clock_sync.h)
+  kTimestamp,
+  kSensorData,
+  kIMU,
+  kSequence,
+  // the sensor data is streamed as packets of timestamped samples (see ble_stream.h), reading the
+  // characteristic returns the index of the next sample that is expected by the server
+  kStream,
+  kNumCharacteristics
+};
+
+static constexpr size_t kNumShoeCharacteristics =
+    static_cast<size_t>(ShoeCharacteristic::kNumCharacteristics);
+
+// the characteristics of the shoe group G (e.g. "01") of a subject ("0")
+#define SENSINT_BLE_SHOE_GROUP(SUBJECT, G, SIDE)                                                   \
+  {                                                                                                \
+    {SIDE " Shoe connected (subject " SUBJECT ")", SENSINT_BLE_UUID(G "a0"),                       \
+     BLECharacteristic::PROPERTY_READ | BLECharacteristic::PROPERTY_WRITE,                         \
+     {0x01, 0x01}, kBLE_CPF_BOOLEAN},                                                              \
+    {SIDE " Shoe Timestamp (subject " SUBJECT ")", SENSINT_BLE_UUID(G "00"),                       \
+     BLECharacteristic::PROPERTY_READ | BLECharacteristic::PROPERTY_WRITE |                        \
+         BLECharacteristic::PROPERTY_WRITE_NR | BLECharacteristic::PROPERTY_NOTIFY,                \
+     {0x01, 0x01}, kBLE_CPF_STRUCT},                                                               \
+    {SIDE " Shoe Sensor Data (subject " SUBJECT ")", SENSINT_BLE_UUID(G "01"),                     \
+     BLECharacteristic::PROPERTY_READ | BLECharacteristic::PROPERTY_WRITE,                         \
+     {0x01, 0x01}, kBLE_CPF_STRUCT},                                                               \
+    {SIDE " Shoe IMU (subject " SUBJECT ")", SENSINT_BLE_UUID(G "02"),                             \
+     BLECharacteristic::PROPERTY_READ | BLECharacteristic::PROPERTY_WRITE,                         \
+     {0x01, 0x01}, kBLE_CPF_STRUCT},                                                               \
+    {SIDE " Shoe Sequence (subject " SUBJECT ")", SENSINT_BLE_UUID(G "03"),                        \
+     BLECharacteristic::PROPERTY_READ | BLECharacteristic::PROPERTY_WRITE |                        \
+         BLECharacteristic::PROPERTY_NOTIFY,                                                       \
+     {0x01, 0x01}, kBLE_CPF_UINT8},                                                                \
+    {SIDE " Shoe Stream (subject " SUBJECT ")", SENSINT_BLE_UUID(G "04"),                          \
+     BLECharacteristic::PROPERTY_READ | BLECharacteristic::PROPERTY_WRITE |                        \
+         BLECharacteristic::PROPERTY_WRITE_NR,                                                     \
+     {0x00, 0x00}, kBLE_CPF_STRUCT}                                                                \
+  }
+
+/**
+ * @brief The characteristics of all shoes that can be served by a central, in the order of the
+ * shoe index (see GetShoeIndex).
+ */
+static constexpr size_t kMaxNumberOfShoes = 2 * settings::global::defaults::kMaxNumberOfSubjects;
+static constexpr BleCharacteristicDescription
+    kShoeCharacteristics[kMaxNumberOfShoes][kNumShoeCharacteristics] = {
+        SENSINT_BLE_SHOE_GROUP("0", "01", "Left"), SENSINT_BLE_SHOE_GROUP("0", "02", "Right"),
+        SENSINT_BLE_SHOE_GROUP("1", "11", "Left"), SENSINT_BLE_SHOE_GROUP("1", "12", "Right"),
+        SENSINT_BLE_SHOE_GROUP("2", "21", "Left"), SENSINT_BLE_SHOE_GROUP("2", "22", "Right"),
+        SENSINT_BLE_SHOE_GROUP("3", "31", "Left"), SENSINT_BLE_SHOE_GROUP("3", "32", "Right")};
+#undef SENSINT_BLE_SHOE_GROUP
+
+/**
+ * @return The index of a shoe, which is the slot of the shoe on the central.
+ */
+constexpr uint8_t GetShoeIndex(const uint8_t subject, const ShoeSide side) {
+  return 2 * subject + static_cast<uint8_t>(side);
+}
+
+/**
+ * @brief Get the description of a characteristic of a shoe.
+ *
+ * @param characteristic The characteristic.
+ * @param shoe The index of the shoe (see GetShoeIndex).
+ * @return The description including the UUID of the shoe group.
+ */
+constexpr const BleCharacteristicDescription &GetShoeCharacteristic(
+    const ShoeCharacteristic characteristic, const uint8_t shoe) {
+  return kShoeCharacteristics[shoe][static_cast<size_t>(characteristic)];
+}
 
 }  // namespace characteristics
 }  // namespace config
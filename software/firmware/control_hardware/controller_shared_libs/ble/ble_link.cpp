@@ -0,0 +1,53 @@
+#include "ble_link.h"
+
+#include <esp_gap_ble_api.h>
+
+#include <cstring>
+
+#ifdef SENSINT_DEBUG
+#include <debug.h>
+#endif  // SENSINT_DEBUG
+
+namespace sensint {
+namespace ble {
+
+bool RequestLinkParameters(esp_bd_addr_t address,
+                           const settings::global::LinkParameters &parameters) {
+  bool success = true;
+
+  esp_ble_conn_update_params_t connection_parameters;
+  memcpy(connection_parameters.bda, address, sizeof(esp_bd_addr_t));
+  connection_parameters.min_int = parameters.min_interval;
+  connection_parameters.max_int = parameters.max_interval;
+  connection_parameters.latency = parameters.latency;
+  connection_parameters.timeout = parameters.timeout;
+  if (esp_ble_gap_update_conn_params(&connection_parameters) != ESP_OK) {
+    success = false;
+  }
+
+  if (esp_ble_gap_set_pkt_data_len(address, parameters.data_length) != ESP_OK) {
+    success = false;
+  }
+
+#ifdef CONFIG_BT_BLE_50_FEATURES_SUPPORTED
+  if (parameters.prefer_2m_phy &&
+      esp_ble_gap_set_preferred_phy(address, 0, ESP_BLE_GAP_PHY_2M_PREF_MASK,
+                                    ESP_BLE_GAP_PHY_2M_PREF_MASK,
+                                    ESP_BLE_GAP_PHY_OPTIONS_NO_PREF) != ESP_OK) {
+    success = false;
+  }
+#endif  // CONFIG_BT_BLE_50_FEATURES_SUPPORTED
+
+#ifdef SENSINT_DEBUG
+  debug::Log("RequestLinkParameters",
+             "interval: " + String(parameters.min_interval * 1.25f, 2) + "-" +
+                 String(parameters.max_interval * 1.25f, 2) +
+                 "ms | latency: " + String(parameters.latency) +
+                 " | data length: " + String(parameters.data_length) +
+                 (success ? " | requested" : " | [ERR] request failed"));
+#endif  // SENSINT_DEBUG
+  return success;
+}
+
+}  // namespace ble
+}  // namespace sensint
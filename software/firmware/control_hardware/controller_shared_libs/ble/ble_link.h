@@ -0,0 +1,27 @@
+#ifndef __SENSINT_BLE_LINK_H__
+#define __SENSINT_BLE_LINK_H__
+
+#include <BLEDevice.h>
+#include <global_settings.h>
+
+namespace sensint {
+namespace ble {
+
+/**
+ * @brief Request the connection interval, the data length and the PHY for an established
+ * connection. The requests are answered asynchronously by the peer, hence the parameters may differ
+ * from the requested ones (e.g. the central decides on the connection interval).
+ *
+ * //! The 2M PHY is only requested if the controller supports BLE 5 (e.g. ESP32-C3/S3).
+ *
+ * @param address The address of the peer.
+ * @param parameters The requested parameters (see settings::global::link).
+ * @return True if all requests were accepted by the BLE stack.
+ */
+bool RequestLinkParameters(esp_bd_addr_t address,
+                           const settings::global::LinkParameters &parameters);
+
+}  // namespace ble
+}  // namespace sensint
+
+#endif  // __SENSINT_BLE_LINK_H__
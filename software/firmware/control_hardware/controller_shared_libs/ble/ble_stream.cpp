@@ -0,0 +1,167 @@
+#include "ble_stream.h"
+
+#include <cstring>
+
+namespace sensint {
+namespace ble {
+namespace stream {
+
+size_t GetPayloadSize(const SampleType type) {
+  switch (type) {
+    case SampleType::kImu:
+      return sizeof(ImuData);
+    case SampleType::kPressure:
+      return sizeof(Vector4D<analog_sensor_t>);
+    default:
+      return 0;
+  }
+}
+
+/******************************************************************************
+                                  PacketWriter
+ ******************************************************************************/
+
+PacketWriter::PacketWriter() {}
+
+PacketWriter::~PacketWriter() {}
+
+void PacketWriter::Begin(const uint16_t sequence, const size_t capacity, const uint8_t flags) {
+  capacity_ = (capacity < kMaxPacketSize) ? capacity : kMaxPacketSize;
+  PacketHeader header = {
+      .sequence = sequence, .num_samples = 0, .flags = flags, .first_sample = 0};
+  memcpy(buffer_, &header, sizeof(PacketHeader));
+  size_ = sizeof(PacketHeader);
+}
+
+bool PacketWriter::Add(const uint32_t index, const uint32_t timestamp_us, const SampleType type,
+                       const void *payload) {
+  const auto payload_size = GetPayloadSize(type);
+  if (payload_size == 0 || size_ + sizeof(SampleHeader) + payload_size > capacity_ ||
+      buffer_[offsetof(PacketHeader, num_samples)] == UINT8_MAX) {
+    return false;
+  }
+  if (IsEmpty()) {
+    memcpy(buffer_ + offsetof(PacketHeader, first_sample), &index, sizeof(uint32_t));
+  } else if (index != next_sample_) {
+    return false;
+  }
+  next_sample_ = index + 1;
+  SampleHeader sample_header = {.timestamp_us = timestamp_us, .type = type};
+  memcpy(buffer_ + size_, &sample_header, sizeof(SampleHeader));
+  size_ += sizeof(SampleHeader);
+  memcpy(buffer_ + size_, payload, payload_size);
+  size_ += payload_size;
+  buffer_[offsetof(PacketHeader, num_samples)]++;
+  return true;
+}
+
+bool PacketWriter::IsEmpty() const { return GetNumSamples() == 0; }
+
+uint8_t PacketWriter::GetNumSamples() const {
+  return (size_ < sizeof(PacketHeader)) ? 0 : buffer_[offsetof(PacketHeader, num_samples)];
+}
+
+size_t PacketWriter::GetSize() const { return size_; }
+
+const uint8_t *PacketWriter::GetData() const { return buffer_; }
+
+/******************************************************************************
+                                  PacketReader
+ ******************************************************************************/
+
+PacketReader::PacketReader(const uint8_t *data, const size_t length)
+    : data_(data), length_(length), offset_(sizeof(PacketHeader)), header_({0, 0, 0, 0}) {
+  if (IsValid()) {
+    memcpy(&header_, data_, sizeof(PacketHeader));
+  }
+}
+
+PacketReader::~PacketReader() {}
+
+bool PacketReader::IsValid() const { return data_ != nullptr && length_ >= sizeof(PacketHeader); }
+
+const PacketHeader &PacketReader::GetHeader() const { return header_; }
+
+bool PacketReader::Next(Sample &sample) {
+  if (!IsValid() || offset_ + sizeof(SampleHeader) > length_) {
+    return false;
+  }
+  SampleHeader sample_header;
+  memcpy(&sample_header, data_ + offset_, sizeof(SampleHeader));
+  const auto payload_size = GetPayloadSize(sample_header.type);
+  // an unknown type or a truncated sample invalidates the rest of the packet
+  if (payload_size == 0 || offset_ + sizeof(SampleHeader) + payload_size > length_) {
+    offset_ = length_;
+    return false;
+  }
+  offset_ += sizeof(SampleHeader);
+  sample.timestamp_us = sample_header.timestamp_us;
+  sample.type = sample_header.type;
+  memcpy(&sample.payload, data_ + offset_, payload_size);
+  offset_ += payload_size;
+  return true;
+}
+
+/******************************************************************************
+                                  StreamMonitor
+ ******************************************************************************/
+
+StreamMonitor::StreamMonitor() {}
+
+StreamMonitor::~StreamMonitor() {}
+
+uint8_t StreamMonitor::Update(const PacketHeader &header, const size_t length, StreamGap &gap) {
+  if (has_sequence_ && !(header.flags & kFlagResync)) {
+    // the sequence number wraps around, hence the difference is calculated in 16 bits
+    const uint16_t lost = static_cast<uint16_t>(header.sequence - last_sequence_ - 1);
+    // a gap of almost the full range is a duplicate or reordered packet rather than a loss
+    if (lost < UINT16_MAX / 2) {
+      statistics_.lost_packets += lost;
+    }
+  }
+  has_sequence_ = true;
+  last_sequence_ = header.sequence;
+  statistics_.packets++;
+  statistics_.samples += header.num_samples;
+  statistics_.bytes += length;
+
+  gap = StreamGap();
+  if (header.num_samples == 0) {
+    return 0;
+  }
+  uint8_t skip = 0;
+  const uint32_t end_sample = header.first_sample + header.num_samples;
+  // the sample index wraps around, hence the distances are calculated as signed values
+  const int32_t distance = static_cast<int32_t>(header.first_sample - next_sample_);
+  const bool restarted = (header.flags & kFlagResync) &&
+                         static_cast<int32_t>(end_sample - next_sample_) <= 0;
+  if (!has_sample_ || restarted) {
+    // the first packet or the shoe restarted and its index starts from the beginning
+    next_sample_ = end_sample;
+  } else if (distance > 0) {
+    gap.first_sample = next_sample_;
+    gap.num_samples = static_cast<uint32_t>(distance);
+    statistics_.missing_samples += gap.num_samples;
+    next_sample_ = end_sample;
+  } else if (distance < 0) {
+    skip = (-distance < header.num_samples) ? static_cast<uint8_t>(-distance) : header.num_samples;
+    statistics_.duplicate_samples += skip;
+    if (static_cast<int32_t>(end_sample - next_sample_) > 0) {
+      next_sample_ = end_sample;
+    }
+  } else {
+    next_sample_ = end_sample;
+  }
+  has_sample_ = true;
+  return skip;
+}
+
+void StreamMonitor::SetDroppedPackets(const uint32_t dropped_packets) {
+  statistics_.dropped_packets = dropped_packets;
+}
+
+const StreamStatistics &StreamMonitor::GetStatistics() const { return statistics_; }
+
+}  // namespace stream
+}  // namespace ble
+}  // namespace sensint
@@ -0,0 +1,224 @@
+#ifndef __SENSINT_BLE_STREAM_H__
+#define __SENSINT_BLE_STREAM_H__
+
+#include <types.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace sensint {
+namespace ble {
+namespace stream {
+
+/*******************************************************************************
+ *                            Stream packet layout
+ * -----------------------------------------------------------------------------
+ *
+ * The shoes send their sensor data as a stream of packets (write without
+ * response). Each packet fills up to one ATT payload (MTU - 3 bytes) and
+ * carries multiple timestamped samples. Every sample has a continuous index, so that samples that
+ * are sent again after a reconnect (backfill) are merged in order and the remaining gaps are
+ * detected by the receiver:
+ *
+ *  ┌─────────────────────────────────────────────────┬───────────────────────────────┬─────┐
+ *  │                     HEADER                      │           SAMPLE 1            │ ... │
+ *  ├──────────┬─────────────┬─────────┬──────────────┼──────────────┬──────┬─────────┼─────┤
+ *  │ sequence │ num_samples │ flags   │ first_sample │ timestamp_us │ type │ payload │     │
+ *  ├──────────┼─────────────┼─────────┼──────────────┼──────────────┼──────┼─────────┼─────┤
+ *  │ uint16_t │ uint8_t     │ uint8_t │ uint32_t     │ uint32_t     │ uint8│ uint8[] │     │
+ *  └──────────┴─────────────┴─────────┴──────────────┴──────────────┴──────┴─────────┴─────┘
+ *
+ *  - sequence: packet counter, used by the receiver to detect lost packets
+ *  - num_samples: number of samples in the packet
+ *  - flags: see kFlagResync and kFlagSynchronized
+ *  - first_sample: index of the first sample, the samples of a packet have consecutive indices
+ *  - timestamp_us: time of the acquisition (in microseconds of the shoe or the receiver)
+ *  - type: see SampleType, the size of the payload depends on the type
+ ******************************************************************************/
+
+// the maximum length of an attribute value (BLE specification)
+static constexpr size_t kMaxPacketSize = 512;
+// the ATT header that is subtracted from the MTU
+static constexpr size_t kAttHeaderSize = 3;
+
+// the first packet after a (re-)connect, the receiver restarts the loss detection
+static constexpr uint8_t kFlagResync = 0x01;
+// the timestamps of the packet are given in the clock of the receiver (see clock_sync.h)
+static constexpr uint8_t kFlagSynchronized = 0x02;
+
+enum class SampleType : uint8_t {
+  kImu = 0x00,
+  kPressure = 0x01,
+};
+
+struct __attribute__((__packed__)) PacketHeader {
+  uint16_t sequence;
+  uint8_t num_samples;
+  uint8_t flags;
+  uint32_t first_sample;
+};
+
+struct __attribute__((__packed__)) SampleHeader {
+  uint32_t timestamp_us;
+  SampleType type;
+};
+
+// the smallest packet that holds the largest sample, smaller MTUs require a long write
+static constexpr size_t kMinPacketSize =
+    sizeof(PacketHeader) + sizeof(SampleHeader) + sizeof(ImuData);
+
+/**
+ * @brief A single decoded sample of the stream.
+ */
+struct Sample {
+  uint32_t timestamp_us;
+  SampleType type;
+  union {
+    ImuData imu;
+    Vector4D<analog_sensor_t> pressure;
+  } payload;
+};
+
+/**
+ * @brief A received packet as it is passed from the BLE stack to the application.
+ */
+struct Packet {
+  uint16_t length;
+  uint8_t data[kMaxPacketSize];
+};
+
+/**
+ * @brief Counters of a single stream. The counters are never reset while the firmware is running.
+ */
+struct StreamStatistics {
+  uint32_t packets = 0;
+  uint32_t samples = 0;
+  uint32_t bytes = 0;
+  // packets that were lost on the air (detected via gaps in the sequence number)
+  uint32_t lost_packets = 0;
+  // packets that were dropped by the receiver, because the application did not keep up
+  uint32_t dropped_packets = 0;
+  // samples that are missing in the recording (detected via gaps in the sample index)
+  uint32_t missing_samples = 0;
+  // samples that were received twice (e.g. the backfill after a reconnect) and were discarded
+  uint32_t duplicate_samples = 0;
+};
+
+/**
+ * @brief A range of samples that is missing in the stream.
+ */
+struct StreamGap {
+  uint32_t first_sample = 0;
+  uint32_t num_samples = 0;
+};
+
+/**
+ * @brief Get the size of the payload of a sample in bytes.
+ *
+ * @param type The type of the sample.
+ * @return size_t The size of the payload or 0 for unknown types.
+ */
+size_t GetPayloadSize(const SampleType type);
+
+/**
+ * @brief Packs samples into a single packet.
+ */
+class PacketWriter {
+ public:
+  PacketWriter();
+  ~PacketWriter();
+
+  /**
+   * @brief Start a new packet.
+   *
+   * @param sequence The sequence number of the packet.
+   * @param capacity The maximum size of the packet in bytes (negotiated MTU - 3).
+   * @param flags The flags of the packet.
+   */
+  void Begin(const uint16_t sequence, const size_t capacity, const uint8_t flags = 0);
+
+  /**
+   * @brief Add a sample to the packet.
+   *
+   * @param index The index of the sample, it must follow the previous sample of the packet.
+   * @return True if the sample was added, false if the packet is full or the index does not follow
+   * the previous sample.
+   */
+  bool Add(const uint32_t index, const uint32_t timestamp_us, const SampleType type,
+           const void *payload);
+
+  bool IsEmpty() const;
+  uint8_t GetNumSamples() const;
+  size_t GetSize() const;
+  const uint8_t *GetData() const;
+
+ private:
+  uint8_t buffer_[kMaxPacketSize];
+  size_t size_ = 0;
+  size_t capacity_ = 0;
+  uint32_t next_sample_ = 0;
+};
+
+/**
+ * @brief Unpacks the samples of a single packet.
+ */
+class PacketReader {
+ public:
+  PacketReader(const uint8_t *data, const size_t length);
+  ~PacketReader();
+
+  /**
+   * @brief Check whether the packet contains a complete header.
+   */
+  bool IsValid() const;
+  const PacketHeader &GetHeader() const;
+
+  /**
+   * @brief Read the next sample of the packet.
+   *
+   * @param sample The decoded sample.
+   * @return False if there are no more (complete) samples in the packet.
+   */
+  bool Next(Sample &sample);
+
+ private:
+  const uint8_t *data_;
+  size_t length_;
+  size_t offset_;
+  PacketHeader header_;
+};
+
+/**
+ * @brief Keeps track of the sequence numbers and the counters of a single stream.
+ */
+class StreamMonitor {
+ public:
+  StreamMonitor();
+  ~StreamMonitor();
+
+  /**
+   * @brief Update the counters with a received packet.
+   *
+   * @param header The header of the packet.
+   * @param length The length of the packet in bytes.
+   * @param gap The samples that are missing before the packet (num_samples is 0 if there is none).
+   * @return uint8_t The number of samples at the beginning of the packet, which were already
+   * received and have to be skipped.
+   */
+  uint8_t Update(const PacketHeader &header, const size_t length, StreamGap &gap);
+  void SetDroppedPackets(const uint32_t dropped_packets);
+  const StreamStatistics &GetStatistics() const;
+
+ private:
+  bool has_sequence_ = false;
+  uint16_t last_sequence_ = 0;
+  bool has_sample_ = false;
+  uint32_t next_sample_ = 0;
+  StreamStatistics statistics_;
+};
+
+}  // namespace stream
+}  // namespace ble
+}  // namespace sensint
+
+#endif  // __SENSINT_BLE_STREAM_H__
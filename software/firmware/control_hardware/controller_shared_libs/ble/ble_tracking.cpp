@@ -0,0 +1,54 @@
+#include "ble_tracking.h"
+
+#include <cstring>
+
+namespace sensint {
+namespace ble {
+namespace tracking {
+
+namespace {
+// IMUs with an ID beyond the slots are ignored
+constexpr uint32_t kSlotMask =
+    (kNumSlots >= 32) ? UINT32_MAX : static_cast<uint32_t>((1ULL << kNumSlots) - 1);
+}  // namespace
+
+size_t GetFrameSize(const uint32_t connected_imus) {
+  return sizeof(FrameHeader) + __builtin_popcount(connected_imus) * sizeof(ImuData);
+}
+
+size_t Pack(const TrackingData &tracking, uint8_t *buffer) {
+  FrameHeader header = {.connected_imus = tracking.connected_imus & kSlotMask};
+  memcpy(buffer, &header, sizeof(FrameHeader));
+  size_t size = sizeof(FrameHeader);
+  for (size_t id = 0; id < kNumSlots; id++) {
+    if (header.connected_imus & (1UL << id)) {
+      memcpy(buffer + size, &tracking.imu[id], sizeof(ImuData));
+      size += sizeof(ImuData);
+    }
+  }
+  return size;
+}
+
+bool Unpack(const uint8_t *data, const size_t length, TrackingData &tracking) {
+  if (data == nullptr || length < sizeof(FrameHeader)) {
+    return false;
+  }
+  FrameHeader header;
+  memcpy(&header, data, sizeof(FrameHeader));
+  if (length != GetFrameSize(header.connected_imus)) {
+    return false;
+  }
+  size_t offset = sizeof(FrameHeader);
+  for (size_t id = 0; id < kNumSlots; id++) {
+    if (header.connected_imus & (1UL << id)) {
+      memcpy(&tracking.imu[id], data + offset, sizeof(ImuData));
+      offset += sizeof(ImuData);
+    }
+  }
+  tracking.connected_imus = header.connected_imus & kSlotMask;
+  return true;
+}
+
+}  // namespace tracking
+}  // namespace ble
+}  // namespace sensint
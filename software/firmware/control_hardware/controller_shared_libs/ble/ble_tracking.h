@@ -0,0 +1,85 @@
+#ifndef __SENSINT_BLE_TRACKING_H__
+#define __SENSINT_BLE_TRACKING_H__
+
+#include <global_settings.h>
+#include <types.h>
+
+#include <cstddef>
+#include <cstdint>
+
+#include "ble_stream.h"
+
+namespace sensint {
+namespace ble {
+namespace tracking {
+
+/*******************************************************************************
+ *                            Tracking frame layout
+ * -----------------------------------------------------------------------------
+ *
+ * The motion tracking system writes the data of all IMUs as a single frame
+ * (one ATT operation per update). Only the connected IMUs are part of the
+ * frame, in the order of their IDs:
+ *
+ *  ┌────────────────┬──────────────────┬──────────────────┬─────┐
+ *  │     HEADER     │ IMU (lowest ID)  │ IMU (next ID)    │ ... │
+ *  ├────────────────┼──────────────────┼──────────────────┼─────┤
+ *  │ connected_imus │ ImuData          │ ImuData          │     │
+ *  ├────────────────┼──────────────────┼──────────────────┼─────┤
+ *  │ uint32_t       │ uint8[]          │ uint8[]          │     │
+ *  └────────────────┴──────────────────┴──────────────────┴─────┘
+ *
+ *  - connected_imus: bitmask of the connected IMUs (bit n: IMU with ID n), IMUs with an ID beyond
+ *    kNumSlots are skipped by the receiver
+ ******************************************************************************/
+
+static constexpr size_t kNumSlots = settings::global::defaults::kTrackingMaxNumberOfIMUs;
+static_assert(kNumSlots <= 32, "the connected IMUs are given as 32 bit mask");
+
+struct __attribute__((__packed__)) FrameHeader {
+  uint32_t connected_imus;
+};
+
+static constexpr size_t kMaxFrameSize = sizeof(FrameHeader) + kNumSlots * sizeof(ImuData);
+static_assert(kMaxFrameSize <= stream::kMaxPacketSize, "the frame exceeds a single attribute");
+
+/**
+ * @brief The latest data of all IMUs of the motion tracking system. The data of an IMU is only
+ * valid if its bit is set in connected_imus.
+ */
+struct TrackingData {
+  uint32_t connected_imus = 0;
+  ImuData imu[kNumSlots];
+};
+
+/**
+ * @brief Get the size of a frame in bytes.
+ *
+ * @param connected_imus The bitmask of the connected IMUs.
+ */
+size_t GetFrameSize(const uint32_t connected_imus);
+
+/**
+ * @brief Pack the data of the connected IMUs into a frame.
+ *
+ * @param tracking The data of all IMUs.
+ * @param buffer The buffer of the frame (at least kMaxFrameSize bytes).
+ * @return size_t The size of the frame in bytes.
+ */
+size_t Pack(const TrackingData &tracking, uint8_t *buffer);
+
+/**
+ * @brief Unpack a frame. The slots of the IMUs that are not connected are not modified.
+ *
+ * @param data The frame.
+ * @param length The size of the frame in bytes.
+ * @param tracking The data of all IMUs.
+ * @return False if the size of the frame does not match its header.
+ */
+bool Unpack(const uint8_t *data, const size_t length, TrackingData &tracking);
+
+}  // namespace tracking
+}  // namespace ble
+}  // namespace sensint
+
+#endif  // __SENSINT_BLE_TRACKING_H__
@@ -1,6 +1,13 @@
 #ifndef __SENSINT_GLOBAL_SETTINGS_H__
 #define __SENSINT_GLOBAL_SETTINGS_H__
 
+#include <cstdint>
+
+#ifdef ESP32
+// the configuration of the precompiled ESP-IDF, e.g. the number of BLE connections
+#include <sdkconfig.h>
+#endif  // ESP32
+
 /**
  * @brief This file provides the settings for the senSInt project.
  * These are the parameters that could change during the operation of the system
@@ -10,13 +17,65 @@
 namespace sensint {
 namespace settings {
 namespace global {
+
+/**
+ * @brief Parameters of a BLE connection. The intervals are given in units of 1.25 ms and the
+ * supervision timeout in units of 10 ms (see Bluetooth Core Specification Vol 6, Part B, 4.5.1).
+ */
+struct LinkParameters {
+  uint16_t min_interval;
+  uint16_t max_interval;
+  uint16_t latency;
+  uint16_t timeout;
+  // payload of a single link layer packet (data length extension), 27 to 251 bytes
+  uint16_t data_length;
+  // only used if the controller supports BLE 5
+  bool prefer_2m_phy;
+};
+
+namespace link {
+// 7.5 - 15 ms connection interval, every connection event is used
+static constexpr LinkParameters kLowLatency = {6, 12, 0, 200, 251, true};
+// 50 - 100 ms connection interval, the peripheral may skip 4 connection events
+static constexpr LinkParameters kLowPower = {40, 80, 4, 400, 27, false};
+}  // namespace link
+
 namespace defaults {
 // serial interface
 static constexpr int kBaudRate = 115200;
 // ble interface
 static constexpr uint16_t kMTU = 517;
+#if SENSINT_BLE_PROFILE == 1
+static constexpr LinkParameters kLinkParameters = link::kLowPower;
+#else
+static constexpr LinkParameters kLinkParameters = link::kLowLatency;
+#endif  // SENSINT_BLE_PROFILE
 // motion tracking system
 static constexpr uint8_t kTrackingMaxNumberOfIMUs = 8;
+// subjects, i.e. pairs of shoes, that are served by a single central
+#ifdef SENSINT_SUBJECTS
+static constexpr uint8_t kNumberOfSubjects = SENSINT_SUBJECTS;
+#else
+static constexpr uint8_t kNumberOfSubjects = 1;
+#endif  // SENSINT_SUBJECTS
+static constexpr uint8_t kNumberOfShoes = 2 * kNumberOfSubjects;
+//! the characteristics of the central are defined for up to 4 subjects (see ble_config.h)
+static constexpr uint8_t kMaxNumberOfSubjects = 4;
+//! The BLE controller of the ESP32 supports CONFIG_BTDM_CTRL_BLE_MAX_CONN simultaneous
+//! connections, which is 3 for the precompiled Arduino framework. One of them is reserved for a
+//! smartphone or the motion tracking system, hence the stock build serves a single subject. More
+//! subjects require a framework built with a custom sdkconfig (up to 9 connections, i.e. 4
+//! subjects).
+#ifdef CONFIG_BTDM_CTRL_BLE_MAX_CONN
+static constexpr uint8_t kMaxNumberOfConnections = CONFIG_BTDM_CTRL_BLE_MAX_CONN;
+#else
+static constexpr uint8_t kMaxNumberOfConnections = 3;
+#endif  // CONFIG_BTDM_CTRL_BLE_MAX_CONN
+static_assert(kNumberOfSubjects >= 1 && kNumberOfSubjects <= kMaxNumberOfSubjects,
+              "a central supports 1 to 4 subjects");
+static_assert(2 * kNumberOfSubjects + 1 <= kMaxNumberOfConnections,
+              "the BLE controller does not support the connections of this number of subjects "
+              "(see CONFIG_BTDM_CTRL_BLE_MAX_CONN)");
 }  // namespace defaults
 
 static int baud_rate = defaults::kBaudRate;
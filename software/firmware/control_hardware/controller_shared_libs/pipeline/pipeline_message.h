@@ -0,0 +1,41 @@
+#ifndef __SENSINT_PIPELINE_MESSAGE_H__
+#define __SENSINT_PIPELINE_MESSAGE_H__
+
+#include <types.h>
+
+namespace sensint {
+namespace pipeline {
+
+/**
+ * @brief Types of messages that are exchanged between the tasks of the pipeline.
+ */
+enum class MessageType : uint8_t {
+  // sensor acquisition -> transport
+  kImuData = 0x00,
+  kPressureData = 0x01,
+  kImuReinitialized = 0x02,
+  // transport -> generator control
+  kAugmentationActive = 0x10,
+  kSequence = 0x11,
+  // generator control -> transport
+  kSequenceApplied = 0x20,
+};
+
+/**
+ * @brief Fixed-size message that is passed between the tasks of the pipeline. Each message carries
+ * the time (in microseconds) when it was created, e.g. when the sensor data was acquired.
+ */
+struct Message {
+  uint32_t timestamp_us;
+  MessageType type;
+  union {
+    ImuData imu;
+    Vector4D<analog_sensor_t> pressure;
+    uint32_t value;
+  } payload;
+};
+
+}  // namespace pipeline
+}  // namespace sensint
+
+#endif  // __SENSINT_PIPELINE_MESSAGE_H__
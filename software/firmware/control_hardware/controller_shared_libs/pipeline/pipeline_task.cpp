@@ -0,0 +1,122 @@
+#include "pipeline_task.h"
+
+#ifdef ESP32
+#include <esp_timer.h>
+#else
+#include <chrono>
+#endif  // ESP32
+
+namespace sensint {
+namespace pipeline {
+
+PipelineTask::PipelineTask(const char *name, StepFunction step, const uint32_t period_ms,
+                           const uint32_t stack_size, const uint8_t priority, const int8_t core)
+    : name_(name),
+      step_(step),
+      period_ms_(period_ms),
+      stack_size_(stack_size),
+      priority_(priority),
+      core_(core) {}
+
+PipelineTask::~PipelineTask() { Stop(); }
+
+bool PipelineTask::Start() {
+  if (running_.load()) {
+    return false;
+  }
+  window_start_us_ = Now();
+  running_.store(true);
+#ifdef ESP32
+  if (xTaskCreatePinnedToCore(Run, name_, stack_size_, this, priority_, &handle_, core_) !=
+      pdPASS) {
+    running_.store(false);
+    return false;
+  }
+#else
+  thread_ = std::thread(Run, this);
+#endif  // ESP32
+  return true;
+}
+
+void PipelineTask::Stop() {
+  if (!running_.load()) {
+    return;
+  }
+#ifdef ESP32
+  // the task notifies the caller before it deletes itself
+  stopping_task_ = xTaskGetCurrentTaskHandle();
+  running_.store(false);
+  ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+  handle_ = nullptr;
+#else
+  running_.store(false);
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+#endif  // ESP32
+}
+
+TaskStatistics PipelineTask::GetStatistics() {
+  const uint32_t now = Now();
+  const uint32_t window_us = now - window_start_us_;
+  window_start_us_ = now;
+  TaskStatistics statistics;
+#ifdef ESP32
+  // on the ESP32 the stack size is given in bytes (in contrast to vanilla FreeRTOS)
+  statistics.stack_free_bytes = (handle_ != nullptr) ? uxTaskGetStackHighWaterMark(handle_) : 0;
+#else
+  statistics.stack_free_bytes = 0;
+#endif  // ESP32
+  const uint32_t busy_us = busy_us_.exchange(0);
+  statistics.cpu_load_percent = (window_us > 0) ? (100.0f * busy_us) / window_us : 0.0f;
+  statistics.max_step_us = max_step_us_.exchange(0);
+  statistics.iterations = iterations_.exchange(0);
+  return statistics;
+}
+
+const char *PipelineTask::GetName() const { return name_; }
+
+void PipelineTask::Run(void *task) { static_cast<PipelineTask *>(task)->Execute(); }
+
+void PipelineTask::Execute() {
+#ifdef ESP32
+  const TickType_t period_ticks = (pdMS_TO_TICKS(period_ms_) > 0) ? pdMS_TO_TICKS(period_ms_) : 1;
+  TickType_t last_wake_time = xTaskGetTickCount();
+#else
+  auto next_wake_time = std::chrono::steady_clock::now();
+#endif  // ESP32
+  while (running_.load()) {
+    const uint32_t start_us = Now();
+    step_();
+    const uint32_t step_us = Now() - start_us;
+    busy_us_.fetch_add(step_us);
+    if (step_us > max_step_us_.load()) {
+      max_step_us_.store(step_us);
+    }
+    iterations_.fetch_add(1);
+#ifdef ESP32
+    vTaskDelayUntil(&last_wake_time, period_ticks);
+#else
+    next_wake_time += std::chrono::milliseconds(period_ms_);
+    std::this_thread::sleep_until(next_wake_time);
+#endif  // ESP32
+  }
+#ifdef ESP32
+  // a FreeRTOS task must not return from its function
+  xTaskNotifyGive(stopping_task_);
+  vTaskDelete(nullptr);
+#endif  // ESP32
+}
+
+uint32_t PipelineTask::Now() {
+#ifdef ESP32
+  return static_cast<uint32_t>(esp_timer_get_time());
+#else
+  return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                                   std::chrono::steady_clock::now().time_since_epoch())
+                                   .count());
+#endif  // ESP32
+}
+
+}  // namespace pipeline
+}  // namespace sensint
@@ -0,0 +1,112 @@
+#ifndef __SENSINT_PIPELINE_TASK_H__
+#define __SENSINT_PIPELINE_TASK_H__
+
+#include <atomic>
+#include <cstdint>
+
+#ifdef ESP32
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#else
+#include <thread>
+#endif  // ESP32
+
+namespace sensint {
+namespace pipeline {
+
+/**
+ * @brief Runtime statistics of a task since the last call of PipelineTask::GetStatistics().
+ */
+struct TaskStatistics {
+  // minimum of free stack space since the start of the task (0 if unknown)
+  uint32_t stack_free_bytes;
+  // share of the time the task was busy executing its step function
+  float cpu_load_percent;
+  // longest execution of the step function
+  uint32_t max_step_us;
+  // number of executions of the step function
+  uint32_t iterations;
+};
+
+/**
+ * @brief Periodic task that executes a step function in a fixed interval. On the ESP32 the task is
+ * a FreeRTOS task pinned to a core. On other platforms (e.g. the host) it runs on a std::thread, so
+ * that the same pipeline can be executed without the hardware.
+ */
+class PipelineTask {
+ public:
+  using StepFunction = void (*)();
+
+  /**
+   * @brief Construct a new PipelineTask object. The task is not started before Start() is called.
+   *
+   * @param name The name of the task (max. 15 characters on the ESP32).
+   * @param step The function that is executed periodically.
+   * @param period_ms The interval of the execution. If the step takes longer, the next execution
+   * starts immediately.
+   * @param stack_size The size of the stack in bytes (ignored on the host).
+   * @param priority The FreeRTOS priority of the task (ignored on the host).
+   * @param core The core the task is pinned to (ignored on the host).
+   */
+  PipelineTask(const char *name, StepFunction step, const uint32_t period_ms,
+               const uint32_t stack_size, const uint8_t priority, const int8_t core);
+
+  /**
+   * @brief Destroy the PipelineTask object. A running task is stopped before.
+   */
+  ~PipelineTask();
+
+  /**
+   * @brief Create and start the task.
+   *
+   * @return True if the task was started.
+   */
+  bool Start();
+
+  /**
+   * @brief Stop the task after the current execution of the step function and wait for it to end.
+   */
+  void Stop();
+
+  /**
+   * @brief Get the statistics since the last call and reset the measurement window.
+   *
+   * @return TaskStatistics
+   */
+  TaskStatistics GetStatistics();
+
+  /**
+   * @brief Get the name of the task.
+   *
+   * @return const char*
+   */
+  const char *GetName() const;
+
+ private:
+  const char *name_;
+  StepFunction step_;
+  uint32_t period_ms_;
+  uint32_t stack_size_;
+  uint8_t priority_;
+  int8_t core_;
+  std::atomic<bool> running_{false};
+  std::atomic<uint32_t> busy_us_{0};
+  std::atomic<uint32_t> max_step_us_{0};
+  std::atomic<uint32_t> iterations_{0};
+  uint32_t window_start_us_ = 0;
+#ifdef ESP32
+  TaskHandle_t handle_ = nullptr;
+  TaskHandle_t stopping_task_ = nullptr;
+#else
+  std::thread thread_;
+#endif  // ESP32
+
+  static void Run(void *task);
+  void Execute();
+  static uint32_t Now();
+};
+
+}  // namespace pipeline
+}  // namespace sensint
+
+#endif  // __SENSINT_PIPELINE_TASK_H__
@@ -0,0 +1,111 @@
+#include "sample_ring.h"
+
+#include <cstdlib>
+
+#ifdef ESP32
+#include <esp_heap_caps.h>
+#endif  // ESP32
+
+namespace sensint {
+namespace pipeline {
+
+SampleRing::SampleRing() {}
+
+SampleRing::~SampleRing() {
+#ifdef ESP32
+  heap_caps_free(buffer_);
+#else
+  free(buffer_);
+#endif  // ESP32
+}
+
+bool SampleRing::Init(const size_t capacity_external, const size_t capacity_internal) {
+  if (buffer_ != nullptr) {
+    return true;
+  }
+  for (auto capacity : {capacity_external, capacity_internal}) {
+    if (capacity < 2 || (capacity & (capacity - 1)) != 0) {
+      return false;
+    }
+  }
+#ifdef ESP32
+  buffer_ = static_cast<RecordedSample *>(heap_caps_malloc(
+      capacity_external * sizeof(RecordedSample), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT));
+  if (buffer_ != nullptr) {
+    capacity_ = capacity_external;
+    external_ = true;
+  } else {
+    buffer_ = static_cast<RecordedSample *>(
+        heap_caps_malloc(capacity_internal * sizeof(RecordedSample), MALLOC_CAP_8BIT));
+    capacity_ = capacity_internal;
+  }
+#else
+  buffer_ = static_cast<RecordedSample *>(malloc(capacity_internal * sizeof(RecordedSample)));
+  capacity_ = capacity_internal;
+#endif  // ESP32
+  if (buffer_ == nullptr) {
+    capacity_ = 0;
+    return false;
+  }
+  mask_ = capacity_ - 1;
+  return true;
+}
+
+bool SampleRing::Push(const Message &message) {
+  const uint32_t index = next_index_++;
+  const size_t head = head_.load(std::memory_order_relaxed);
+  if (capacity_ == 0 || head - tail_.load(std::memory_order_acquire) >= capacity_) {
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  buffer_[head & mask_] = {.index = index, .message = message};
+  head_.store(head + 1, std::memory_order_release);
+  return true;
+}
+
+bool SampleRing::Peek(RecordedSample &sample) const {
+  if (cursor_ == head_.load(std::memory_order_acquire)) {
+    return false;
+  }
+  sample = buffer_[cursor_ & mask_];
+  return true;
+}
+
+void SampleRing::Advance() {
+  if (cursor_ == head_.load(std::memory_order_acquire)) {
+    return;
+  }
+  cursor_++;
+  // half of the ring is kept for a rewind, the other half is free for the producer
+  const size_t tail = tail_.load(std::memory_order_relaxed);
+  if (cursor_ - tail > capacity_ / 2) {
+    tail_.store(cursor_ - capacity_ / 2, std::memory_order_release);
+  }
+}
+
+bool SampleRing::Rewind(const uint32_t index) {
+  // the indices wrap around, hence the distance is compared as signed value
+  size_t position = cursor_;
+  const size_t tail = tail_.load(std::memory_order_relaxed);
+  while (position != tail) {
+    const uint32_t previous = buffer_[(position - 1) & mask_].index;
+    if (static_cast<int32_t>(previous - index) < 0) {
+      break;
+    }
+    position--;
+  }
+  const bool rewound = position != cursor_;
+  cursor_ = position;
+  return rewound;
+}
+
+size_t SampleRing::GetPending() const { return head_.load(std::memory_order_acquire) - cursor_; }
+
+size_t SampleRing::GetCapacity() const { return capacity_; }
+
+uint32_t SampleRing::GetDropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+bool SampleRing::IsExternal() const { return external_; }
+
+}  // namespace pipeline
+}  // namespace sensint
@@ -0,0 +1,101 @@
+#ifndef __SENSINT_SAMPLE_RING_H__
+#define __SENSINT_SAMPLE_RING_H__
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "pipeline_message.h"
+
+namespace sensint {
+namespace pipeline {
+
+/**
+ * @brief A sample of the recording with its (continuous) index. The index is incremented for every
+ * sample, including the ones that were dropped, hence a missing index marks a gap of the recording.
+ */
+struct RecordedSample {
+  uint32_t index;
+  Message message;
+};
+
+/**
+ * @brief Lock-free single-producer/single-consumer ring buffer of the recorded samples. In contrast
+ * to the SpscQueue, the samples are kept after they were read, so that the consumer can rewind and
+ * send them again (e.g. after a reconnect). The consumer releases the samples that are more than
+ * half of the capacity behind its read position. If the ring is full, the new sample is dropped.
+ *
+ *   tail                   cursor                   head
+ *    |--- already read ------|------- pending -------|------- free -------|
+ *
+ * The buffer is allocated in the external PSRAM if available and in the internal RAM otherwise.
+ *
+ * //! Exactly one task may push and exactly one task may read.
+ */
+class SampleRing {
+ public:
+  SampleRing();
+  ~SampleRing();
+
+  /**
+   * @brief Allocate the buffer. The capacities must be a power of two.
+   *
+   * @param capacity_external The number of samples if the PSRAM is available.
+   * @param capacity_internal The number of samples if the buffer is allocated in the internal RAM.
+   * @return False if the buffer could not be allocated.
+   */
+  bool Init(const size_t capacity_external, const size_t capacity_internal);
+
+  /**
+   * @brief Add a sample to the ring (producer only).
+   *
+   * @return False if the ring was full and the sample was dropped.
+   */
+  bool Push(const Message &message);
+
+  /**
+   * @brief Get the sample at the read position without advancing it (consumer only).
+   *
+   * @return False if there is no pending sample.
+   */
+  bool Peek(RecordedSample &sample) const;
+
+  /**
+   * @brief Advance the read position by one sample and release old samples (consumer only).
+   */
+  void Advance();
+
+  /**
+   * @brief Move the read position back to the sample with the given index (consumer only). If the
+   * sample was already released, the read position is moved to the oldest sample in the ring.
+   *
+   * @param index The index of the first sample that is read again.
+   * @return False if the index is ahead of the read position (nothing to rewind).
+   */
+  bool Rewind(const uint32_t index);
+
+  // the number of samples that were not read yet
+  size_t GetPending() const;
+  size_t GetCapacity() const;
+  uint32_t GetDropped() const;
+  bool IsExternal() const;
+
+ private:
+  RecordedSample *buffer_ = nullptr;
+  size_t capacity_ = 0;
+  size_t mask_ = 0;
+  bool external_ = false;
+  // owned by the producer
+  uint32_t next_index_ = 0;
+  // owned by the consumer
+  size_t cursor_ = 0;
+  // head and tail are placed in different cache lines to prevent false sharing between the cores
+  alignas(32) std::atomic<size_t> head_{0};
+  alignas(32) std::atomic<size_t> tail_{0};
+  std::atomic<uint32_t> dropped_{0};
+};
+
+}  // namespace pipeline
+}  // namespace sensint
+
+#endif  // __SENSINT_SAMPLE_RING_H__
@@ -0,0 +1,107 @@
+#ifndef __SENSINT_SPSC_QUEUE_H__
+#define __SENSINT_SPSC_QUEUE_H__
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace sensint {
+namespace pipeline {
+
+/**
+ * @brief Lock-free single-producer/single-consumer queue with a fixed capacity. The queue never
+ * allocates memory and never blocks. If the queue is full, the new element is dropped and counted.
+ *
+ * //! Exactly one task (or callback context) may push and exactly one task may pop.
+ *
+ * @tparam T The type of the elements. It should be trivially copyable.
+ * @tparam N The capacity of the queue. It must be a power of two.
+ */
+template <typename T, size_t N>
+class SpscQueue {
+  static_assert(N >= 2 && (N & (N - 1)) == 0, "the capacity must be a power of two");
+
+ public:
+  /**
+   * @brief Add an element to the queue (producer only).
+   *
+   * @param element The element to add.
+   * @return True if the element was added, false if the queue was full.
+   */
+  bool Push(const T &element) {
+    const size_t head = head_.load(std::memory_order_relaxed);
+    if (head - tail_.load(std::memory_order_acquire) >= N) {
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    buffer_[head & kMask] = element;
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Remove the oldest element from the queue (consumer only).
+   *
+   * @param element The removed element.
+   * @return True if an element was removed, false if the queue was empty.
+   */
+  bool Pop(T &element) {
+    const size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail == head_.load(std::memory_order_acquire)) {
+      return false;
+    }
+    element = buffer_[tail & kMask];
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Get the oldest element without removing it (consumer only).
+   *
+   * @return const T* Pointer to the oldest element or nullptr if the queue is empty.
+   */
+  const T *Peek() const {
+    const size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail == head_.load(std::memory_order_acquire)) {
+      return nullptr;
+    }
+    return &buffer_[tail & kMask];
+  }
+
+  /**
+   * @brief Get the number of elements in the queue. The value is only a snapshot if called
+   * concurrently.
+   *
+   * @return size_t
+   */
+  size_t Size() const {
+    return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+  }
+
+  /**
+   * @brief Get the capacity of the queue.
+   *
+   * @return constexpr size_t
+   */
+  static constexpr size_t Capacity() { return N; }
+
+  /**
+   * @brief Get the number of elements that were dropped because the queue was full.
+   *
+   * @return uint32_t
+   */
+  uint32_t GetDropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+ private:
+  static constexpr size_t kMask = N - 1;
+  T buffer_[N];
+  // head and tail are placed in different cache lines to prevent false sharing between the cores
+  alignas(32) std::atomic<size_t> head_{0};
+  alignas(32) std::atomic<size_t> tail_{0};
+  std::atomic<uint32_t> dropped_{0};
+};
+
+}  // namespace pipeline
+}  // namespace sensint
+
+#endif  // __SENSINT_SPSC_QUEUE_H__
@@ -8,6 +8,14 @@ namespace sensint {
 namespace sensor {
 // namespace imu {
 
+namespace {
+#ifdef ESP32
+// the NVS namespace and keys are limited to 15 characters
+static constexpr const char *kStorageNamespace = "sensint_imu";
+static constexpr const char *kStorageKeyPrefix = "bno055_";
+#endif  // ESP32
+}  // namespace
+
 BNO055::BNO055() : BNO055(kDefaultId) {}
 
 BNO055::BNO055(const uint8_t id, const uint8_t address) : IMU(id) {
@@ -24,8 +32,47 @@ bool BNO055::Init() {
   // We use the OPERATION_MODE_IMUPLUS to the IMU's relative orientation. The zero-rotation [0,0,0]
   // (initial orientaion) is set at initialization of the IMU. To reset the orientation one need to
   // reinitialize the IMU.
+  init_time_ms_ = millis();
+  time_to_calibration_ms_ = 0;
   initialized_ = device_->begin(adafruit_bno055_opmode_t::OPERATION_MODE_IMUPLUS);
-  return initialized_;
+  if (!initialized_) {
+    return false;
+  }
+  // setSensorOffsets() switches to CONFIG mode and back to IMUPLUS, hence the zero-rotation is set
+  // after the offsets were written
+  offsets_restored_ = LoadOffsetsFromStorage();
+  if (offsets_restored_) {
+    device_->setSensorOffsets(offsets_);
+    offsets_stored_ = true;
+  }
+#ifdef SENSINT_DEBUG
+  debug::Log("BNO055::Init",
+             offsets_restored_ ? "calibration offsets restored" : "no calibration offsets stored");
+#endif  // SENSINT_DEBUG
+  return true;
+}
+
+bool BNO055::Reinitialize() {
+  if (!initialized_) {
+    return Init();
+  }
+  init_time_ms_ = millis();
+  time_to_calibration_ms_ = 0;
+  if (offsets_valid_) {
+    // writing the offsets requires CONFIG mode and restarts the fusion in IMUPLUS mode
+    device_->setSensorOffsets(offsets_);
+    offsets_restored_ = true;
+  } else {
+    device_->setMode(adafruit_bno055_opmode_t::OPERATION_MODE_CONFIG);
+    delay(kModeSwitchDelayMs);
+    device_->setMode(adafruit_bno055_opmode_t::OPERATION_MODE_IMUPLUS);
+    offsets_restored_ = false;
+  }
+  delay(kModeSwitchDelayMs);
+#ifdef SENSINT_DEBUG
+  debug::Log("BNO055::Reinitialize", "orientation reset");
+#endif  // SENSINT_DEBUG
+  return true;
 }
 
 void BNO055::UpdateData(const uint8_t data_types) {
@@ -34,6 +81,7 @@ void BNO055::UpdateData(const uint8_t data_types) {
   }
   data_.calibration = GetCalibration();
   data_.time_offset = time_offset_;
+  UpdateCalibrationTiming();
   if (data_types & static_cast<uint8_t>(ImuDataType::kOrientation)) {
     // device_->getEvent(&orientation_data_, Adafruit_BNO055::VECTOR_EULER);
     // ConvertEventToVector(orientation_data_.orientation, data_.orientation_euler);
@@ -100,6 +148,79 @@ bool BNO055::IsCalibrated() const {
 
 void BNO055::SetTimeOffset(const uint32_t offset_ms) { time_offset_ = offset_ms; }
 
+bool BNO055::HasPendingCalibration() const {
+  return initialized_ && !offsets_stored_ && cal_acc_ == kFullCalibration &&
+         cal_gyr_ == kFullCalibration;
+}
+
+bool BNO055::StoreCalibration() {
+  if (!HasPendingCalibration()) {
+    return false;
+  }
+  // getSensorOffsets() switches to CONFIG mode and back to the last operation mode
+  if (!device_->getSensorOffsets(offsets_)) {
+    return false;
+  }
+  offsets_valid_ = true;
+  offsets_stored_ = SaveOffsetsToStorage();
+#ifdef SENSINT_DEBUG
+  debug::Log("BNO055::StoreCalibration",
+             offsets_stored_ ? "calibration offsets stored" : "failed to store offsets");
+#endif  // SENSINT_DEBUG
+  return offsets_stored_;
+}
+
+uint32_t BNO055::GetTimeToCalibrationMs() const { return time_to_calibration_ms_; }
+
+bool BNO055::IsCalibrationRestored() const { return offsets_restored_; }
+
+void BNO055::UpdateCalibrationTiming() {
+  if (time_to_calibration_ms_ != 0 ||
+      (cal_sys_ + cal_gyr_ + cal_acc_ + cal_mag_) < kCalibrationThreshold) {
+    return;
+  }
+  // a calibration within the first millisecond is reported as 1ms to keep 0 as "not calibrated"
+  uint32_t elapsed_ms = millis() - init_time_ms_;
+  time_to_calibration_ms_ = (elapsed_ms > 0) ? elapsed_ms : 1;
+#ifdef SENSINT_DEBUG
+  debug::Log("BNO055::UpdateData", "calibrated after " + String(time_to_calibration_ms_) + "ms (" +
+                                       (offsets_restored_ ? "restored" : "cold") + ")");
+#endif  // SENSINT_DEBUG
+}
+
+bool BNO055::LoadOffsetsFromStorage() {
+#ifdef ESP32
+  Preferences storage;
+  if (!storage.begin(kStorageNamespace, true)) {
+    return false;
+  }
+  String key = String(kStorageKeyPrefix) + String(id_);
+  if (storage.getBytesLength(key.c_str()) == sizeof(adafruit_bno055_offsets_t)) {
+    offsets_valid_ = storage.getBytes(key.c_str(), &offsets_, sizeof(adafruit_bno055_offsets_t)) ==
+                     sizeof(adafruit_bno055_offsets_t);
+  }
+  storage.end();
+  return offsets_valid_;
+#else
+  return false;
+#endif  // ESP32
+}
+
+bool BNO055::SaveOffsetsToStorage() {
+#ifdef ESP32
+  Preferences storage;
+  if (!storage.begin(kStorageNamespace, false)) {
+    return false;
+  }
+  String key = String(kStorageKeyPrefix) + String(id_);
+  auto written = storage.putBytes(key.c_str(), &offsets_, sizeof(adafruit_bno055_offsets_t));
+  storage.end();
+  return written == sizeof(adafruit_bno055_offsets_t);
+#else
+  return false;
+#endif  // ESP32
+}
+
 void BNO055::ConvertEventToVector(const sensors_vec_t &event, Vector3D<float> &vector) {
   vector.x = event.x;
   vector.y = event.y;
@@ -2,6 +2,9 @@
 #define __SENSINT_BNO055_H__
 
 #include <Adafruit_BNO055.h>
+#ifdef ESP32
+#include <Preferences.h>
+#endif  // ESP32
 #include <types.h>
 
 #include "imu.h"
@@ -40,6 +43,16 @@ class BNO055 : public IMU {
    */
   virtual bool Init() override;
 
+  /**
+   * @brief Reset the relative orientation of an already initialized IMU. In contrast to creating a
+   * new object this neither reallocates the device nor runs the full begin() sequence. The IMU is
+   * put into CONFIG mode, the last known calibration offsets are written (if any) and the fusion is
+   * restarted in IMUPLUS mode, which sets the current orientation as the new zero-rotation.
+   *
+   * @return True if the IMU is initialized and running afterwards.
+   */
+  bool Reinitialize();
+
   /**
    * @brief Acquire new data from the IMU. This just updates all internal data members. To get the
    * actual data, use the GetData() function.
@@ -80,6 +93,42 @@ class BNO055 : public IMU {
    */
   uint32_t GetCalibration();
 
+  /**
+   * @brief Check if the IMU reached a full calibration since the last (re-)initialization but the
+   * offsets have not been stored yet. Reading the offsets requires a switch to CONFIG mode, which
+   * resets the relative orientation. Hence, the caller decides when it is safe to store them, e.g.
+   * when no recording is running.
+   *
+   * @return bool
+   */
+  bool HasPendingCalibration() const;
+
+  /**
+   * @brief Read the calibration offsets from the IMU and store them in the non-volatile storage
+   * (NVS) of the ESP32. The stored offsets are restored on the next Init() or Reinitialize().
+   *
+   * //! This resets the relative orientation of the IMU.
+   *
+   * @return True if the offsets were read and stored successfully.
+   */
+  bool StoreCalibration();
+
+  /**
+   * @brief Get the time it took from the last (re-)initialization until the IMU reported the first
+   * calibrated sample.
+   *
+   * @return uint32_t Time in milliseconds or 0 if the IMU is not calibrated yet.
+   */
+  uint32_t GetTimeToCalibrationMs() const;
+
+  /**
+   * @brief Check if the calibration offsets were restored from the non-volatile storage during the
+   * last (re-)initialization.
+   *
+   * @return bool
+   */
+  bool IsCalibrationRestored() const;
+
  private:
   uint8_t address_;
   Adafruit_BNO055 *device_;
@@ -87,7 +136,20 @@ class BNO055 : public IMU {
   // 0 if not calibrated and 3 if fully calibrated (see section 34.3.54)
   // If all 4 parameters are 2 we can assume the sensor is calibrated.
   static constexpr uint8_t kCalibrationThreshold = 4 * 2;
-  uint8_t cal_sys_, cal_gyr_, cal_acc_, cal_mag_ = 0;
+  uint8_t cal_sys_ = 0, cal_gyr_ = 0, cal_acc_ = 0, cal_mag_ = 0;
+  // the BNO055 needs 19ms to switch from CONFIG mode to any operation mode (see table 3-6)
+  static constexpr uint32_t kModeSwitchDelayMs = 25;
+  // the offsets can only be read if accelerometer and gyroscope are fully calibrated
+  static constexpr uint8_t kFullCalibration = 3;
+  adafruit_bno055_offsets_t offsets_;
+  bool offsets_valid_ = false;
+  bool offsets_restored_ = false;
+  bool offsets_stored_ = false;
+  uint32_t init_time_ms_ = 0;
+  uint32_t time_to_calibration_ms_ = 0;
+  bool LoadOffsetsFromStorage();
+  bool SaveOffsetsToStorage();
+  void UpdateCalibrationTiming();
   sensors_event_t orientation_data_, linear_accel_data_;
   //   sensors_event_t ang_velocity_data_, magnetometer_data_, accelerometer_data_, gravity_data_;
   void ConvertEventToVector(const sensors_vec_t &event, Vector3D<float> &vector);
@@ -0,0 +1,135 @@
+#include "bno055_raw.h"
+
+#include <Wire.h>
+
+#include "debug.h"
+
+namespace sensint {
+namespace sensor {
+// namespace imu {
+
+BNO055Raw::BNO055Raw() : BNO055Raw(kDefaultId) {}
+
+BNO055Raw::BNO055Raw(const uint8_t id, const uint8_t address, const uint16_t sample_rate_hz)
+    : IMU(id), address_(address), device_(id, address), filter_(kConvergenceBeta) {
+  SetSampleRate(sample_rate_hz);
+}
+
+bool BNO055Raw::Init() {
+  if (initialized_) {
+    return true;
+  }
+  // The ACCGYRO mode provides the raw accelerometer and gyroscope data. In contrast to the fusion
+  // modes, the sensor configuration (range, bandwidth) is not overwritten by the BNO055.
+  initialized_ = device_.begin(adafruit_bno055_opmode_t::OPERATION_MODE_ACCGYRO);
+  if (!initialized_) {
+    return false;
+  }
+  if (!ConfigureSensors()) {
+#ifdef SENSINT_DEBUG
+    debug::Log("BNO055Raw::Init", "failed to configure the sensors, using default configuration");
+#endif  // SENSINT_DEBUG
+  }
+  return Reinitialize();
+}
+
+bool BNO055Raw::Reinitialize() {
+  if (!initialized_) {
+    return Init();
+  }
+  filter_.Reset();
+  filter_.SetBeta(kConvergenceBeta);
+  converged_ = false;
+  init_time_ms_ = millis();
+  last_sample_us_ = micros();
+  return true;
+}
+
+bool BNO055Raw::Poll() {
+  if (!initialized_) {
+    return false;
+  }
+  const uint32_t now_us = micros();
+  const uint32_t elapsed_us = now_us - last_sample_us_;
+  if (elapsed_us < sample_period_us_) {
+    return false;
+  }
+  last_sample_us_ = now_us;
+  if (!converged_ && (millis() - init_time_ms_) >= kConvergenceTimeMs) {
+    filter_.SetBeta(MadgwickFilter::kDefaultBeta);
+    converged_ = true;
+  }
+  imu::Vector<3> gyro_dps = device_.getVector(Adafruit_BNO055::VECTOR_GYROSCOPE);
+  imu::Vector<3> accel_ms2 = device_.getVector(Adafruit_BNO055::VECTOR_ACCELEROMETER);
+  const Vector3D<float> gyro = {.x = (float)gyro_dps.x() * kDegToRad,
+                                .y = (float)gyro_dps.y() * kDegToRad,
+                                .z = (float)gyro_dps.z() * kDegToRad};
+  accel_.x = (float)accel_ms2.x();
+  accel_.y = (float)accel_ms2.y();
+  accel_.z = (float)accel_ms2.z();
+  filter_.Update(gyro, accel_, elapsed_us * 1e-6f);
+  return true;
+}
+
+void BNO055Raw::UpdateData(const uint8_t data_types) {
+  if (!initialized_) {
+    return;
+  }
+  data_.calibration = GetCalibration();
+  data_.time_offset = time_offset_;
+  if (data_types & static_cast<uint8_t>(ImuDataType::kOrientation)) {
+    data_.orientation_quaternion = filter_.GetQuaternion();
+  }
+  if (data_types & static_cast<uint8_t>(ImuDataType::kAccelerationLin)) {
+    // remove the gravity from the latest raw acceleration
+    const Vector3D<float> gravity = filter_.GetGravityDirection();
+    data_.acceleration_linear.x = accel_.x - gravity.x * kGravity;
+    data_.acceleration_linear.y = accel_.y - gravity.y * kGravity;
+    data_.acceleration_linear.z = accel_.z - gravity.z * kGravity;
+  }
+}
+
+ImuData BNO055Raw::GetData() const { return data_; }
+
+bool BNO055Raw::IsCalibrated() const { return initialized_ && converged_; }
+
+void BNO055Raw::SetTimeOffset(const uint32_t offset_ms) { time_offset_ = offset_ms; }
+
+void BNO055Raw::SetSampleRate(const uint16_t sample_rate_hz) {
+  sample_period_us_ = (sample_rate_hz > 0) ? (1000000UL / sample_rate_hz) : 0;
+}
+
+uint32_t BNO055Raw::GetCalibration() {
+  if (!initialized_) {
+    return 0;
+  }
+  uint8_t cal_sys, cal_mag;
+  device_.getCalibration(&cal_sys, &cal_gyr_, &cal_acc_, &cal_mag);
+  cal_sys = converged_ ? 3 : 0;
+  return ((cal_acc_ & 0xF) << 4) | ((cal_gyr_ & 0xF) << 8) | ((cal_sys & 0xF) << 12);
+}
+
+bool BNO055Raw::ConfigureSensors() {
+  // the sensor configuration registers (page 1) can only be written in CONFIG mode
+  device_.setMode(adafruit_bno055_opmode_t::OPERATION_MODE_CONFIG);
+  delay(kModeSwitchDelayMs);
+  bool success = WriteRegister(kRegisterPageId, 1) && WriteRegister(kRegisterAccConfig, kAccConfig) &&
+                 WriteRegister(kRegisterGyrConfig0, kGyrConfig0) &&
+                 WriteRegister(kRegisterGyrConfig1, kGyrConfig1);
+  success = WriteRegister(kRegisterPageId, 0) && success;
+  device_.setMode(adafruit_bno055_opmode_t::OPERATION_MODE_ACCGYRO);
+  delay(kModeSwitchDelayMs);
+  return success;
+}
+
+bool BNO055Raw::WriteRegister(const uint8_t reg, const uint8_t value) {
+  // Adafruit_BNO055 uses the default Wire instance
+  Wire.beginTransmission(address_);
+  Wire.write(reg);
+  Wire.write(value);
+  return Wire.endTransmission() == 0;
+}
+
+// }  // namespace imu
+}  // namespace sensor
+}  // namespace sensint
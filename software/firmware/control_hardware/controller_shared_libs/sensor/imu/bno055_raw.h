@@ -0,0 +1,151 @@
+#ifndef __SENSINT_BNO055_RAW_H__
+#define __SENSINT_BNO055_RAW_H__
+
+#include <Adafruit_BNO055.h>
+#include <types.h>
+
+#include "imu.h"
+#include "madgwick_filter.h"
+
+namespace sensint {
+namespace sensor {
+// namespace imu {
+
+/**
+ * @brief Alternative BNO055 implementation that bypasses the on-chip sensor fusion. The IMU runs in
+ * the raw accelerometer/gyroscope mode (OPERATION_MODE_ACCGYRO) and the orientation is computed on
+ * the controller by a Madgwick filter. In contrast to the IMUPLUS mode, which is limited to the
+ * 100Hz fusion rate of the BNO055, the filter can be updated at a higher rate by calling Poll()
+ * regularly. The output uses the same ImuData format as the BNO055 class.
+ *
+ * All members have a fixed size and the class does not allocate memory.
+ */
+class BNO055Raw : public IMU {
+ public:
+  // !connect the ADR-pin to VCC to enforce the address 0x29
+  static constexpr uint8_t kDefaultAddress = 0x29;
+  static constexpr uint16_t kDefaultSampleRateHz = 400;
+  // the filter converges faster with a high gain, which is used for a short time after (re-)init
+  static constexpr float kConvergenceBeta = 2.5f;
+  static constexpr uint32_t kConvergenceTimeMs = 2000;
+
+  /**
+   * @brief Default constructor to construct a new BNO055Raw object.
+   */
+  BNO055Raw();
+
+  /**
+   * @brief Construct a new BNO055Raw object.
+   *
+   * @param id The number of the multiplexer port, where this IMU is connected to.
+   * @param address The I2C address of the IMU.
+   * @param sample_rate_hz The rate of the raw data acquisition and filter updates.
+   */
+  BNO055Raw(const uint8_t id, const uint8_t address = kDefaultAddress,
+            const uint16_t sample_rate_hz = kDefaultSampleRateHz);
+
+  /**
+   * @brief Initialize the IMU.
+   *
+   * @return True if initialization was successful.
+   */
+  virtual bool Init() override;
+
+  /**
+   * @brief Reset the orientation estimate. The current orientation becomes the new zero-rotation
+   * once the filter converged.
+   *
+   * @return True if the IMU is initialized.
+   */
+  bool Reinitialize();
+
+  /**
+   * @brief Read the raw sensor channels and update the orientation filter if the sample period
+   * elapsed. This should be called as often as possible, e.g. in every iteration of the loop.
+   *
+   * @return True if a new sample was integrated.
+   */
+  bool Poll();
+
+  /**
+   * @brief Copy the latest filter output into the internal data members. To get the actual data,
+   * use the GetData() function.
+   *
+   * @param data_types Define the type of data that should be updated. The default is to update all
+   * data members.
+   */
+  virtual void UpdateData(
+      const uint8_t data_types = static_cast<uint8_t>(ImuDataType::kAll)) override;
+
+  /**
+   * @brief Get the data object.
+   * @return ImuData
+   */
+  virtual ImuData GetData() const override;
+
+  /**
+   * @brief Check if the orientation filter converged. The on-chip calibration status is not
+   * meaningful without the on-chip fusion.
+   *
+   * @return bool
+   */
+  virtual bool IsCalibrated() const override;
+
+  /**
+   * @brief Set the time offset for this IMU. This might be the time difference from another action,
+   * e.g. the IMU that was retrieved before this one.
+   *
+   * @param offset_ms Time offset in milliseconds.
+   */
+  virtual void SetTimeOffset(const uint32_t offset_ms) override;
+
+  /**
+   * @brief Set the rate of the raw data acquisition and filter updates.
+   *
+   * @param sample_rate_hz The sample rate in Hz.
+   */
+  void SetSampleRate(const uint16_t sample_rate_hz);
+
+  /**
+   * @brief Get the combined calibration information in the same format as the BNO055 class. The
+   * sys value reflects the convergence of the orientation filter.
+   *
+   * @return uint32_t Combined calibration of the IMU.
+   */
+  uint32_t GetCalibration();
+
+ private:
+  // standard gravity in m/s^2
+  static constexpr float kGravity = 9.80665f;
+  static constexpr float kDegToRad = 0.01745329252f;
+  // register map (see section 4.2 and 4.3 of the datasheet)
+  static constexpr uint8_t kRegisterPageId = 0x07;
+  static constexpr uint8_t kRegisterAccConfig = 0x08;    // page 1
+  static constexpr uint8_t kRegisterGyrConfig0 = 0x0A;   // page 1
+  static constexpr uint8_t kRegisterGyrConfig1 = 0x0B;   // page 1
+  // accelerometer: 8G range, 250Hz bandwidth, normal power mode
+  static constexpr uint8_t kAccConfig = 0b00010110;
+  // gyroscope: 2000dps range, 230Hz bandwidth, normal power mode
+  static constexpr uint8_t kGyrConfig0 = 0b00001000;
+  static constexpr uint8_t kGyrConfig1 = 0b00000000;
+  static constexpr uint32_t kModeSwitchDelayMs = 25;
+
+  uint8_t address_;
+  Adafruit_BNO055 device_;
+  MadgwickFilter filter_;
+  uint32_t sample_period_us_;
+  uint32_t last_sample_us_ = 0;
+  uint32_t init_time_ms_ = 0;
+  bool converged_ = false;
+  Vector3D<float> accel_ = {.x = 0.0f, .y = 0.0f, .z = 0.0f};
+  uint8_t cal_gyr_ = 0, cal_acc_ = 0;
+
+  bool ConfigureSensors();
+  bool WriteRegister(const uint8_t reg, const uint8_t value);
+};
+
+// }  // namespace imu
+}  // namespace sensor
+}  // namespace sensint
+
+#endif  // __SENSINT_BNO055_RAW_H__
@@ -0,0 +1,105 @@
+#include "madgwick_filter.h"
+
+#include <math.h>
+
+namespace sensint {
+namespace sensor {
+// namespace imu {
+
+MadgwickFilter::MadgwickFilter(const float beta) : beta_(beta) { Reset(); }
+
+void MadgwickFilter::Reset() {
+  q0_ = 1.0f;
+  q1_ = 0.0f;
+  q2_ = 0.0f;
+  q3_ = 0.0f;
+}
+
+void MadgwickFilter::SetBeta(const float beta) { beta_ = beta; }
+
+void MadgwickFilter::Update(const Vector3D<float> &gyro, const Vector3D<float> &accel,
+                            const float dt_s) {
+  // rate of change of the quaternion from the gyroscope
+  float q_dot0 = 0.5f * (-q1_ * gyro.x - q2_ * gyro.y - q3_ * gyro.z);
+  float q_dot1 = 0.5f * (q0_ * gyro.x + q2_ * gyro.z - q3_ * gyro.y);
+  float q_dot2 = 0.5f * (q0_ * gyro.y - q1_ * gyro.z + q3_ * gyro.x);
+  float q_dot3 = 0.5f * (q0_ * gyro.z + q1_ * gyro.y - q2_ * gyro.x);
+
+  // the accelerometer correction is only applied if the measurement is valid (avoids NaN)
+  if (!((accel.x == 0.0f) && (accel.y == 0.0f) && (accel.z == 0.0f))) {
+    float recip_norm = InvSqrt(accel.x * accel.x + accel.y * accel.y + accel.z * accel.z);
+    const float ax = accel.x * recip_norm;
+    const float ay = accel.y * recip_norm;
+    const float az = accel.z * recip_norm;
+
+    // auxiliary variables to avoid repeated arithmetic
+    const float _2q0 = 2.0f * q0_;
+    const float _2q1 = 2.0f * q1_;
+    const float _2q2 = 2.0f * q2_;
+    const float _2q3 = 2.0f * q3_;
+    const float _4q0 = 4.0f * q0_;
+    const float _4q1 = 4.0f * q1_;
+    const float _4q2 = 4.0f * q2_;
+    const float _8q1 = 8.0f * q1_;
+    const float _8q2 = 8.0f * q2_;
+    const float q0q0 = q0_ * q0_;
+    const float q1q1 = q1_ * q1_;
+    const float q2q2 = q2_ * q2_;
+    const float q3q3 = q3_ * q3_;
+
+    // gradient descent step
+    float s0 = _4q0 * q2q2 + _2q2 * ax + _4q0 * q1q1 - _2q1 * ay;
+    float s1 = _4q1 * q3q3 - _2q3 * ax + 4.0f * q0q0 * q1_ - _2q0 * ay - _4q1 + _8q1 * q1q1 +
+               _8q1 * q2q2 + _4q1 * az;
+    float s2 = 4.0f * q0q0 * q2_ + _2q0 * ax + _4q2 * q3q3 - _2q3 * ay - _4q2 + _8q2 * q1q1 +
+               _8q2 * q2q2 + _4q2 * az;
+    float s3 = 4.0f * q1q1 * q3_ - _2q1 * ax + 4.0f * q2q2 * q3_ - _2q2 * ay;
+    const float step_norm = s0 * s0 + s1 * s1 + s2 * s2 + s3 * s3;
+    if (step_norm > 0.0f) {
+      recip_norm = InvSqrt(step_norm);
+      s0 *= recip_norm;
+      s1 *= recip_norm;
+      s2 *= recip_norm;
+      s3 *= recip_norm;
+
+      q_dot0 -= beta_ * s0;
+      q_dot1 -= beta_ * s1;
+      q_dot2 -= beta_ * s2;
+      q_dot3 -= beta_ * s3;
+    }
+  }
+
+  // integrate and normalize the quaternion
+  q0_ += q_dot0 * dt_s;
+  q1_ += q_dot1 * dt_s;
+  q2_ += q_dot2 * dt_s;
+  q3_ += q_dot3 * dt_s;
+  const float recip_norm = InvSqrt(q0_ * q0_ + q1_ * q1_ + q2_ * q2_ + q3_ * q3_);
+  q0_ *= recip_norm;
+  q1_ *= recip_norm;
+  q2_ *= recip_norm;
+  q3_ *= recip_norm;
+}
+
+Vector4D<float> MadgwickFilter::GetQuaternion() const {
+  Vector4D<float> quaternion;
+  quaternion.w = q0_;
+  quaternion.x = q1_;
+  quaternion.y = q2_;
+  quaternion.z = q3_;
+  return quaternion;
+}
+
+Vector3D<float> MadgwickFilter::GetGravityDirection() const {
+  Vector3D<float> gravity;
+  gravity.x = 2.0f * (q1_ * q3_ - q0_ * q2_);
+  gravity.y = 2.0f * (q0_ * q1_ + q2_ * q3_);
+  gravity.z = q0_ * q0_ - q1_ * q1_ - q2_ * q2_ + q3_ * q3_;
+  return gravity;
+}
+
+float MadgwickFilter::InvSqrt(const float x) { return 1.0f / sqrtf(x); }
+
+// }  // namespace imu
+}  // namespace sensor
+}  // namespace sensint
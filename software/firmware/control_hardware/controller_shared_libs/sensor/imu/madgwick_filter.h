@@ -0,0 +1,78 @@
+#ifndef __SENSINT_MADGWICK_FILTER_H__
+#define __SENSINT_MADGWICK_FILTER_H__
+
+#include <types.h>
+
+namespace sensint {
+namespace sensor {
+// namespace imu {
+
+/**
+ * @brief Madgwick orientation filter for a 6-DOF IMU (accelerometer and gyroscope). The
+ * implementation only uses fixed-size members and does not allocate memory. It is independent of
+ * the hardware and can therefore be fed with live or recorded raw data.
+ *
+ * See S. Madgwick, "An efficient orientation filter for inertial and inertial/magnetic sensor
+ * arrays", 2010.
+ */
+class MadgwickFilter {
+ public:
+  // the filter gain proposed by Madgwick for a gyroscope error of ~2.7 deg/s
+  static constexpr float kDefaultBeta = 0.041f;
+
+  /**
+   * @brief Construct a new MadgwickFilter object with the identity orientation.
+   *
+   * @param beta The filter gain which weights the accelerometer correction against the gyroscope
+   * integration.
+   */
+  MadgwickFilter(const float beta = kDefaultBeta);
+
+  /**
+   * @brief Reset the orientation to the identity quaternion.
+   */
+  void Reset();
+
+  /**
+   * @brief Set the filter gain.
+   *
+   * @param beta The filter gain which weights the accelerometer correction against the gyroscope
+   * integration.
+   */
+  void SetBeta(const float beta);
+
+  /**
+   * @brief Integrate a new sample into the orientation estimate.
+   *
+   * @param gyro Angular velocity in rad/s.
+   * @param accel Acceleration in any unit (the vector gets normalized).
+   * @param dt_s Time since the last update in seconds.
+   */
+  void Update(const Vector3D<float> &gyro, const Vector3D<float> &accel, const float dt_s);
+
+  /**
+   * @brief Get the current orientation.
+   *
+   * @return Vector4D<float> The orientation quaternion (w, x, y, z).
+   */
+  Vector4D<float> GetQuaternion() const;
+
+  /**
+   * @brief Get the direction of the gravity in the sensor frame derived from the current
+   * orientation.
+   *
+   * @return Vector3D<float> Unit vector of the gravity.
+   */
+  Vector3D<float> GetGravityDirection() const;
+
+ private:
+  float beta_;
+  float q0_ = 1.0f, q1_ = 0.0f, q2_ = 0.0f, q3_ = 0.0f;
+  static float InvSqrt(const float x);
+};
+
+// }  // namespace imu
+}  // namespace sensor
+}  // namespace sensint
+
+#endif  // __SENSINT_MADGWICK_FILTER_H__
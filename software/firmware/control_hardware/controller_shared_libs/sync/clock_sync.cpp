@@ -0,0 +1,143 @@
+#include "clock_sync.h"
+
+#include <cmath>
+
+namespace sensint {
+namespace sync {
+
+ClockSync::ClockSync() {}
+
+ClockSync::~ClockSync() {}
+
+bool ClockSync::AddExchange(const ClockSyncExchange &exchange) {
+  // the round trip without the processing time of the reference
+  const int64_t round_trip = static_cast<int32_t>(exchange.t4 - exchange.t1);
+  const int64_t processing = static_cast<int32_t>(exchange.t3 - exchange.t2);
+  const uint32_t delay_us =
+      (round_trip > processing) ? static_cast<uint32_t>(round_trip - processing) : 0;
+  const int64_t offset_request = static_cast<int32_t>(exchange.t2 - exchange.t1);
+  const int64_t offset_response = static_cast<int32_t>(exchange.t3 - exchange.t4);
+  const int32_t offset_us = static_cast<int32_t>((offset_request + offset_response) / 2);
+  const uint32_t local_us = exchange.t1 + static_cast<uint32_t>(round_trip / 2);
+  const uint32_t min_delay_us = AddDelay(delay_us);
+
+  if (count_ >= kMinExchanges) {
+    if (delay_us > 2 * min_delay_us + kDelayToleranceUs) {
+      rejected_++;
+      return false;
+    }
+    // the prediction error of the previous model is the residual of the synchronization
+    const double error =
+        static_cast<int32_t>(offset_us - reference_offset_us_) - PredictOffset(local_us);
+    residual_us_ = static_cast<uint32_t>(fabs(error) + 0.5);
+  }
+
+  samples_[next_] = {.local_us = local_us, .offset_us = offset_us, .delay_us = delay_us};
+  next_ = (next_ + 1) % kWindowSize;
+  if (count_ < kWindowSize) {
+    count_++;
+  }
+  delay_us_ = delay_us;
+  reference_us_ = local_us;
+  reference_offset_us_ = offset_us;
+  UpdateModel();
+  return true;
+}
+
+void ClockSync::Reset() {
+  count_ = 0;
+  next_ = 0;
+  num_delays_ = 0;
+  next_delay_ = 0;
+  rejected_ = 0;
+  residual_us_ = 0;
+  delay_us_ = 0;
+  reference_us_ = 0;
+  reference_offset_us_ = 0;
+  intercept_ = 0.0;
+  slope_ = 0.0;
+}
+
+/**
+ * The minimum is taken over the last exchanges instead of the accepted ones, otherwise a minimum
+ * from before a persistent increase of the delay would never age out.
+ */
+uint32_t ClockSync::AddDelay(const uint32_t delay_us) {
+  delays_us_[next_delay_] = delay_us;
+  next_delay_ = (next_delay_ + 1) % kWindowSize;
+  if (num_delays_ < kWindowSize) {
+    num_delays_++;
+  }
+  uint32_t min_delay_us = UINT32_MAX;
+  for (size_t i = 0; i < num_delays_; i++) {
+    min_delay_us = (delays_us_[i] < min_delay_us) ? delays_us_[i] : min_delay_us;
+  }
+  return min_delay_us;
+}
+
+/**
+ * Fit a line to the offsets of the window (weighted least squares). An exchange with a longer round
+ * trip has a less certain offset, hence it gets a lower weight. The values are relative to the
+ * newest exchange to keep the precision of the floating point calculation.
+ */
+void ClockSync::UpdateModel() {
+  if (count_ < kMinExchanges) {
+    intercept_ = 0.0;
+    slope_ = 0.0;
+    return;
+  }
+  uint32_t min_delay_us = UINT32_MAX;
+  for (size_t i = 0; i < count_; i++) {
+    min_delay_us = (samples_[i].delay_us < min_delay_us) ? samples_[i].delay_us : min_delay_us;
+  }
+  double weights[kWindowSize];
+  double sum_weights = 0.0, mean_x = 0.0, mean_y = 0.0;
+  for (size_t i = 0; i < count_; i++) {
+    const double excess = (samples_[i].delay_us - min_delay_us) / double(kDelayToleranceUs);
+    weights[i] = 1.0 / (1.0 + excess * excess);
+    sum_weights += weights[i];
+    mean_x += weights[i] * static_cast<int32_t>(samples_[i].local_us - reference_us_);
+    mean_y += weights[i] * static_cast<int32_t>(samples_[i].offset_us - reference_offset_us_);
+  }
+  mean_x /= sum_weights;
+  mean_y /= sum_weights;
+  double covariance = 0.0, variance = 0.0;
+  for (size_t i = 0; i < count_; i++) {
+    const double dx = static_cast<int32_t>(samples_[i].local_us - reference_us_) - mean_x;
+    const double dy = static_cast<int32_t>(samples_[i].offset_us - reference_offset_us_) - mean_y;
+    covariance += weights[i] * dx * dy;
+    variance += weights[i] * dx * dx;
+  }
+  slope_ = (variance > 0.0) ? covariance / variance : 0.0;
+  intercept_ = mean_y - slope_ * mean_x;
+}
+
+double ClockSync::PredictOffset(const uint32_t local_us) const {
+  return intercept_ + slope_ * static_cast<int32_t>(local_us - reference_us_);
+}
+
+uint32_t ClockSync::ToReferenceTime(const uint32_t local_us) const {
+  if (count_ == 0) {
+    return local_us;
+  }
+  const int32_t offset_us =
+      reference_offset_us_ + static_cast<int32_t>(lround(PredictOffset(local_us)));
+  return local_us + static_cast<uint32_t>(offset_us);
+}
+
+bool ClockSync::IsSynchronized() const { return count_ >= kMinExchanges; }
+
+int32_t ClockSync::GetOffset() const {
+  return reference_offset_us_ + static_cast<int32_t>(lround(intercept_));
+}
+
+int32_t ClockSync::GetDriftPpb() const { return static_cast<int32_t>(lround(slope_ * 1e9)); }
+
+uint32_t ClockSync::GetResidual() const { return residual_us_; }
+
+uint32_t ClockSync::GetDelay() const { return delay_us_; }
+
+uint32_t ClockSync::GetRejected() const { return rejected_; }
+
+}  // namespace sync
+}  // namespace sensint
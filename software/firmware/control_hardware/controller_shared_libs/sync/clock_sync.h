@@ -0,0 +1,127 @@
+#ifndef __SENSINT_CLOCK_SYNC_H__
+#define __SENSINT_CLOCK_SYNC_H__
+
+#include <cstddef>
+#include <cstdint>
+
+namespace sensint {
+namespace sync {
+
+/**
+ * @brief The packet that is exchanged via the timestamp characteristic of a shoe. The shoe writes
+ * the request (sequence, t1 and its current estimate) and the server answers with a notification
+ * of the same packet including t2 and t3.
+ *
+ *   shoe    t1 ----------------> t2    server
+ *           t4 <---------------- t3
+ *
+ * All timestamps are given in microseconds of the corresponding clock.
+ */
+struct __attribute__((__packed__)) ClockSyncPacket {
+  uint16_t sequence;
+  uint32_t t1;
+  uint32_t t2;
+  uint32_t t3;
+  // the current estimate of the shoe, which is reported to the PC by the server
+  uint8_t synchronized;
+  int32_t offset_us;
+  int32_t drift_ppb;
+  uint32_t residual_us;
+  uint32_t delay_us;
+};
+
+/**
+ * @brief The four timestamps of a single request/response exchange.
+ */
+struct ClockSyncExchange {
+  uint32_t t1;
+  uint32_t t2;
+  uint32_t t3;
+  uint32_t t4;
+};
+
+/**
+ * @brief Estimates the offset and the drift of the local clock relative to a reference clock
+ * (NTP-style). The offset is modeled as a linear function of the local time, which is fitted to the
+ * last kWindowSize exchanges. Exchanges with a much longer round trip than the fastest of the last
+ * kWindowSize exchanges are rejected, because their offset is dominated by the asymmetric delay.
+ * The rejected exchanges count for the fastest one as well, hence a persistent increase of the
+ * delay (e.g. a longer connection interval) is accepted after at most kWindowSize exchanges. The
+ * remaining exchanges are weighted by their round trip.
+ *
+ * //! The timestamps are 32 bit microseconds, i.e. they wrap around every ~71 minutes. The
+ * //! differences are calculated modulo 2^32, hence the model is valid across the wrap around.
+ */
+class ClockSync {
+ public:
+  static constexpr size_t kWindowSize = 16;
+  // the number of exchanges that are required for an offset and drift estimate
+  static constexpr size_t kMinExchanges = 3;
+  static constexpr uint32_t kDelayToleranceUs = 1000;
+
+  ClockSync();
+  ~ClockSync();
+
+  /**
+   * @brief Add an exchange and update the estimate.
+   *
+   * @param exchange The timestamps of the exchange.
+   * @return False if the exchange was rejected.
+   */
+  bool AddExchange(const ClockSyncExchange &exchange);
+
+  /**
+   * @brief Discard all exchanges and the rejected count, e.g. after a reconnect as the reference
+   * might have restarted.
+   */
+  void Reset();
+
+  /**
+   * @brief Convert a local timestamp to the reference clock. The local timestamp is returned as is,
+   * while the clock is not synchronized.
+   *
+   * @param local_us The local timestamp in microseconds.
+   * @return uint32_t The timestamp of the reference clock in microseconds.
+   */
+  uint32_t ToReferenceTime(const uint32_t local_us) const;
+
+  bool IsSynchronized() const;
+  int32_t GetOffset() const;
+  int32_t GetDriftPpb() const;
+  // the difference between the measured and the predicted offset of the last exchange
+  uint32_t GetResidual() const;
+  uint32_t GetDelay() const;
+  uint32_t GetRejected() const;
+
+ private:
+  struct Sample {
+    uint32_t local_us;
+    int32_t offset_us;
+    uint32_t delay_us;
+  };
+
+  uint32_t AddDelay(const uint32_t delay_us);
+  void UpdateModel();
+  double PredictOffset(const uint32_t local_us) const;
+
+  Sample samples_[kWindowSize];
+  size_t count_ = 0;
+  size_t next_ = 0;
+  // the delays of the last exchanges, including the rejected ones
+  uint32_t delays_us_[kWindowSize];
+  size_t num_delays_ = 0;
+  size_t next_delay_ = 0;
+  uint32_t rejected_ = 0;
+  uint32_t residual_us_ = 0;
+  uint32_t delay_us_ = 0;
+  // offset(t) = reference_offset_us_ + intercept_ + slope_ * (t - reference_us_)
+  uint32_t reference_us_ = 0;
+  int32_t reference_offset_us_ = 0;
+  double intercept_ = 0.0;
+  double slope_ = 0.0;
+};
+
+}  // namespace sync
+}  // namespace sensint
+
+#endif  // __SENSINT_CLOCK_SYNC_H__
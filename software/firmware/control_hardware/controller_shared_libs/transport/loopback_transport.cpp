@@ -0,0 +1,91 @@
+#include "loopback_transport.h"
+
+#include <cstring>
+
+namespace sensint {
+namespace transport {
+
+LoopbackTransport::LoopbackTransport(StreamReceiver &receiver, const LoopbackConfig &config)
+    : receiver_(receiver), config_(config), random_state_(config.seed ? config.seed : 1) {}
+
+LoopbackTransport::~LoopbackTransport() {}
+
+void LoopbackTransport::Connect() { connected_ = true; }
+
+void LoopbackTransport::Disconnect() {
+  connected_ = false;
+  statistics_.discarded_packets += count_;
+  head_ = 0;
+  count_ = 0;
+}
+
+size_t LoopbackTransport::Poll(const uint32_t now_us) {
+  now_us_ = now_us;
+  size_t delivered = 0;
+  while (count_ > 0) {
+    auto &in_flight = in_flight_[head_];
+    // the times are compared modulo 2^32
+    if (static_cast<int32_t>(now_us_ - in_flight.delivery_us) < 0) {
+      break;
+    }
+    receiver_.Receive(in_flight.packet.data, in_flight.packet.length);
+    head_ = (head_ + 1) % kMaxPacketsInFlight;
+    count_--;
+    delivered++;
+  }
+  statistics_.delivered_packets += delivered;
+  return delivered;
+}
+
+bool LoopbackTransport::IsConnected() const { return connected_; }
+
+size_t LoopbackTransport::GetPacketSize() const {
+  return config_.mtu - ble::stream::kAttHeaderSize;
+}
+
+bool LoopbackTransport::Send(const uint8_t *data, const size_t length) {
+  if (!connected_ || length > ble::stream::kMaxPacketSize) {
+    return false;
+  }
+  if (count_ >= kMaxPacketsInFlight) {
+    statistics_.rejected_packets++;
+    return false;
+  }
+  statistics_.sent_packets++;
+  // the random number is drawn for every packet, so that the losses only depend on the seed
+  if (NextRandom() % 1000000 < config_.loss_ppm) {
+    statistics_.lost_packets++;
+    return true;
+  }
+  uint32_t delivery_us = now_us_ + config_.latency_us;
+  if (config_.jitter_us > 0) {
+    delivery_us += NextRandom() % (config_.jitter_us + 1);
+  }
+  if (count_ > 0 && static_cast<int32_t>(delivery_us - last_delivery_us_) < 0) {
+    delivery_us = last_delivery_us_;
+  }
+  last_delivery_us_ = delivery_us;
+  auto &in_flight = in_flight_[(head_ + count_) % kMaxPacketsInFlight];
+  in_flight.delivery_us = delivery_us;
+  in_flight.packet.length = length;
+  memcpy(in_flight.packet.data, data, length);
+  count_++;
+  return true;
+}
+
+uint32_t LoopbackTransport::ReadNextSample() { return receiver_.GetNextSample(); }
+
+const LoopbackStatistics &LoopbackTransport::GetStatistics() const { return statistics_; }
+
+/**
+ * xorshift32, which is sufficient to model the losses and is the same on every platform.
+ */
+uint32_t LoopbackTransport::NextRandom() {
+  random_state_ ^= random_state_ << 13;
+  random_state_ ^= random_state_ >> 17;
+  random_state_ ^= random_state_ << 5;
+  return random_state_;
+}
+
+}  // namespace transport
+}  // namespace sensint
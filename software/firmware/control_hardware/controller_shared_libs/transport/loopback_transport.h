@@ -0,0 +1,106 @@
+#ifndef __SENSINT_LOOPBACK_TRANSPORT_H__
+#define __SENSINT_LOOPBACK_TRANSPORT_H__
+
+#include <cstddef>
+#include <cstdint>
+
+#include "stream_transport.h"
+
+namespace sensint {
+namespace transport {
+
+/**
+ * @brief The properties of the simulated link.
+ */
+struct LoopbackConfig {
+  // the negotiated MTU, the packet size is MTU - ATT header
+  uint16_t mtu = 247;
+  // the time from sending a packet until it is received by the central
+  uint32_t latency_us = 7500;
+  // an additional random delay (0..jitter_us), the packets are still received in order
+  uint32_t jitter_us = 0;
+  // the probability that a packet is lost on the air, in parts per million
+  uint32_t loss_ppm = 0;
+  // the seed of the random generator, the same seed results in the same losses and delays
+  uint32_t seed = 1;
+};
+
+/**
+ * @brief Counters of a loopback link.
+ */
+struct LoopbackStatistics {
+  uint32_t sent_packets = 0;
+  uint32_t lost_packets = 0;
+  uint32_t delivered_packets = 0;
+  // packets that were not sent, because too many packets were in flight
+  uint32_t rejected_packets = 0;
+  // packets that were in flight while the link was disconnected
+  uint32_t discarded_packets = 0;
+};
+
+/**
+ * @brief An in-process stand-in for the BLE link of a single shoe. The packets of the shoe are
+ * delivered to the receiver of the central after the configured latency, and are lost with the
+ * configured probability. A central and several shoes run together in a single process by creating
+ * one loopback per shoe.
+ *
+ * The loopback has no clock of its own. The time is advanced with @ref Poll, which also delivers
+ * the packets that are due, hence a simulation can run faster than real time.
+ *
+ * //! Send and Poll have to be called from the same thread.
+ */
+class LoopbackTransport : public StreamTransport {
+ public:
+  // the number of packets in flight, more packets are rejected as if the link was congested
+  static constexpr size_t kMaxPacketsInFlight = 32;
+
+  LoopbackTransport(StreamReceiver &receiver, const LoopbackConfig &config = LoopbackConfig());
+  ~LoopbackTransport();
+
+  void Connect();
+
+  /**
+   * @brief Disconnect the link. The packets in flight are discarded.
+   */
+  void Disconnect();
+
+  /**
+   * @brief Advance the time of the link and deliver the packets that are due.
+   *
+   * @param now_us The current time in microseconds.
+   * @return The number of delivered packets.
+   */
+  size_t Poll(const uint32_t now_us);
+
+  bool IsConnected() const override;
+  size_t GetPacketSize() const override;
+  bool Send(const uint8_t *data, const size_t length) override;
+  uint32_t ReadNextSample() override;
+
+  const LoopbackStatistics &GetStatistics() const;
+
+ private:
+  struct PacketInFlight {
+    uint32_t delivery_us;
+    ble::stream::Packet packet;
+  };
+
+  uint32_t NextRandom();
+
+  StreamReceiver &receiver_;
+  LoopbackConfig config_;
+  LoopbackStatistics statistics_;
+  bool connected_ = false;
+  uint32_t now_us_ = 0;
+  uint32_t random_state_;
+  // the delivery time of the last packet, which keeps the packets in order despite the jitter
+  uint32_t last_delivery_us_ = 0;
+  PacketInFlight in_flight_[kMaxPacketsInFlight];
+  size_t head_ = 0;
+  size_t count_ = 0;
+};
+
+}  // namespace transport
+}  // namespace sensint
+
+#endif  // __SENSINT_LOOPBACK_TRANSPORT_H__
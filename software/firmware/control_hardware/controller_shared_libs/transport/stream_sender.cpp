@@ -0,0 +1,89 @@
+#include "stream_sender.h"
+
+namespace sensint {
+namespace transport {
+
+StreamSender::StreamSender(pipeline::SampleRing &sample_ring, StreamTransport &transport,
+                           const sync::ClockSync &clock_sync, const StreamSenderConfig &config)
+    : sample_ring_(sample_ring), transport_(transport), clock_sync_(clock_sync), config_(config) {}
+
+StreamSender::~StreamSender() {}
+
+void StreamSender::Resync() { resync_ = true; }
+
+void StreamSender::Step(const uint32_t now_ms) {
+  // the first packet after a connect is started when the clock is synchronized
+  if (resync_) {
+    resync_ = false;
+    Reset(ble::stream::kFlagResync);
+  }
+  size_t packets = 0;
+  pipeline::RecordedSample sample;
+  while (packets < config_.backfill_packets_per_step && sample_ring_.Peek(sample)) {
+    if (Add(sample, now_ms)) {
+      sample_ring_.Advance();
+      continue;
+    }
+    // a sample that does not even fit into an empty packet is skipped
+    if (writer_.IsEmpty()) {
+      sample_ring_.Advance();
+      continue;
+    }
+    // the packet is full or the index does not follow (dropped samples)
+    if (!Flush()) {
+      return;
+    }
+    packets++;
+  }
+  if (!writer_.IsEmpty() && now_ms - packet_start_ms_ >= config_.flush_interval_ms) {
+    Flush();
+  }
+}
+
+bool StreamSender::Flush() {
+  if (writer_.IsEmpty()) {
+    return true;
+  }
+  // the packet is kept until the link accepts it, i.e. a congested link delays the samples
+  if (!transport_.Send(writer_.GetData(), writer_.GetSize())) {
+    return false;
+  }
+  sequence_++;
+  Reset(0);
+  return true;
+}
+
+uint16_t StreamSender::GetSequence() const { return sequence_; }
+
+bool StreamSender::Add(const pipeline::RecordedSample &sample, const uint32_t now_ms) {
+  using namespace sensint::ble;
+  stream::SampleType type;
+  const void *payload;
+  if (sample.message.type == pipeline::MessageType::kImuData) {
+    type = stream::SampleType::kImu;
+    payload = &sample.message.payload.imu;
+  } else {
+    type = stream::SampleType::kPressure;
+    payload = &sample.message.payload.pressure;
+  }
+  if (writer_.IsEmpty()) {
+    packet_start_ms_ = now_ms;
+  }
+  const uint32_t timestamp_us = synchronized_
+                                    ? clock_sync_.ToReferenceTime(sample.message.timestamp_us)
+                                    : sample.message.timestamp_us;
+  return writer_.Add(sample.index, timestamp_us, type, payload);
+}
+
+void StreamSender::Reset(const uint8_t flags) {
+  using namespace sensint::ble;
+  const size_t packet_size = transport_.GetPacketSize();
+  const size_t capacity =
+      (packet_size < stream::kMinPacketSize) ? stream::kMinPacketSize : packet_size;
+  synchronized_ = clock_sync_.IsSynchronized();
+  writer_.Begin(sequence_, capacity,
+                synchronized_ ? (flags | stream::kFlagSynchronized) : flags);
+}
+
+}  // namespace transport
+}  // namespace sensint
@@ -0,0 +1,92 @@
+#ifndef __SENSINT_STREAM_SENDER_H__
+#define __SENSINT_STREAM_SENDER_H__
+
+#include <ble_stream.h>
+#include <clock_sync.h>
+#include <sample_ring.h>
+
+#include <cstddef>
+#include <cstdint>
+
+#include "stream_transport.h"
+
+namespace sensint {
+namespace transport {
+
+/**
+ * @brief The timing of the packets of a shoe.
+ */
+struct StreamSenderConfig {
+  // the maximum time a sample waits for further samples before the (partial) packet is sent
+  uint32_t flush_interval_ms = 20;
+  // the number of full packets that are sent per step while samples are pending (e.g. the backfill
+  // after a reconnect)
+  size_t backfill_packets_per_step = 4;
+};
+
+/**
+ * @brief Packs the recorded samples of a shoe into stream packets (see ble_stream.h) and sends them
+ * with the given transport. The samples are read from the sample ring in order. A sample is only
+ * advanced once it was added to a packet, hence the samples of a packet that was not sent are
+ * still available for a rewind.
+ *
+ * //! All methods have to be called from the transport task.
+ */
+class StreamSender {
+ public:
+  StreamSender(pipeline::SampleRing &sample_ring, StreamTransport &transport,
+               const sync::ClockSync &clock_sync,
+               const StreamSenderConfig &config = StreamSenderConfig());
+  ~StreamSender();
+
+  /**
+   * @brief Start the next packet as the first one after a connect, i.e. the receiver restarts the
+   * loss detection. The packet is started with the next Step.
+   */
+  void Resync();
+
+  /**
+   * @brief Send the pending samples. While samples are pending (e.g. after a reconnect or
+   * congestion), full packets are sent back to back. Otherwise, a partial packet is sent after the
+   * flush interval.
+   *
+   * @param now_ms The current time in milliseconds.
+   */
+  void Step(const uint32_t now_ms);
+
+  /**
+   * @brief Send the current packet without waiting for a response.
+   *
+   * @return False if the transport did not accept the packet, it is sent again with the next Step.
+   */
+  bool Flush();
+
+  uint16_t GetSequence() const;
+
+ private:
+  bool Add(const pipeline::RecordedSample &sample, const uint32_t now_ms);
+
+  /**
+   * @brief Discard the current packet and start a new one with the negotiated packet size. The
+   * samples of a packet are either all synchronized or none of them.
+   */
+  void Reset(const uint8_t flags);
+
+  pipeline::SampleRing &sample_ring_;
+  StreamTransport &transport_;
+  const sync::ClockSync &clock_sync_;
+  StreamSenderConfig config_;
+  ble::stream::PacketWriter writer_;
+  uint16_t sequence_ = 0;
+  // the timestamps of the current packet are converted to the clock of the server
+  bool synchronized_ = false;
+  // the next packet is the first one after a connect
+  bool resync_ = false;
+  // the time the first sample was added to the current packet
+  uint32_t packet_start_ms_ = 0;
+};
+
+}  // namespace transport
+}  // namespace sensint
+
+#endif  // __SENSINT_STREAM_SENDER_H__
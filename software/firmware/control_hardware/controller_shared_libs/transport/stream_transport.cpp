@@ -0,0 +1,34 @@
+#include "stream_transport.h"
+
+#include <cstring>
+
+namespace sensint {
+namespace transport {
+
+StreamReceiver::StreamReceiver() {}
+
+StreamReceiver::~StreamReceiver() {}
+
+bool StreamReceiver::Receive(const uint8_t *data, const size_t length) {
+  using namespace sensint::ble;
+  if (length < sizeof(stream::PacketHeader) || length > stream::kMaxPacketSize) {
+    return false;
+  }
+  stream::Packet packet;
+  packet.length = length;
+  memcpy(packet.data, data, length);
+  if (!packets_.Push(packet)) {
+    return false;
+  }
+  stream::PacketHeader header;
+  memcpy(&header, packet.data, sizeof(stream::PacketHeader));
+  if (header.num_samples > 0) {
+    next_sample_ = header.first_sample + header.num_samples;
+  }
+  return true;
+}
+
+uint32_t StreamReceiver::GetNextSample() const { return next_sample_; }
+
+}  // namespace transport
+}  // namespace sensint
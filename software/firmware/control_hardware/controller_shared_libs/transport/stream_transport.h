@@ -0,0 +1,79 @@
+#ifndef __SENSINT_STREAM_TRANSPORT_H__
+#define __SENSINT_STREAM_TRANSPORT_H__
+
+#include <ble_stream.h>
+#include <spsc_queue.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace sensint {
+namespace transport {
+
+/**
+ * @brief The link that a shoe uses to send its stream packets (see ble_stream.h) to the central.
+ * The firmware uses the BLE characteristic of the shoe group, the loopback (see
+ * loopback_transport.h) connects a shoe and a central within a single process.
+ */
+class StreamTransport {
+ public:
+  virtual ~StreamTransport() {}
+
+  virtual bool IsConnected() const = 0;
+
+  /**
+   * @brief Get the maximum size of a packet that is sent at once (negotiated MTU - ATT header).
+   */
+  virtual size_t GetPacketSize() const = 0;
+
+  /**
+   * @brief Send a packet without waiting for a response.
+   *
+   * @return False if the packet was not sent (e.g. not connected or the link is congested).
+   */
+  virtual bool Send(const uint8_t *data, const size_t length) = 0;
+
+  /**
+   * @brief Read the index of the next sample that is expected by the central (0: the central did
+   * not receive any sample yet). It is read after a connect to send the missing samples again.
+   */
+  virtual uint32_t ReadNextSample() = 0;
+};
+
+/**
+ * @brief The receiving end of the stream of a single shoe on the central. The packets are queued to
+ * be processed by the application.
+ *
+ * //! Receive and GetNextSample are called in the context of the BLE stack (or the loopback), the
+ * //! packets are popped by the application.
+ */
+class StreamReceiver {
+ public:
+  static constexpr size_t kQueueSize = 16;
+
+  StreamReceiver();
+  ~StreamReceiver();
+
+  /**
+   * @brief Queue a received packet.
+   *
+   * @return False if the packet is invalid or the queue is full (counted by the queue).
+   */
+  bool Receive(const uint8_t *data, const size_t length);
+
+  /**
+   * @brief Get the index of the sample that follows the last queued packet (0: no sample was
+   * received yet).
+   */
+  uint32_t GetNextSample() const;
+
+  pipeline::SpscQueue<ble::stream::Packet, kQueueSize> packets_;
+
+ private:
+  uint32_t next_sample_ = 0;
+};
+
+}  // namespace transport
+}  // namespace sensint
+
+#endif  // __SENSINT_STREAM_TRANSPORT_H__
@@ -5,8 +5,11 @@
 #include <BLEServer.h>
 #include <BLEUtils.h>
 
+#include <global_settings.h>
+
 #include "ble_callbacks.h"
 #include "ble_characteristic_description.h"
+#include "ble_config.h"
 
 namespace sensint {
 namespace ble {
@@ -33,40 +36,29 @@ class BleServer {
   BleConnectionCallback connection_cb_;
 
   /*******************************************************************************
-                                  left shoe group
+                                   shoe groups
    ******************************************************************************/
-  BLECharacteristic *left_shoe_connected_char_;
-  BleBooleanCallback left_shoe_connected_cb_;
-
-  BLECharacteristic *left_shoe_timestamp_char_;
-  BleUInteger32Callback left_shoe_timestamp_cb_;
-
-  BLECharacteristic *left_shoe_sensors_char_;
-  BleByteArrayCallback left_shoe_sensors_cb_;
-
-  BLECharacteristic *left_shoe_imu_char_;
-  BleByteArrayCallback left_shoe_imu_cb_;
+  struct ShoeGroup {
+    BLECharacteristic *connected_char;
+    BleBooleanCallback connected_cb;
 
-  BLECharacteristic *left_shoe_sequence_char_;
-  BleUInteger8Callback left_shoe_sequence_cb_;
+    BLECharacteristic *timestamp_char;
+    BleClockSyncCallback timestamp_cb;
 
-  /*******************************************************************************
-                                  right shoe group
-   ******************************************************************************/
-  BLECharacteristic *right_shoe_connected_char_;
-  BleBooleanCallback right_shoe_connected_cb_;
+    BLECharacteristic *sensors_char;
+    BleByteArrayCallback sensors_cb;
 
-  BLECharacteristic *right_shoe_timestamp_char_;
-  BleUInteger32Callback right_shoe_timestamp_cb_;
+    BLECharacteristic *imu_char;
+    BleByteArrayCallback imu_cb;
 
-  BLECharacteristic *right_shoe_sensors_char_;
-  BleByteArrayCallback right_shoe_sensors_cb_;
+    BLECharacteristic *sequence_char;
+    BleUInteger8Callback sequence_cb;
 
-  BLECharacteristic *right_shoe_imu_char_;
-  BleByteArrayCallback right_shoe_imu_cb_;
-
-  BLECharacteristic *right_shoe_sequence_char_;
-  BleUInteger8Callback right_shoe_sequence_cb_;
+    BLECharacteristic *stream_char;
+    BleStreamCallback stream_cb;
+  };
+  // the left (even index) and the right (odd index) shoe of every subject
+  ShoeGroup shoes_[settings::global::defaults::kNumberOfShoes];
 
   /*******************************************************************************
                                    tracking group
@@ -77,44 +69,37 @@ class BleServer {
   BLECharacteristic *tracking_num_imu_char_;
   BleUInteger8Callback tracking_num_imu_cb_;
 
-  BLECharacteristic *tracking_connected_imu_char_;
-  BleUInteger8Callback tracking_connected_imu_cb_;
-
   BLECharacteristic *tracking_data_selection_char_;
   BleUInteger8Callback tracking_data_selection_cb_;
 
-  BLECharacteristic *tracking_imu_1_char_;
-  BleByteArrayCallback tracking_imu_1_cb_;
-
-  BLECharacteristic *tracking_imu_2_char_;
-  BleByteArrayCallback tracking_imu_2_cb_;
-
-  BLECharacteristic *tracking_imu_3_char_;
-  BleByteArrayCallback tracking_imu_3_cb_;
-
-  BLECharacteristic *tracking_imu_4_char_;
-  BleByteArrayCallback tracking_imu_4_cb_;
-
-  BLECharacteristic *tracking_imu_5_char_;
-  BleByteArrayCallback tracking_imu_5_cb_;
-
-  BLECharacteristic *tracking_imu_6_char_;
-  BleByteArrayCallback tracking_imu_6_cb_;
-
-  BLECharacteristic *tracking_imu_7_char_;
-  BleByteArrayCallback tracking_imu_7_cb_;
-
-  BLECharacteristic *tracking_imu_8_char_;
-  BleByteArrayCallback tracking_imu_8_cb_;
+  BLECharacteristic *tracking_imu_data_char_;
+  BleTrackingCallback tracking_imu_data_cb_;
 
   void Init();
   void Advertize();
 
  private:
+  /**
+   * @brief Binds a characteristic of the table in ble_config.h to its callbacks and its initial
+   * value.
+   */
+  struct CharacteristicBinding {
+    const BleCharacteristicDescription *description;
+    BLECharacteristic **ble_characteristic;
+    BLECharacteristicCallbacks *callbacks;
+    const void *value;
+    size_t size;
+  };
+
+  BLECharacteristic *CreateCharacteristic(const CharacteristicBinding &binding);
+
   static const std::string kServiceUuid;
   static const std::string kDeviceName;
-  // !This number has to be updated when adding or removing characteristics
-  static const unsigned int kNumApplicationCharacteristics = 26;
+  static const unsigned int kNumCharacteristicsPerCentral =
+      static_cast<unsigned int>(config::characteristics::Characteristic::kNumCharacteristics);
+  static const unsigned int kNumApplicationCharacteristics =
+      kNumCharacteristicsPerCentral + settings::global::defaults::kNumberOfShoes *
+                                          config::characteristics::kNumShoeCharacteristics;
   // needed to calculate amount of handles for ble service
   static const unsigned int kNumCharacteristics = kNumApplicationCharacteristics;
 
@@ -1,6 +1,8 @@
 #ifndef __SENSINT_SETTINGS_H__
 #define __SENSINT_SETTINGS_H__
 
+#include <array>
+
 /**
  * @brief This file provides the settings for the senSInt project.
  * These are the parameters that could change during the operation of the system
@@ -23,51 +25,18 @@ static constexpr bool kAugmentationActive = true;
 static const uint8_t kSequenceID = 0;
 static constexpr bool kIMUReinitialize = false;
 static constexpr uint8_t kTrackingDataSelection = 0b11111111;
+static constexpr uint32_t kStreamStatisticsIntervalMs = 1000;
 }  // namespace defaults
 
+//! The settings are shared with the connected devices via BLE. Change them with the
+//! SettingsRegistry (settings_registry.h), which propagates the changes.
 static uint32_t recording_status = static_cast<uint32_t>(defaults::kRecordingStatus);
-static bool recording_status_changed = false;
-//! This is a dirty hack to enable setting this value from a remote connected device (e.g.
-//! smartphone) via BLE.
-static uint32_t recording_status_old = recording_status;
-
 static uint32_t recording_interval = defaults::kRecordingDelayMs;
-static bool recording_interval_changed = false;
-//! This is a dirty hack to enable setting this value from a remote connected device (e.g.
-//! smartphone) via BLE.
-static uint32_t recording_interval_old = recording_interval;
-
 static bool augmentation_active = defaults::kAugmentationActive;
-static bool augmentation_active_changed = false;
-//! This is a dirty hack to enable setting this value from a remote connected device (e.g.
-//! smartphone) via BLE.
-static bool augmentation_active_old = augmentation_active;
-
-static uint8_t left_shoe_sequence = defaults::kSequenceID;
-static bool left_shoe_sequence_changed = false;
-//! This is a dirty hack to enable setting this value from a remote connected device (e.g.
-//! smartphone) via BLE.
-static uint8_t left_shoe_sequence_old = left_shoe_sequence;
-
-static uint8_t right_shoe_sequence = defaults::kSequenceID;
-static bool right_shoe_sequence_changed = false;
-//! This is a dirty hack to enable setting this value from a remote connected device (e.g.
-//! smartphone) via BLE.
-static uint8_t right_shoe_sequence_old = right_shoe_sequence;
-
+// the left (even index) and the right (odd index) shoe of every subject
+static std::array<uint8_t, global::defaults::kNumberOfShoes> shoe_sequence = {};
 static uint8_t tracking_data_selection = defaults::kTrackingDataSelection;
-static bool tracking_data_selection_changed = false;
-//! This is a dirty hack to enable setting this value from a remote connected device (e.g.
-//! smartphone) via BLE.
-static uint8_t tracking_data_selection_old = tracking_data_selection;
-
 static bool imu_reinitialize = defaults::kIMUReinitialize;
-static bool imu_reinitialize_changed = false;
-//! This is a dirty hack to enable setting this value from a remote connected device (e.g.
-//! smartphone) via BLE.
-static bool imu_reinitialize_old = imu_reinitialize;
-
-static bool settings_changed = false;
 
 }  // namespace local
 }  // namespace settings
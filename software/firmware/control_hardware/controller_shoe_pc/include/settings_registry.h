@@ -0,0 +1,108 @@
+#ifndef __SENSINT_SETTINGS_REGISTRY_H__
+#define __SENSINT_SETTINGS_REGISTRY_H__
+
+#include <BLECharacteristic.h>
+#include <global_settings.h>
+
+#include <atomic>
+#include <cstdint>
+
+#include "ble_callbacks.h"
+
+namespace sensint {
+namespace settings {
+
+/**
+ * @brief The settings that are shared with the connected devices via BLE. The ID is the bit in
+ * the dirty mask of the registry. The sequence of every shoe is a separate setting (see
+ * GetShoeSequenceId).
+ */
+enum class SettingId : uint8_t {
+  kRecordingStatus = 0,
+  kRecordingInterval,
+  kAugmentationActive,
+  kIMUReinitialize,
+  kTrackingDataSelection,
+  kShoeSequence,
+  kNumSettings = kShoeSequence + global::defaults::kNumberOfShoes
+};
+
+inline SettingId GetShoeSequenceId(const uint8_t shoe) {
+  return static_cast<SettingId>(static_cast<uint8_t>(SettingId::kShoeSequence) + shoe);
+}
+
+enum class SettingType : uint8_t { kBoolean = 0, kUInteger8, kUInteger32 };
+
+/**
+ * @brief Table of the settings of the central that are propagated to the connected devices.
+ *
+ * A setting is changed either by a command from the serial port (@ref Set) or by a write of a
+ * connected device, in which case the BLE callback marks the dirty bit. Both only mark a bit if
+ * the value actually changed. @ref Flush updates and notifies the characteristics of all dirty
+ * settings at once, hence a burst of changes results in a single notification per setting.
+ *
+ * //! The dirty mask is shared with the BLE callbacks, which run in the context of the BLE stack.
+ * //! The values themselves are only read by @ref Flush in the loop.
+ */
+class SettingsRegistry {
+ public:
+  static constexpr size_t kNumSettings = static_cast<size_t>(SettingId::kNumSettings);
+  static_assert(kNumSettings <= 32, "the dirty mask is limited to 32 settings");
+
+  SettingsRegistry();
+  ~SettingsRegistry();
+
+  void Register(const SettingId id, const char *name, bool *value,
+                BLECharacteristic *characteristic, ble::BleBooleanCallback &callback);
+  void Register(const SettingId id, const char *name, uint8_t *value,
+                BLECharacteristic *characteristic, ble::BleUInteger8Callback &callback);
+  void Register(const SettingId id, const char *name, uint32_t *value,
+                BLECharacteristic *characteristic, ble::BleUInteger32Callback &callback);
+
+  /**
+   * @brief Change the value of a setting and mark it dirty if the value changed. The value is
+   * converted to the type of the setting.
+   *
+   * @param id The setting.
+   * @param value The new value.
+   * @return False if the setting is not registered.
+   */
+  bool Set(const SettingId id, const uint32_t value);
+
+  /**
+   * @brief Mark all registered settings dirty, e.g. to broadcast the settings to a newly
+   * connected device.
+   */
+  void MarkAll();
+
+  bool IsDirty() const;
+
+  /**
+   * @brief Update and notify the characteristics of all dirty settings and clear their bits.
+   *
+   * @return The number of notified settings.
+   */
+  size_t Flush();
+
+ private:
+  struct Setting {
+    const char *name = nullptr;
+    SettingType type = SettingType::kBoolean;
+    void *value = nullptr;
+    BLECharacteristic *characteristic = nullptr;
+  };
+
+  void Register(const SettingId id, const char *name, const SettingType type, void *value,
+                BLECharacteristic *characteristic);
+  static uint32_t GetBit(const SettingId id);
+  uint32_t GetValue(const Setting &setting) const;
+
+  Setting settings_[kNumSettings];
+  uint32_t registered_ = 0;
+  std::atomic<uint32_t> dirty_{0};
+};
+
+}  // namespace settings
+}  // namespace sensint
+
+#endif  // __SENSINT_SETTINGS_REGISTRY_H__
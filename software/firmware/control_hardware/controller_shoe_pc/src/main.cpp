@@ -5,7 +5,10 @@
 #include <string>
 
 // include shared libraries
+#include <ble_stream.h>
+#include <ble_tracking.h>
 #include <build.h>
+#include <clock_sync.h>
 #include <communication.h>
 #include <debug.h>
 #include <global_settings.h>
@@ -16,6 +19,7 @@
 // include project headers
 #include "ble_server.h"
 #include "local_settings.h"
+#include "settings_registry.h"
 
 // !Declare variables in unnamed namespace to prevent name clashes with other files.
 namespace {
@@ -25,8 +29,10 @@ std::string serialized_input_msg;
 
 // timers
 elapsedMillis recording_update_time;
+elapsedMillis stream_statistics_update_time;
 // ble device
 ble::BleServer ble_server;
+settings::SettingsRegistry settings_registry;
 uint8_t ble_connected_devices = 0;
 
 /*******************************************************************************
@@ -39,39 +45,32 @@ ImuData empty_imu{.orientation_quaternion = {.w = 0.0, .x = 0.0, .y = 0.0, .z =
                   .time_offset = 0};
 
 /*******************************************************************************
-                                left shoe group
+                                  shoe groups
  ******************************************************************************/
-bool left_shoe_connected = false;
-uint32_t left_shoe_timestamp = 0;
-union SerializableStruct<ImuData> left_shoe_imu;
-union SerializableStruct<Vector4D<analog_sensor_t>> left_shoe_sensor_data = {
-  .data = {.w = 0, .x = 0, .y = 0, .z = 0 }
-};
-
-/*******************************************************************************
-                                right shoe group
- ******************************************************************************/
-bool right_shoe_connected = false;
-uint32_t right_shoe_timestamp = 0;
-union SerializableStruct<ImuData> right_shoe_imu;
-union SerializableStruct<Vector4D<analog_sensor_t>> right_shoe_sensor_data = {
-  .data = {.w = 0, .x = 0, .y = 0, .z = 0 }
+struct ShoeState {
+  bool connected = false;
+  uint32_t timestamp = 0;
+  union SerializableStruct<ImuData> imu;
+  union SerializableStruct<Vector4D<analog_sensor_t>> sensor_data = {
+    .data = {.w = 0, .x = 0, .y = 0, .z = 0 }
+  };
+  ble::stream::StreamMonitor stream_monitor;
+  uint32_t stream_bytes_old = 0;
+  // time of the last sequence selection from the PC (0: no command pending)
+  uint32_t sequence_sent_us = 0;
 };
+// the left (even index) and the right (odd index) shoe of every subject
+ShoeState shoes[settings::global::defaults::kNumberOfShoes];
+// the totals of all streams at the last throughput report
+uint32_t stream_samples_total_old = 0;
+uint32_t stream_bytes_total_old = 0;
 
 /*******************************************************************************
                                  tracking group
  ******************************************************************************/
 bool tracking_connected = false;
 uint8_t tracking_num_imu = 0;
-uint8_t tracking_connected_imu = 0b00000000;
-union SerializableStruct<ImuData> tracking_imu_1;
-union SerializableStruct<ImuData> tracking_imu_2;
-union SerializableStruct<ImuData> tracking_imu_3;
-union SerializableStruct<ImuData> tracking_imu_4;
-union SerializableStruct<ImuData> tracking_imu_5;
-union SerializableStruct<ImuData> tracking_imu_6;
-union SerializableStruct<ImuData> tracking_imu_7;
-union SerializableStruct<ImuData> tracking_imu_8;
+ble::tracking::TrackingData tracking_data;
 
 /*******************************************************************************
                               extracted functions
@@ -81,17 +80,44 @@ inline void SetupSerial() __attribute__((always_inline));
 inline void SetupBLECallbacks() __attribute__((always_inline));
 inline void SetupBLEServer() __attribute__((always_inline));
 inline void SetupBLEData() __attribute__((always_inline));
+inline void SetupSettingsRegistry() __attribute__((always_inline));
 inline void ResetAllTimer() __attribute__((always_inline));
 #ifdef SENSINT_DEBUG
 inline void LogIMUData() __attribute__((always_inline));
 inline void PrintConfig() __attribute__((always_inline));
 #endif  // SENSINT_DEBUG
 inline void HandleTrackingUpdate() __attribute__((always_inline));
-inline void HandleLeftShoeUpdate() __attribute__((always_inline));
-inline void HandleRightShoeUpdate() __attribute__((always_inline));
+inline void HandleShoeUpdate(const uint8_t shoe) __attribute__((always_inline));
+inline void HandleShoeStream(const uint8_t shoe) __attribute__((always_inline));
+inline void HandleShoeSample(const uint8_t shoe, const ble::stream::Sample &sample)
+    __attribute__((always_inline));
 inline void HandleMessageFromSerial() __attribute__((always_inline));
+inline void HandleSequenceAcknowledge(const uint8_t shoe) __attribute__((always_inline));
+inline void HandleClockSync(const uint8_t shoe) __attribute__((always_inline));
 inline void SendTrackingDataToPC() __attribute__((always_inline));
-inline void SendShoeDataToPC() __attribute__((always_inline));
+inline void SendShoeDataToPC(const uint8_t subject) __attribute__((always_inline));
+inline void SendShoeSampleToPC(const uint8_t shoe, const ble::stream::Sample &sample)
+    __attribute__((always_inline));
+inline void SendLinkLatencyToPC(const uint8_t shoe, const communication::MessageTypes command,
+                                const uint32_t rtt_us) __attribute__((always_inline));
+inline void SendRecordingGapToPC(const uint8_t shoe, const ble::stream::StreamGap &gap,
+                                 const uint32_t timestamp_us) __attribute__((always_inline));
+inline void SendClockSyncToPC(const uint8_t shoe, const sync::ClockSyncPacket &report)
+    __attribute__((always_inline));
+inline void SendStreamStatisticsToPC(const uint8_t shoe, const uint32_t elapsed_ms)
+    __attribute__((always_inline));
+inline void SendStreamThroughputToPC(const uint32_t elapsed_ms) __attribute__((always_inline));
+
+/**
+ * @return The device ID of a shoe, which is sent to the PC together with the subject.
+ */
+communication::Devices GetShoeDevice(const uint8_t shoe) {
+  return (shoe % 2 == static_cast<uint8_t>(ble::config::characteristics::ShoeSide::kLeft))
+             ? communication::Devices::kLeftShoe
+             : communication::Devices::kRightShoe;
+}
+
+uint8_t GetShoeSubject(const uint8_t shoe) { return shoe / 2; }
 
 void SetupSerial() {
   Serial.begin(settings::global::baud_rate);
@@ -111,42 +137,37 @@ void SetupBLECallbacks() {
   ble_server.imu_reinitialize_cb_.value_ = &local::imu_reinitialize;
 
   /*******************************************************************************
-                                  left shoe group
-   ******************************************************************************/
-  ble_server.left_shoe_connected_cb_.value_ = &left_shoe_connected;
-  ble_server.left_shoe_timestamp_cb_.value_ = &left_shoe_timestamp;
-  ble_server.left_shoe_sensors_cb_.value_ = (uint8_t*)&left_shoe_sensor_data;
-  ble_server.left_shoe_imu_cb_.value_ = (uint8_t*)&left_shoe_imu;
-  ble_server.left_shoe_sequence_cb_.value_ = &local::left_shoe_sequence;
-
-  /*******************************************************************************
-                                  right shoe group
+                                   shoe groups
    ******************************************************************************/
-  ble_server.right_shoe_connected_cb_.value_ = &right_shoe_connected;
-  ble_server.right_shoe_timestamp_cb_.value_ = &right_shoe_timestamp;
-  ble_server.right_shoe_sensors_cb_.value_ = (uint8_t*)&right_shoe_sensor_data;
-  ble_server.right_shoe_imu_cb_.value_ = (uint8_t*)&right_shoe_imu;
-  ble_server.right_shoe_sequence_cb_.value_ = &local::right_shoe_sequence;
+  for (uint8_t shoe = 0; shoe < global::defaults::kNumberOfShoes; shoe++) {
+    auto& group = ble_server.shoes_[shoe];
+    group.connected_cb.value_ = &shoes[shoe].connected;
+    group.timestamp_cb.value_ = &shoes[shoe].timestamp;
+    group.sensors_cb.value_ = (uint8_t*)&shoes[shoe].sensor_data;
+    group.imu_cb.value_ = (uint8_t*)&shoes[shoe].imu;
+    group.sequence_cb.value_ = &local::shoe_sequence[shoe];
+  }
 
   /*******************************************************************************
                                    tracking group
    ******************************************************************************/
   ble_server.tracking_connected_cb_.value_ = &tracking_connected;
   ble_server.tracking_num_imu_cb_.value_ = &tracking_num_imu;
-  ble_server.tracking_connected_imu_cb_.value_ = &tracking_connected_imu;
   ble_server.tracking_data_selection_cb_.value_ = &local::tracking_data_selection;
-  ble_server.tracking_imu_1_cb_.value_ = (uint8_t*)&tracking_imu_1;
-  ble_server.tracking_imu_2_cb_.value_ = (uint8_t*)&tracking_imu_2;
-  ble_server.tracking_imu_3_cb_.value_ = (uint8_t*)&tracking_imu_3;
-  ble_server.tracking_imu_4_cb_.value_ = (uint8_t*)&tracking_imu_4;
-  ble_server.tracking_imu_5_cb_.value_ = (uint8_t*)&tracking_imu_5;
-  ble_server.tracking_imu_6_cb_.value_ = (uint8_t*)&tracking_imu_6;
-  ble_server.tracking_imu_7_cb_.value_ = (uint8_t*)&tracking_imu_7;
-  ble_server.tracking_imu_8_cb_.value_ = (uint8_t*)&tracking_imu_8;
+  ble_server.tracking_imu_data_cb_.value_ = &tracking_data;
 }
 
 void SetupBLEServer() {
+#ifdef SENSINT_DEBUG
+  // the GATT table is created once, its cost is logged to compare changes of ble_config.h
+  const uint32_t free_heap = ESP.getFreeHeap();
+  const uint32_t init_start_us = micros();
+#endif  // SENSINT_DEBUG
   ble_server.Init();
+#ifdef SENSINT_DEBUG
+  debug::Log("SetupBLEServer", "init: " + String(micros() - init_start_us) + "us | heap: " +
+                                   String(free_heap - ESP.getFreeHeap()) + "B");
+#endif  // SENSINT_DEBUG
   ble_server.Advertize();
 }
 
@@ -166,38 +187,22 @@ void SetupBLEData() {
   ble_server.imu_reinitialize_char_->setValue(tmp_imu_reinitialize);
 
   /*******************************************************************************
-                                  left shoe group
-   ******************************************************************************/
-  auto tmp_left_shoe_connected = left_shoe_connected ? 1 : 0;
-  ble_server.left_shoe_connected_char_->setValue(tmp_left_shoe_connected);
-
-  ble_server.left_shoe_timestamp_char_->setValue(left_shoe_timestamp);
-
-  ble_server.left_shoe_sensors_char_->setValue(left_shoe_sensor_data.serialized,
-                                               ble_server.left_shoe_sensors_cb_.size_);
-
-  ble_server.left_shoe_imu_char_->setValue(left_shoe_imu.serialized,
-                                           ble_server.left_shoe_imu_cb_.size_);
-
-  int tmp_left_shoe_sequence = local::left_shoe_sequence;
-  ble_server.left_shoe_sequence_char_->setValue(tmp_left_shoe_sequence);
-
-  /*******************************************************************************
-                                  right shoe group
+                                   shoe groups
    ******************************************************************************/
-  auto tmp_right_shoe_connected = right_shoe_connected ? 1 : 0;
-  ble_server.right_shoe_connected_char_->setValue(tmp_right_shoe_connected);
+  for (uint8_t shoe = 0; shoe < global::defaults::kNumberOfShoes; shoe++) {
+    auto& group = ble_server.shoes_[shoe];
+    auto tmp_connected = shoes[shoe].connected ? 1 : 0;
+    group.connected_char->setValue(tmp_connected);
 
-  ble_server.right_shoe_timestamp_char_->setValue(right_shoe_timestamp);
+    group.timestamp_char->setValue(shoes[shoe].timestamp);
 
-  ble_server.right_shoe_sensors_char_->setValue(right_shoe_sensor_data.serialized,
-                                                ble_server.right_shoe_sensors_cb_.size_);
+    group.sensors_char->setValue(shoes[shoe].sensor_data.serialized, group.sensors_cb.size_);
 
-  ble_server.right_shoe_imu_char_->setValue(right_shoe_imu.serialized,
-                                            ble_server.right_shoe_imu_cb_.size_);
+    group.imu_char->setValue(shoes[shoe].imu.serialized, group.imu_cb.size_);
 
-  int tmp_right_shoe_sequence = local::right_shoe_sequence;
-  ble_server.right_shoe_sequence_char_->setValue(tmp_right_shoe_sequence);
+    int tmp_sequence = local::shoe_sequence[shoe];
+    group.sequence_char->setValue(tmp_sequence);
+  }
 
   /*******************************************************************************
                                    tracking group
@@ -208,31 +213,47 @@ void SetupBLEData() {
   int tmp_tracking_num_imu = tracking_num_imu;
   ble_server.tracking_num_imu_char_->setValue(tmp_tracking_num_imu);
 
-  int tmp_tracking_connected_imu = tracking_connected_imu;
-  ble_server.tracking_connected_imu_char_->setValue(tmp_tracking_connected_imu);
-
   int tmp_tracking_data_selection = local::tracking_data_selection;
   ble_server.tracking_data_selection_char_->setValue(tmp_tracking_data_selection);
 
-  ble_server.tracking_imu_1_char_->setValue(tracking_imu_1.serialized,
-                                            ble_server.tracking_imu_1_cb_.size_);
-  ble_server.tracking_imu_2_char_->setValue(tracking_imu_2.serialized,
-                                            ble_server.tracking_imu_2_cb_.size_);
-  ble_server.tracking_imu_3_char_->setValue(tracking_imu_3.serialized,
-                                            ble_server.tracking_imu_3_cb_.size_);
-  ble_server.tracking_imu_4_char_->setValue(tracking_imu_4.serialized,
-                                            ble_server.tracking_imu_4_cb_.size_);
-  ble_server.tracking_imu_5_char_->setValue(tracking_imu_5.serialized,
-                                            ble_server.tracking_imu_5_cb_.size_);
-  ble_server.tracking_imu_6_char_->setValue(tracking_imu_6.serialized,
-                                            ble_server.tracking_imu_6_cb_.size_);
-  ble_server.tracking_imu_7_char_->setValue(tracking_imu_7.serialized,
-                                            ble_server.tracking_imu_7_cb_.size_);
-  ble_server.tracking_imu_8_char_->setValue(tracking_imu_8.serialized,
-                                            ble_server.tracking_imu_8_cb_.size_);
+  uint8_t tracking_frame[ble::tracking::kMaxFrameSize];
+  auto tracking_frame_size = ble::tracking::Pack(tracking_data, tracking_frame);
+  ble_server.tracking_imu_data_char_->setValue(tracking_frame, tracking_frame_size);
+}
+
+/**
+ * @brief The settings that are shared with the connected devices. Changes from the serial port
+ * and from the connected devices mark the setting dirty and are sent by a single flush.
+ */
+void SetupSettingsRegistry() {
+  using namespace sensint::settings;
+  settings_registry.Register(SettingId::kRecordingStatus, "recording status",
+                             &local::recording_status, ble_server.recording_status_char_,
+                             ble_server.recording_status_cb_);
+  settings_registry.Register(SettingId::kRecordingInterval, "recording interval",
+                             &local::recording_interval, ble_server.recording_interval_char_,
+                             ble_server.recording_interval_cb_);
+  settings_registry.Register(SettingId::kAugmentationActive, "augmentation active",
+                             &local::augmentation_active, ble_server.augmentation_active_char_,
+                             ble_server.augmentation_active_cb_);
+  settings_registry.Register(SettingId::kIMUReinitialize, "IMU reinitialize",
+                             &local::imu_reinitialize, ble_server.imu_reinitialize_char_,
+                             ble_server.imu_reinitialize_cb_);
+  settings_registry.Register(SettingId::kTrackingDataSelection, "tracking data selection",
+                             &local::tracking_data_selection,
+                             ble_server.tracking_data_selection_char_,
+                             ble_server.tracking_data_selection_cb_);
+  for (uint8_t shoe = 0; shoe < global::defaults::kNumberOfShoes; shoe++) {
+    settings_registry.Register(GetShoeSequenceId(shoe), "shoe sequence",
+                               &local::shoe_sequence[shoe], ble_server.shoes_[shoe].sequence_char,
+                               ble_server.shoes_[shoe].sequence_cb);
+  }
 }
 
-void ResetAllTimer() { recording_update_time = 0; }
+void ResetAllTimer() {
+  recording_update_time = 0;
+  stream_statistics_update_time = 0;
+}
 
 #ifdef SENSINT_DEBUG
 void LogImuData(const ImuData& imu_data, const uint8_t imu_id) {
@@ -252,6 +273,7 @@ void PrintConfig() {
   Log("commit: " + String(GIT_REV));
   Log("build mode: " + String((SENSINT_BUILD_MODE == 0) ? "development" : "release"));
   Log("debug level: " + String(SENSINT_DEBUG));
+  Log("subjects: " + String(settings::global::defaults::kNumberOfSubjects));
   Serial.println("============================================\n\n");
 }
 #endif  // SENSINT_DEBUG
@@ -270,14 +292,13 @@ void HandleTrackingUpdate() {
   }
   // tracking_num_imu = *ble_server.tracking_num_imu_cb_.value_;
   tracking_num_imu = ble_server.tracking_num_imu_char_->getData()[0];
-  // tracking_connected_imu = *ble_server.tracking_connected_imu_cb_.value_;
-  tracking_connected_imu = ble_server.tracking_connected_imu_char_->getData()[0];
   // tracking_data_selection = *ble_server.tracking_data_selection_cb_.value_;
   local::tracking_data_selection = ble_server.tracking_data_selection_char_->getData()[0];
 #ifdef SENSINT_DEBUG
   Log("HandleTrackingUpdate", "tracking # of IMUs: " + String((int)tracking_num_imu),
       DebugLevel::verbose);
-  Log("HandleTrackingUpdate", "tracking connected IMUs: " + String((int)tracking_connected_imu),
+  Log("HandleTrackingUpdate",
+      "tracking connected IMUs: " + String(tracking_data.connected_imus, BIN),
       DebugLevel::verbose);
   Log("HandleTrackingUpdate",
       "tracking data selection: " + String((int)local::tracking_data_selection),
@@ -286,225 +307,101 @@ void HandleTrackingUpdate() {
   if (local::recording_status != static_cast<uint32_t>(RecordingStatus::kRecording)) {
     return;
   }
-  for (uint8_t id = 0; id < global::defaults::kTrackingMaxNumberOfIMUs; id++) {
-    if (tracking_connected_imu & (1 << id)) {
-      switch (id) {
-        case 0:
-          memcpy(ble_server.tracking_imu_1_cb_.value_, tracking_imu_1.serialized,
-                 ble_server.tracking_imu_1_cb_.size_);
-#ifdef SENSINT_DEBUG
-          LogImuData(tracking_imu_1.data, id);
-#endif  // SENSINT_DEBUG
-          break;
-        case 1:
-          memcpy(ble_server.tracking_imu_2_cb_.value_, tracking_imu_2.serialized,
-                 ble_server.tracking_imu_2_cb_.size_);
-#ifdef SENSINT_DEBUG
-          LogImuData(tracking_imu_2.data, id);
-#endif  // SENSINT_DEBUG
-          break;
-        case 2:
-          memcpy(ble_server.tracking_imu_3_cb_.value_, tracking_imu_3.serialized,
-                 ble_server.tracking_imu_3_cb_.size_);
-#ifdef SENSINT_DEBUG
-          LogImuData(tracking_imu_3.data, id);
-#endif  // SENSINT_DEBUG
-          break;
-        case 3:
-          memcpy(ble_server.tracking_imu_4_cb_.value_, tracking_imu_4.serialized,
-                 ble_server.tracking_imu_4_cb_.size_);
-#ifdef SENSINT_DEBUG
-          LogImuData(tracking_imu_4.data, id);
-#endif  // SENSINT_DEBUG
-          break;
-        case 4:
-          memcpy(ble_server.tracking_imu_5_cb_.value_, tracking_imu_5.serialized,
-                 ble_server.tracking_imu_5_cb_.size_);
-#ifdef SENSINT_DEBUG
-          LogImuData(tracking_imu_5.data, id);
-#endif  // SENSINT_DEBUG
-          break;
-        case 5:
-          memcpy(ble_server.tracking_imu_6_cb_.value_, tracking_imu_6.serialized,
-                 ble_server.tracking_imu_6_cb_.size_);
-#ifdef SENSINT_DEBUG
-          LogImuData(tracking_imu_6.data, id);
-#endif  // SENSINT_DEBUG
-          break;
-        case 6:
-          memcpy(ble_server.tracking_imu_7_cb_.value_, tracking_imu_7.serialized,
-                 ble_server.tracking_imu_7_cb_.size_);
-#ifdef SENSINT_DEBUG
-          LogImuData(tracking_imu_7.data, id);
-#endif  // SENSINT_DEBUG
-          break;
-        case 7:
-          memcpy(ble_server.tracking_imu_8_cb_.value_, tracking_imu_8.serialized,
-                 ble_server.tracking_imu_8_cb_.size_);
 #ifdef SENSINT_DEBUG
-          LogImuData(tracking_imu_8.data, id);
-#endif  // SENSINT_DEBUG
-          break;
-        default:
-          break;
-      }
+  for (uint8_t id = 0; id < ble::tracking::kNumSlots; id++) {
+    if (tracking_data.connected_imus & (1UL << id)) {
+      LogImuData(tracking_data.imu[id], id);
     }
   }
+#endif  // SENSINT_DEBUG
 }
 
-void HandleLeftShoeUpdate() {
+void HandleShoeUpdate(const uint8_t shoe) {
   using namespace sensint::debug;
   using namespace sensint::sensor;
   using namespace sensint::settings;
-  left_shoe_connected = *ble_server.left_shoe_connected_cb_.value_;
+  const auto& state = shoes[shoe];
 #ifdef SENSINT_DEBUG
-  Log("HandleLeftShoeUpdate", "left shoe connected: " + String(left_shoe_connected ? "yes" : "no"),
+  Log("HandleShoeUpdate",
+      "shoe " + String(shoe) + " connected: " + String(state.connected ? "yes" : "no"),
       DebugLevel::verbose);
 #endif  // SENSINT_DEBUG
-  if (!left_shoe_connected) {
+  if (!state.connected) {
     return;
   }
   if (local::recording_status != static_cast<uint32_t>(RecordingStatus::kRecording)) {
     return;
   }
-  memcpy(ble_server.left_shoe_imu_cb_.value_, left_shoe_imu.serialized,
-         ble_server.left_shoe_imu_cb_.size_);
-  memcpy(ble_server.left_shoe_sensors_cb_.value_, left_shoe_sensor_data.serialized,
-         ble_server.left_shoe_sensors_cb_.size_);
 #ifdef SENSINT_DEBUG
-  Log("HandleLeftShoeUpdate", "IMU data from left shoe");
+  Log("HandleShoeUpdate", "IMU data from shoe " + String(shoe));
   if (kDebugLevel == DebugLevel::verbose) {
-    PrintImuData(left_shoe_imu.data, local::tracking_data_selection);
+    PrintImuData(state.imu.data, local::tracking_data_selection);
   }
-  Log("HandleLeftShoeUpdate", "sensor data from left shoe");
+  Log("HandleShoeUpdate", "sensor data from shoe " + String(shoe));
   if (kDebugLevel == DebugLevel::verbose) {
-    PrintVector4D(left_shoe_sensor_data.data);
+    PrintVector4D(state.sensor_data.data);
   }
 #endif  // SENSINT_DEBUG
 }
 
-void HandleRightShoeUpdate() {
-  using namespace sensint::debug;
-  using namespace sensint::sensor;
-  using namespace sensint::settings;
-  right_shoe_connected = *ble_server.right_shoe_connected_cb_.value_;
-#ifdef SENSINT_DEBUG
-  Log("HandleRightShoeUpdate",
-      "right shoe connected: " + String(right_shoe_connected ? "yes" : "no"), DebugLevel::verbose);
-#endif  // SENSINT_DEBUG
-  if (!right_shoe_connected) {
-    return;
-  }
-  if (local::recording_status != static_cast<uint32_t>(RecordingStatus::kRecording)) {
-    return;
-  }
-  memcpy(ble_server.right_shoe_imu_cb_.value_, right_shoe_imu.serialized,
-         ble_server.right_shoe_imu_cb_.size_);
-  memcpy(ble_server.right_shoe_sensors_cb_.value_, right_shoe_sensor_data.serialized,
-         ble_server.right_shoe_sensors_cb_.size_);
-#ifdef SENSINT_DEBUG
-  Log("HandleRightShoeUpdate", "IMU data from right shoe");
-  if (kDebugLevel == DebugLevel::verbose) {
-    PrintImuData(right_shoe_imu.data, local::tracking_data_selection);
-  }
-  Log("HandleRightShoeUpdate", "sensor data from right shoe");
-  if (kDebugLevel == DebugLevel::verbose) {
-    PrintVector4D(right_shoe_sensor_data.data);
+/**
+ * @brief Decode all packets that were received from a shoe since the last call. Unlike the
+ * characteristic values, the stream is queued by the BLE callback. Hence, no sample is lost
+ * between two calls.
+ */
+void HandleShoeStream(const uint8_t shoe) {
+  using namespace sensint::ble;
+  // the receiver is independent of the transport (see stream_transport.h)
+  auto &receiver = ble_server.shoes_[shoe].stream_cb.receiver_;
+  auto &monitor = shoes[shoe].stream_monitor;
+  stream::Packet packet;
+  while (receiver.packets_.Pop(packet)) {
+    stream::PacketReader reader(packet.data, packet.length);
+    if (!reader.IsValid()) {
+      continue;
+    }
+    // the samples arrive in order, the backfill after a reconnect may overlap the received ones
+    stream::StreamGap gap;
+    uint8_t skip = monitor.Update(reader.GetHeader(), packet.length, gap);
+    stream::Sample sample;
+    while (reader.Next(sample)) {
+      if (skip > 0) {
+        skip--;
+        continue;
+      }
+      if (gap.num_samples > 0) {
+        if (settings::local::recording_status ==
+            static_cast<uint32_t>(RecordingStatus::kRecording)) {
+          SendRecordingGapToPC(shoe, gap, sample.timestamp_us);
+        }
+        gap.num_samples = 0;
+      }
+      HandleShoeSample(shoe, sample);
+    }
   }
-#endif  // SENSINT_DEBUG
+  monitor.SetDroppedPackets(receiver.packets_.GetDropped());
 }
 
-void HandleRemoteSettingsUpdate(bool force_update = false) {
-  using namespace sensint::debug;
+/**
+ * @brief Keep the latest values of a shoe (e.g. for SendShoeDataToPC) and forward the sample to the
+ * PC while recording.
+ */
+void HandleShoeSample(const uint8_t shoe, const ble::stream::Sample &sample) {
+  using namespace sensint::ble;
   using namespace sensint::settings;
-
-  if (force_update ||
-      local::recording_status != local::recording_status_old && local::recording_status_changed) {
-    ble_server.recording_status_char_->setValue(local::recording_status);
-    ble_server.recording_status_char_->notify();
-    local::recording_status_changed = false;
-    local::recording_status_old = local::recording_status;
-#ifdef SENSINT_DEBUG
-    Log("HandleRemoteSettingsUpdate", "recording status: " + String(local::recording_status));
-#endif  // SENSINT_DEBUG
-  }
-
-  if (force_update || local::recording_interval != local::recording_interval_old &&
-                          local::recording_interval_changed) {
-    ble_server.recording_interval_char_->setValue(local::recording_interval);
-    ble_server.recording_interval_char_->notify();
-    local::recording_interval_changed = false;
-    local::recording_interval_old = local::recording_interval;
-#ifdef SENSINT_DEBUG
-    Log("HandleRemoteSettingsUpdate", "recording interval: " + String(local::recording_interval));
-#endif  // SENSINT_DEBUG
-  }
-
-  if (force_update || local::augmentation_active != local::augmentation_active_old &&
-                          local::augmentation_active_changed) {
-    auto tmp_augmentation_active = local::augmentation_active ? 1 : 0;
-    ble_server.augmentation_active_char_->setValue(tmp_augmentation_active);
-    ble_server.augmentation_active_char_->notify();
-    local::augmentation_active_changed = false;
-    local::augmentation_active_old = local::augmentation_active;
-#ifdef SENSINT_DEBUG
-    Log("HandleRemoteSettingsUpdate", "augmentation active: " + String(local::augmentation_active));
-#endif  // SENSINT_DEBUG
-  }
-
-  if (force_update ||
-      local::imu_reinitialize != local::imu_reinitialize_old && local::imu_reinitialize_changed) {
-    auto tmp_imu_reinitialize = local::imu_reinitialize ? 1 : 0;
-    ble_server.imu_reinitialize_char_->setValue(tmp_imu_reinitialize);
-    ble_server.imu_reinitialize_char_->notify();
-    local::imu_reinitialize_changed = false;
-    local::imu_reinitialize_old = local::imu_reinitialize;
-#ifdef SENSINT_DEBUG
-    Log("HandleRemoteSettingsUpdate", "IMU reinitialize: " + String(local::imu_reinitialize));
-#endif  // SENSINT_DEBUG
-  }
-
-  if (force_update || local::tracking_data_selection_changed &&
-                          local::tracking_data_selection != local::tracking_data_selection_old) {
-    int tmp_tracking_data_selection = local::tracking_data_selection;
-    ble_server.tracking_data_selection_char_->setValue(tmp_tracking_data_selection);
-    ble_server.tracking_data_selection_char_->notify();
-    local::tracking_data_selection_changed = false;
-    local::tracking_data_selection_old = local::tracking_data_selection;
-#ifdef SENSINT_DEBUG
-    Log("HandleRemoteSettingsUpdate",
-        "tracking data selection: " + String((int)local::tracking_data_selection));
-#endif  // SENSINT_DEBUG
-  }
-
-  if (force_update || local::left_shoe_sequence_changed &&
-                          local::left_shoe_sequence != local::left_shoe_sequence_old) {
-    int tmp_left_shoe_sequence = (int)local::left_shoe_sequence;
-    ble_server.left_shoe_sequence_char_->setValue(tmp_left_shoe_sequence);
-    ble_server.left_shoe_sequence_char_->notify();
-    local::left_shoe_sequence_changed = false;
-    local::left_shoe_sequence_old = local::left_shoe_sequence;
-#ifdef SENSINT_DEBUG
-    Log("HandleRemoteSettingsUpdate",
-        "left shoe sequence: " + String((int)local::left_shoe_sequence));
-#endif  // SENSINT_DEBUG
+  switch (sample.type) {
+    case stream::SampleType::kImu:
+      shoes[shoe].imu.data = sample.payload.imu;
+      break;
+    case stream::SampleType::kPressure:
+      shoes[shoe].sensor_data.data = sample.payload.pressure;
+      break;
+    default:
+      return;
   }
-
-  if (force_update || local::right_shoe_sequence_changed &&
-                          local::right_shoe_sequence != local::right_shoe_sequence_old) {
-    int tmp_right_shoe_sequence = (int)local::right_shoe_sequence;
-    ble_server.right_shoe_sequence_char_->setValue(tmp_right_shoe_sequence);
-    ble_server.right_shoe_sequence_char_->notify();
-    local::right_shoe_sequence_changed = false;
-    local::right_shoe_sequence_old = local::right_shoe_sequence;
-#ifdef SENSINT_DEBUG
-    Log("HandleRemoteSettingsUpdate",
-        "right shoe sequence: " + String((int)local::right_shoe_sequence));
-#endif  // SENSINT_DEBUG
+  if (local::recording_status == static_cast<uint32_t>(RecordingStatus::kRecording)) {
+    SendShoeSampleToPC(shoe, sample);
   }
-
-  // reset the global flag
-  local::settings_changed = false;
 }
 
 void HandleMessageFromSerial() {
@@ -527,33 +424,30 @@ void HandleMessageFromSerial() {
       Log("HandleMessageFromSerial", "should start augmentation");
 #endif  // SENSINT_DEBUG
       // TODO: toggle augmentation per shoe
-      settings::local::augmentation_active = true;
-      settings::local::augmentation_active_changed = true;
+      settings_registry.Set(settings::SettingId::kAugmentationActive, true);
       break;
 
     case MessageTypes::kStopAugmentation:
 #ifdef SENSINT_DEBUG
       Log("HandleMessageFromSerial", "should stop augmentation");
 #endif  // SENSINT_DEBUG
-      settings::local::augmentation_active = false;
-      settings::local::augmentation_active_changed = true;
+      settings_registry.Set(settings::SettingId::kAugmentationActive, false);
       break;
 
     case MessageTypes::kStartRecording:
 #ifdef SENSINT_DEBUG
       Log("HandleMessageFromSerial", "should start recording");
 #endif  // SENSINT_DEBUG
-      settings::local::recording_status =
-          static_cast<uint32_t>(sensint::RecordingStatus::kRecording);
-      settings::local::recording_status_changed = true;
+      settings_registry.Set(settings::SettingId::kRecordingStatus,
+                            static_cast<uint32_t>(sensint::RecordingStatus::kRecording));
       break;
 
     case MessageTypes::kStopRecording:
 #ifdef SENSINT_DEBUG
       Log("HandleMessageFromSerial", "should stop recording");
 #endif  // SENSINT_DEBUG
-      settings::local::recording_status = static_cast<uint32_t>(sensint::RecordingStatus::kIdle);
-      settings::local::recording_status_changed = true;
+      settings_registry.Set(settings::SettingId::kRecordingStatus,
+                            static_cast<uint32_t>(sensint::RecordingStatus::kIdle));
       break;
 
     case MessageTypes::kChangeRecordingInterval:
@@ -561,8 +455,8 @@ void HandleMessageFromSerial() {
       Log("HandleMessageFromSerial", "should change recording interval");
 #endif  // SENSINT_DEBUG
       if (tokens.size() == 4) {
-        settings::local::recording_interval = static_cast<uint32_t>(atoi(tokens[3].c_str()));
-        settings::local::recording_interval_changed = true;
+        settings_registry.Set(settings::SettingId::kRecordingInterval,
+                              static_cast<uint32_t>(atoi(tokens[3].c_str())));
       }
       break;
 
@@ -570,38 +464,35 @@ void HandleMessageFromSerial() {
 #ifdef SENSINT_DEBUG
       Log("HandleMessageFromSerial", "should reinitialize IMU");
 #endif  // SENSINT_DEBUG
-      settings::local::imu_reinitialize = true;
-      settings::local::imu_reinitialize_changed = true;
+      settings_registry.Set(settings::SettingId::kIMUReinitialize, true);
       break;
 
     case MessageTypes::kSelectGrainSequence: {
 #ifdef SENSINT_DEBUG
       Log("HandleMessageFromSerial", "should change sequence");
 #endif  // SENSINT_DEBUG
-      if (tokens.size() != 4) {
+      // the subject is optional, a command without a subject addresses all subjects
+      if (tokens.size() != 4 && tokens.size() != 5) {
         return;
       }
-      auto destination = atoi(tokens[0].c_str());
-      switch (destination) {
-        case static_cast<int>(Devices::kAll):
-          settings::local::left_shoe_sequence = static_cast<uint32_t>(atoi(tokens[3].c_str()));
-          settings::local::left_shoe_sequence_changed = true;
-          settings::local::right_shoe_sequence = static_cast<uint32_t>(atoi(tokens[3].c_str()));
-          settings::local::right_shoe_sequence_changed = true;
-          break;
-        case static_cast<int>(Devices::kLeftShoe):
-          settings::local::left_shoe_sequence = static_cast<uint32_t>(atoi(tokens[3].c_str()));
-          settings::local::left_shoe_sequence_changed = true;
-          break;
-        case static_cast<int>(Devices::kRightShoe):
-          settings::local::right_shoe_sequence = static_cast<uint32_t>(atoi(tokens[3].c_str()));
-          settings::local::right_shoe_sequence_changed = true;
-          break;
-        default:
+      auto destination = static_cast<Devices>(atoi(tokens[0].c_str()));
+      auto sequence = static_cast<uint32_t>(atoi(tokens[3].c_str()));
+      int subject = (tokens.size() == 5) ? atoi(tokens[4].c_str()) : -1;
+      if ((destination != Devices::kAll && destination != Devices::kLeftShoe &&
+           destination != Devices::kRightShoe) ||
+          subject >= settings::global::defaults::kNumberOfSubjects) {
 #ifdef SENSINT_DEBUG
-          Log("HandleMessageFromSerial", "destination device not supported");
+        Log("HandleMessageFromSerial", "destination device not supported");
 #endif  // SENSINT_DEBUG
-          break;
+        break;
+      }
+      for (uint8_t shoe = 0; shoe < settings::global::defaults::kNumberOfShoes; shoe++) {
+        if ((subject >= 0 && GetShoeSubject(shoe) != subject) ||
+            (destination != Devices::kAll && destination != GetShoeDevice(shoe))) {
+          continue;
+        }
+        settings_registry.Set(settings::GetShoeSequenceId(shoe), sequence);
+        shoes[shoe].sequence_sent_us = micros();
       }
       break;
     }
@@ -614,102 +505,69 @@ void HandleMessageFromSerial() {
   }
 }
 
+/**
+ * @brief The shoes echo the sequence as soon as it was applied by the generators. This closes the
+ * round trip from the serial command to the generator.
+ */
+void HandleSequenceAcknowledge(const uint8_t shoe) {
+  auto &sent_us = shoes[shoe].sequence_sent_us;
+  // the flag is always consumed, echoes without a pending command are ignored
+  if (!ble_server.shoes_[shoe].sequence_cb.WasWritten() || sent_us == 0) {
+    return;
+  }
+  const uint32_t rtt_us = micros() - sent_us;
+  sent_us = 0;
+  SendLinkLatencyToPC(shoe, communication::MessageTypes::kSelectGrainSequence, rtt_us);
+}
+
+/**
+ * @brief The shoes include their current clock estimate in every synchronization request. The
+ * estimates are forwarded to the PC to monitor the synchronization error.
+ */
+void HandleClockSync(const uint8_t shoe) {
+  sync::ClockSyncPacket report;
+  while (ble_server.shoes_[shoe].timestamp_cb.reports_.Pop(report)) {
+    SendClockSyncToPC(shoe, report);
+  }
+}
+
 void SendTrackingDataToPC() {
 #ifdef SENSINT_DEBUG
   debug::Log("SendTrackingDataToPC", "IMU data", debug::DebugLevel::verbose);
 #endif  // SENSINT_DEBUG
   std::string msg;
-  for (uint8_t id = 0; id < settings::global::defaults::kTrackingMaxNumberOfIMUs; id++) {
-    if (tracking_connected_imu & (1 << id)) {
-      switch (id) {
-        case 0:
-          communication::SerializeImuData(tracking_imu_1.data, msg, true);
-          msg += communication::kMessageDelimiter;
-          break;
-        case 1:
-          communication::SerializeImuData(tracking_imu_2.data, msg, true);
-          msg += communication::kMessageDelimiter;
-          break;
-        case 2:
-          communication::SerializeImuData(tracking_imu_3.data, msg, true);
-          msg += communication::kMessageDelimiter;
-          break;
-        case 3:
-          communication::SerializeImuData(tracking_imu_4.data, msg, true);
-          msg += communication::kMessageDelimiter;
-          break;
-        case 4:
-          communication::SerializeImuData(tracking_imu_5.data, msg, true);
-          msg += communication::kMessageDelimiter;
-          break;
-        case 5:
-          communication::SerializeImuData(tracking_imu_6.data, msg, true);
-          msg += communication::kMessageDelimiter;
-          break;
-        case 6:
-          communication::SerializeImuData(tracking_imu_7.data, msg, true);
-          msg += communication::kMessageDelimiter;
-          break;
-        case 7:
-          communication::SerializeImuData(tracking_imu_7.data, msg, true);
-          msg += communication::kMessageDelimiter;
-          break;
-        default:
-          break;
-      }
-    }
-    if (msg.empty()) {
-      return;
+  for (uint8_t id = 0; id < ble::tracking::kNumSlots; id++) {
+    if (tracking_data.connected_imus & (1UL << id)) {
+      communication::SerializeImuData(tracking_data.imu[id], msg, true);
+      msg += communication::kMessageDelimiter;
     }
-    msg.erase(msg.end());
-    Serial.println(msg.c_str());
   }
+  if (msg.empty()) {
+    return;
+  }
+  // remove the trailing delimiter
+  msg.pop_back();
+  Serial.println(msg.c_str());
 
   //! This is the binary version.
-  // for (uint8_t id = 0; id < settings::global::defaults::kTrackingMaxNumberOfIMUs; id++) {
-  //   if (tracking_connected_imu & (1 << id)) {
-  //     switch (id) {
-  //       case 0:
-  //         Serial.write(tracking_imu_1.serialized, sizeof(tracking_imu_1.serialized));
-  //         break;
-  //       case 1:
-  //         Serial.write(tracking_imu_2.serialized, sizeof(tracking_imu_2.serialized));
-  //         break;
-  //       case 2:
-  //         Serial.write(tracking_imu_3.serialized, sizeof(tracking_imu_3.serialized));
-  //         break;
-  //       case 3:
-  //         Serial.write(tracking_imu_4.serialized, sizeof(tracking_imu_4.serialized));
-  //         break;
-  //       case 4:
-  //         Serial.write(tracking_imu_5.serialized, sizeof(tracking_imu_5.serialized));
-  //         break;
-  //       case 5:
-  //         Serial.write(tracking_imu_6.serialized, sizeof(tracking_imu_6.serialized));
-  //         break;
-  //       case 6:
-  //         Serial.write(tracking_imu_7.serialized, sizeof(tracking_imu_7.serialized));
-  //         break;
-  //       case 7:
-  //         Serial.write(tracking_imu_8.serialized, sizeof(tracking_imu_8.serialized));
-  //         break;
-  //       default:
-  //         break;
-  //     }
+  // for (uint8_t id = 0; id < ble::tracking::kNumSlots; id++) {
+  //   if (tracking_data.connected_imus & (1UL << id)) {
+  //     Serial.write((uint8_t*)&tracking_data.imu[id], sizeof(ImuData));
   //   }
   // }
 }
 
 /**
- * @brief send data of both shoes to the serial port
- * order of data: left shoe [4x fsr,imu], right shoe [4x fsr,imu]
+ * @brief send data of both shoes of a subject to the serial port
+ * order of data: subject, left shoe [4x fsr,imu], right shoe [4x fsr,imu]
  * @example
- * <1,68,1,0,0,0,0,0.000000,0.000000,0.000000,0.000000,0.000000,0.000000,0.000000,0,0,0,0,0,0,0.000000,0.000000,0.000000,0.000000,0.000000,0.000000,0.000000,0,0>
+ * <1,68,1,0,0,0,0,0,0.000000,0.000000,0.000000,0.000000,0.000000,0.000000,0.000000,0,0,0,0,0,0,0.000000,0.000000,0.000000,0.000000,0.000000,0.000000,0.000000,0,0>
  *
  */
-void SendShoeDataToPC() {
+void SendShoeDataToPC(const uint8_t subject) {
 #ifdef SENSINT_DEBUG
-  debug::Log("SendShoeDataToPC", "order of data: left shoe [fsr,imu], right shoe [fsr,imu]",
+  debug::Log("SendShoeDataToPC",
+             "order of data: subject, left shoe [fsr,imu], right shoe [fsr,imu]",
              debug::DebugLevel::verbose);
 #endif  // SENSINT_DEBUG
   //"<1,68,1,"
@@ -717,40 +575,218 @@ void SendShoeDataToPC() {
   header << "<" << String((int)communication::Devices::kGUI).c_str()
          << communication::kMessageDelimiter
          << String((int)communication::MessageTypes::kShoeData).c_str()
-         << communication::kMessageDelimiter << "1" << communication::kMessageDelimiter;
+         << communication::kMessageDelimiter << "1" << communication::kMessageDelimiter
+         << String((int)subject).c_str() << communication::kMessageDelimiter;
   std::string msg{header.str()};
-  if (left_shoe_connected) {
-    communication::SerializeVector4D<analog_sensor_t>(left_shoe_sensor_data.data, msg, true, false);
-    msg += communication::kMessageDelimiter;
-    communication::SerializeImuData(left_shoe_imu.data, msg, true);
-  } else {
-    communication::SerializeVector4D<analog_sensor_t>(empty_fsr, msg, true, false);
-    msg += communication::kMessageDelimiter;
-    communication::SerializeImuData(empty_imu, msg, true);
+  using ble::config::characteristics::ShoeSide;
+  for (auto side : {ShoeSide::kLeft, ShoeSide::kRight}) {
+    const auto &state = shoes[ble::config::characteristics::GetShoeIndex(subject, side)];
+    if (side == ShoeSide::kRight) {
+      msg += communication::kMessageDelimiter;
+    }
+    if (state.connected) {
+      communication::SerializeVector4D<analog_sensor_t>(state.sensor_data.data, msg, true, false);
+      msg += communication::kMessageDelimiter;
+      communication::SerializeImuData(state.imu.data, msg, true);
+    } else {
+      communication::SerializeVector4D<analog_sensor_t>(empty_fsr, msg, true, false);
+      msg += communication::kMessageDelimiter;
+      communication::SerializeImuData(empty_imu, msg, true);
+    }
   }
-  msg += communication::kMessageDelimiter;
-  if (right_shoe_connected) {
-    communication::SerializeVector4D<analog_sensor_t>(right_shoe_sensor_data.data, msg, true,
-                                                      false);
-    msg += communication::kMessageDelimiter;
-    communication::SerializeImuData(left_shoe_imu.data, msg, true);
+  msg.append(">");
+  Serial.println(msg.c_str());
+}
+
+/**
+ * @brief send a single sample of a shoe's stream to the serial port
+ * order of data: device, subject, sample type, timestamp [us], values (4x fsr or imu)
+ * @example
+ * <1,70,1,6,0,1,1234567,0,0,0,0>
+ *
+ */
+void SendShoeSampleToPC(const uint8_t shoe, const ble::stream::Sample &sample) {
+  //"<1,70,1,"
+  std::stringstream header;
+  header << "<" << String((int)communication::Devices::kGUI).c_str()
+         << communication::kMessageDelimiter
+         << String((int)communication::MessageTypes::kShoeStreamData).c_str()
+         << communication::kMessageDelimiter << "1" << communication::kMessageDelimiter
+         << String((int)GetShoeDevice(shoe)).c_str() << communication::kMessageDelimiter
+         << String((int)GetShoeSubject(shoe)).c_str() << communication::kMessageDelimiter
+         << String((int)sample.type).c_str() << communication::kMessageDelimiter
+         << String(sample.timestamp_us).c_str() << communication::kMessageDelimiter;
+  std::string msg{header.str()};
+  if (sample.type == ble::stream::SampleType::kImu) {
+    communication::SerializeImuData(sample.payload.imu, msg, true);
   } else {
-    communication::SerializeVector4D<analog_sensor_t>(empty_fsr, msg, true, false);
-    msg += communication::kMessageDelimiter;
-    communication::SerializeImuData(empty_imu, msg, true);
+    communication::SerializeVector4D<analog_sensor_t>(sample.payload.pressure, msg, true, false);
   }
   msg.append(">");
   Serial.println(msg.c_str());
+}
 
-  //! This is the binary version.
-  // if (left_shoe_connected) {
-  //   Serial.write(left_shoe_sensor_data.serialized, sizeof(left_shoe_sensor_data.serialized));
-  //   Serial.write(left_shoe_imu.serialized, sizeof(left_shoe_imu.serialized));
-  // }
-  // if (right_shoe_connected) {
-  //   Serial.write(right_shoe_sensor_data.serialized, sizeof(right_shoe_sensor_data.serialized));
-  //   Serial.write(right_shoe_imu.serialized, sizeof(right_shoe_imu.serialized));
-  // }
+/**
+ * @brief send the round trip time of a command to the serial port
+ * order of data: device, subject, command type, round trip time [us]
+ * @example
+ * <1,72,1,6,0,34,18250>
+ *
+ */
+void SendLinkLatencyToPC(const uint8_t shoe, const communication::MessageTypes command,
+                         const uint32_t rtt_us) {
+  std::stringstream msg;
+  msg << "<" << String((int)communication::Devices::kGUI).c_str()
+      << communication::kMessageDelimiter
+      << String((int)communication::MessageTypes::kLinkLatency).c_str()
+      << communication::kMessageDelimiter << "1" << communication::kMessageDelimiter
+      << String((int)GetShoeDevice(shoe)).c_str() << communication::kMessageDelimiter
+      << String((int)GetShoeSubject(shoe)).c_str() << communication::kMessageDelimiter
+      << String((int)command).c_str() << communication::kMessageDelimiter
+      << String(rtt_us).c_str() << ">";
+  Serial.println(msg.str().c_str());
+#ifdef SENSINT_DEBUG
+  debug::Log("SendLinkLatencyToPC", "shoe " + String(shoe) + " | command " +
+                                        String((int)command) + " | rtt " + String(rtt_us) + "us");
+#endif  // SENSINT_DEBUG
+}
+
+/**
+ * @brief send a range of samples that is missing in a shoe's stream to the serial port
+ * order of data: device, subject, first missing sample, number of missing samples, timestamp of
+ * the next received sample [us]
+ * @example
+ * <1,74,1,6,0,18230,120,95123456>
+ *
+ */
+void SendRecordingGapToPC(const uint8_t shoe, const ble::stream::StreamGap &gap,
+                          const uint32_t timestamp_us) {
+  std::stringstream msg;
+  msg << "<" << String((int)communication::Devices::kGUI).c_str()
+      << communication::kMessageDelimiter
+      << String((int)communication::MessageTypes::kRecordingGap).c_str()
+      << communication::kMessageDelimiter << "1" << communication::kMessageDelimiter
+      << String((int)GetShoeDevice(shoe)).c_str() << communication::kMessageDelimiter
+      << String((int)GetShoeSubject(shoe)).c_str() << communication::kMessageDelimiter
+      << String(gap.first_sample).c_str() << communication::kMessageDelimiter
+      << String(gap.num_samples).c_str() << communication::kMessageDelimiter
+      << String(timestamp_us).c_str() << ">";
+  Serial.println(msg.str().c_str());
+#ifdef SENSINT_DEBUG
+  debug::Log("SendRecordingGapToPC",
+             "shoe " + String(shoe) + " | missing " + String(gap.num_samples) + " samples");
+#endif  // SENSINT_DEBUG
+}
+
+/**
+ * @brief send the clock synchronization state of a shoe to the serial port
+ * order of data: device, subject, synchronized, offset [us], drift [ppb], residual [us], round
+ * trip [us]
+ * @example
+ * <1,73,1,6,0,1,-1523074,12500,180,9250>
+ *
+ */
+void SendClockSyncToPC(const uint8_t shoe, const sync::ClockSyncPacket &report) {
+  std::stringstream msg;
+  msg << "<" << String((int)communication::Devices::kGUI).c_str()
+      << communication::kMessageDelimiter
+      << String((int)communication::MessageTypes::kClockSync).c_str()
+      << communication::kMessageDelimiter << "1" << communication::kMessageDelimiter
+      << String((int)GetShoeDevice(shoe)).c_str() << communication::kMessageDelimiter
+      << String((int)GetShoeSubject(shoe)).c_str() << communication::kMessageDelimiter
+      << String((int)report.synchronized).c_str() << communication::kMessageDelimiter
+      << String(report.offset_us).c_str() << communication::kMessageDelimiter
+      << String(report.drift_ppb).c_str() << communication::kMessageDelimiter
+      << String(report.residual_us).c_str() << communication::kMessageDelimiter
+      << String(report.delay_us).c_str() << ">";
+  Serial.println(msg.str().c_str());
+#ifdef SENSINT_DEBUG
+  debug::Log("SendClockSyncToPC", "shoe " + String(shoe) + " | offset " +
+                                      String(report.offset_us) + "us | residual " +
+                                      String(report.residual_us) + "us",
+             debug::DebugLevel::verbose);
+#endif  // SENSINT_DEBUG
+}
+
+/**
+ * @brief send the counters of a shoe's stream to the serial port
+ * order of data: device, subject, packets, samples, throughput [bytes/s], lost packets, dropped
+ * packets, missing samples
+ * @example
+ * <1,71,1,6,0,120,960,6480,0,0,0>
+ *
+ */
+void SendStreamStatisticsToPC(const uint8_t shoe, const uint32_t elapsed_ms) {
+  auto &state = shoes[shoe];
+  const auto &statistics = state.stream_monitor.GetStatistics();
+  const uint32_t throughput =
+      (elapsed_ms > 0) ? (statistics.bytes - state.stream_bytes_old) * 1000 / elapsed_ms : 0;
+  state.stream_bytes_old = statistics.bytes;
+  std::stringstream msg;
+  msg << "<" << String((int)communication::Devices::kGUI).c_str()
+      << communication::kMessageDelimiter
+      << String((int)communication::MessageTypes::kStreamStatistics).c_str()
+      << communication::kMessageDelimiter << "1" << communication::kMessageDelimiter
+      << String((int)GetShoeDevice(shoe)).c_str() << communication::kMessageDelimiter
+      << String((int)GetShoeSubject(shoe)).c_str() << communication::kMessageDelimiter
+      << String(statistics.packets).c_str() << communication::kMessageDelimiter
+      << String(statistics.samples).c_str() << communication::kMessageDelimiter
+      << String(throughput).c_str() << communication::kMessageDelimiter
+      << String(statistics.lost_packets).c_str() << communication::kMessageDelimiter
+      << String(statistics.dropped_packets).c_str() << communication::kMessageDelimiter
+      << String(statistics.missing_samples).c_str() << ">";
+  Serial.println(msg.str().c_str());
+#ifdef SENSINT_DEBUG
+  debug::Log("SendStreamStatisticsToPC",
+             "shoe " + String(shoe) + " | " + String(throughput) + " B/s | lost " +
+                 String(statistics.lost_packets) + " | dropped " +
+                 String(statistics.dropped_packets) + " | missing " +
+                 String(statistics.missing_samples) + " | duplicate " +
+                 String(statistics.duplicate_samples));
+#endif  // SENSINT_DEBUG
+}
+
+/**
+ * @brief send the aggregated throughput of the streams of all shoes to the serial port. This is
+ * used to verify that the central sustains the sample rate of all subjects.
+ * order of data: subjects, connected shoes, throughput [samples/s], throughput [bytes/s], dropped
+ * packets
+ * @example
+ * <1,75,1,2,4,2000,27200,0>
+ *
+ */
+void SendStreamThroughputToPC(const uint32_t elapsed_ms) {
+  uint32_t samples = 0, bytes = 0, dropped_packets = 0;
+  uint8_t connected_shoes = 0;
+  for (const auto &state : shoes) {
+    const auto &statistics = state.stream_monitor.GetStatistics();
+    samples += statistics.samples;
+    bytes += statistics.bytes;
+    dropped_packets += statistics.dropped_packets;
+    connected_shoes += state.connected ? 1 : 0;
+  }
+  const uint32_t sample_rate =
+      (elapsed_ms > 0) ? (samples - stream_samples_total_old) * 1000 / elapsed_ms : 0;
+  const uint32_t throughput =
+      (elapsed_ms > 0) ? (bytes - stream_bytes_total_old) * 1000 / elapsed_ms : 0;
+  stream_samples_total_old = samples;
+  stream_bytes_total_old = bytes;
+  std::stringstream msg;
+  msg << "<" << String((int)communication::Devices::kGUI).c_str()
+      << communication::kMessageDelimiter
+      << String((int)communication::MessageTypes::kStreamThroughput).c_str()
+      << communication::kMessageDelimiter << "1" << communication::kMessageDelimiter
+      << String((int)settings::global::defaults::kNumberOfSubjects).c_str()
+      << communication::kMessageDelimiter << String((int)connected_shoes).c_str()
+      << communication::kMessageDelimiter << String(sample_rate).c_str()
+      << communication::kMessageDelimiter << String(throughput).c_str()
+      << communication::kMessageDelimiter << String(dropped_packets).c_str() << ">";
+  Serial.println(msg.str().c_str());
+#ifdef SENSINT_DEBUG
+  debug::Log("SendStreamThroughputToPC", String((int)connected_shoes) + " shoes | " +
+                                             String(sample_rate) + " samples/s | " +
+                                             String(throughput) + " B/s");
+#endif  // SENSINT_DEBUG
 }
 
 }  // namespace
@@ -762,6 +798,7 @@ void setup() {
 #endif  // SENSINT_DEBUG
   SetupBLECallbacks();
   SetupBLEServer();
+  SetupSettingsRegistry();
   SetupBLEData();
   ResetAllTimer();
 }
@@ -775,15 +812,41 @@ void loop() {
   if (ble_connected_devices != ble_server.connection_cb_.connected_devices_) {
     ble_connected_devices = ble_server.connection_cb_.connected_devices_;
     // broadcast current settings to all connected devices
-    HandleRemoteSettingsUpdate(true);
+    settings_registry.MarkAll();
 #ifdef SENSINT_DEBUG
     debug::Log("loop", "connected devices: " + String(ble_connected_devices));
 #endif  // SENSINT_DEBUG
   }
 
-  // if (local::settings_changed && ble_connected_devices > 0) {
-  if (ble_connected_devices > 0) {
-    HandleRemoteSettingsUpdate();
+  // the changes since the last iteration are sent at once
+  if (settings_registry.IsDirty()) {
+    settings_registry.Flush();
+  }
+
+  for (uint8_t shoe = 0; shoe < global::defaults::kNumberOfShoes; shoe++) {
+    HandleSequenceAcknowledge(shoe);
+    HandleClockSync(shoe);
+    // the streams are drained continuously, the recording interval only affects SendShoeDataToPC
+    HandleShoeStream(shoe);
+  }
+
+  if (stream_statistics_update_time >= local::defaults::kStreamStatisticsIntervalMs) {
+    const uint32_t elapsed_ms = stream_statistics_update_time;
+    stream_statistics_update_time = 0;
+    if (local::recording_status == static_cast<uint32_t>(RecordingStatus::kRecording)) {
+      for (uint8_t shoe = 0; shoe < global::defaults::kNumberOfShoes; shoe++) {
+        SendStreamStatisticsToPC(shoe, elapsed_ms);
+      }
+      SendStreamThroughputToPC(elapsed_ms);
+    } else {
+      stream_samples_total_old = 0;
+      stream_bytes_total_old = 0;
+      for (auto &state : shoes) {
+        state.stream_bytes_old = state.stream_monitor.GetStatistics().bytes;
+        stream_samples_total_old += state.stream_monitor.GetStatistics().samples;
+        stream_bytes_total_old += state.stream_bytes_old;
+      }
+    }
   }
 
   if (recording_update_time >= local::recording_interval) {
@@ -791,10 +854,13 @@ void loop() {
     if (local::recording_status == static_cast<uint32_t>(RecordingStatus::kRecording) &&
         ble_connected_devices > 0) {
       // HandleTrackingUpdate();
-      HandleLeftShoeUpdate();
-      HandleRightShoeUpdate();
+      for (uint8_t shoe = 0; shoe < global::defaults::kNumberOfShoes; shoe++) {
+        HandleShoeUpdate(shoe);
+      }
       // SendTrackingDataToPC();
-      SendShoeDataToPC();
+      for (uint8_t subject = 0; subject < global::defaults::kNumberOfSubjects; subject++) {
+        SendShoeDataToPC(subject);
+      }
     }
   }
 }
@@ -0,0 +1,125 @@
+#include "settings_registry.h"
+
+#ifdef SENSINT_DEBUG
+#include <debug.h>
+#endif  // SENSINT_DEBUG
+
+namespace sensint {
+namespace settings {
+
+SettingsRegistry::SettingsRegistry() {}
+
+SettingsRegistry::~SettingsRegistry() {}
+
+void SettingsRegistry::Register(const SettingId id, const char *name, bool *value,
+                                BLECharacteristic *characteristic,
+                                ble::BleBooleanCallback &callback) {
+  Register(id, name, SettingType::kBoolean, value, characteristic);
+  callback.dirty_ = {.mask = &dirty_, .bit = GetBit(id)};
+}
+
+void SettingsRegistry::Register(const SettingId id, const char *name, uint8_t *value,
+                                BLECharacteristic *characteristic,
+                                ble::BleUInteger8Callback &callback) {
+  Register(id, name, SettingType::kUInteger8, value, characteristic);
+  callback.dirty_ = {.mask = &dirty_, .bit = GetBit(id)};
+}
+
+void SettingsRegistry::Register(const SettingId id, const char *name, uint32_t *value,
+                                BLECharacteristic *characteristic,
+                                ble::BleUInteger32Callback &callback) {
+  Register(id, name, SettingType::kUInteger32, value, characteristic);
+  callback.dirty_ = {.mask = &dirty_, .bit = GetBit(id)};
+}
+
+void SettingsRegistry::Register(const SettingId id, const char *name, const SettingType type,
+                                void *value, BLECharacteristic *characteristic) {
+  auto &setting = settings_[static_cast<size_t>(id)];
+  setting.name = name;
+  setting.type = type;
+  setting.value = value;
+  setting.characteristic = characteristic;
+  registered_ |= GetBit(id);
+}
+
+bool SettingsRegistry::Set(const SettingId id, const uint32_t value) {
+  if (!(registered_ & GetBit(id))) {
+    return false;
+  }
+  auto &setting = settings_[static_cast<size_t>(id)];
+  bool changed = false;
+  switch (setting.type) {
+    case SettingType::kBoolean: {
+      auto &current = *static_cast<bool *>(setting.value);
+      changed = current != (value != 0);
+      current = (value != 0);
+      break;
+    }
+    case SettingType::kUInteger8: {
+      auto &current = *static_cast<uint8_t *>(setting.value);
+      changed = current != static_cast<uint8_t>(value);
+      current = static_cast<uint8_t>(value);
+      break;
+    }
+    case SettingType::kUInteger32: {
+      auto &current = *static_cast<uint32_t *>(setting.value);
+      changed = current != value;
+      current = value;
+      break;
+    }
+  }
+  if (changed) {
+    dirty_.fetch_or(GetBit(id), std::memory_order_release);
+  }
+  return true;
+}
+
+void SettingsRegistry::MarkAll() { dirty_.fetch_or(registered_, std::memory_order_release); }
+
+bool SettingsRegistry::IsDirty() const { return dirty_.load(std::memory_order_relaxed) != 0; }
+
+/**
+ * The bit of a setting is cleared right before its value is read, i.e. only the bits of the
+ * settings that were dirty when the flush started. A change that happens during the flush marks
+ * its bit again and is sent with the next flush, unless its value was not read yet.
+ */
+size_t SettingsRegistry::Flush() {
+  uint32_t dirty = dirty_.load(std::memory_order_acquire) & registered_;
+  size_t notified = 0;
+  while (dirty) {
+    const size_t index = __builtin_ctz(dirty);
+    dirty &= dirty - 1;
+    dirty_.fetch_and(~(1UL << index), std::memory_order_acquire);
+    const auto &setting = settings_[index];
+    if (!setting.characteristic) {
+      continue;
+    }
+    // the values are sent with 4 bytes, as the connected devices expect
+    uint32_t tmp = GetValue(setting);
+    setting.characteristic->setValue(tmp);
+    setting.characteristic->notify();
+    notified++;
+#ifdef SENSINT_DEBUG
+    debug::Log("SettingsRegistry::Flush",
+               String(setting.name) + " [" + String(index) + "]: " + String(tmp));
+#endif  // SENSINT_DEBUG
+  }
+  return notified;
+}
+
+uint32_t SettingsRegistry::GetBit(const SettingId id) { return 1UL << static_cast<uint32_t>(id); }
+
+uint32_t SettingsRegistry::GetValue(const Setting &setting) const {
+  switch (setting.type) {
+    case SettingType::kBoolean:
+      return *static_cast<const bool *>(setting.value) ? 1 : 0;
+    case SettingType::kUInteger8:
+      return *static_cast<const uint8_t *>(setting.value);
+    case SettingType::kUInteger32:
+      return *static_cast<const uint32_t *>(setting.value);
+  }
+  return 0;
+}
+
+}  // namespace settings
+}  // namespace sensint
@@ -3,66 +3,60 @@
 
 // include system headers
 #include <Arduino.h>
+#include <Preferences.h>
+
+#include <atomic>
 
 // include library headers
 #include "BLEDevice.h"
 
 // include shared libraries
 #include <ble_config.h>
+#include <ble_link.h>
+#include <ble_stream.h>
+#include <clock_sync.h>
 #include <debug.h>
 #include <global_settings.h>
+#include <stream_transport.h>
 
 // include project headers
 #include "local_settings.h"
+#include "pipeline.h"
 
 namespace sensint {
 namespace ble {
 namespace client {
 
-static BLEAdvertisedDevice* device;
+static BLEClient* client = nullptr;
+
+/**
+ * @brief The address of the server is cached in RAM and in the NVS after the first connection. It
+ * is used to connect directly after a disconnect (or a restart) without scanning first.
+ */
+struct PeerAddress {
+  esp_bd_addr_t address;
+  uint8_t type;
+};
+static PeerAddress peer_address;
+static constexpr const char* kStorageNamespace = "ble_client";
+static constexpr const char* kStorageKey = "peer";
 
 static BLEUUID service_UUID(config::kServiceUUID);
 
-static BLEUUID data_selection_char_UUID(config::characteristics::kTrackingDataSelection.uuid);
 static BLERemoteCharacteristic* data_selection_char;
-
-static BLEUUID recording_status_char_UUID(config::characteristics::kRecordingStatus.uuid);
 static BLERemoteCharacteristic* recording_status_char;
-
-static BLEUUID recording_interval_char_UUID(config::characteristics::kRecordingInterval.uuid);
 static BLERemoteCharacteristic* recording_interval_char;
-
-static BLEUUID augmentation_active_UUID(config::characteristics::kAugmentationActive.uuid);
 static BLERemoteCharacteristic* augmentation_active_char;
-
-static BLEUUID imu_reinitialize_char_UUID(config::characteristics::kIMUReinitialize.uuid);
 static BLERemoteCharacteristic* imu_reinitialize_char;
 
-#if SENSINT_SHOE == 0 /* LEFT */
-static BLEUUID imu_UUID(config::characteristics::kLeftShoeIMU.uuid);
-static BLERemoteCharacteristic* imu_char;
-
-static BLEUUID connected_char_UUID(config::characteristics::kLeftShoeConnected.uuid);
+// the characteristics of the shoe group that belongs to this shoe's subject and side
 static BLERemoteCharacteristic* connected_char;
-
-static BLEUUID sensor_char_UUID(config::characteristics::kLeftShoeSensorData.uuid);
-static BLERemoteCharacteristic* sensor_char;
-
-static BLEUUID sequence_char_UUID(config::characteristics::kLeftShoeSequence.uuid);
 static BLERemoteCharacteristic* sequence_char;
-#else   /* RIGHT */
-static BLEUUID imu_UUID(config::characteristics::kLeftShoeIMU.uuid);
-static BLERemoteCharacteristic* imu_char;
-
-static BLEUUID connected_char_UUID(config::characteristics::kRightShoeConnected.uuid);
-static BLERemoteCharacteristic* connected_char;
-
-static BLEUUID sensor_char_UUID(config::characteristics::kRightShoeSensorData.uuid);
-static BLERemoteCharacteristic* sensor_char;
+static BLERemoteCharacteristic* stream_char;
+static BLERemoteCharacteristic* timestamp_char;
 
-static BLEUUID sequence_char_UUID(config::characteristics::kRightShoeSequence.uuid);
-static BLERemoteCharacteristic* sequence_char;
-#endif  // SENSINT_SHOE
+// the payload of a single write without response (negotiated MTU - ATT header)
+static size_t stream_packet_size = stream::kMinPacketSize;
 
 static void NotifyRecordingStatusCallback(BLERemoteCharacteristic* remote_characteristic,
                                           uint8_t* data, size_t length, bool is_notify) {
@@ -88,8 +82,11 @@ static void NotifyAugmentationActiveCallback(BLERemoteCharacteristic* remote_cha
 #ifdef SENSINT_DEBUG
   debug::Log("NotifyAugmentationActiveCallback", String(tmp), debug::DebugLevel::verbose);
 #endif  // SENSINT_DEBUG
-  settings::local::augmentation_active = tmp;
-  settings::local::augmentation_active_changed = true;
+  pipeline::Message message;
+  message.timestamp_us = micros();
+  message.type = pipeline::MessageType::kAugmentationActive;
+  message.payload.value = tmp ? 1 : 0;
+  pipeline::generator_queue.Push(message);
 }
 
 static void NotifyDataSelectionCallback(BLERemoteCharacteristic* remote_characteristic,
@@ -107,8 +104,11 @@ static void NotifySequenceCallback(BLERemoteCharacteristic* remote_characteristi
 #ifdef SENSINT_DEBUG
   debug::Log("NotifySequenceCallback", String(tmp), debug::DebugLevel::verbose);
 #endif  // SENSINT_DEBUG
-  settings::local::sequence = tmp;
-  settings::local::sequence_changed = true;
+  pipeline::Message message;
+  message.timestamp_us = micros();
+  message.type = pipeline::MessageType::kSequence;
+  message.payload.value = tmp;
+  pipeline::generator_queue.Push(message);
 }
 
 static void NotifyIMUReinitializeCallback(BLERemoteCharacteristic* remote_characteristic,
@@ -120,154 +120,205 @@ static void NotifyIMUReinitializeCallback(BLERemoteCharacteristic* remote_charac
   settings::local::imu_reinitialize = (tmp == 1);
 }
 
-static boolean do_connect = false;
-static boolean connected = false;
-static boolean do_scan = false;
-
-class ClientConnectionCallback : public BLEClientCallbacks {
-  void onConnect(BLEClient* client) { client->setMTU(settings::global::defaults::kMTU); }
-  void onDisconnect(BLEClient* client) { connected = false; }
-};
-
-bool ConnectToServer() {
-  BLEClient* client = BLEDevice::createClient();
-  client->setClientCallbacks(new ClientConnectionCallback());
-  client->connect(device);
-  BLERemoteService* remote_service = client->getService(service_UUID);
-  if (remote_service == nullptr) {
+// the sequence of the clock synchronization request that is waiting for its response
+static std::atomic<uint16_t> clock_sync_sequence{0};
+// the completed exchanges are passed from the BLE stack to the transport task
+static pipeline::SpscQueue<sync::ClockSyncExchange, 4> clock_sync_queue;
+
+static void NotifyClockSyncCallback(BLERemoteCharacteristic* remote_characteristic, uint8_t* data,
+                                    size_t length, bool is_notify) {
+  // the timestamp is taken first to keep the processing time out of the measurement
+  const uint32_t t4 = micros();
+  if (length != sizeof(sync::ClockSyncPacket)) {
+    return;
+  }
+  sync::ClockSyncPacket packet;
+  memcpy(&packet, data, sizeof(sync::ClockSyncPacket));
+  // late responses of previous requests are ignored
+  if (packet.sequence != clock_sync_sequence) {
 #ifdef SENSINT_DEBUG
-    sensint::debug::Log("ConnectToServer", __LINE__, "[ERR] failed to connect to service");
+    debug::Log("NotifyClockSyncCallback", "stale response " + String(packet.sequence),
+               debug::DebugLevel::verbose);
 #endif  // SENSINT_DEBUG
-    client->disconnect();
-    return false;
+    return;
   }
+  clock_sync_queue.Push({.t1 = packet.t1, .t2 = packet.t2, .t3 = packet.t3, .t4 = t4});
+}
 
-  /** connected
-   * this value will be send to the server
+// the flags are shared between the BLE stack and the transport task
+static std::atomic<bool> do_connect{false};
+static std::atomic<bool> connected{false};
+static std::atomic<bool> scanning{false};
+static std::atomic<bool> peer_cached{false};
+// the time of the last disconnect (or the start), used to measure the reconnect time
+static std::atomic<uint32_t> disconnected_ms{0};
+
+/**
+ * @brief Sends the stream packets via the stream characteristic of the shoe group.
+ */
+class BleStreamTransport : public transport::StreamTransport {
+ public:
+  bool IsConnected() const override { return connected; }
+  size_t GetPacketSize() const override { return stream_packet_size; }
+  /**
+   * @brief Send the packet without waiting for a response. Only if the negotiated MTU is too small
+   * for the packet, it is sent as (slower) long write with response.
    */
-  connected_char = remote_service->getCharacteristic(connected_char_UUID);
-  if (connected_char == nullptr) {
-#ifdef SENSINT_DEBUG
-    sensint::debug::Log("ConnectToServer", __LINE__, "[ERR] failed to connect to characteristic");
-#endif  // SENSINT_DEBUG
-    client->disconnect();
-    return false;
+  bool Send(const uint8_t* data, const size_t length) override {
+    const bool response = length > stream_packet_size;
+    stream_char->writeValue(const_cast<uint8_t*>(data), length, response);
+    return true;
   }
+  uint32_t ReadNextSample() override { return stream_char->readUInt32(); }
+};
+static BleStreamTransport stream_transport;
 
-  /** recording status
-   * Will be modified by the server. Hence we need to subscribe to it.
-   */
-  recording_status_char = remote_service->getCharacteristic(recording_status_char_UUID);
-  if (recording_status_char == nullptr) {
-#ifdef SENSINT_DEBUG
-    sensint::debug::Log("ConnectToServer", __LINE__, "[ERR] failed to connect to characteristic");
-#endif  // SENSINT_DEBUG
-    client->disconnect();
-    return false;
+class ClientConnectionCallback : public BLEClientCallbacks {
+  void onConnect(BLEClient* client) {
+    client->setMTU(settings::global::defaults::kMTU);
+    // as the central of the connection, the link parameters are applied right away
+    RequestLinkParameters(*client->getPeerAddress().getNative(),
+                          settings::global::defaults::kLinkParameters);
   }
-  if (recording_status_char->canNotify()) {
-    recording_status_char->registerForNotify(NotifyRecordingStatusCallback);
+  void onDisconnect(BLEClient* client) {
+    connected = false;
+    disconnected_ms = millis();
   }
+};
 
-  /** IMU data selection
-   * Will be modified by the server. Hence we need to subscribe to it.
-   */
-  data_selection_char = remote_service->getCharacteristic(data_selection_char_UUID);
-  if (data_selection_char == nullptr) {
-#ifdef SENSINT_DEBUG
-    sensint::debug::Log("ConnectToServer", __LINE__, "[ERR] failed to connect to characteristic");
-#endif  // SENSINT_DEBUG
-    client->disconnect();
+using NotifyCallback = void (*)(BLERemoteCharacteristic*, uint8_t*, size_t, bool);
+
+/**
+ * @brief Binds a characteristic of the table in ble_config.h to the remote characteristic of the
+ * client and the callback for its notifications (nullptr: not subscribed).
+ */
+struct RemoteCharacteristicBinding {
+  const BleCharacteristicDescription* description;
+  BLERemoteCharacteristic** remote_characteristic;
+  NotifyCallback callback;
+};
+
+// the characteristics of the server that are used by the shoe
+static constexpr RemoteCharacteristicBinding kRemoteCharacteristics[] = {
+    {&config::characteristics::GetShoeCharacteristic(
+         config::characteristics::ShoeCharacteristic::kConnected, settings::local::defaults::kShoe),
+     &connected_char, nullptr},
+    {&config::characteristics::GetCharacteristic(
+         config::characteristics::Characteristic::kRecordingStatus),
+     &recording_status_char, NotifyRecordingStatusCallback},
+    {&config::characteristics::GetCharacteristic(
+         config::characteristics::Characteristic::kTrackingDataSelection),
+     &data_selection_char, NotifyDataSelectionCallback},
+    {&config::characteristics::GetCharacteristic(
+         config::characteristics::Characteristic::kRecordingInterval),
+     &recording_interval_char, NotifyRecordingIntervalCallback},
+    {&config::characteristics::GetCharacteristic(
+         config::characteristics::Characteristic::kAugmentationActive),
+     &augmentation_active_char, NotifyAugmentationActiveCallback},
+    {&config::characteristics::GetShoeCharacteristic(
+         config::characteristics::ShoeCharacteristic::kSequence, settings::local::defaults::kShoe),
+     &sequence_char, NotifySequenceCallback},
+    {&config::characteristics::GetCharacteristic(
+         config::characteristics::Characteristic::kIMUReinitialize),
+     &imu_reinitialize_char, NotifyIMUReinitializeCallback},
+    // the samples are sent as packets (write without response)
+    {&config::characteristics::GetShoeCharacteristic(
+         config::characteristics::ShoeCharacteristic::kStream, settings::local::defaults::kShoe),
+     &stream_char, nullptr},
+    // the clock synchronization requests are answered via notifications
+    {&config::characteristics::GetShoeCharacteristic(
+         config::characteristics::ShoeCharacteristic::kTimestamp, settings::local::defaults::kShoe),
+     &timestamp_char, NotifyClockSyncCallback}};
+
+bool LoadPeerAddress() {
+  Preferences storage;
+  if (!storage.begin(kStorageNamespace, true)) {
     return false;
   }
-  if (data_selection_char->canNotify()) {
-    data_selection_char->registerForNotify(NotifyDataSelectionCallback);
+  if (storage.getBytesLength(kStorageKey) == sizeof(PeerAddress)) {
+    peer_cached =
+        storage.getBytes(kStorageKey, &peer_address, sizeof(PeerAddress)) == sizeof(PeerAddress);
   }
+  storage.end();
+  return peer_cached;
+}
 
-  /** recording interval
-   * Will be modified by the server. Hence we need to subscribe to it.
-   */
-  recording_interval_char = remote_service->getCharacteristic(recording_interval_char_UUID);
-  if (recording_interval_char == nullptr) {
-#ifdef SENSINT_DEBUG
-    sensint::debug::Log("ConnectToServer", __LINE__, "[ERR] failed to connect to characteristic");
-#endif  // SENSINT_DEBUG
-    client->disconnect();
+/**
+ * @brief Store the address of the server in the NVS. The flash is only written if the address
+ * changed (i.e. after connecting to a new server).
+ */
+bool SavePeerAddress() {
+  Preferences storage;
+  if (!storage.begin(kStorageNamespace, false)) {
     return false;
   }
-  if (recording_interval_char->canNotify()) {
-    recording_interval_char->registerForNotify(NotifyRecordingIntervalCallback);
+  PeerAddress stored;
+  if (storage.getBytesLength(kStorageKey) == sizeof(PeerAddress) &&
+      storage.getBytes(kStorageKey, &stored, sizeof(PeerAddress)) == sizeof(PeerAddress) &&
+      memcmp(&stored, &peer_address, sizeof(PeerAddress)) == 0) {
+    storage.end();
+    return true;
   }
+  auto written = storage.putBytes(kStorageKey, &peer_address, sizeof(PeerAddress));
+  storage.end();
+  return written == sizeof(PeerAddress);
+}
 
-  /** augmentation active
-   * Will be modified by the server. Hence we need to subscribe to it.
-   */
-  augmentation_active_char = remote_service->getCharacteristic(augmentation_active_UUID);
-  if (augmentation_active_char == nullptr) {
+/**
+ * @brief Connect to the cached address of the server and discover the characteristics.
+ *
+ * //! The client is reused for every connection. The remote services of the client are cleared by
+ * //! the BLE library on every connect, hence the characteristics are discovered again. All
+ * //! characteristics of the service are retrieved with the first lookup.
+ */
+bool ConnectToServer() {
+  if (!peer_cached) {
+    return false;
+  }
+  if (!client->connect(BLEAddress(peer_address.address),
+                       static_cast<esp_ble_addr_type_t>(peer_address.type))) {
 #ifdef SENSINT_DEBUG
-    sensint::debug::Log("ConnectToServer", __LINE__, "[ERR] failed to connect to characteristic");
+    sensint::debug::Log("ConnectToServer", __LINE__, "[ERR] failed to connect to server");
 #endif  // SENSINT_DEBUG
-    client->disconnect();
     return false;
   }
-  if (augmentation_active_char->canNotify()) {
-    augmentation_active_char->registerForNotify(NotifyAugmentationActiveCallback);
-  }
-
-  /** sequence selection
-   * Will be modified by the server. Hence we need to subscribe to it.
-   */
-  sequence_char = remote_service->getCharacteristic(sequence_char_UUID);
-  if (sequence_char == nullptr) {
+  BLERemoteService* remote_service = client->getService(service_UUID);
+  if (remote_service == nullptr) {
 #ifdef SENSINT_DEBUG
-    sensint::debug::Log("ConnectToServer", __LINE__, "[ERR] failed to connect to characteristic");
+    sensint::debug::Log("ConnectToServer", __LINE__, "[ERR] failed to connect to service");
 #endif  // SENSINT_DEBUG
     client->disconnect();
     return false;
   }
-  if (sequence_char->canNotify()) {
-    sequence_char->registerForNotify(NotifySequenceCallback);
-  }
 
-  /** IMU
-   * Will be send to the server.
-   */
-  imu_char = remote_service->getCharacteristic(imu_UUID);
-  if (imu_char == nullptr) {
+  for (const auto& binding : kRemoteCharacteristics) {
+    auto remote_characteristic = remote_service->getCharacteristic(binding.description->uuid);
+    if (remote_characteristic == nullptr) {
 #ifdef SENSINT_DEBUG
-    sensint::debug::Log("ConnectToServer", __LINE__, "[ERR] failed to connect to characteristic");
+      sensint::debug::Log("ConnectToServer", __LINE__,
+                          "[ERR] failed to connect to characteristic " +
+                              String(binding.description->user_description));
 #endif  // SENSINT_DEBUG
-    client->disconnect();
-    return false;
+      client->disconnect();
+      return false;
+    }
+    if (binding.callback && remote_characteristic->canNotify()) {
+      remote_characteristic->registerForNotify(binding.callback);
+    }
+    *binding.remote_characteristic = remote_characteristic;
   }
 
-  /** IMU reinitialize
-   * Will be modified by the server. Hence we need to subscribe to it.
-   */
-  imu_reinitialize_char = remote_service->getCharacteristic(imu_reinitialize_char_UUID);
-  if (imu_reinitialize_char == nullptr) {
+  // the MTU was negotiated while discovering the service
+  stream_packet_size = client->getMTU() - stream::kAttHeaderSize;
 #ifdef SENSINT_DEBUG
-    sensint::debug::Log("ConnectToServer", __LINE__, "[ERR] failed to connect to characteristic");
+  sensint::debug::Log("ConnectToServer", "stream packet size: " + String(stream_packet_size));
 #endif  // SENSINT_DEBUG
-    client->disconnect();
-    return false;
-  }
-  if (imu_reinitialize_char->canNotify()) {
-    imu_reinitialize_char->registerForNotify(NotifyIMUReinitializeCallback);
-  }
 
-  /** sensor data
-   * Will be send to the server.
-   */
-  sensor_char = remote_service->getCharacteristic(sensor_char_UUID);
-  if (sensor_char == nullptr) {
+  if (!SavePeerAddress()) {
 #ifdef SENSINT_DEBUG
-    sensint::debug::Log("ConnectToServer", __LINE__, "[ERR] failed to connect to characteristic");
+    sensint::debug::Log("ConnectToServer", __LINE__, "[ERR] failed to store the server address");
 #endif  // SENSINT_DEBUG
-    client->disconnect();
-    return false;
   }
-
   connected = true;
   return true;
 }
@@ -277,22 +328,50 @@ class AdvertisedDeviceCallbacks : public BLEAdvertisedDeviceCallbacks {
     if (advertised_device.haveServiceUUID() &&
         advertised_device.isAdvertisingService(service_UUID)) {
       BLEDevice::getScan()->stop();
-      device = new BLEAdvertisedDevice(advertised_device);
+      memcpy(peer_address.address, *advertised_device.getAddress().getNative(),
+             ESP_BD_ADDR_LEN);
+      peer_address.type = advertised_device.getAddressType();
+      peer_cached = true;
+      // the callback of a stopped scan is not called
+      scanning = false;
       do_connect = true;
-      do_scan = true;
     }
   }
 };
 
+static void ScanCompleteCallback(BLEScanResults results) { scanning = false; }
+
+/**
+ * @brief Start a scan for the server in the background. The scan ends when the server is found or
+ * after kScanDurationS.
+ */
+bool StartScan() {
+  if (scanning) {
+    return true;
+  }
+  scanning = true;
+  BLEScan* BLE_scan = BLEDevice::getScan();
+  BLE_scan->clearResults();
+  if (!BLE_scan->start(settings::local::tasks::kScanDurationS, ScanCompleteCallback, false)) {
+    scanning = false;
+    return false;
+  }
+  return true;
+}
+
 void Init() {
   BLEDevice::init(settings::local::defaults::kBLEDeviceName);
   BLEDevice::setMTU(settings::global::defaults::kMTU);
+  client = BLEDevice::createClient();
+  client->setClientCallbacks(new ClientConnectionCallback());
   BLEScan* BLE_scan = BLEDevice::getScan();
   BLE_scan->setAdvertisedDeviceCallbacks(new AdvertisedDeviceCallbacks());
   BLE_scan->setInterval(1349);
   BLE_scan->setWindow(449);
   BLE_scan->setActiveScan(true);
-  BLE_scan->start(5, false);
+  // the connection is established by the transport task
+  LoadPeerAddress();
+  disconnected_ms = millis();
 }
 
 }  // namespace client
@@ -5,6 +5,7 @@
 #include <types.h>
 
 #include <array>
+#include <atomic>
 
 #ifdef PICO
 #include <pixeltypes.h>
@@ -14,10 +15,19 @@ namespace sensint {
 namespace settings {
 namespace local {
 namespace defaults {
+// the subject (i.e. the pair of shoes) this shoe belongs to
+#ifdef SENSINT_SUBJECT
+static constexpr uint8_t kSubject = SENSINT_SUBJECT;
+#else
+static constexpr uint8_t kSubject = 0;
+#endif  // SENSINT_SUBJECT
+// the slot of this shoe on the central (see GetShoeIndex in ble_config.h)
+static constexpr uint8_t kShoe = 2 * kSubject + SENSINT_SHOE;
+
 #if SENSINT_SHOE == 0
-static const std::string kBLEDeviceName = "senSInt Shoe left";
+static const std::string kBLEDeviceName = "senSInt Shoe left " + std::to_string(kSubject);
 #else
-static const std::string kBLEDeviceName = "senSInt Shoe right";
+static const std::string kBLEDeviceName = "senSInt Shoe right " + std::to_string(kSubject);
 #endif  // SENSINT_SHOE
 
 static constexpr uint32_t kLogIntervalMs = 2000;
@@ -31,22 +41,56 @@ static constexpr uint8_t kSequence = 0;
 
 }  // namespace defaults
 
-static uint32_t log_interval_ms = defaults::kLogIntervalMs;
+// these settings are written by the BLE stack and read by the sensor acquisition task
+static std::atomic<uint32_t> log_interval_ms{defaults::kLogIntervalMs};
 
-static RecordingStatus recording_status = RecordingStatus::kIdle;
+static std::atomic<RecordingStatus> recording_status{RecordingStatus::kIdle};
 
-static bool augmentation_active = defaults::kAugmentationActive;
-static bool augmentation_active_changed = false;
+static std::atomic<uint8_t> imu_data_selection{defaults::kIMUDataSelection};
+static std::atomic<bool> imu_reinitialize{defaults::kIMUReinitialize};
 
-static uint8_t imu_data_selection = defaults::kIMUDataSelection;
-static bool imu_reinitialize = defaults::kIMUReinitialize;
+// these settings are owned by the generator control task and changed via the generator_queue
+static bool augmentation_active = defaults::kAugmentationActive;
 
 // I2C addresses for the signal generators (slaves)
 static const communication::Devices i2c_slave_vertical = communication::Devices::kPD1;
 static const communication::Devices i2c_slave_horizontal = communication::Devices::kPD2;
 
 static uint8_t sequence = defaults::kSequence;
-static bool sequence_changed = false;
+
+namespace tasks {
+// The BLE stack runs on core 0 and the Arduino loop on core 1. The time critical sensor acquisition
+// and generator control are kept away from the BLE stack.
+static constexpr int8_t kSensorCore = 1;
+static constexpr int8_t kGeneratorCore = 1;
+static constexpr int8_t kTransportCore = 0;
+// the stack size is given in bytes
+static constexpr uint32_t kSensorStackSize = 4096;
+static constexpr uint32_t kGeneratorStackSize = 4096;
+static constexpr uint32_t kTransportStackSize = 8192;
+// the Arduino loop task has priority 1
+static constexpr uint8_t kSensorPriority = 3;
+static constexpr uint8_t kGeneratorPriority = 2;
+static constexpr uint8_t kTransportPriority = 2;
+static constexpr uint32_t kSensorPeriodMs = 1;
+static constexpr uint32_t kGeneratorPeriodMs = 2;
+static constexpr uint32_t kTransportPeriodMs = 1;
+// the duration of a single BLE scan, which runs in the background
+static constexpr uint32_t kScanDurationS = 5;
+// the cached address of the server is connected directly this often before scanning
+static constexpr uint8_t kDirectConnectAttempts = 2;
+static constexpr uint32_t kTelemetryIntervalMs = 5000;
+// the maximum time a sample waits for further samples before the (partial) packet is sent
+static constexpr uint32_t kStreamFlushIntervalMs = 20;
+// the number of full packets that are sent per step while samples are pending (e.g. the backfill
+// after a reconnect)
+static constexpr size_t kStreamBackfillPacketsPerStep = 4;
+// the samples are held back after a connect until the clock is synchronized or the timeout elapsed
+static constexpr uint32_t kStreamSyncTimeoutMs = 1000;
+// the clock synchronization is repeated faster until the first estimate is available
+static constexpr uint32_t kClockSyncIntervalMs = 1000;
+static constexpr uint32_t kClockSyncFastIntervalMs = 100;
+}  // namespace tasks
 
 #ifdef SENSINT_PARALLEL_DATA
 namespace pins {
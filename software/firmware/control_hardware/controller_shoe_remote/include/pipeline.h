@@ -0,0 +1,56 @@
+#ifndef __SENSINT_PIPELINE_H__
+#define __SENSINT_PIPELINE_H__
+
+#include <pipeline_message.h>
+#include <sample_ring.h>
+#include <spsc_queue.h>
+
+namespace sensint {
+namespace pipeline {
+
+/**
+ * @brief The firmware is split into three tasks that are connected by lock-free queues:
+ *   - sensor acquisition: reads the IMU and the pressure sensors (via I2C)
+ *   - generator control: forwards control messages to the signal generators (via I2C or GPIO)
+ *   - BLE transport: handles the BLE connection and sends the sensor data to the server
+ *
+ *   [sensor] --sample_ring-----> [BLE] --generator_queue--> [generator]
+ *            --transport_queue-->   ^                              |
+ *                                   +------acknowledge_queue-------+
+ *
+ * The samples are recorded in the sample_ring, which keeps them while the BLE link is down or
+ * congested. The transport task sends them in order as soon as the link is available again. The
+ * other messages of the sensor task (e.g. a reinitialized IMU) are passed via the transport_queue.
+ * The BLE notifications are received in the context of the BLE stack, which is the only producer
+ * of the generator_queue. The generator control acknowledges applied commands via the
+ * acknowledge_queue, so that the server can measure the round trip time.
+ *
+ * The I2C bus (SENSINT_I2C) is shared by two tasks: the sensor acquisition reads the pressure
+ * sensors (ReadFromI2C), and the generator control writes to the signal generators
+ * (ForwardMessageUnicast, called by HandleSerial). Both run on core 1 with different priorities,
+ * i.e. the sensor task may preempt the generator task in the middle of a message. This relies on
+ * the lock of the arduino-esp32 Wire HAL, which is held from beginTransmission to endTransmission
+ * and during requestFrom. A message that is split into several packets is not atomic, but every
+ * packet is a complete transaction to its generator, hence an interleaved read does not corrupt
+ * it. The received bytes are read from the buffer of Wire after the lock was released, which is
+ * safe, because the sensor task is the only reader and it is not preempted by the generator task.
+ * Wire must not be built with CONFIG_DISABLE_HAL_LOCKS, and a new user of the bus in another task
+ * has to keep these rules.
+ */
+static constexpr size_t kTransportQueueSize = 64;
+static constexpr size_t kGeneratorQueueSize = 16;
+static constexpr size_t kAcknowledgeQueueSize = 8;
+// the number of samples (48 bytes each) in the PSRAM or in the RAM if there is no PSRAM
+static constexpr size_t kSampleRingSizeExternal = 16384;
+static constexpr size_t kSampleRingSizeInternal = 1024;
+
+// the queues and the sample ring are defined once in main.cpp
+extern SpscQueue<Message, kTransportQueueSize> transport_queue;
+extern SpscQueue<Message, kGeneratorQueueSize> generator_queue;
+extern SpscQueue<Message, kAcknowledgeQueueSize> acknowledge_queue;
+extern SampleRing sample_ring;
+
+}  // namespace pipeline
+}  // namespace sensint
+
+#endif  // __SENSINT_PIPELINE_H__
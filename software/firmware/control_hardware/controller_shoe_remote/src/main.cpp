@@ -1,4 +1,5 @@
 // include std headers
+#include <atomic>
 #include <string>
 #include <vector>
 
@@ -12,18 +13,34 @@
 #endif  // PICO
 
 // include shared libraries
+#include <ble_stream.h>
 #include <build.h>
+#include <clock_sync.h>
 #include <communication.h>
 #include <debug.h>
 #include <global_settings.h>
 #include <helper.h>
 #include <i2c.h>
 #include <imu/bno055.h>
+#include <imu/bno055_raw.h>
+#include <pipeline_task.h>
+#include <stream_sender.h>
+#include <stream_transport.h>
 #include <types.h>
 
 // include project headers
 #include "ble_client.h"
 #include "local_settings.h"
+#include "pipeline.h"
+
+namespace sensint {
+namespace pipeline {
+SpscQueue<Message, kTransportQueueSize> transport_queue;
+SpscQueue<Message, kGeneratorQueueSize> generator_queue;
+SpscQueue<Message, kAcknowledgeQueueSize> acknowledge_queue;
+SampleRing sample_ring;
+}  // namespace pipeline
+}  // namespace sensint
 
 // !Declare variables in unnamed namespace to prevent name clashes with other files.
 namespace {
@@ -32,19 +49,51 @@ using namespace sensint;
 elapsedMillis last_log_update_ms;
 elapsedMillis imu_time_offset_ms;
 elapsedMillis fsr_time_offset_ms;
+elapsedMillis clock_sync_update_ms;
+elapsedMillis connection_age_ms;
+
+// the cached address of the server is tried first after a disconnect, scanning is the fallback
+uint8_t direct_connect_attempts = 0;
+bool connect_direct = false;
+// the time from the disconnect until the server accepted the connection again
+uint32_t reconnect_ms = 0;
+
+// the clock of the server is the common time base of both shoes (only used by the transport task)
+sync::ClockSync clock_sync;
+uint16_t clock_sync_sequence = 0;
+
+// the link the packets are sent with (see stream_transport.h)
+transport::StreamTransport *stream_transport = &ble::client::stream_transport;
+transport::StreamSenderConfig GetStreamSenderConfig() {
+  transport::StreamSenderConfig config;
+  config.flush_interval_ms = settings::local::tasks::kStreamFlushIntervalMs;
+  config.backfill_packets_per_step = settings::local::tasks::kStreamBackfillPacketsPerStep;
+  return config;
+}
+// the samples are packed into a single packet until it is full or kStreamFlushIntervalMs elapsed
+transport::StreamSender stream_sender(pipeline::sample_ring, *stream_transport, clock_sync,
+                                      GetStreamSenderConfig());
 
-sensor::BNO055 *imu;
+#if SENSINT_IMU_FUSION == 1
+sensor::BNO055Raw *imu = nullptr;
+#else
+sensor::BNO055 *imu = nullptr;
+#endif  // SENSINT_IMU_FUSION
+
+#ifdef SENSINT_DEBUG
+elapsedMillis last_telemetry_ms;
+#endif  // SENSINT_DEBUG
 
 #ifdef PICO
 CRGB led;
+// the color is set by all tasks but the LED is only updated by the loop (encoded as 0xRRGGBB)
+std::atomic<uint32_t> led_color{0};
 static constexpr uint8_t kButtonPin = 39;
 bool reset_pressed = false;
 #endif  // PICO
 
 std::string serialized_input_msg;
 
-union SerializableStruct<ImuData> imu_data_packet;
-
 /**
  * @brief sensor  mapping - each shoe has 4 pressure sensors with the
  * following configuration:
@@ -74,11 +123,6 @@ union SerializableStruct<ImuData> imu_data_packet;
  *   2. horizontal generator: [y] and [z]
  */
 
-// this is pressure sensor data from both generators (vertical and horizontal)
-// the data will be sent to PC
-union SerializableStruct<Vector4D<analog_sensor_t>> shoe_sensor_data_packet = {
-  .data = {.w = 0, .x = 0, .y = 0, .z = 0 }
-};
 // this is the pressure sensor data from a single generator (vertical or horizontal)
 // the data will be retrieved via I2C from the corresponding generator
 SerializableStruct<Vector2D<analog_sensor_t>> sensor_data_vertical = {.data = {.x = 0, .y = 0}};
@@ -96,6 +140,8 @@ inline void PrintConfig() __attribute__((always_inline));
 #ifdef PICO
 inline void SetupLED() __attribute__((always_inline));
 inline void SetupButton() __attribute__((always_inline));
+inline void SetLED(const CRGB &color) __attribute__((always_inline));
+inline void UpdateLED() __attribute__((always_inline));
 #endif  // PICO
 
 inline void SetupI2C() __attribute__((always_inline));
@@ -107,17 +153,48 @@ inline void ForwardMessageUnicast(const communication::Devices device_id, const
     __attribute__((always_inline));
 inline void ForwardMessageBroadcast(const std::string &msg) __attribute__((always_inline));
 inline void GetFSRData() __attribute__((always_inline));
-inline void SendFSRData() __attribute__((always_inline));
 #else
 inline void SetupControlPins() __attribute__((always_inline));
 inline void ConvertSequenceToBinary() __attribute__((always_inline));
 #endif  // SENSINT_PARALLEL_DATA
 
+#ifdef SENSINT_DEVELOPMENT
+inline void HandleSerial() __attribute__((always_inline));
+#endif  // SENSINT_DEVELOPMENT
+#ifdef SENSINT_DEBUG
+inline void PrintTelemetry() __attribute__((always_inline));
+#endif  // SENSINT_DEBUG
+
 inline void HandleMessage(const std::vector<std::string> &tokens) __attribute__((always_inline));
 inline void SetupIMU() __attribute__((always_inline));
+inline void ReinitializeIMU() __attribute__((always_inline));
+inline void HandleIMU() __attribute__((always_inline));
 inline void GetIMUData() __attribute__((always_inline));
-inline void SendIMUData() __attribute__((always_inline));
+inline void HandleStream() __attribute__((always_inline));
+inline void SendClockSyncRequest() __attribute__((always_inline));
+inline void HandleClockSync() __attribute__((always_inline));
 inline void HandleBLEConnection() __attribute__((always_inline));
+inline void HandleGeneratorMessage(const pipeline::Message &message) __attribute__((always_inline));
+inline void HandleTransportMessage(const pipeline::Message &message) __attribute__((always_inline));
+
+void SensorStep();
+void GeneratorStep();
+void TransportStep();
+
+pipeline::PipelineTask sensor_task("sensor", SensorStep, settings::local::tasks::kSensorPeriodMs,
+                                   settings::local::tasks::kSensorStackSize,
+                                   settings::local::tasks::kSensorPriority,
+                                   settings::local::tasks::kSensorCore);
+pipeline::PipelineTask generator_task("generator", GeneratorStep,
+                                      settings::local::tasks::kGeneratorPeriodMs,
+                                      settings::local::tasks::kGeneratorStackSize,
+                                      settings::local::tasks::kGeneratorPriority,
+                                      settings::local::tasks::kGeneratorCore);
+pipeline::PipelineTask transport_task("transport", TransportStep,
+                                      settings::local::tasks::kTransportPeriodMs,
+                                      settings::local::tasks::kTransportStackSize,
+                                      settings::local::tasks::kTransportPriority,
+                                      settings::local::tasks::kTransportCore);
 
 #ifdef SENSINT_DEVELOPMENT
 /**
@@ -142,6 +219,7 @@ void PrintConfig() {
   Log("debug level: " + String(SENSINT_DEBUG));
   Serial.println("--------------------------------------------");
   Log("shoe: " + String((SENSINT_SHOE == 0) ? "left" : "right"));
+  Log("subject: " + String(settings::local::defaults::kSubject));
   Log("i2c bus: " + String((SENSINT_WIRE == 0) ? "Wire" : "Wire1"));
 #ifdef SENSINT_PARALLEL_DATA
   Log("use parallel communication for control signals");
@@ -164,6 +242,16 @@ void SetupLED() {
 }
 
 void SetupButton() { pinMode(kButtonPin, INPUT); }
+
+void SetLED(const CRGB &color) { led_color = (color.r << 16) | (color.g << 8) | color.b; }
+
+void UpdateLED() {
+  const CRGB color(led_color.load());
+  if (color != led) {
+    led = color;
+    FastLED.show();
+  }
+}
 #endif  // PICO
 
 /**
@@ -180,11 +268,18 @@ void SetupI2C() {
 }
 
 void SetupIMU() {
-  imu = new sensor::BNO055();
+  // the IMU is allocated only once, a reinitialization is handled by ReinitializeIMU()
+  if (imu == nullptr) {
+#if SENSINT_IMU_FUSION == 1
+    imu = new sensor::BNO055Raw(sensor::IMU::kDefaultId, sensor::BNO055Raw::kDefaultAddress,
+                                SENSINT_IMU_RATE);
+#else
+    imu = new sensor::BNO055();
+#endif  // SENSINT_IMU_FUSION
+  }
   auto connected = imu->Init();
 #ifdef PICO
-  led = connected ? settings::local::colors::kImuConnected : settings::local::colors::kError;
-  FastLED.show();
+  SetLED(connected ? settings::local::colors::kImuConnected : settings::local::colors::kError);
 #endif  // PICO
 #ifdef SENSINT_DEBUG
   if (connected) {
@@ -195,6 +290,21 @@ void SetupIMU() {
 #endif  // SENSINT_DEBUG
 }
 
+/**
+ * @brief Reset the IMU's relative orientation without reallocating the device. If the IMU was not
+ * connected during setup, a full initialization is tried instead.
+ */
+void ReinitializeIMU() {
+  auto connected = imu->Reinitialize();
+#ifdef PICO
+  SetLED(connected ? settings::local::colors::kImuConnected : settings::local::colors::kError);
+#endif  // PICO
+#ifdef SENSINT_DEBUG
+  debug::Log("ReinitializeIMU",
+             connected ? "IMU reinitialized, the relative orientation was reset" : "No IMU");
+#endif  // SENSINT_DEBUG
+}
+
 #ifdef SENSINT_PARALLEL_DATA
 void SetupControlPins() {
   using namespace sensint::settings;
@@ -311,143 +421,208 @@ void HandleMessage(const std::vector<std::string> &tokens) {
   }
 }
 
+/**
+ * @brief Handle the IMU tasks that are independent of the log interval.
+ */
+void HandleIMU() {
+#if SENSINT_IMU_FUSION == 1
+  // the orientation filter runs independent of the log interval
+  imu->Poll();
+#else
+  // storing the calibration offsets resets the relative orientation, hence we only do this while
+  // no recording is running
+  if (settings::local::recording_status != sensint::RecordingStatus::kRecording &&
+      imu->HasPendingCalibration()) {
+#ifdef SENSINT_DEBUG
+    if (imu->StoreCalibration()) {
+      debug::Log("HandleIMU", "calibration stored, the relative orientation was reset");
+    }
+#else
+    imu->StoreCalibration();
+#endif  // SENSINT_DEBUG
+  }
+#endif  // SENSINT_IMU_FUSION
+}
+
 void GetIMUData() {
   using namespace sensint::sensor;
   using namespace sensint::settings;
+  pipeline::Message message;
+  message.timestamp_us = micros();
+  message.type = pipeline::MessageType::kImuData;
   imu->UpdateData(local::imu_data_selection);
   imu->SetTimeOffset(imu_time_offset_ms);
+  message.payload.imu = imu->GetData();
+  pipeline::sample_ring.Push(message);
 #ifdef SENSINT_DEBUG
   sensint::debug::Log("GetIMUData", "read IMU data", debug::DebugLevel::verbose);
   if (debug::kDebugLevel == debug::DebugLevel::verbose) {
-    PrintImuData(imu->GetData(), local::imu_data_selection);
+    PrintImuData(message.payload.imu, local::imu_data_selection);
   }
 #endif  // SENSINT_DEBUG
 }
 
-void SendIMUData() {
-  using namespace sensint::ble;
-  using namespace sensint::sensor;
-  using namespace sensint::settings;
-  if (!client::connected) {
-    return;
-  }
-  imu_data_packet.data = imu->GetData();
-  client::imu_char->writeValue((uint8_t *)&imu_data_packet.serialized, sizeof(ImuData));
-}
 
 #ifndef SENSINT_PARALLEL_DATA
 void GetFSRData() {
+  pipeline::Message message;
+  message.timestamp_us = micros();
+  message.type = pipeline::MessageType::kPressureData;
   ReadFromI2C(settings::local::i2c_slave_vertical, sensor_data_vertical.serialized,
               sizeof(sensor_data_vertical.serialized));
   ReadFromI2C(settings::local::i2c_slave_horizontal, sensor_data_horizontal.serialized,
               sizeof(sensor_data_horizontal.serialized));
-  shoe_sensor_data_packet.data.w = sensor_data_vertical.data.x;
-  shoe_sensor_data_packet.data.x = sensor_data_vertical.data.y;
-  shoe_sensor_data_packet.data.y = sensor_data_horizontal.data.x;
-  shoe_sensor_data_packet.data.z = sensor_data_horizontal.data.y;
+  message.payload.pressure.w = sensor_data_vertical.data.x;
+  message.payload.pressure.x = sensor_data_vertical.data.y;
+  message.payload.pressure.y = sensor_data_horizontal.data.x;
+  message.payload.pressure.z = sensor_data_horizontal.data.y;
+  pipeline::sample_ring.Push(message);
 #ifdef SENSINT_DEBUG
   if (debug::kDebugLevel == debug::DebugLevel::verbose) {
-    PrintVector4D(shoe_sensor_data_packet.data, false);
+    PrintVector4D(message.payload.pressure, false);
   }
 #endif  // SENSINT_DEBUG
 }
+#endif  // SENSINT_PARALLEL_DATA
 
-void SendFSRData() {
-  using namespace sensint::ble;
-  if (!client::connected) {
+/**
+ * @brief Send the recorded samples in order (see StreamSender). The samples are held back after a
+ * connect until the clock is synchronized or kStreamSyncTimeoutMs elapsed.
+ */
+void HandleStream() {
+  using namespace sensint::settings;
+  // the timestamps are only converted once the clock is synchronized
+  if (!clock_sync.IsSynchronized() && connection_age_ms < local::tasks::kStreamSyncTimeoutMs) {
     return;
   }
-  client::sensor_char->writeValue((uint8_t *)&shoe_sensor_data_packet.serialized,
-                                  sizeof(Vector4D<analog_sensor_t>));
+  stream_sender.Step(millis());
+}
+
+/**
+ * @brief Start a clock synchronization exchange with the server (write without response). The
+ * current estimate is included in the request to be reported to the PC.
+ */
+void SendClockSyncRequest() {
+  using namespace sensint::ble;
+  sync::ClockSyncPacket packet = {
+      .sequence = ++clock_sync_sequence,
+      .t1 = 0,
+      .t2 = 0,
+      .t3 = 0,
+      .synchronized = clock_sync.IsSynchronized() ? (uint8_t)1 : (uint8_t)0,
+      .offset_us = clock_sync.GetOffset(),
+      .drift_ppb = clock_sync.GetDriftPpb(),
+      .residual_us = clock_sync.GetResidual(),
+      .delay_us = clock_sync.GetDelay()};
+  client::clock_sync_sequence = clock_sync_sequence;
+  // the timestamp is taken last to keep the preparation out of the measurement
+  packet.t1 = micros();
+  client::timestamp_char->writeValue((uint8_t *)&packet, sizeof(sync::ClockSyncPacket), false);
+}
+
+/**
+ * @brief Update the clock estimate with the completed exchanges and start the next exchange.
+ */
+void HandleClockSync() {
+  using namespace sensint::ble;
+  sync::ClockSyncExchange exchange;
+  while (client::clock_sync_queue.Pop(exchange)) {
+    const bool was_synchronized = clock_sync.IsSynchronized();
+    clock_sync.AddExchange(exchange);
+#ifdef SENSINT_DEBUG
+    if (!was_synchronized && clock_sync.IsSynchronized()) {
+      debug::Log("HandleClockSync", "synchronized | offset: " + String(clock_sync.GetOffset()) +
+                                        "us | round trip: " + String(clock_sync.GetDelay()) +
+                                        "us");
+    }
+#endif  // SENSINT_DEBUG
+  }
+  const uint32_t interval_ms = clock_sync.IsSynchronized()
+                                   ? settings::local::tasks::kClockSyncIntervalMs
+                                   : settings::local::tasks::kClockSyncFastIntervalMs;
+  if (clock_sync_update_ms >= interval_ms) {
+    clock_sync_update_ms = 0;
+    SendClockSyncRequest();
+  }
 }
-#endif  // SENSINT_PARALLEL_DATA
 
+/**
+ * @brief Reconnect to the server. The cached address is connected directly (up to
+ * kDirectConnectAttempts times) before the server is searched with a background scan.
+ */
 void HandleBLEConnection() {
   using namespace sensint::ble;
+  if (!client::connected && !client::scanning && !client::do_connect) {
+    if (client::peer_cached &&
+        direct_connect_attempts < settings::local::tasks::kDirectConnectAttempts) {
+      direct_connect_attempts++;
+      connect_direct = true;
+      client::do_connect = true;
+    } else {
+#ifdef PICO
+      SetLED(settings::local::colors::kBleScan);
+#endif  // PICO
+      if (!client::StartScan()) {
+#ifdef SENSINT_DEBUG
+        debug::Log("HandleBLEConnection", "[ERR] failed to start the scan");
+#endif  // SENSINT_DEBUG
+      }
+    }
+  }
   if (client::do_connect) {
     if (client::ConnectToServer()) {
-      client::connected_char->writeValue((uint8_t *)&client::connected, sizeof(bool));
+      reconnect_ms = millis() - client::disconnected_ms;
+      direct_connect_attempts = 0;
+#ifdef SENSINT_DEBUG
+      debug::Log("HandleBLEConnection", String("connected ") +
+                                            (connect_direct ? "directly" : "after scan") + " in " +
+                                            String(reconnect_ms) + "ms");
+#endif  // SENSINT_DEBUG
+      bool connected = true;
+      client::connected_char->writeValue((uint8_t *)&connected, sizeof(bool));
+      // the server might have restarted, hence its clock is synchronized again
+      clock_sync.Reset();
+      connection_age_ms = 0;
+      // the samples that were sent before the disconnect but not received by the server are sent
+      // again (0: the server did not receive any sample yet)
+      const uint32_t next_sample = stream_transport->ReadNextSample();
+      if (next_sample != 0 && pipeline::sample_ring.Rewind(next_sample)) {
+#ifdef SENSINT_DEBUG
+        debug::Log("HandleBLEConnection",
+                   "backfill from sample " + String(next_sample) + " | pending " +
+                       String(pipeline::sample_ring.GetPending()));
+#endif  // SENSINT_DEBUG
+      }
+      // the server restarts the loss detection with the first packet after a connect
+      stream_sender.Resync();
     } else {
 #ifdef SENSINT_DEBUG
       debug::Log("HandleBLEConnection", "Could not connect to BLE server!");
 #endif  // SENSINT_DEBUG
     }
     client::do_connect = false;
-  }
-  if (!client::connected && client::do_scan) {
-#ifdef PICO
-    led = settings::local::colors::kBleScan;
-    FastLED.show();
-#endif  // PICO
-    BLEDevice::getScan()->start(0);
+    connect_direct = false;
   }
 
 #ifdef PICO
   if (client::connected) {
-    led = settings::local::colors::kBleConnected;
-    FastLED.show();
+    SetLED(settings::local::colors::kBleConnected);
   }
 #endif  // PICO
 }
 
-}  // namespace
-
-void setup() {
-  using namespace sensint::debug;
-
 #ifdef SENSINT_DEVELOPMENT
-  SetupSerial();
-#ifdef SENSINT_DEBUG
-  PrintConfig();
-#endif  // SENSINT_DEBUG
-#endif  // SENSINT_DEVELOPMENT
-
-#ifdef PICO
-  SetupLED();
-  SetupButton();
-#endif  // PICO
-
-#ifdef SENSINT_PARALLEL_DATA
-  SetupControlPins();
-#endif  // SENSINT_PARALLEL_DATA
-
-  SetupI2C();
-
-  // initialize peripherals
-  SetupIMU();
-  sensint::ble::client::Init();
-
-  // reset the update timers
-  imu_time_offset_ms = 0;
-  fsr_time_offset_ms = 0;
-  last_log_update_ms = 0;
-}
-
-void loop() {
+/**
+ * @brief Parse the messages from the serial port and forward them to the signal generators or
+ * handle them locally.
+ */
+void HandleSerial() {
   using namespace sensint::debug;
   using namespace sensint::communication;
-  using namespace sensint::settings;
-
-#ifdef PICO
-  bool btn_state = digitalRead(kButtonPin);
-  if (!btn_state) {
-    if (!reset_pressed) {
-#ifdef SENSINT_DEBUG
-      Log("reset");
-#endif  // SENSINT_DEBUG
-      reset_pressed = true;
-      ESP.restart();
-    }
-  } else {
-    reset_pressed = false;
-  }
-#endif  // PICO
 
-#ifdef SENSINT_DEVELOPMENT
   if (GetSerializedDataFrameFromSerial(serialized_input_msg)) {
 #ifdef PICO
-    led = settings::local::colors::kReadSerial;
-    FastLED.show();
+    SetLED(settings::local::colors::kReadSerial);
 #endif  // PICO
     std::vector<std::string> tokens;
     if (helper::SplitString(serialized_input_msg, tokens)) {
@@ -496,70 +671,251 @@ void loop() {
       }
     }
 #ifdef PICO
-    led = settings::local::colors::kIdle;
-    FastLED.show();
+    SetLED(settings::local::colors::kIdle);
 #endif  // PICO
   }
+}
 #endif  // SENSINT_DEVELOPMENT
 
-  if (local::imu_reinitialize) {
-    SetupIMU();
-    uint32_t tmp = 0;
-    ble::client::imu_reinitialize_char->writeValue((uint8_t *)&tmp, sizeof(uint32_t));
-    local::imu_reinitialize = false;
-  }
-
-  // regularly check for BLE connection
-  HandleBLEConnection();
-
-  // the haptic augmentation can be enabled/disabled from the PC
-  // the ble-client implements a notification mechanism for this
-  if (local::augmentation_active_changed) {
+void HandleGeneratorMessage(const pipeline::Message &message) {
+  using namespace sensint::settings;
+  switch (message.type) {
+    // the haptic augmentation can be enabled/disabled from the PC
+    case pipeline::MessageType::kAugmentationActive: {
+      local::augmentation_active = (message.payload.value == 1);
 #ifndef SENSINT_PARALLEL_DATA
-    std::string msg = (local::augmentation_active) ? "0,32,0,-" : "0,33,0,-";
-    ForwardMessageBroadcast(msg);
+      std::string msg = (local::augmentation_active) ? "0,32,0,-" : "0,33,0,-";
+      ForwardMessageBroadcast(msg);
 #else
-    digitalWrite(local::pins::kAugmentation, (local::augmentation_active) ? HIGH : LOW);
+      digitalWrite(local::pins::kAugmentation, (local::augmentation_active) ? HIGH : LOW);
 #endif  // SENSINT_PARALLEL_DATA
-    local::augmentation_active_changed = false;
-  }
-
-  // the the can be changed from the PC
-  // the ble-client implements a notification mechanism for this
-  if (local::sequence_changed) {
+      break;
+    }
+    // the sequence can be changed from the PC
+    case pipeline::MessageType::kSequence: {
+      local::sequence = static_cast<uint8_t>(message.payload.value);
 #ifndef SENSINT_PARALLEL_DATA
-    std::string msg = "0,34,1,";
-    msg += String((int)local::sequence).c_str();
-    ForwardMessageBroadcast(msg);
+      std::string msg = "0,34,1,";
+      msg += String((int)local::sequence).c_str();
+      ForwardMessageBroadcast(msg);
 #else
-    ConvertSequenceToBinary();
+      ConvertSequenceToBinary();
 #endif  // SENSINT_PARALLEL_DATA
-    local::sequence_changed = false;
+      // the acknowledgement keeps the time of the notification
+      pipeline::Message acknowledge = message;
+      acknowledge.type = pipeline::MessageType::kSequenceApplied;
+      pipeline::acknowledge_queue.Push(acknowledge);
+#ifdef SENSINT_DEBUG
+      debug::Log("HandleGeneratorMessage",
+                 "sequence applied after " + String(micros() - message.timestamp_us) + "us");
+#endif  // SENSINT_DEBUG
+      break;
+    }
+    default:
+      break;
   }
+}
 
-  // the frequency can be changed from the PC
+void HandleTransportMessage(const pipeline::Message &message) {
+  using namespace sensint::ble;
+  // the messages are dropped while there is no connection, the samples are kept in the sample_ring
+  if (!client::connected) {
+    return;
+  }
+  switch (message.type) {
+    case pipeline::MessageType::kImuReinitialized: {
+      uint32_t tmp = 0;
+      client::imu_reinitialize_char->writeValue((uint8_t *)&tmp, sizeof(uint32_t));
+      break;
+    }
+    // the server measures the round trip time of the sequence selection with the echo
+    case pipeline::MessageType::kSequenceApplied: {
+      uint8_t tmp = static_cast<uint8_t>(message.payload.value);
+      client::sequence_char->writeValue(&tmp, sizeof(uint8_t), true);
+      break;
+    }
+    default:
+      break;
+  }
+}
+
+/**
+ * @brief Sensor acquisition task. Reads the IMU and the pressure sensors in the log interval and
+ * records the timestamped samples in the sample_ring.
+ */
+void SensorStep() {
+  using namespace sensint::settings;
+  if (local::imu_reinitialize.exchange(false)) {
+    // the warm reinitialization resets the relative orientation, the central is told so below
+    ReinitializeIMU();
+    pipeline::Message message;
+    message.timestamp_us = micros();
+    message.type = pipeline::MessageType::kImuReinitialized;
+    pipeline::transport_queue.Push(message);
+  }
+
+  HandleIMU();
+
+  // the log interval and the recording status can be changed from the PC
   // the ble-client implements a notification mechanism for this
-  if (last_log_update_ms >= local::log_interval_ms) {
-    last_log_update_ms = 0;
-    // the recording status can be changed from the PC
-    // the ble-client implements a notification mechanism for this
-    if (local::recording_status == sensint::RecordingStatus::kRecording) {
-      fsr_time_offset_ms = 0;
-      imu_time_offset_ms = 0;
+  if (last_log_update_ms < local::log_interval_ms) {
+    return;
+  }
+  last_log_update_ms = 0;
+  if (local::recording_status != sensint::RecordingStatus::kRecording) {
+    return;
+  }
+  fsr_time_offset_ms = 0;
+  imu_time_offset_ms = 0;
 #ifdef PICO
-      led = settings::local::colors::kHandleData;
-      FastLED.show();
+  SetLED(local::colors::kHandleData);
 #endif  // PICO
-      GetIMUData();
-      SendIMUData();
+  GetIMUData();
 #ifndef SENSINT_PARALLEL_DATA
-      GetFSRData();
-      SendFSRData();
+  GetFSRData();
 #endif  // SENSINT_PARALLEL_DATA
 #ifdef PICO
-      led = settings::local::colors::kIdle;
-      FastLED.show();
+  SetLED(local::colors::kIdle);
+#endif  // PICO
+}
+
+/**
+ * @brief Generator control task. Forwards the control messages from the serial port and the BLE
+ * server to the signal generators.
+ */
+void GeneratorStep() {
+#ifdef SENSINT_DEVELOPMENT
+  HandleSerial();
+#endif  // SENSINT_DEVELOPMENT
+  pipeline::Message message;
+  while (pipeline::generator_queue.Pop(message)) {
+    HandleGeneratorMessage(message);
+  }
+}
+
+/**
+ * @brief BLE transport task. Maintains the connection to the BLE server and sends the sensor data
+ * in packets of multiple samples.
+ */
+void TransportStep() {
+  HandleBLEConnection();
+  pipeline::Message message;
+  while (pipeline::transport_queue.Pop(message)) {
+    HandleTransportMessage(message);
+  }
+  while (pipeline::acknowledge_queue.Pop(message)) {
+    HandleTransportMessage(message);
+  }
+  if (ble::client::connected) {
+    HandleClockSync();
+    HandleStream();
+  }
+}
+
+#ifdef SENSINT_DEBUG
+void PrintTelemetry() {
+  using namespace sensint::debug;
+  for (auto task : {&sensor_task, &generator_task, &transport_task}) {
+    auto statistics = task->GetStatistics();
+    Log("Telemetry", String(task->GetName()) + " | stack free: " +
+                         String(statistics.stack_free_bytes) + "B | cpu: " +
+                         String(statistics.cpu_load_percent, 1) + "% | max step: " +
+                         String(statistics.max_step_us) + "us | iterations: " +
+                         String(statistics.iterations));
+  }
+  Log("Telemetry", "queues | transport: " + String(pipeline::transport_queue.Size()) +
+                       " (dropped " + String(pipeline::transport_queue.GetDropped()) +
+                       ") | generator: " + String(pipeline::generator_queue.Size()) +
+                       " (dropped " + String(pipeline::generator_queue.GetDropped()) +
+                       ") | acknowledge: " + String(pipeline::acknowledge_queue.Size()) +
+                       " (dropped " + String(pipeline::acknowledge_queue.GetDropped()) + ")");
+  Log("Telemetry", "stream | sequence: " + String(stream_sender.GetSequence()) +
+                       " | packet size: " + String(stream_transport->GetPacketSize()) +
+                       "B | last reconnect: " + String(reconnect_ms) + "ms");
+  Log("Telemetry", "samples | pending: " + String(pipeline::sample_ring.GetPending()) + "/" +
+                       String(pipeline::sample_ring.GetCapacity()) +
+                       (pipeline::sample_ring.IsExternal() ? " (PSRAM)" : " (RAM)") +
+                       " | dropped: " + String(pipeline::sample_ring.GetDropped()));
+  Log("Telemetry", "clock | synchronized: " + String(clock_sync.IsSynchronized()) +
+                       " | offset: " + String(clock_sync.GetOffset()) +
+                       "us | drift: " + String(clock_sync.GetDriftPpb()) +
+                       "ppb | residual: " + String(clock_sync.GetResidual()) +
+                       "us | rejected: " + String(clock_sync.GetRejected()));
+}
+#endif  // SENSINT_DEBUG
+
+}  // namespace
+
+void setup() {
+  using namespace sensint::debug;
+
+#ifdef SENSINT_DEVELOPMENT
+  SetupSerial();
+#ifdef SENSINT_DEBUG
+  PrintConfig();
+#endif  // SENSINT_DEBUG
+#endif  // SENSINT_DEVELOPMENT
+
+#ifdef PICO
+  SetupLED();
+  SetupButton();
 #endif  // PICO
+
+#ifdef SENSINT_PARALLEL_DATA
+  SetupControlPins();
+#endif  // SENSINT_PARALLEL_DATA
+
+  SetupI2C();
+
+  // initialize peripherals
+  SetupIMU();
+  sensint::ble::client::Init();
+
+  // the samples are recorded independent of the BLE connection
+  if (!pipeline::sample_ring.Init(pipeline::kSampleRingSizeExternal,
+                                  pipeline::kSampleRingSizeInternal)) {
+#ifdef SENSINT_DEBUG
+    Log("setup", "[ERR] failed to allocate the sample ring");
+#endif  // SENSINT_DEBUG
+  }
+
+  // reset the update timers
+  imu_time_offset_ms = 0;
+  fsr_time_offset_ms = 0;
+  last_log_update_ms = 0;
+
+  sensor_task.Start();
+  generator_task.Start();
+  transport_task.Start();
+}
+
+void loop() {
+  using namespace sensint::debug;
+  using namespace sensint::settings;
+
+#ifdef PICO
+  bool btn_state = digitalRead(kButtonPin);
+  if (!btn_state) {
+    if (!reset_pressed) {
+#ifdef SENSINT_DEBUG
+      Log("reset");
+#endif  // SENSINT_DEBUG
+      reset_pressed = true;
+      ESP.restart();
     }
+  } else {
+    reset_pressed = false;
+  }
+  UpdateLED();
+#endif  // PICO
+
+#ifdef SENSINT_DEBUG
+  if (last_telemetry_ms >= local::tasks::kTelemetryIntervalMs) {
+    last_telemetry_ms = 0;
+    PrintTelemetry();
   }
+#endif  // SENSINT_DEBUG
+
+  // all the work is done by the tasks of the pipeline
+  delay(20);
 }
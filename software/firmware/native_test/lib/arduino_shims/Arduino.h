@@ -0,0 +1,264 @@
+#ifndef __SENSINT_NATIVE_ARDUINO_H__
+#define __SENSINT_NATIVE_ARDUINO_H__
+
+#include <host_audio.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <string>
+
+/**
+ * @brief Stand-ins of the Arduino API used by the libraries, hence the code paths of the
+ * controllers (e.g. the logging and the serial port) can be tested on a PC (see native_test).
+ *
+ * //! The time is the simulated time of the Teensy Audio stand-ins (see host_audio.h), i.e. it is
+ * //! only advanced by sensint::host_audio::SetMicros() and delay(). The serial port keeps the
+ * //! received bytes and the written output in memory, where the tests can inspect them.
+ */
+
+enum : uint8_t { BIN = 2, OCT = 8, DEC = 10, HEX = 16 };
+enum : uint8_t { LOW = 0, HIGH = 1 };
+enum : uint8_t { INPUT = 0, OUTPUT = 1, INPUT_PULLUP = 2 };
+
+inline uint32_t micros() { return sensint::host_audio::Micros(); }
+inline uint32_t millis() { return sensint::host_audio::Micros() / 1000; }
+inline void delayMicroseconds(const uint32_t us) {
+  sensint::host_audio::SetMicros(sensint::host_audio::Micros() + us);
+}
+inline void delay(const uint32_t ms) { delayMicroseconds(ms * 1000); }
+
+//! the clock of the Teensy 4.1, the cycle counter of the CPU follows the simulated time
+#define F_CPU 600000000
+
+namespace sensint {
+namespace native {
+
+inline uint32_t &ArmRegister(const size_t index) {
+  static uint32_t registers[2] = {0};
+  return registers[index];
+}
+
+inline uint32_t GetCycleCount() { return host_audio::Micros() * (F_CPU / 1000000); }
+
+}  // namespace native
+}  // namespace sensint
+
+#define ARM_DEMCR (sensint::native::ArmRegister(0))
+#define ARM_DEMCR_TRCENA (1 << 24)
+#define ARM_DWT_CTRL (sensint::native::ArmRegister(1))
+#define ARM_DWT_CTRL_CYCCNTENA (1 << 0)
+#define ARM_DWT_CYCCNT (sensint::native::GetCycleCount())
+
+namespace sensint {
+namespace native {
+
+inline uint16_t &AnalogValue() {
+  static uint16_t value = 0;
+  return value;
+}
+
+/**
+ * @brief Set the value which is returned by analogRead() for all pins.
+ */
+inline void SetAnalogValue(const uint16_t value) { AnalogValue() = value; }
+
+}  // namespace native
+}  // namespace sensint
+
+inline void pinMode(const uint8_t pin, const uint8_t mode) {}
+inline void digitalWrite(const uint8_t pin, const uint8_t value) {}
+inline int digitalRead(const uint8_t pin) { return LOW; }
+inline void analogReadResolution(const unsigned int bits) {}
+inline int analogRead(const uint8_t pin) { return sensint::native::AnalogValue(); }
+
+/**
+ * @brief Counts the simulated milliseconds since it was (re)set, like the one of the Teensy core.
+ */
+class elapsedMillis {
+ public:
+  elapsedMillis(const uint32_t value = 0) : start_(millis() - value) {}
+  operator uint32_t() const { return millis() - start_; }
+  elapsedMillis &operator=(const uint32_t value) {
+    start_ = millis() - value;
+    return *this;
+  }
+
+ private:
+  uint32_t start_;
+};
+
+/**
+ * @brief The string of the Arduino core, which formats numbers like the original (e.g. two
+ * decimals for floats).
+ */
+class String {
+ public:
+  String(const char *str = "") : str_(str != nullptr ? str : "") {}
+  String(const char c) : str_(1, c) {}
+  String(const int value, const uint8_t base = DEC) : String(static_cast<long>(value), base) {}
+  String(const unsigned int value, const uint8_t base = DEC)
+      : String(static_cast<unsigned long>(value), base) {}
+  String(const unsigned char value, const uint8_t base = DEC)
+      : String(static_cast<unsigned long>(value), base) {}
+  String(const long value, const uint8_t base = DEC)
+      : str_(value < 0 ? "-" + Format(-static_cast<unsigned long>(value), base)
+                       : Format(static_cast<unsigned long>(value), base)) {}
+  String(const unsigned long value, const uint8_t base = DEC) : str_(Format(value, base)) {}
+  String(const float value, const uint8_t decimals = 2)
+      : String(static_cast<double>(value), decimals) {}
+  String(const double value, const uint8_t decimals = 2) {
+    char buffer[64];
+    snprintf(buffer, sizeof(buffer), "%.*f", decimals, value);
+    str_ = buffer;
+  }
+
+  const char *c_str() const { return str_.c_str(); }
+  unsigned int length() const { return static_cast<unsigned int>(str_.size()); }
+  char operator[](const unsigned int idx) const { return str_[idx]; }
+  long toInt() const { return atol(str_.c_str()); }
+  float toFloat() const { return static_cast<float>(atof(str_.c_str())); }
+
+  String &operator+=(const String &other) {
+    str_ += other.str_;
+    return *this;
+  }
+  bool operator==(const String &other) const { return str_ == other.str_; }
+  bool operator!=(const String &other) const { return str_ != other.str_; }
+
+  friend String operator+(const String &lhs, const String &rhs) {
+    String result(lhs);
+    result += rhs;
+    return result;
+  }
+
+ private:
+  static std::string Format(unsigned long value, const uint8_t base) {
+    if (value == 0) {
+      return "0";
+    }
+    std::string digits;
+    while (value > 0) {
+      digits.insert(digits.begin(), "0123456789abcdef"[value % base]);
+      value /= base;
+    }
+    return digits;
+  }
+
+  std::string str_;
+};
+
+/**
+ * @brief The serial port of the controller. The received bytes are provided by the test (see
+ * Receive) and the output is only kept if it is captured (see SetCapture), because the
+ * benchmarks write a lot of log messages.
+ */
+class NativeSerial {
+ public:
+  void begin(const unsigned long baud) {}
+  void flush() {}
+  operator bool() const { return true; }
+
+  int available() const { return static_cast<int>(input_.size()); }
+  int peek() const { return input_.empty() ? -1 : input_.front(); }
+  int read() {
+    if (input_.empty()) {
+      return -1;
+    }
+    const auto value = input_.front();
+    input_.pop_front();
+    return value;
+  }
+  String readStringUntil(const char terminator, const size_t max = SIZE_MAX) {
+    std::string str;
+    while (!input_.empty() && str.size() < max) {
+      const auto c = static_cast<char>(read());
+      if (c == terminator) {
+        break;
+      }
+      str += c;
+    }
+    return String(str.c_str());
+  }
+
+  size_t write(const uint8_t value) { return write(&value, 1); }
+  size_t write(const uint8_t *data, const size_t size) {
+    num_written_bytes_ += size;
+    if (is_captured_) {
+      output_.append(reinterpret_cast<const char *>(data), size);
+    }
+    return size;
+  }
+  size_t print(const String &str) {
+    return write(reinterpret_cast<const uint8_t *>(str.c_str()), str.length());
+  }
+  size_t print(const char *str) { return print(String(str)); }
+  template <typename T>
+  size_t print(const T value) {
+    return print(String(value));
+  }
+  template <typename T>
+  size_t print(const T value, const uint8_t format) {
+    return print(String(value, format));
+  }
+  size_t println() { return print("\r\n"); }
+  template <typename... Args>
+  size_t println(const Args... args) {
+    return print(args...) + println();
+  }
+  __attribute__((format(printf, 2, 3))) size_t printf(const char *format, ...) {
+    char buffer[512];
+    va_list args;
+    va_start(args, format);
+    const auto length = vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    if (length < 0) {
+      return 0;
+    }
+    return write(reinterpret_cast<const uint8_t *>(buffer),
+                 std::min(static_cast<size_t>(length), sizeof(buffer) - 1));
+  }
+
+  /**
+   * @brief Append bytes to the input of the serial port, i.e. simulate a message of the host.
+   */
+  void Receive(const std::string &data) { input_.insert(input_.end(), data.begin(), data.end()); }
+
+  void SetCapture(const bool is_captured) { is_captured_ = is_captured; }
+
+  /**
+   * @brief Get the captured output and clear it.
+   */
+  std::string TakeOutput() {
+    std::string output;
+    output.swap(output_);
+    return output;
+  }
+
+  size_t GetNumWrittenBytes() const { return num_written_bytes_; }
+
+  /**
+   * @brief Clear the input, the output, and the statistics.
+   */
+  void Reset() {
+    input_.clear();
+    output_.clear();
+    num_written_bytes_ = 0;
+  }
+
+ private:
+  std::deque<uint8_t> input_;
+  std::string output_;
+  bool is_captured_ = false;
+  size_t num_written_bytes_ = 0;
+};
+
+extern NativeSerial Serial;
+
+#endif  // __SENSINT_NATIVE_ARDUINO_H__
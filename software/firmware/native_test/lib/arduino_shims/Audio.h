@@ -0,0 +1,7 @@
+#ifndef __SENSINT_NATIVE_AUDIO_H__
+#define __SENSINT_NATIVE_AUDIO_H__
+
+//! the subset of the Teensy Audio library used by the signal generator
+#include <host_audio.h>
+
+#endif  // __SENSINT_NATIVE_AUDIO_H__
@@ -0,0 +1,48 @@
+#ifndef __SENSINT_NATIVE_EEPROM_H__
+#define __SENSINT_NATIVE_EEPROM_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Stand-in of the EEPROM of the Teensy core (see Arduino.h). It is kept in memory and an
+ * erased EEPROM reads as 0xFF, like the one of the controller.
+ */
+class EEPROMClass {
+ public:
+  //! the EEPROM size of the Teensy 4.1
+  static constexpr size_t kSize = 4284;
+
+  EEPROMClass() : data_(kSize, 0xFF) {}
+
+  uint16_t length() const { return static_cast<uint16_t>(data_.size()); }
+  uint8_t read(const int address) const { return data_[address]; }
+  void write(const int address, const uint8_t value) {
+    data_[address] = value;
+    num_written_bytes_++;
+  }
+  void update(const int address, const uint8_t value) {
+    if (data_[address] != value) {
+      write(address, value);
+    }
+  }
+
+  /**
+   * @brief Get the number of written bytes, i.e. the wear of the EEPROM.
+   */
+  size_t GetNumWrittenBytes() const { return num_written_bytes_; }
+
+  void Erase() {
+    data_.assign(data_.size(), 0xFF);
+    num_written_bytes_ = 0;
+  }
+
+ private:
+  std::vector<uint8_t> data_;
+  size_t num_written_bytes_ = 0;
+};
+
+extern EEPROMClass EEPROM;
+
+#endif  // __SENSINT_NATIVE_EEPROM_H__
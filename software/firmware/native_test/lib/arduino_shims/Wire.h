@@ -0,0 +1,111 @@
+#ifndef __SENSINT_NATIVE_WIRE_H__
+#define __SENSINT_NATIVE_WIRE_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+
+/**
+ * @brief Stand-in of the I2C bus of the Arduino core (see Arduino.h). A test plays the other device
+ * of the bus: Transmit() delivers a write of the master to the receive handler of a slave and
+ * Request() returns the answer of the request handler. The writes of a master are kept as well,
+ * hence the transmitted registers can be checked.
+ */
+class TwoWire {
+ public:
+  void begin() {}
+  void begin(const uint8_t address) { address_ = address; }
+  void setClock(const uint32_t frequency) {}
+  void onReceive(void (*handler)(int)) { on_receive_ = handler; }
+  void onRequest(void (*handler)()) { on_request_ = handler; }
+
+  void beginTransmission(const uint8_t address) { output_.clear(); }
+  uint8_t endTransmission(const bool stop = true) {
+    transmissions_.push_back(output_);
+    output_.clear();
+    return 0;
+  }
+  uint8_t requestFrom(const uint8_t address, const uint8_t quantity, const bool stop = true) {
+    return static_cast<uint8_t>(input_.size());
+  }
+
+  size_t write(const uint8_t value) { return write(&value, 1); }
+  size_t write(const uint8_t *data, const size_t size) {
+    output_.append(reinterpret_cast<const char *>(data), size);
+    return size;
+  }
+  int available() const { return static_cast<int>(input_.size()); }
+  int peek() const { return input_.empty() ? -1 : input_.front(); }
+  int read() {
+    if (input_.empty()) {
+      return -1;
+    }
+    const auto value = input_.front();
+    input_.pop_front();
+    return value;
+  }
+
+  uint8_t GetAddress() const { return address_; }
+
+  /**
+   * @brief Simulate a write of the master to this slave, i.e. the bytes are received and the
+   * receive handler is called.
+   */
+  void Transmit(const std::string &data) {
+    input_.insert(input_.end(), data.begin(), data.end());
+    if (on_receive_ != nullptr) {
+      on_receive_(static_cast<int>(data.size()));
+    }
+  }
+
+  /**
+   * @brief Simulate a read of the master from this slave.
+   *
+   * @return the bytes written by the request handler
+   */
+  std::string Request() {
+    output_.clear();
+    if (on_request_ != nullptr) {
+      on_request_();
+    }
+    std::string answer;
+    answer.swap(output_);
+    return answer;
+  }
+
+  /**
+   * @brief Append bytes to the input, e.g. the answer of a sensor to requestFrom().
+   */
+  void Receive(const std::string &data) { input_.insert(input_.end(), data.begin(), data.end()); }
+
+  /**
+   * @brief Get the completed transmissions of the master and clear them.
+   */
+  std::deque<std::string> TakeTransmissions() {
+    std::deque<std::string> transmissions;
+    transmissions.swap(transmissions_);
+    return transmissions;
+  }
+
+  void Reset() {
+    input_.clear();
+    output_.clear();
+    transmissions_.clear();
+    on_receive_ = nullptr;
+    on_request_ = nullptr;
+  }
+
+ private:
+  uint8_t address_ = 0;
+  void (*on_receive_)(int) = nullptr;
+  void (*on_request_)() = nullptr;
+  std::deque<uint8_t> input_;
+  std::string output_;
+  std::deque<std::string> transmissions_;
+};
+
+extern TwoWire Wire;
+extern TwoWire Wire1;
+
+#endif  // __SENSINT_NATIVE_WIRE_H__
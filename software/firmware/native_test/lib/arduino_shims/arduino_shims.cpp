@@ -0,0 +1,8 @@
+#include <Arduino.h>
+#include <EEPROM.h>
+#include <Wire.h>
+
+NativeSerial Serial;
+TwoWire Wire;
+TwoWire Wire1;
+EEPROMClass EEPROM;
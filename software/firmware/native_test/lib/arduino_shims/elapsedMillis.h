@@ -0,0 +1,7 @@
+#ifndef __SENSINT_NATIVE_ELAPSED_MILLIS_H__
+#define __SENSINT_NATIVE_ELAPSED_MILLIS_H__
+
+//! elapsedMillis and elapsedMicros are part of the Arduino stand-ins
+#include <Arduino.h>
+
+#endif  // __SENSINT_NATIVE_ELAPSED_MILLIS_H__
@@ -0,0 +1,19 @@
+#ifndef __SENSINT_NATIVE_BLE2902_H__
+#define __SENSINT_NATIVE_BLE2902_H__
+
+#include "BLEDescriptor.h"
+
+//! the client characteristic configuration descriptor
+class BLE2902 : public BLEDescriptor {
+ public:
+  BLE2902() : BLEDescriptor(BLEUUID(static_cast<uint16_t>(0x2902))) {}
+
+  void setNotifications(const bool enable) { notifications_ = enable; }
+  void setIndications(const bool enable) { indications_ = enable; }
+
+ private:
+  bool notifications_ = false;
+  bool indications_ = false;
+};
+
+#endif  // __SENSINT_NATIVE_BLE2902_H__
@@ -0,0 +1,20 @@
+#ifndef __SENSINT_NATIVE_BLE2904_H__
+#define __SENSINT_NATIVE_BLE2904_H__
+
+#include "BLEDescriptor.h"
+
+//! the characteristic presentation format descriptor
+class BLE2904 : public BLEDescriptor {
+ public:
+  BLE2904() : BLEDescriptor(BLEUUID(static_cast<uint16_t>(0x2904))) {}
+
+  void setFormat(const uint8_t format) { format_ = format; }
+  void setUnit(const uint16_t unit) { unit_ = unit; }
+  uint16_t GetUnit() const { return unit_; }
+
+ private:
+  uint8_t format_ = 0;
+  uint16_t unit_ = 0;
+};
+
+#endif  // __SENSINT_NATIVE_BLE2904_H__
@@ -0,0 +1,107 @@
+#ifndef __SENSINT_NATIVE_BLE_CHARACTERISTIC_H__
+#define __SENSINT_NATIVE_BLE_CHARACTERISTIC_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "BLEDescriptor.h"
+
+class BLECharacteristic;
+
+class BLECharacteristicCallbacks {
+ public:
+  virtual ~BLECharacteristicCallbacks() {}
+  virtual void onRead(BLECharacteristic *pCharacteristic) {}
+  virtual void onWrite(BLECharacteristic *pCharacteristic) {}
+};
+
+/**
+ * @brief Stand-in of a characteristic of the ESP32 BLE library. It keeps its value in memory and
+ * counts the notifications, where the tests can inspect them.
+ *
+ * //! A write or a read of a connected device is simulated by @ref Write and @ref Read, which call
+ * //! the callbacks like the BLE stack. The hook of @ref SetNotifyHook is called by every
+ * //! notification, e.g. to change a value while the application notifies the characteristics.
+ */
+class BLECharacteristic {
+ public:
+  static constexpr uint32_t PROPERTY_READ = 1 << 0;
+  static constexpr uint32_t PROPERTY_WRITE = 1 << 1;
+  static constexpr uint32_t PROPERTY_NOTIFY = 1 << 2;
+  static constexpr uint32_t PROPERTY_BROADCAST = 1 << 3;
+  static constexpr uint32_t PROPERTY_INDICATE = 1 << 4;
+  static constexpr uint32_t PROPERTY_WRITE_NR = 1 << 5;
+
+  BLECharacteristic(const BLEUUID &uuid, const uint32_t properties = 0)
+      : uuid_(uuid), properties_(properties) {}
+  BLECharacteristic(const char *uuid, const uint32_t properties = 0)
+      : BLECharacteristic(BLEUUID(uuid), properties) {}
+  virtual ~BLECharacteristic() {}
+
+  void setCallbacks(BLECharacteristicCallbacks *callbacks) { callbacks_ = callbacks; }
+  //! the characteristic takes the ownership of the descriptor, like the BLE library
+  void addDescriptor(BLEDescriptor *descriptor) { descriptors_.emplace_back(descriptor); }
+
+  void setValue(const uint8_t *data, const size_t length) {
+    value_.assign(reinterpret_cast<const char *>(data), length);
+  }
+  void setValue(const std::string &value) { value_ = value; }
+  void setValue(uint16_t &data) { setValue(reinterpret_cast<uint8_t *>(&data), sizeof(data)); }
+  void setValue(uint32_t &data) { setValue(reinterpret_cast<uint8_t *>(&data), sizeof(data)); }
+  void setValue(int &data) { setValue(reinterpret_cast<uint8_t *>(&data), sizeof(data)); }
+  void setValue(float &data) { setValue(reinterpret_cast<uint8_t *>(&data), sizeof(data)); }
+
+  std::string getValue() const { return value_; }
+  uint8_t *getData() { return reinterpret_cast<uint8_t *>(&value_[0]); }
+  size_t getLength() const { return value_.size(); }
+  BLEUUID getUUID() const { return uuid_; }
+
+  void notify(const bool is_notification = true) {
+    num_notifications_++;
+    if (notify_hook_) {
+      notify_hook_();
+    }
+  }
+
+  /**
+   * @brief Simulate a write of a connected device.
+   */
+  void Write(const uint8_t *data, const size_t length) {
+    setValue(data, length);
+    if (callbacks_) {
+      callbacks_->onWrite(this);
+    }
+  }
+
+  /**
+   * @brief Simulate a read of a connected device.
+   *
+   * @return The value after the read callback.
+   */
+  std::string Read() {
+    if (callbacks_) {
+      callbacks_->onRead(this);
+    }
+    return value_;
+  }
+
+  uint32_t GetProperties() const { return properties_; }
+  size_t GetNumDescriptors() const { return descriptors_.size(); }
+  uint32_t GetNumNotifications() const { return num_notifications_; }
+  void SetNotifyHook(std::function<void()> hook) { notify_hook_ = std::move(hook); }
+
+ private:
+  BLEUUID uuid_;
+  uint32_t properties_;
+  BLECharacteristicCallbacks *callbacks_ = nullptr;
+  std::vector<std::unique_ptr<BLEDescriptor>> descriptors_;
+  std::string value_;
+  uint32_t num_notifications_ = 0;
+  std::function<void()> notify_hook_;
+};
+
+#endif  // __SENSINT_NATIVE_BLE_CHARACTERISTIC_H__
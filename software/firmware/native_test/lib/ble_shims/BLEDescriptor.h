@@ -0,0 +1,46 @@
+#ifndef __SENSINT_NATIVE_BLE_DESCRIPTOR_H__
+#define __SENSINT_NATIVE_BLE_DESCRIPTOR_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Stand-in of the UUID of the ESP32 BLE library, it keeps the UUID as it was given.
+ */
+class BLEUUID {
+ public:
+  BLEUUID() {}
+  explicit BLEUUID(const uint16_t uuid) : uuid_(std::to_string(uuid)) {}
+  BLEUUID(const char *uuid) : uuid_(uuid) {}
+  BLEUUID(const std::string &uuid) : uuid_(uuid) {}
+
+  std::string toString() const { return uuid_; }
+  bool equals(const BLEUUID &uuid) const { return uuid_ == uuid.uuid_; }
+
+ private:
+  std::string uuid_;
+};
+
+class BLEDescriptor {
+ public:
+  BLEDescriptor(const BLEUUID &uuid, const uint16_t max_length = 100)
+      : uuid_(uuid), max_length_(max_length) {}
+  BLEDescriptor(const char *uuid, const uint16_t max_length = 100)
+      : BLEDescriptor(BLEUUID(uuid), max_length) {}
+  virtual ~BLEDescriptor() {}
+
+  void setValue(const uint8_t *data, const size_t length) {
+    value_.assign(reinterpret_cast<const char *>(data), length);
+  }
+  void setValue(const std::string &value) { value_ = value; }
+  std::string getValue() const { return value_; }
+  BLEUUID getUUID() const { return uuid_; }
+
+ private:
+  BLEUUID uuid_;
+  uint16_t max_length_;
+  std::string value_;
+};
+
+#endif  // __SENSINT_NATIVE_BLE_DESCRIPTOR_H__
@@ -0,0 +1,45 @@
+#ifndef __SENSINT_NATIVE_BLE_DEVICE_H__
+#define __SENSINT_NATIVE_BLE_DEVICE_H__
+
+#include <esp_gap_ble_api.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "BLE2902.h"
+#include "BLE2904.h"
+#include "BLECharacteristic.h"
+#include "BLEServer.h"
+#include "BLEService.h"
+#include "BLEUtils.h"
+
+/**
+ * @brief Stand-in of the ESP32 BLE library (BLEDevice.h), hence the BLE server of the central and
+ * its callbacks can be tested on a PC (see native_test). Only the GATT server is provided, i.e.
+ * the part of the library that is used by controller_shoe_pc.
+ *
+ * //! The device owns the server and its attributes. They are released by @ref deinit, so that
+ * //! every test can start with a new server.
+ */
+class BLEDevice {
+ public:
+  static void init(const std::string &name);
+  static void deinit(const bool release_memory = false);
+  static BLEServer *createServer();
+  static BLEAdvertising *getAdvertising();
+  static void startAdvertising();
+  static int setMTU(const uint16_t mtu);
+  static uint16_t getMTU();
+
+  static uint32_t GetNumAdvertisingStarts();
+
+ private:
+  static std::string name_;
+  static uint16_t mtu_;
+  static uint32_t num_advertising_starts_;
+  static std::unique_ptr<BLEServer> server_;
+  static std::unique_ptr<BLEAdvertising> advertising_;
+};
+
+#endif  // __SENSINT_NATIVE_BLE_DEVICE_H__
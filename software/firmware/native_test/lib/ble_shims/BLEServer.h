@@ -0,0 +1,72 @@
+#ifndef __SENSINT_NATIVE_BLE_SERVER_H__
+#define __SENSINT_NATIVE_BLE_SERVER_H__
+
+#include <esp_gap_ble_api.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "BLEService.h"
+
+class BLEServer;
+
+class BLEServerCallbacks {
+ public:
+  virtual ~BLEServerCallbacks() {}
+  virtual void onConnect(BLEServer *pServer) {}
+  virtual void onConnect(BLEServer *pServer, esp_ble_gatts_cb_param_t *param) {}
+  virtual void onDisconnect(BLEServer *pServer) {}
+};
+
+class BLEAdvertising {
+ public:
+  void addServiceUUID(const BLEUUID &uuid) { service_uuids_.push_back(uuid); }
+  void addServiceUUID(const char *uuid) { addServiceUUID(BLEUUID(uuid)); }
+  void setScanResponse(const bool scan_response) {}
+  void setMinPreferred(const uint16_t interval) {}
+  void setMaxPreferred(const uint16_t interval) {}
+  void start() {}
+
+  size_t GetNumServiceUUIDs() const { return service_uuids_.size(); }
+
+ private:
+  std::vector<BLEUUID> service_uuids_;
+};
+
+/**
+ * @brief Stand-in of the GATT server of the ESP32 BLE library. A connect or a disconnect of a
+ * device is simulated by @ref Connect and @ref Disconnect, which call the callbacks like the BLE
+ * stack.
+ */
+class BLEServer {
+ public:
+  void setCallbacks(BLEServerCallbacks *callbacks) { callbacks_ = callbacks; }
+
+  //! the server owns its services, like the BLE library
+  BLEService *createService(const BLEUUID &uuid, const uint32_t num_handles = 15,
+                            const uint8_t instance = 0) {
+    services_.emplace_back(new BLEService(uuid, num_handles));
+    return services_.back().get();
+  }
+  BLEService *createService(const char *uuid, const uint32_t num_handles = 15,
+                            const uint8_t instance = 0) {
+    return createService(BLEUUID(uuid), num_handles, instance);
+  }
+
+  uint32_t getConnectedCount() const { return connected_; }
+
+  void Connect(const uint16_t connection_id = 0);
+  void Disconnect();
+
+  size_t GetNumServices() const { return services_.size(); }
+  BLEService *GetService(const size_t index) { return services_[index].get(); }
+
+ private:
+  BLEServerCallbacks *callbacks_ = nullptr;
+  std::vector<std::unique_ptr<BLEService>> services_;
+  uint32_t connected_ = 0;
+};
+
+#endif  // __SENSINT_NATIVE_BLE_SERVER_H__
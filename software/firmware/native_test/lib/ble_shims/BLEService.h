@@ -0,0 +1,40 @@
+#ifndef __SENSINT_NATIVE_BLE_SERVICE_H__
+#define __SENSINT_NATIVE_BLE_SERVICE_H__
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "BLECharacteristic.h"
+
+class BLEService {
+ public:
+  BLEService(const BLEUUID &uuid, const uint32_t num_handles)
+      : uuid_(uuid), num_handles_(num_handles) {}
+
+  //! the service owns its characteristics, like the BLE library
+  BLECharacteristic *createCharacteristic(const BLEUUID &uuid, const uint32_t properties) {
+    characteristics_.emplace_back(new BLECharacteristic(uuid, properties));
+    return characteristics_.back().get();
+  }
+  BLECharacteristic *createCharacteristic(const char *uuid, const uint32_t properties) {
+    return createCharacteristic(BLEUUID(uuid), properties);
+  }
+  void start() { started_ = true; }
+
+  BLEUUID getUUID() const { return uuid_; }
+  uint32_t GetNumHandles() const { return num_handles_; }
+  size_t GetNumCharacteristics() const { return characteristics_.size(); }
+  BLECharacteristic *GetCharacteristic(const size_t index) {
+    return characteristics_[index].get();
+  }
+  bool IsStarted() const { return started_; }
+
+ private:
+  BLEUUID uuid_;
+  uint32_t num_handles_;
+  std::vector<std::unique_ptr<BLECharacteristic>> characteristics_;
+  bool started_ = false;
+};
+
+#endif  // __SENSINT_NATIVE_BLE_SERVICE_H__
@@ -0,0 +1,6 @@
+#ifndef __SENSINT_NATIVE_BLE_UTILS_H__
+#define __SENSINT_NATIVE_BLE_UTILS_H__
+
+#include "BLEDescriptor.h"
+
+#endif  // __SENSINT_NATIVE_BLE_UTILS_H__
@@ -0,0 +1,89 @@
+#include <BLEDevice.h>
+#include <esp_gap_ble_api.h>
+
+#include <cstring>
+
+std::string BLEDevice::name_;
+uint16_t BLEDevice::mtu_ = 23;
+uint32_t BLEDevice::num_advertising_starts_ = 0;
+std::unique_ptr<BLEServer> BLEDevice::server_;
+std::unique_ptr<BLEAdvertising> BLEDevice::advertising_;
+
+void BLEDevice::init(const std::string &name) {
+  name_ = name;
+  advertising_.reset(new BLEAdvertising());
+}
+
+void BLEDevice::deinit(const bool release_memory) {
+  server_.reset();
+  advertising_.reset();
+  mtu_ = 23;
+  num_advertising_starts_ = 0;
+}
+
+BLEServer *BLEDevice::createServer() {
+  server_.reset(new BLEServer());
+  return server_.get();
+}
+
+BLEAdvertising *BLEDevice::getAdvertising() {
+  if (!advertising_) {
+    advertising_.reset(new BLEAdvertising());
+  }
+  return advertising_.get();
+}
+
+void BLEDevice::startAdvertising() { num_advertising_starts_++; }
+
+int BLEDevice::setMTU(const uint16_t mtu) {
+  mtu_ = mtu;
+  return ESP_OK;
+}
+
+uint16_t BLEDevice::getMTU() { return mtu_; }
+
+uint32_t BLEDevice::GetNumAdvertisingStarts() { return num_advertising_starts_; }
+
+void BLEServer::Connect(const uint16_t connection_id) {
+  connected_++;
+  if (!callbacks_) {
+    return;
+  }
+  esp_ble_gatts_cb_param_t param = {};
+  param.connect.conn_id = connection_id;
+  param.connect.remote_bda[5] = static_cast<uint8_t>(connection_id);
+  callbacks_->onConnect(this);
+  callbacks_->onConnect(this, &param);
+}
+
+void BLEServer::Disconnect() {
+  if (connected_ > 0) {
+    connected_--;
+  }
+  if (callbacks_) {
+    callbacks_->onDisconnect(this);
+  }
+}
+
+esp_err_t esp_ble_gap_update_conn_params(esp_ble_conn_update_params_t *params) {
+  auto &requests = sensint::native::GetLinkRequests();
+  memcpy(&requests.connection, params, sizeof(esp_ble_conn_update_params_t));
+  requests.num_requests++;
+  return ESP_OK;
+}
+
+esp_err_t esp_ble_gap_set_pkt_data_len(esp_bd_addr_t remote_device, uint16_t tx_data_length) {
+  sensint::native::GetLinkRequests().data_length = tx_data_length;
+  return ESP_OK;
+}
+
+namespace sensint {
+namespace native {
+
+LinkRequests &GetLinkRequests() {
+  static LinkRequests requests;
+  return requests;
+}
+
+}  // namespace native
+}  // namespace sensint
@@ -0,0 +1,56 @@
+#ifndef __SENSINT_NATIVE_ESP_GAP_BLE_API_H__
+#define __SENSINT_NATIVE_ESP_GAP_BLE_API_H__
+
+#include <cstdint>
+
+/**
+ * @brief Stand-ins of the GAP and GATT server API of the ESP-IDF that are used by the BLE server of
+ * the central (see BLEDevice.h). The requests of the link parameters are accepted and recorded.
+ */
+
+typedef int esp_err_t;
+#define ESP_OK 0
+#define ESP_FAIL -1
+
+typedef uint8_t esp_bd_addr_t[6];
+
+struct esp_ble_conn_update_params_t {
+  esp_bd_addr_t bda;
+  uint16_t min_int;
+  uint16_t max_int;
+  uint16_t latency;
+  uint16_t timeout;
+};
+
+union esp_ble_gatts_cb_param_t {
+  struct {
+    uint16_t conn_id;
+    esp_bd_addr_t remote_bda;
+  } connect;
+  struct {
+    uint16_t conn_id;
+    esp_bd_addr_t remote_bda;
+  } disconnect;
+};
+
+esp_err_t esp_ble_gap_update_conn_params(esp_ble_conn_update_params_t *params);
+esp_err_t esp_ble_gap_set_pkt_data_len(esp_bd_addr_t remote_device, uint16_t tx_data_length);
+
+namespace sensint {
+namespace native {
+
+/**
+ * @brief The last link parameters that were requested (see esp_ble_gap_update_conn_params).
+ */
+struct LinkRequests {
+  esp_ble_conn_update_params_t connection = {};
+  uint16_t data_length = 0;
+  uint32_t num_requests = 0;
+};
+
+LinkRequests &GetLinkRequests();
+
+}  // namespace native
+}  // namespace sensint
+
+#endif  // __SENSINT_NATIVE_ESP_GAP_BLE_API_H__
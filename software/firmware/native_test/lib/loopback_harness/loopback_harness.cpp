@@ -0,0 +1,143 @@
+#include "loopback_harness.h"
+
+namespace sensint {
+namespace transport {
+
+LoopbackHarness::Shoe::Shoe(const HarnessShoeConfig &config)
+    : config(config),
+      link(receiver, config.link),
+      sender(sample_ring, link, clock_sync, config.sender) {
+  sample_ring.Init(config.sample_ring_size, config.sample_ring_size);
+}
+
+LoopbackHarness::LoopbackHarness(const HarnessShoeConfig &left, const HarnessShoeConfig &right)
+    : LoopbackHarness(std::vector<HarnessShoeConfig>{left, right}) {}
+
+LoopbackHarness::LoopbackHarness(const std::vector<HarnessShoeConfig> &shoes) {
+  for (const auto &config : shoes) {
+    shoes_.emplace_back(new Shoe(config));
+  }
+}
+
+LoopbackHarness::~LoopbackHarness() {}
+
+size_t LoopbackHarness::GetNumShoes() const { return shoes_.size(); }
+
+void LoopbackHarness::Connect(const size_t shoe) {
+  auto &state = *shoes_[shoe];
+  state.link.Connect();
+  const uint32_t next_sample = state.link.ReadNextSample();
+  if (next_sample != 0) {
+    state.sample_ring.Rewind(next_sample);
+  }
+  state.sender.Resync();
+}
+
+void LoopbackHarness::Disconnect(const size_t shoe) { shoes_[shoe]->link.Disconnect(); }
+
+void LoopbackHarness::Run(const uint32_t duration_us) {
+  const uint32_t end_us = now_us_ + duration_us;
+  while (static_cast<int32_t>(end_us - now_us_) > 0) {
+    now_us_ += kStepUs;
+    for (auto &shoe : shoes_) {
+      Record(*shoe);
+      // the packets that are due are delivered before the new ones are sent
+      shoe->link.Poll(now_us_);
+      if (shoe->link.IsConnected()) {
+        shoe->sender.Step(now_us_ / 1000);
+      }
+      Decode(*shoe);
+    }
+  }
+}
+
+uint32_t LoopbackHarness::GetTime() const { return now_us_; }
+
+size_t LoopbackHarness::GetPending(const size_t shoe) const {
+  return shoes_[shoe]->sample_ring.GetPending();
+}
+
+const HarnessShoeResult &LoopbackHarness::GetResult(const size_t shoe) const {
+  return shoes_[shoe]->result;
+}
+
+const ble::stream::StreamStatistics &LoopbackHarness::GetStreamStatistics(const size_t shoe) const {
+  return shoes_[shoe]->monitor.GetStatistics();
+}
+
+const LoopbackStatistics &LoopbackHarness::GetLinkStatistics(const size_t shoe) const {
+  return shoes_[shoe]->link.GetStatistics();
+}
+
+/**
+ * The payload of a sample carries its index, so that the central can verify that every sample is
+ * decoded as the one that was recorded.
+ */
+void LoopbackHarness::Record(Shoe &shoe) {
+  pipeline::Message message;
+  while (static_cast<int32_t>(now_us_ - shoe.next_pressure_us) >= 0) {
+    message.timestamp_us = shoe.next_pressure_us;
+    message.type = pipeline::MessageType::kPressureData;
+    message.payload.pressure = {static_cast<analog_sensor_t>(shoe.result.recorded_samples), 0, 0,
+                                0};
+    shoe.sample_ring.Push(message);
+    shoe.result.recorded_samples++;
+    shoe.next_pressure_us += shoe.config.pressure_period_us;
+  }
+  while (static_cast<int32_t>(now_us_ - shoe.next_imu_us) >= 0) {
+    message.timestamp_us = shoe.next_imu_us;
+    message.type = pipeline::MessageType::kImuData;
+    message.payload.imu = ImuData();
+    message.payload.imu.orientation_quaternion.w = static_cast<float>(shoe.result.recorded_samples);
+    shoe.sample_ring.Push(message);
+    shoe.result.recorded_samples++;
+    shoe.next_imu_us += shoe.config.imu_period_us;
+  }
+  shoe.result.dropped_samples = shoe.sample_ring.GetDropped();
+}
+
+/**
+ * The same steps as HandleShoeStream of controller_shoe_pc.
+ */
+void LoopbackHarness::Decode(Shoe &shoe) {
+  using namespace sensint::ble;
+  stream::Packet packet;
+  while (shoe.receiver.packets_.Pop(packet)) {
+    stream::PacketReader reader(packet.data, packet.length);
+    if (!reader.IsValid()) {
+      continue;
+    }
+    stream::StreamGap gap;
+    uint8_t skip = shoe.monitor.Update(reader.GetHeader(), packet.length, gap);
+    uint32_t index = reader.GetHeader().first_sample;
+    stream::Sample sample;
+    for (; reader.Next(sample); index++) {
+      if (skip > 0) {
+        skip--;
+        continue;
+      }
+      DecodeSample(shoe, index, sample);
+    }
+  }
+  shoe.monitor.SetDroppedPackets(shoe.receiver.packets_.GetDropped());
+}
+
+void LoopbackHarness::DecodeSample(Shoe &shoe, const uint32_t index,
+                                   const ble::stream::Sample &sample) {
+  using namespace sensint::ble;
+  const bool in_order = !shoe.has_sample || static_cast<int32_t>(index - shoe.last_sample) > 0;
+  const bool matches = (sample.type == stream::SampleType::kPressure)
+                           ? sample.payload.pressure.w == static_cast<analog_sensor_t>(index)
+                           : sample.payload.imu.orientation_quaternion.w ==
+                                 static_cast<float>(index);
+  if (!in_order || !matches) {
+    shoe.result.corrupt_samples++;
+  }
+  shoe.has_sample = true;
+  shoe.last_sample = index;
+  shoe.result.received_samples++;
+  shoe.result.latencies_us.push_back(now_us_ - sample.timestamp_us);
+}
+
+}  // namespace transport
+}  // namespace sensint
@@ -0,0 +1,128 @@
+#ifndef __SENSINT_LOOPBACK_HARNESS_H__
+#define __SENSINT_LOOPBACK_HARNESS_H__
+
+#include <ble_stream.h>
+#include <clock_sync.h>
+#include <loopback_transport.h>
+#include <sample_ring.h>
+#include <stream_sender.h>
+#include <stream_transport.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace sensint {
+namespace transport {
+
+/**
+ * @brief The configuration of a single shoe and of its link to the central.
+ */
+struct HarnessShoeConfig {
+  LoopbackConfig link;
+  StreamSenderConfig sender;
+  // the periods of the pressure sensors (read via I2C) and of the IMU (400 Hz)
+  uint32_t pressure_period_us = 1000;
+  uint32_t imu_period_us = 2500;
+  // the samples that are kept while the link is down (the RAM of a shoe without PSRAM)
+  size_t sample_ring_size = 1024;
+};
+
+/**
+ * @brief What the central received from a single shoe.
+ */
+struct HarnessShoeResult {
+  // the samples that were recorded by the shoe, including the ones dropped by the sample ring
+  uint32_t recorded_samples = 0;
+  // the samples that were dropped, because the sample ring was full (e.g. while disconnected)
+  uint32_t dropped_samples = 0;
+  // the samples that were passed to the application of the central, i.e. without duplicates
+  uint32_t received_samples = 0;
+  // samples that were received out of order or with a payload of another sample
+  uint32_t corrupt_samples = 0;
+  // the time from the acquisition of a sample until the central decoded it
+  std::vector<uint32_t> latencies_us;
+};
+
+/**
+ * @brief A central and its shoes in a single process. Every shoe records its samples in a sample
+ * ring and packs them with the StreamSender of the firmware (see controller_shoe_remote). The
+ * packets are sent via a LoopbackTransport to the StreamReceiver of the central, which decodes
+ * them with the StreamMonitor like HandleShoeStream of controller_shoe_pc.
+ *
+ * The simulation advances in steps of kStepUs, which is the period of the transport task, and runs
+ * faster than real time. The clocks of the shoes are the simulated time, hence the latency of a
+ * sample is the difference between its timestamp and the time it was decoded.
+ *
+ * //! Every shoe has a link of its own, i.e. the airtime that the connections share on the radio of
+ * //! the central is not simulated.
+ */
+class LoopbackHarness {
+ public:
+  static constexpr uint32_t kStepUs = 1000;
+
+  /**
+   * @brief A single subject, i.e. a left and a right shoe.
+   */
+  LoopbackHarness(const HarnessShoeConfig &left = HarnessShoeConfig(),
+                  const HarnessShoeConfig &right = HarnessShoeConfig());
+  /**
+   * @brief Any number of shoes, e.g. the shoes of several subjects.
+   */
+  explicit LoopbackHarness(const std::vector<HarnessShoeConfig> &shoes);
+  ~LoopbackHarness();
+
+  size_t GetNumShoes() const;
+
+  /**
+   * @brief Connect a shoe like HandleBLEConnection does, i.e. the samples that the central did not
+   * receive are sent again.
+   */
+  void Connect(const size_t shoe);
+  void Disconnect(const size_t shoe);
+
+  /**
+   * @brief Record, send and decode the samples of all shoes for the given duration.
+   */
+  void Run(const uint32_t duration_us);
+
+  uint32_t GetTime() const;
+  size_t GetPending(const size_t shoe) const;
+  const HarnessShoeResult &GetResult(const size_t shoe) const;
+  const ble::stream::StreamStatistics &GetStreamStatistics(const size_t shoe) const;
+  const LoopbackStatistics &GetLinkStatistics(const size_t shoe) const;
+
+ private:
+  struct Shoe {
+    explicit Shoe(const HarnessShoeConfig &config);
+
+    HarnessShoeConfig config;
+    // the shoe
+    pipeline::SampleRing sample_ring;
+    sync::ClockSync clock_sync;
+    uint32_t next_pressure_us = 0;
+    uint32_t next_imu_us = 0;
+    // the central
+    StreamReceiver receiver;
+    ble::stream::StreamMonitor monitor;
+    bool has_sample = false;
+    uint32_t last_sample = 0;
+    // the link between both
+    LoopbackTransport link;
+    StreamSender sender;
+    HarnessShoeResult result;
+  };
+
+  void Record(Shoe &shoe);
+  void Decode(Shoe &shoe);
+  void DecodeSample(Shoe &shoe, const uint32_t index, const ble::stream::Sample &sample);
+
+  std::vector<std::unique_ptr<Shoe>> shoes_;
+  uint32_t now_us_ = 0;
+};
+
+}  // namespace transport
+}  // namespace sensint
+
+#endif  // __SENSINT_LOOPBACK_HARNESS_H__
@@ -0,0 +1,66 @@
+#include <BLEDevice.h>
+#include <benchmark/benchmark.h>
+#include <ble_server.h>
+
+#include <cstdlib>
+#include <memory>
+#include <new>
+
+/**
+ * The setup of the GATT table of the central (BleServer::Init), i.e. the characteristics of the
+ * table in ble_config.h with their descriptors, callbacks and initial values. The BLE library is
+ * replaced by stand-ins (see lib/ble_shims), hence the registration of the attributes by the BLE
+ * stack of the ESP32 is not included. The heap allocations of the stand-ins are included in the
+ * counters, the ones of the BLE library of the ESP32 differ.
+ *
+ * On the ESP32, the debug build of controller_shoe_pc logs the duration and the heap of Init (see
+ * SetupBLEServer).
+ *
+ * This file is built by the benchmark_ble_server environment only, because it counts every heap
+ * allocation of the program.
+ */
+
+namespace {
+
+size_t num_allocations = 0;
+size_t num_allocated_bytes = 0;
+
+}  // namespace
+
+//! the replacements are not inlined, otherwise GCC warns about free() of the memory of new
+__attribute__((noinline)) void *operator new(size_t size) {
+  num_allocations++;
+  num_allocated_bytes += size;
+  if (void *memory = malloc(size)) {
+    return memory;
+  }
+  throw std::bad_alloc();
+}
+__attribute__((noinline)) void operator delete(void *memory) noexcept { free(memory); }
+__attribute__((noinline)) void operator delete(void *memory, size_t size) noexcept {
+  free(memory);
+}
+
+static void BM_BleServerInit(benchmark::State &bm_state) {
+  size_t allocations = 0;
+  size_t allocated_bytes = 0;
+  for (auto _ : bm_state) {
+    bm_state.PauseTiming();
+    std::unique_ptr<sensint::ble::BleServer> server(new sensint::ble::BleServer());
+    const size_t start_allocations = num_allocations;
+    const size_t start_allocated_bytes = num_allocated_bytes;
+    bm_state.ResumeTiming();
+    server->Init();
+    bm_state.PauseTiming();
+    allocations += num_allocations - start_allocations;
+    allocated_bytes += num_allocated_bytes - start_allocated_bytes;
+    BLEDevice::deinit(true);
+    server.reset();
+    bm_state.ResumeTiming();
+  }
+  bm_state.counters["allocations"] =
+      benchmark::Counter(allocations, benchmark::Counter::kAvgIterations);
+  bm_state.counters["bytes"] =
+      benchmark::Counter(allocated_bytes, benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_BleServerInit);
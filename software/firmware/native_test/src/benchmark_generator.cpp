@@ -0,0 +1,141 @@
+#include <benchmark/benchmark.h>
+#include <helper.h>
+#include <state_management.h>
+
+#include <string>
+#include <vector>
+
+/**
+ * The hot paths of the signal generator: the processing of a sensor sample (see HandleAugmentation
+ * of generator_stereo_out) and the parsing of the library messages.
+ */
+
+using namespace sensint;
+
+namespace {
+
+//! the sensor range of the signal generator (10 bit ADC)
+constexpr analog_sensor_t kMaxSensorValue = 1023;
+
+GrainSequence CreateSequence(const uint8_t id, const int num_grains, const int num_materials) {
+  GrainSequence sequence;
+  sequence.id = id;
+  for (int i = 0; i < num_grains; i++) {
+    const auto position = static_cast<analog_sensor_t>(i * kMaxSensorValue / num_grains);
+    sequence.grains.push_back(
+        Grain{static_cast<uint8_t>(1 + i % num_materials), position, position});
+  }
+  return sequence;
+}
+
+Material CreateMaterial(const uint8_t id) {
+  Material material;
+  material.id = id;
+  material.grain_params.raw_signal_params.frequency = 100.f + id;
+  material.grain_params.duration = 2000.f;
+  return material;
+}
+
+/**
+ * @brief A triangle sweep over the sensor range, i.e. like a step of the shoe.
+ */
+analog_sensor_t GetSensorValue(const size_t sample) {
+  const auto phase = static_cast<analog_sensor_t>(sample % (2 * kMaxSensorValue));
+  return (phase < kMaxSensorValue) ? phase
+                                   : static_cast<analog_sensor_t>(2 * kMaxSensorValue - phase);
+}
+
+}  // namespace
+
+static void BM_FindClosestGrainIndex(benchmark::State &bm_state) {
+  SequenceLib lib;
+  lib.AddSequence(CreateSequence(1, static_cast<int>(bm_state.range(0)), 1));
+  const auto &sequence = *lib.GetSequence(lib.GetSequenceHandle(1));
+  size_t sample = 0;
+  for (auto _ : bm_state) {
+    benchmark::DoNotOptimize(
+        tactile_audio::FindClosestGrainIndex(sequence, GetSensorValue(sample++)));
+  }
+}
+BENCHMARK(BM_FindClosestGrainIndex)->Arg(20)->Arg(128)->Arg(512);
+
+/**
+ * The processing of a sensor sample of one channel, including the start and stop of the grains
+ * and the change of the material. The grains are several sensor values apart, i.e. outside of
+ * the jitter threshold.
+ */
+static void BM_ProcessSensorSample(benchmark::State &bm_state) {
+  const auto num_materials = static_cast<int>(bm_state.range(1));
+  LibraryBuffer libraries;
+  for (int id = 1; id <= num_materials; id++) {
+    libraries.GetShadowMaterialLib().AddMaterial(CreateMaterial(static_cast<uint8_t>(id)));
+  }
+  libraries.GetShadowSequenceLib().AddSequence(
+      CreateSequence(1, static_cast<int>(bm_state.range(0)), num_materials));
+  libraries.MarkEdited();
+  libraries.Commit();
+  AugmentationState state;
+  tactile_audio::MonoAudio audio;
+  state_management::HandleLibraryCommit(state, libraries);
+  state_management::SelectSequence(state, libraries.GetSequenceLib().GetSequenceHandle(1),
+                                   libraries.GetSequenceLib());
+  size_t sample = 0;
+  size_t num_triggers = 0;
+  for (auto _ : bm_state) {
+    using namespace state_management;
+    // a sample every 1 ms
+    host_audio::SetMicros(static_cast<uint32_t>(sample * 1000));
+    state.current_sensor_value = GetSensorValue(sample++);
+    const auto idx =
+        tactile_audio::FindClosestGrainIndex(*state.current_sequence, state.current_sensor_value);
+    CheckAndStopContinuousVibration(idx, state, audio);
+    CheckAndStopGrain(idx, state, audio);
+    state.closest_grain = (*state.current_sequence)[idx];
+    num_triggers += CheckAndStartClosestGrain(idx, state, audio, libraries.GetMaterialLib());
+  }
+  bm_state.counters["triggers"] =
+      benchmark::Counter(static_cast<double>(num_triggers), benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_ProcessSensorSample)->Args({20, 1})->Args({128, 16})->Args({256, 255});
+
+static void BM_ParseGrainSequenceList(benchmark::State &bm_state) {
+  std::vector<GrainSequence> sequences;
+  for (int id = 1; id <= 8; id++) {
+    sequences.push_back(CreateSequence(static_cast<uint8_t>(id), bm_state.range(0), 4));
+  }
+  std::string message;
+  communication::SerializeGrainSequenceList(sequences, message);
+  std::vector<std::string> tokens;
+  std::vector<GrainSequence> parsed;
+  for (auto _ : bm_state) {
+    helper::SplitString(message, tokens);
+    benchmark::DoNotOptimize(communication::ParseGrainSequenceList(tokens, 8, parsed));
+  }
+  bm_state.SetBytesProcessed(static_cast<int64_t>(bm_state.iterations() * message.size()));
+}
+BENCHMARK(BM_ParseGrainSequenceList)->Arg(16)->Arg(128);
+
+/**
+ * The update of a sequence by a message, i.e. parsing, the edit of the shadow library, and the
+ * commit of the libraries.
+ */
+static void BM_UpdateSequenceMessage(benchmark::State &bm_state) {
+  LibraryBuffer libraries;
+  AugmentationState state;
+  for (int id = 1; id <= 32; id++) {
+    libraries.GetShadowSequenceLib().AddSequence(CreateSequence(static_cast<uint8_t>(id), 32, 1));
+  }
+  libraries.MarkEdited();
+  libraries.Commit();
+  std::string payload;
+  communication::SerializeGrainSequence(CreateSequence(16, bm_state.range(0), 1), payload);
+  std::vector<std::string> tokens;
+  helper::SplitString("0,55," + std::to_string(bm_state.range(0)) + "," + payload, tokens);
+  for (auto _ : bm_state) {
+    state_management::UpdateConfig(communication::MessageTypes::kUpdateGrainSequence, tokens,
+                                   state, libraries);
+    libraries.Commit();
+    state_management::HandleLibraryCommit(state, libraries);
+  }
+}
+BENCHMARK(BM_UpdateSequenceMessage)->Arg(16)->Arg(128);
@@ -0,0 +1,185 @@
+#include <benchmark/benchmark.h>
+#include <material_lib.h>
+#include <sequence_lib.h>
+
+#include <algorithm>
+#include <vector>
+
+/**
+ * The lookups and edits of the material and sequence libraries with up to 255 entries, i.e. all IDs
+ * besides the default. The lookups of the ID index are compared with the linear search over the
+ * entries, which the libraries used before.
+ */
+
+using namespace sensint;
+
+namespace {
+
+//! the grains per sequence, so that 255 sequences fit into the grain arena
+constexpr uint16_t kNumGrains = 4;
+
+Material CreateMaterial(const uint8_t id) {
+  Material material;
+  material.id = id;
+  material.grain_params.raw_signal_params.frequency = 100.f + id;
+  return material;
+}
+
+GrainSequence CreateSequence(const uint8_t id) {
+  GrainSequence sequence;
+  sequence.id = id;
+  for (uint16_t i = 0; i < kNumGrains; i++) {
+    const auto position = static_cast<analog_sensor_t>(100 * i + id % 100);
+    sequence.grains.push_back(Grain{id, position, position});
+  }
+  return sequence;
+}
+
+/**
+ * @brief The IDs 1 to num_entries in a shuffled order, i.e. the lookups are not predictable.
+ */
+std::vector<uint8_t> GetShuffledIds(const int num_entries) {
+  std::vector<uint8_t> ids;
+  for (int id = 1; id <= num_entries; id++) {
+    ids.push_back(static_cast<uint8_t>(id));
+  }
+  for (size_t i = ids.size() - 1; i > 0; i--) {
+    std::swap(ids[i], ids[(i * 7919) % (i + 1)]);
+  }
+  return ids;
+}
+
+MaterialLib CreateMaterialLib(const int num_entries) {
+  MaterialLib lib;
+  for (const auto id : GetShuffledIds(num_entries)) {
+    lib.AddMaterial(CreateMaterial(id));
+  }
+  return lib;
+}
+
+SequenceLib CreateSequenceLib(const int num_entries) {
+  SequenceLib lib;
+  for (const auto id : GetShuffledIds(num_entries)) {
+    lib.AddSequence(CreateSequence(id));
+  }
+  return lib;
+}
+
+}  // namespace
+
+static void BM_GetMaterialIndexByID(benchmark::State &bm_state) {
+  const auto lib = CreateMaterialLib(static_cast<int>(bm_state.range(0)));
+  const auto ids = GetShuffledIds(static_cast<int>(bm_state.range(0)));
+  size_t i = 0;
+  for (auto _ : bm_state) {
+    benchmark::DoNotOptimize(lib.GetMaterialIndexByID(ids[i++ % ids.size()]));
+  }
+}
+BENCHMARK(BM_GetMaterialIndexByID)->Arg(16)->Arg(64)->Arg(255);
+
+/**
+ * The previous lookup, i.e. a linear search over the materials ordered by ID.
+ */
+static void BM_LinearMaterialLookup(benchmark::State &bm_state) {
+  std::vector<Material> materials;
+  for (int id = 0; id <= bm_state.range(0); id++) {
+    materials.push_back(CreateMaterial(static_cast<uint8_t>(id)));
+  }
+  const auto ids = GetShuffledIds(static_cast<int>(bm_state.range(0)));
+  size_t i = 0;
+  for (auto _ : bm_state) {
+    const auto id = ids[i++ % ids.size()];
+    benchmark::DoNotOptimize(std::find_if(materials.begin(), materials.end(),
+                                          [id](const Material &m) { return m.id == id; }));
+  }
+}
+BENCHMARK(BM_LinearMaterialLookup)->Arg(16)->Arg(64)->Arg(255);
+
+/**
+ * The lookup of the trigger path, i.e. a handle that is resolved for every grain.
+ */
+static void BM_GetMaterialByHandle(benchmark::State &bm_state) {
+  const auto lib = CreateMaterialLib(static_cast<int>(bm_state.range(0)));
+  std::vector<MaterialHandle> handles;
+  for (const auto id : GetShuffledIds(static_cast<int>(bm_state.range(0)))) {
+    handles.push_back(lib.GetMaterialHandle(id));
+  }
+  size_t i = 0;
+  for (auto _ : bm_state) {
+    benchmark::DoNotOptimize(lib.GetMaterial(handles[i++ % handles.size()]));
+  }
+}
+BENCHMARK(BM_GetMaterialByHandle)->Arg(16)->Arg(64)->Arg(255);
+
+static void BM_UpdateMaterial(benchmark::State &bm_state) {
+  auto lib = CreateMaterialLib(static_cast<int>(bm_state.range(0)));
+  const auto ids = GetShuffledIds(static_cast<int>(bm_state.range(0)));
+  size_t i = 0;
+  for (auto _ : bm_state) {
+    benchmark::DoNotOptimize(lib.UpdateMaterial(CreateMaterial(ids[i++ % ids.size()])));
+  }
+}
+BENCHMARK(BM_UpdateMaterial)->Arg(16)->Arg(64)->Arg(255);
+
+/**
+ * A delete and an add of the same ID, i.e. the slot is freed and reused.
+ */
+static void BM_DeleteAndAddMaterial(benchmark::State &bm_state) {
+  auto lib = CreateMaterialLib(static_cast<int>(bm_state.range(0)));
+  const auto ids = GetShuffledIds(static_cast<int>(bm_state.range(0)));
+  size_t i = 0;
+  for (auto _ : bm_state) {
+    const auto id = ids[i++ % ids.size()];
+    lib.DeleteMaterial(id);
+    benchmark::DoNotOptimize(lib.AddMaterial(CreateMaterial(id)));
+  }
+}
+BENCHMARK(BM_DeleteAndAddMaterial)->Arg(16)->Arg(64)->Arg(255);
+
+static void BM_GetSequenceByHandle(benchmark::State &bm_state) {
+  const auto lib = CreateSequenceLib(static_cast<int>(bm_state.range(0)));
+  std::vector<SequenceHandle> handles;
+  for (const auto id : GetShuffledIds(static_cast<int>(bm_state.range(0)))) {
+    handles.push_back(lib.GetSequenceHandle(id));
+  }
+  size_t i = 0;
+  for (auto _ : bm_state) {
+    benchmark::DoNotOptimize(lib.GetSequence(handles[i++ % handles.size()]));
+  }
+}
+BENCHMARK(BM_GetSequenceByHandle)->Arg(16)->Arg(64)->Arg(255);
+
+/**
+ * An update of a sequence of the same size, i.e. the grains are replaced in the arena.
+ */
+static void BM_UpdateSequence(benchmark::State &bm_state) {
+  auto lib = CreateSequenceLib(static_cast<int>(bm_state.range(0)));
+  std::vector<GrainSequence> sequences;
+  for (const auto id : GetShuffledIds(static_cast<int>(bm_state.range(0)))) {
+    sequences.push_back(CreateSequence(id));
+  }
+  size_t i = 0;
+  for (auto _ : bm_state) {
+    benchmark::DoNotOptimize(lib.UpdateSequence(sequences[i++ % sequences.size()]));
+  }
+}
+BENCHMARK(BM_UpdateSequence)->Arg(16)->Arg(64)->Arg(255);
+
+/**
+ * A delete and an add of the same ID. The delete shifts the grains of the following sequences in
+ * the arena, hence the cost depends on the number of grains.
+ */
+static void BM_DeleteAndAddSequence(benchmark::State &bm_state) {
+  auto lib = CreateSequenceLib(static_cast<int>(bm_state.range(0)));
+  std::vector<GrainSequence> sequences;
+  for (const auto id : GetShuffledIds(static_cast<int>(bm_state.range(0)))) {
+    sequences.push_back(CreateSequence(id));
+  }
+  size_t i = 0;
+  for (auto _ : bm_state) {
+    const auto &sequence = sequences[i++ % sequences.size()];
+    lib.DeleteSequence(sequence.id);
+    benchmark::DoNotOptimize(lib.AddSequence(sequence));
+  }
+}
+BENCHMARK(BM_DeleteAndAddSequence)->Arg(16)->Arg(64)->Arg(255);
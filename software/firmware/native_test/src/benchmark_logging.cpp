@@ -0,0 +1,86 @@
+#include <Arduino.h>
+#include <benchmark/benchmark.h>
+#include <debug.h>
+
+/**
+ * The debug output of a grain trigger (see CheckAndStartGrain) as String message (debug::Log) and
+ * as tokenized message (debug::LogTokenized). The serial port of the host discards the output,
+ * i.e. the time of a transmission via USB is not included, which favors debug::Log.
+ *
+ * This file is built by the benchmark_logging environment only, because the release build of the
+ * benchmark environment has no debug output.
+ */
+
+using namespace sensint;
+using namespace sensint::debug;
+
+namespace {
+
+//! the values of a grain trigger
+constexpr int kGrainIdx = 7;
+constexpr uint16_t kPosStart = 420;
+constexpr uint16_t kSensorValue = 421;
+constexpr uint8_t kMaterialId = 3;
+
+void SetBytesPerMessage(benchmark::State &bm_state) {
+  bm_state.counters["bytes"] =
+      benchmark::Counter(static_cast<double>(Serial.GetNumWrittenBytes()),
+                         benchmark::Counter::kAvgIterations);
+  Serial.Reset();
+}
+
+}  // namespace
+
+static void BM_LogString(benchmark::State &bm_state) {
+  Serial.Reset();
+  int grain_idx = kGrainIdx;
+  for (auto _ : bm_state) {
+    Log("CheckAndStartGrain",
+        "trigger grain - idx:" + String(grain_idx++) + " pos:" + String(kPosStart) +
+            " | sensor:" + String((int)kSensorValue) + " | mat:" + String((int)kMaterialId),
+        DebugLevel::verbose);
+  }
+  SetBytesPerMessage(bm_state);
+}
+BENCHMARK(BM_LogString);
+
+/**
+ * The cost in the hot path, i.e. the copy into the log buffer. The buffer is drained outside of
+ * the measurement before it overflows.
+ */
+static void BM_LogTokenized(benchmark::State &bm_state) {
+  DrainLog(kLogCapacity);
+  Serial.Reset();
+  int grain_idx = kGrainIdx;
+  size_t count = 0;
+  for (auto _ : bm_state) {
+    LogTokenized<LogToken::kStartGrain>(DebugLevel::verbose, grain_idx++, kPosStart, kSensorValue,
+                                        kMaterialId);
+    if (++count == kLogCapacity) {
+      bm_state.PauseTiming();
+      DrainLog(kLogCapacity);
+      count = 0;
+      bm_state.ResumeTiming();
+    }
+  }
+  DrainLog(kLogCapacity);
+  SetBytesPerMessage(bm_state);
+}
+BENCHMARK(BM_LogTokenized);
+
+/**
+ * The total cost of a tokenized message, i.e. including the binary frame that is written at the
+ * end of the loop by DrainLog.
+ */
+static void BM_LogTokenizedAndDrain(benchmark::State &bm_state) {
+  DrainLog(kLogCapacity);
+  Serial.Reset();
+  int grain_idx = kGrainIdx;
+  for (auto _ : bm_state) {
+    LogTokenized<LogToken::kStartGrain>(DebugLevel::verbose, grain_idx++, kPosStart, kSensorValue,
+                                        kMaterialId);
+    DrainLog(1);
+  }
+  SetBytesPerMessage(bm_state);
+}
+BENCHMARK(BM_LogTokenizedAndDrain);
@@ -0,0 +1,111 @@
+#include <benchmark/benchmark.h>
+#include <global_settings.h>
+#include <loopback_harness.h>
+
+#include <algorithm>
+#include <vector>
+
+/**
+ * The stream of the shoes to the central over the loopback (see loopback_harness.h), i.e. the
+ * packing of the StreamSender and the decoding with the StreamMonitor. Every iteration simulates a
+ * second of all shoes. The throughput is given in samples per second of host time, the latencies
+ * in microseconds of the simulated time.
+ *
+ * This file is built by the benchmark_controller environment only.
+ */
+
+using namespace sensint;
+using namespace sensint::transport;
+
+namespace {
+
+uint32_t GetPercentile(std::vector<uint32_t> values, const double percentile) {
+  if (values.empty()) {
+    return 0;
+  }
+  const auto nth = values.begin() + static_cast<size_t>(percentile * (values.size() - 1));
+  std::nth_element(values.begin(), nth, values.end());
+  return *nth;
+}
+
+void SetCounters(benchmark::State &bm_state, const LoopbackHarness &harness) {
+  uint32_t samples = 0;
+  uint32_t packets = 0;
+  uint32_t lost = 0;
+  std::vector<uint32_t> latencies;
+  for (size_t shoe = 0; shoe < harness.GetNumShoes(); shoe++) {
+    const auto &result = harness.GetResult(shoe);
+    samples += result.received_samples;
+    packets += harness.GetStreamStatistics(shoe).packets;
+    lost += harness.GetStreamStatistics(shoe).missing_samples;
+    latencies.insert(latencies.end(), result.latencies_us.begin(), result.latencies_us.end());
+  }
+  bm_state.SetItemsProcessed(samples);
+  bm_state.counters["samples/packet"] = static_cast<double>(samples) / packets;
+  // the samples that the central decoded per simulated second
+  bm_state.counters["decoded"] = benchmark::Counter(samples, benchmark::Counter::kAvgIterations);
+  // the missing samples per simulated second
+  bm_state.counters["missing"] = benchmark::Counter(lost, benchmark::Counter::kAvgIterations);
+  bm_state.counters["p50_us"] = GetPercentile(latencies, 0.5);
+  bm_state.counters["p99_us"] = GetPercentile(latencies, 0.99);
+}
+
+}  // namespace
+
+/**
+ * Both shoes with the given MTU and packet loss (in parts per million).
+ */
+static void BM_StreamLoopback(benchmark::State &bm_state) {
+  HarnessShoeConfig config;
+  config.link.mtu = static_cast<uint16_t>(bm_state.range(0));
+  config.link.loss_ppm = static_cast<uint32_t>(bm_state.range(1));
+  config.link.jitter_us = 2000;
+  LoopbackHarness harness(config, config);
+  harness.Connect(0);
+  harness.Connect(1);
+  for (auto _ : bm_state) {
+    harness.Run(1000000);
+  }
+  SetCounters(bm_state, harness);
+}
+BENCHMARK(BM_StreamLoopback)->Args({247, 0})->Args({247, 20000})->Args({23, 0});
+
+/**
+ * The shoes of 1 to kMaxNumberOfSubjects subjects, i.e. the aggregate throughput of the central
+ * as subjects are added. The links of the shoes are independent (see loopback_harness.h), hence
+ * only the cost of the central to decode the streams is measured, not the shared airtime.
+ */
+static void BM_StreamSubjects(benchmark::State &bm_state) {
+  const size_t subjects = static_cast<size_t>(bm_state.range(0));
+  HarnessShoeConfig config;
+  config.link.jitter_us = 2000;
+  LoopbackHarness harness(std::vector<HarnessShoeConfig>(2 * subjects, config));
+  for (size_t shoe = 0; shoe < harness.GetNumShoes(); shoe++) {
+    harness.Connect(shoe);
+  }
+  for (auto _ : bm_state) {
+    harness.Run(1000000);
+  }
+  SetCounters(bm_state, harness);
+  bm_state.counters["subjects"] = subjects;
+}
+BENCHMARK(BM_StreamSubjects)->DenseRange(1, settings::global::defaults::kMaxNumberOfSubjects);
+
+/**
+ * A reconnect after a disconnect of a second, i.e. the backlog of a shoe is sent back to back.
+ */
+static void BM_StreamBackfill(benchmark::State &bm_state) {
+  HarnessShoeConfig config;
+  config.sample_ring_size = 16384;
+  LoopbackHarness harness(config, config);
+  harness.Connect(0);
+  harness.Connect(1);
+  for (auto _ : bm_state) {
+    harness.Disconnect(0);
+    harness.Run(1000000);
+    harness.Connect(0);
+    harness.Run(1000000);
+  }
+  SetCounters(bm_state, harness);
+}
+BENCHMARK(BM_StreamBackfill);
@@ -0,0 +1,4 @@
+#include <benchmark/benchmark.h>
+
+//! the benchmarks are defined in the other files of this folder
+BENCHMARK_MAIN();
@@ -0,0 +1,116 @@
+#include <ble_tracking.h>
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+using namespace sensint;
+using namespace sensint::ble;
+
+namespace {
+
+constexpr uint32_t kAllSlots = (tracking::kNumSlots >= 32)
+                                   ? UINT32_MAX
+                                   : static_cast<uint32_t>((1ULL << tracking::kNumSlots) - 1);
+
+/**
+ * @brief The data of all slots, every slot has a distinct orientation and time offset.
+ */
+tracking::TrackingData CreateTrackingData(const uint32_t connected_imus) {
+  tracking::TrackingData tracking;
+  tracking.connected_imus = connected_imus;
+  for (size_t id = 0; id < tracking::kNumSlots; id++) {
+    tracking.imu[id].orientation_quaternion.w = 1.f + id;
+    tracking.imu[id].orientation_quaternion.x = 0.5f * id;
+    tracking.imu[id].time_offset = static_cast<uint32_t>(10 * id);
+  }
+  return tracking;
+}
+
+void ExpectRoundTrip(const uint32_t connected_imus) {
+  const auto tracking = CreateTrackingData(connected_imus);
+  uint8_t frame[tracking::kMaxFrameSize];
+  const auto size = tracking::Pack(tracking, frame);
+  ASSERT_EQ(tracking::GetFrameSize(connected_imus), size);
+
+  tracking::TrackingData unpacked;
+  unpacked.imu[0].time_offset = 12345;
+  ASSERT_TRUE(tracking::Unpack(frame, size, unpacked));
+  EXPECT_EQ(connected_imus, unpacked.connected_imus);
+  for (size_t id = 0; id < tracking::kNumSlots; id++) {
+    if (connected_imus & (1UL << id)) {
+      EXPECT_FLOAT_EQ(tracking.imu[id].orientation_quaternion.w,
+                      unpacked.imu[id].orientation_quaternion.w)
+          << "IMU " << id;
+      EXPECT_FLOAT_EQ(tracking.imu[id].orientation_quaternion.x,
+                      unpacked.imu[id].orientation_quaternion.x)
+          << "IMU " << id;
+      EXPECT_EQ(tracking.imu[id].time_offset, unpacked.imu[id].time_offset) << "IMU " << id;
+    }
+  }
+  // the slot of a disconnected IMU is not modified
+  if (!(connected_imus & 1UL)) {
+    EXPECT_EQ(12345u, unpacked.imu[0].time_offset);
+  }
+}
+
+}  // namespace
+
+TEST(BleTracking, FrameOfAllSlotsFitsIntoASingleAttribute) {
+  ASSERT_LE(tracking::kMaxFrameSize, stream::kMaxPacketSize);
+  EXPECT_EQ(tracking::kMaxFrameSize, tracking::GetFrameSize(kAllSlots));
+}
+
+TEST(BleTracking, EmptyMaskRoundTrip) {
+  EXPECT_EQ(sizeof(tracking::FrameHeader), tracking::GetFrameSize(0));
+  ExpectRoundTrip(0);
+}
+
+TEST(BleTracking, FullMaskRoundTrip) { ExpectRoundTrip(kAllSlots); }
+
+TEST(BleTracking, SparseMaskRoundTrip) {
+  ExpectRoundTrip(1UL << (tracking::kNumSlots - 1));
+  ExpectRoundTrip(0b10100101 & kAllSlots);
+  ExpectRoundTrip(0b01011010 & kAllSlots);
+}
+
+TEST(BleTracking, IgnoresTheIMUsBeyondTheSlots) {
+  const auto tracking = CreateTrackingData(UINT32_MAX);
+  std::vector<uint8_t> frame(tracking::kMaxFrameSize + sizeof(ImuData));
+  EXPECT_EQ(tracking::kMaxFrameSize, tracking::Pack(tracking, frame.data()));
+  tracking::TrackingData unpacked;
+  ASSERT_TRUE(tracking::Unpack(frame.data(), tracking::kMaxFrameSize, unpacked));
+  EXPECT_EQ(kAllSlots, unpacked.connected_imus);
+  if (tracking::kNumSlots >= 32) {
+    return;
+  }
+  // a tracking system with one more IMU than slots, its data follows the data of the slots
+  const tracking::FrameHeader header = {.connected_imus = kAllSlots | (kAllSlots + 1)};
+  memcpy(frame.data(), &header, sizeof(header));
+  ASSERT_TRUE(tracking::Unpack(frame.data(), frame.size(), unpacked));
+  EXPECT_EQ(kAllSlots, unpacked.connected_imus);
+  EXPECT_EQ(tracking.imu[tracking::kNumSlots - 1].time_offset,
+            unpacked.imu[tracking::kNumSlots - 1].time_offset);
+}
+
+TEST(BleTracking, RejectsATruncatedOrOversizedFrame) {
+  const auto tracking = CreateTrackingData(0b1011);
+  std::vector<uint8_t> frame(tracking::kMaxFrameSize + 1);
+  const auto size = tracking::Pack(tracking, frame.data());
+
+  tracking::TrackingData unpacked;
+  EXPECT_FALSE(tracking::Unpack(frame.data(), size - 1, unpacked));
+  EXPECT_FALSE(tracking::Unpack(frame.data(), size + 1, unpacked));
+  EXPECT_FALSE(tracking::Unpack(frame.data(), sizeof(tracking::FrameHeader) - 1, unpacked));
+  EXPECT_FALSE(tracking::Unpack(frame.data(), 0, unpacked));
+  EXPECT_FALSE(tracking::Unpack(nullptr, size, unpacked));
+  // a rejected frame does not modify the data
+  EXPECT_EQ(0u, unpacked.connected_imus);
+  EXPECT_TRUE(tracking::Unpack(frame.data(), size, unpacked));
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
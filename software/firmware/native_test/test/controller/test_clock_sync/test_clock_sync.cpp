@@ -0,0 +1,209 @@
+#include <clock_sync.h>
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <random>
+
+using namespace sensint::sync;
+
+namespace {
+
+/**
+ * @brief The clocks of the server (reference) and of a shoe (local) as functions of the true time.
+ * Both are 32 bit microsecond counters like micros() and esp_timer_get_time(), i.e. they wrap
+ * around. The local clock drifts relative to the reference.
+ */
+struct Clocks {
+  uint32_t reference_start_us;
+  uint32_t local_start_us;
+  double drift_ppm;
+
+  uint32_t Reference(const int64_t time_us) const {
+    return reference_start_us + static_cast<uint32_t>(time_us);
+  }
+
+  uint32_t Local(const int64_t time_us) const {
+    return local_start_us + static_cast<uint32_t>(llround(time_us * (1.0 + drift_ppm * 1e-6)));
+  }
+};
+
+/**
+ * @brief Simulate the exchanges of the timestamp characteristic with a BLE connection interval
+ * of 7.5 ms, i.e. delays between one and two intervals in each direction.
+ */
+class ClockSyncSimulation {
+ public:
+  ClockSyncSimulation(const Clocks &clocks, const uint32_t seed) : clocks_(clocks), random_(seed) {}
+
+  ClockSyncExchange Exchange(const int64_t time_us, const uint32_t extra_delay_us = 0) {
+    std::uniform_int_distribution<int64_t> delay(interval_us_, interval_us_ + 500);
+    const int64_t sent_us = time_us;
+    const int64_t received_us = sent_us + delay(random_) + extra_delay_us;
+    const int64_t answered_us = received_us + 200;
+    const int64_t returned_us = answered_us + delay(random_);
+    return {clocks_.Local(sent_us), clocks_.Reference(received_us), clocks_.Reference(answered_us),
+            clocks_.Local(returned_us)};
+  }
+
+  void SetConnectionInterval(const int64_t interval_us) { interval_us_ = interval_us; }
+
+  /**
+   * @brief The error of the synchronized local timestamp at the given time.
+   */
+  int32_t GetError(const ClockSync &sync, const int64_t time_us) const {
+    return static_cast<int32_t>(sync.ToReferenceTime(clocks_.Local(time_us)) -
+                                clocks_.Reference(time_us));
+  }
+
+ private:
+  Clocks clocks_;
+  std::mt19937 random_;
+  int64_t interval_us_ = 7500;
+};
+
+/**
+ * @brief The time of an exchange like the shoe sends them, i.e. in the fast interval until it is
+ * synchronized and in the regular interval afterwards (see kClockSyncIntervalMs).
+ */
+int64_t GetExchangeTime(const int exchange) {
+  constexpr int64_t kFastIntervalUs = 100000;
+  constexpr int64_t kIntervalUs = 1000000;
+  constexpr int kNumFast = static_cast<int>(ClockSync::kMinExchanges);
+  return (exchange < kNumFast) ? exchange * kFastIntervalUs
+                               : (kNumFast - 1) * kFastIntervalUs + (exchange - kNumFast + 1) *
+                                                                        kIntervalUs;
+}
+
+//! the interval of the exchanges of the shoe once it is synchronized
+constexpr int64_t kIntervalUs = 1000000;
+/**
+ * The asymmetry of the delays shifts the offset of an exchange by up to 250 us. The window of 16
+ * exchanges, i.e. 16 s, averages it to an error below 150 us and a drift error below 20 ppm.
+ */
+constexpr int32_t kMaxOffsetErrorUs = 150;
+constexpr int32_t kMaxDriftErrorPpb = 20000;
+constexpr uint32_t kMaxResidualUs = 400;
+
+}  // namespace
+
+TEST(ClockSync, ReturnsTheLocalTimeUntilSynchronized) {
+  ClockSync sync;
+  EXPECT_FALSE(sync.IsSynchronized());
+  EXPECT_EQ(12345u, sync.ToReferenceTime(12345));
+  ClockSyncSimulation simulation({1000000, 5000, 0.0}, 1);
+  for (size_t i = 0; i < ClockSync::kMinExchanges; i++) {
+    EXPECT_FALSE(sync.IsSynchronized());
+    ASSERT_TRUE(sync.AddExchange(simulation.Exchange(GetExchangeTime(i))));
+  }
+  EXPECT_TRUE(sync.IsSynchronized());
+  sync.Reset();
+  EXPECT_FALSE(sync.IsSynchronized());
+  EXPECT_EQ(12345u, sync.ToReferenceTime(12345));
+}
+
+TEST(ClockSync, EstimatesTheOffsetAndTheDrift) {
+  const Clocks clocks{2000000000u, 1000u, 40.0};
+  ClockSyncSimulation simulation(clocks, 2);
+  ClockSync sync;
+  for (int i = 0; i < 50; i++) {
+    ASSERT_TRUE(sync.AddExchange(simulation.Exchange(GetExchangeTime(i))));
+  }
+  EXPECT_NEAR(40000, -sync.GetDriftPpb(), kMaxDriftErrorPpb);
+  EXPECT_GE(sync.GetDelay(), 15000u);
+  EXPECT_LE(sync.GetDelay(), 16000u);
+  EXPECT_LT(sync.GetResidual(), kMaxResidualUs);
+  for (int64_t t = GetExchangeTime(49); t < GetExchangeTime(50); t += 50000) {
+    EXPECT_LT(std::abs(simulation.GetError(sync, t)), kMaxOffsetErrorUs) << "at " << t;
+  }
+}
+
+/**
+ * Both clocks are shifted, so that one of them wraps around in the middle of the window. The
+ * estimate has to be exactly the same as without the shift, i.e. the timestamps are converted
+ * equally well before and after the wrap around.
+ */
+void ExpectEqualAcrossTheWrapAround(const Clocks &clocks, const uint32_t shift_us) {
+  const Clocks wrapping_clocks{clocks.reference_start_us + shift_us,
+                               clocks.local_start_us + shift_us, clocks.drift_ppm};
+  ClockSyncSimulation simulation(clocks, 3);
+  ClockSyncSimulation wrapping_simulation(wrapping_clocks, 3);
+  ClockSync sync, wrapping_sync;
+  for (int i = 0; i < 40; i++) {
+    const int64_t time_us = GetExchangeTime(i);
+    ASSERT_TRUE(sync.AddExchange(simulation.Exchange(time_us)));
+    ASSERT_TRUE(wrapping_sync.AddExchange(wrapping_simulation.Exchange(time_us)))
+        << "exchange " << i;
+    EXPECT_EQ(sync.GetDriftPpb(), wrapping_sync.GetDriftPpb()) << "exchange " << i;
+    EXPECT_EQ(sync.GetResidual(), wrapping_sync.GetResidual()) << "exchange " << i;
+    EXPECT_EQ(sync.GetDelay(), wrapping_sync.GetDelay()) << "exchange " << i;
+    for (int64_t t = time_us; t < time_us + kIntervalUs; t += kIntervalUs / 4) {
+      EXPECT_EQ(simulation.GetError(sync, t), wrapping_simulation.GetError(wrapping_sync, t))
+          << "exchange " << i << " at " << t;
+    }
+  }
+  EXPECT_NEAR(-clocks.drift_ppm * 1000, wrapping_sync.GetDriftPpb(), kMaxDriftErrorPpb);
+  EXPECT_LT(std::abs(wrapping_simulation.GetError(wrapping_sync, GetExchangeTime(40))),
+            kMaxOffsetErrorUs);
+}
+
+TEST(ClockSync, IsContinuousAcrossTheWrapAroundOfTheLocalClock) {
+  // the local clock wraps around after 20 s
+  const Clocks clocks{300000000u, 1000000000u, -25.0};
+  ExpectEqualAcrossTheWrapAround(clocks, UINT32_MAX - 20000000u - clocks.local_start_us);
+}
+
+TEST(ClockSync, IsContinuousAcrossTheWrapAroundOfTheReferenceClock) {
+  const Clocks clocks{100000000u, 7000000u, 60.0};
+  ExpectEqualAcrossTheWrapAround(clocks, UINT32_MAX - 20000000u - clocks.reference_start_us);
+}
+
+TEST(ClockSync, RejectsExchangesWithALongRoundTrip) {
+  ClockSyncSimulation simulation({0u, UINT32_MAX - 200000u, 10.0}, 5);
+  ClockSync sync;
+  for (int i = 0; i < 10; i++) {
+    ASSERT_TRUE(sync.AddExchange(simulation.Exchange(GetExchangeTime(i))));
+  }
+  const auto offset_us = sync.GetOffset();
+  // a retransmission delays the request by several connection intervals
+  EXPECT_FALSE(sync.AddExchange(simulation.Exchange(GetExchangeTime(10), 30000)));
+  EXPECT_EQ(1u, sync.GetRejected());
+  EXPECT_EQ(offset_us, sync.GetOffset());
+  EXPECT_TRUE(sync.AddExchange(simulation.Exchange(GetExchangeTime(11))));
+  EXPECT_LT(std::abs(simulation.GetError(sync, GetExchangeTime(11))), kMaxOffsetErrorUs);
+}
+
+/**
+ * The central switches to a longer connection interval, i.e. the delay of every following exchange
+ * is four times the delay of the window. The exchanges are rejected until the fastest exchange
+ * before the switch aged out, afterwards the synchronization follows the new delay.
+ */
+TEST(ClockSync, RecoversFromAPersistentIncreaseOfTheDelay) {
+  ClockSyncSimulation simulation({5000000u, 300u, 20.0}, 6);
+  ClockSync sync;
+  int exchange = 0;
+  for (; exchange < 20; exchange++) {
+    ASSERT_TRUE(sync.AddExchange(simulation.Exchange(GetExchangeTime(exchange))));
+  }
+  simulation.SetConnectionInterval(30000);
+  for (; exchange < 20 + static_cast<int>(ClockSync::kWindowSize); exchange++) {
+    sync.AddExchange(simulation.Exchange(GetExchangeTime(exchange)));
+  }
+  EXPECT_GT(sync.GetRejected(), 0u);
+  EXPECT_LE(sync.GetRejected(), ClockSync::kWindowSize);
+  for (const int end = exchange + 20; exchange < end; exchange++) {
+    ASSERT_TRUE(sync.AddExchange(simulation.Exchange(GetExchangeTime(exchange))))
+        << "exchange " << exchange;
+  }
+  EXPECT_GE(sync.GetDelay(), 60000u);
+  EXPECT_LT(sync.GetResidual(), kMaxResidualUs);
+  EXPECT_LT(std::abs(simulation.GetError(sync, GetExchangeTime(exchange))), kMaxOffsetErrorUs);
+
+  sync.Reset();
+  EXPECT_EQ(0u, sync.GetRejected());
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,110 @@
+"""Generate the raw IMU data of test_madgwick_filter.
+
+The data has the format of a recording of the BNO055 in the ACCGYRO mode (see BNO055Raw), i.e. the
+register values of the gyroscope (16 LSB/dps) and of the accelerometer (100 LSB/m/s^2) at a fixed
+sample rate. A recording has no ground truth, hence the samples are simulated from a known motion
+of a shoe: the shoe rests tilted, then steps with heel strikes and turns. The direction of the
+gravity in the sensor frame (in 1e-4) is added to every sample as reference.
+
+The sensor errors are a constant gyroscope bias, white noise, and the quantization of the
+registers. The random numbers are seeded, i.e. the output is reproducible.
+
+EXAMPLE:
+  python generate_imu_raw.py > imu_raw.csv
+"""
+
+import math
+import random
+
+SAMPLE_RATE_HZ = 400
+DURATION_S = 6.0
+REST_S = 2.0
+SUBSTEPS = 8
+GRAVITY = 9.80665
+GYRO_LSB_PER_DPS = 16
+ACCEL_LSB_PER_MS2 = 100
+GYRO_BIAS_DPS = (0.4, -0.3, 0.2)
+GYRO_NOISE_DPS = 0.1
+ACCEL_NOISE_MS2 = 0.08
+
+
+def multiply(a, b):
+    """Return the Hamilton product of two quaternions (w, x, y, z)."""
+    return (
+        a[0] * b[0] - a[1] * b[1] - a[2] * b[2] - a[3] * b[3],
+        a[0] * b[1] + a[1] * b[0] + a[2] * b[3] - a[3] * b[2],
+        a[0] * b[2] - a[1] * b[3] + a[2] * b[0] + a[3] * b[1],
+        a[0] * b[3] + a[1] * b[2] - a[2] * b[1] + a[3] * b[0],
+    )
+
+
+def normalize(q):
+    norm = math.sqrt(sum(value * value for value in q))
+    return tuple(value / norm for value in q)
+
+
+def from_euler(roll, pitch):
+    """Return the orientation (sensor to earth) of a sensor tilted by roll and pitch (rad)."""
+    qx = (math.cos(roll / 2), math.sin(roll / 2), 0.0, 0.0)
+    qy = (math.cos(pitch / 2), 0.0, math.sin(pitch / 2), 0.0)
+    return multiply(qy, qx)
+
+
+def to_sensor(q, v):
+    """Rotate a vector of the earth frame into the sensor frame."""
+    conjugate = (q[0], -q[1], -q[2], -q[3])
+    rotated = multiply(multiply(conjugate, (0.0, v[0], v[1], v[2])), q)
+    return rotated[1:]
+
+
+def angular_velocity(t):
+    """Return the angular velocity (rad/s) of the sensor frame during the steps."""
+    if t < REST_S:
+        return (0.0, 0.0, 0.0)
+    phase = 2.0 * math.pi * (t - REST_S)
+    roll_rate = math.radians(20.0) * math.cos(phase)
+    pitch_rate = math.radians(120.0) * math.sin(phase)
+    yaw_rate = math.radians(45.0) if 3.5 <= t < 4.5 else 0.0
+    return (roll_rate, pitch_rate, yaw_rate)
+
+
+def linear_acceleration(t):
+    """Return the linear acceleration (m/s^2, earth frame), i.e. a heel strike every second."""
+    if t < REST_S:
+        return (0.0, 0.0, 0.0)
+    since_strike = (t - REST_S) % 1.0
+    if since_strike < 0.03:
+        return (-0.5 * GRAVITY, 0.0, 1.5 * GRAVITY * math.sin(math.pi * since_strike / 0.03))
+    return (0.0, 0.0, 0.0)
+
+
+def main():
+    rng = random.Random(27)
+    q = from_euler(math.radians(10.0), math.radians(-15.0))
+    dt = 1.0 / SAMPLE_RATE_HZ
+    print("# simulated BNO055 ACCGYRO recording, see generate_imu_raw.py")
+    print("# sample_rate_hz=%d" % SAMPLE_RATE_HZ)
+    print("# gyro_x,gyro_y,gyro_z,accel_x,accel_y,accel_z,gravity_x,gravity_y,gravity_z")
+    for sample in range(int(DURATION_S * SAMPLE_RATE_HZ)):
+        t = sample * dt
+        for substep in range(SUBSTEPS):
+            w = angular_velocity(t - dt + (substep + 0.5) * dt / SUBSTEPS)
+            q_dot = multiply(q, (0.0, w[0], w[1], w[2]))
+            q = normalize(tuple(q[i] + 0.5 * q_dot[i] * dt / SUBSTEPS for i in range(4)))
+        w = angular_velocity(t)
+        gravity = to_sensor(q, (0.0, 0.0, 1.0))
+        a = linear_acceleration(t)
+        accel = to_sensor(q, (a[0], a[1], a[2] + GRAVITY))
+        gyro_raw = [
+            round((math.degrees(w[i]) + GYRO_BIAS_DPS[i] + rng.gauss(0.0, GYRO_NOISE_DPS))
+                  * GYRO_LSB_PER_DPS)
+            for i in range(3)
+        ]
+        accel_raw = [round((accel[i] + rng.gauss(0.0, ACCEL_NOISE_MS2)) * ACCEL_LSB_PER_MS2)
+                     for i in range(3)]
+        gravity_ref = [round(value * 1e4) for value in gravity]
+        print(",".join(str(value) for value in gyro_raw + accel_raw + gravity_ref))
+
+
+if __name__ == "__main__":
+    main()
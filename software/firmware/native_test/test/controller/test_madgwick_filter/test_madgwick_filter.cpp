@@ -0,0 +1,187 @@
+#include <gtest/gtest.h>
+#include <madgwick_filter.h>
+
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace sensint;
+using namespace sensint::sensor;
+
+namespace {
+
+//! the units of the registers of the BNO055 (see the datasheet, section 3.6.4)
+constexpr float kGyroLsbPerDps = 16.f;
+constexpr float kAccelLsbPerMs2 = 100.f;
+constexpr float kGravityScale = 1e-4f;
+constexpr float kDegToRad = 0.01745329252f;
+constexpr float kRadToDeg = 57.2957795131f;
+
+//! the gains and the convergence time of BNO055Raw
+constexpr float kConvergenceBeta = 2.5f;
+constexpr float kConvergenceTimeS = 2.f;
+
+/**
+ * @brief A sample of the raw data, converted like BNO055Raw does, and the gravity direction of the
+ * simulated motion.
+ */
+struct RawSample {
+  Vector3D<float> gyro;
+  Vector3D<float> accel;
+  Vector3D<float> gravity;
+};
+
+struct Recording {
+  float sample_rate_hz = 0.f;
+  std::vector<RawSample> samples;
+};
+
+/**
+ * @brief Load the raw data next to this file (see generate_imu_raw.py).
+ */
+Recording LoadRecording() {
+  std::string path = __FILE__;
+  path = path.substr(0, path.find_last_of('/') + 1) + "imu_raw.csv";
+  std::ifstream file(path);
+  EXPECT_TRUE(file.is_open()) << path;
+
+  Recording recording;
+  std::string line;
+  while (std::getline(file, line)) {
+    if (line.empty()) {
+      continue;
+    }
+    if (line[0] == '#') {
+      const auto pos = line.find("sample_rate_hz=");
+      if (pos != std::string::npos) {
+        recording.sample_rate_hz = std::stof(line.substr(pos + 15));
+      }
+      continue;
+    }
+    std::stringstream stream(line);
+    std::string token;
+    float values[9];
+    for (auto &value : values) {
+      std::getline(stream, token, ',');
+      value = std::stof(token);
+    }
+    recording.samples.push_back(RawSample{
+        {values[0] / kGyroLsbPerDps * kDegToRad, values[1] / kGyroLsbPerDps * kDegToRad,
+         values[2] / kGyroLsbPerDps * kDegToRad},
+        {values[3] / kAccelLsbPerMs2, values[4] / kAccelLsbPerMs2, values[5] / kAccelLsbPerMs2},
+        {values[6] * kGravityScale, values[7] * kGravityScale, values[8] * kGravityScale}});
+  }
+  return recording;
+}
+
+/**
+ * @brief The angle between the estimated and the true gravity, i.e. the error of the tilt.
+ */
+float GetTiltErrorDeg(const Vector3D<float> &estimate, const Vector3D<float> &truth) {
+  const auto dot = estimate.x * truth.x + estimate.y * truth.y + estimate.z * truth.z;
+  const auto norm = std::sqrt(truth.x * truth.x + truth.y * truth.y + truth.z * truth.z);
+  return std::acos(std::min(1.f, std::max(-1.f, dot / norm))) * kRadToDeg;
+}
+
+class MadgwickFilterRecording : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() { recording_ = new Recording(LoadRecording()); }
+  static void TearDownTestSuite() { delete recording_; }
+
+  static Recording *recording_;
+};
+
+Recording *MadgwickFilterRecording::recording_ = nullptr;
+
+}  // namespace
+
+TEST_F(MadgwickFilterRecording, LoadsTheRawData) {
+  EXPECT_FLOAT_EQ(400.f, recording_->sample_rate_hz);
+  EXPECT_EQ(2400u, recording_->samples.size());
+}
+
+TEST_F(MadgwickFilterRecording, ConvergesFromTheIdentityWhileResting) {
+  const auto dt_s = 1.f / recording_->sample_rate_hz;
+  MadgwickFilter filter(kConvergenceBeta);
+  const auto &first = recording_->samples.front();
+  // the shoe is tilted, i.e. the identity is about 18 degrees off
+  EXPECT_GT(GetTiltErrorDeg(filter.GetGravityDirection(), first.gravity), 15.f);
+  size_t i = 0;
+  for (; i < recording_->samples.size(); i++) {
+    const auto &sample = recording_->samples[i];
+    filter.Update(sample.gyro, sample.accel, dt_s);
+    if (GetTiltErrorDeg(filter.GetGravityDirection(), sample.gravity) < 1.f) {
+      break;
+    }
+  }
+  EXPECT_LT(i * dt_s, 0.25f);
+}
+
+/**
+ * The filter is run like BNO055Raw, i.e. with the high gain during the convergence and with the
+ * default gain afterwards. The steps accelerate the shoe and rotate it up to 30 degrees, but the
+ * tilt has to follow the motion.
+ */
+TEST_F(MadgwickFilterRecording, TracksTheTiltWhileWalking) {
+  const auto dt_s = 1.f / recording_->sample_rate_hz;
+  MadgwickFilter filter(kConvergenceBeta);
+  double sum_squared_error = 0.;
+  float max_error = 0.f;
+  size_t num_errors = 0;
+  for (size_t i = 0; i < recording_->samples.size(); i++) {
+    const auto &sample = recording_->samples[i];
+    if (i * dt_s >= kConvergenceTimeS) {
+      filter.SetBeta(MadgwickFilter::kDefaultBeta);
+    }
+    filter.Update(sample.gyro, sample.accel, dt_s);
+    if (i * dt_s < kConvergenceTimeS) {
+      continue;
+    }
+    const auto error = GetTiltErrorDeg(filter.GetGravityDirection(), sample.gravity);
+    ASSERT_FALSE(std::isnan(error)) << "sample " << i;
+    sum_squared_error += error * error;
+    max_error = std::max(max_error, error);
+    num_errors++;
+  }
+  EXPECT_LT(std::sqrt(sum_squared_error / num_errors), 1.);
+  EXPECT_LT(max_error, 2.f);
+
+  const auto q = filter.GetQuaternion();
+  EXPECT_NEAR(1.f, q.w * q.w + q.x * q.x + q.y * q.y + q.z * q.z, 1e-4f);
+}
+
+TEST(MadgwickFilter, IntegratesTheGyroscopeWithoutGain) {
+  MadgwickFilter filter(0.f);
+  // 90 degrees around x in one second
+  const Vector3D<float> gyro = {90.f * kDegToRad, 0.f, 0.f};
+  const Vector3D<float> accel = {0.f, 0.f, 9.81f};
+  for (int i = 0; i < 400; i++) {
+    filter.Update(gyro, accel, 1.f / 400.f);
+  }
+  const auto q = filter.GetQuaternion();
+  EXPECT_NEAR(std::cos(45.f * kDegToRad), q.w, 1e-3f);
+  EXPECT_NEAR(std::sin(45.f * kDegToRad), q.x, 1e-3f);
+  // the gravity is along the y axis of the rotated sensor
+  const auto gravity = filter.GetGravityDirection();
+  EXPECT_NEAR(0.f, gravity.x, 1e-3f);
+  EXPECT_NEAR(1.f, std::fabs(gravity.y), 1e-3f);
+  EXPECT_NEAR(0.f, gravity.z, 1e-3f);
+}
+
+TEST(MadgwickFilter, IgnoresAZeroAcceleration) {
+  MadgwickFilter filter(kConvergenceBeta);
+  const Vector3D<float> gyro = {0.f, 0.f, 0.f};
+  filter.Update(gyro, {0.f, 0.f, 0.f}, 1.f / 400.f);
+  const auto q = filter.GetQuaternion();
+  EXPECT_FALSE(std::isnan(q.w));
+  EXPECT_FLOAT_EQ(1.f, q.w);
+  filter.Reset();
+  EXPECT_FLOAT_EQ(1.f, filter.GetQuaternion().w);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
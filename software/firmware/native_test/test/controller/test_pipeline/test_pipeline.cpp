@@ -0,0 +1,233 @@
+#include <gtest/gtest.h>
+#include <pipeline_message.h>
+#include <pipeline_task.h>
+#include <sample_ring.h>
+#include <spsc_queue.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace sensint;
+using namespace sensint::pipeline;
+
+namespace {
+
+/**
+ * The tasks of the shoe (see pipeline.h of controller_shoe_remote) on threads of the host, i.e.
+ * with the same queues and periods, but with stand-ins for the hardware.
+ */
+constexpr uint32_t kNumSamples = 500;
+constexpr uint32_t kNumSequences = 40;
+constexpr uint32_t kReinitializeInterval = 100;
+
+SpscQueue<Message, 64> transport_queue;
+SpscQueue<Message, 16> generator_queue;
+SpscQueue<Message, 8> acknowledge_queue;
+SampleRing sample_ring;
+
+// sensor task
+std::atomic<uint32_t> num_acquired{0};
+// generator task
+std::atomic<uint32_t> num_applied{0};
+// transport task
+std::atomic<uint32_t> num_sent{0};
+std::atomic<uint32_t> num_acknowledged{0};
+std::atomic<uint32_t> num_reinitialized{0};
+std::atomic<uint32_t> num_errors{0};
+uint32_t next_index = 0;
+uint32_t last_timestamp_us = 0;
+
+uint32_t Now() {
+  return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                                   std::chrono::steady_clock::now().time_since_epoch())
+                                   .count());
+}
+
+void SensorStep() {
+  // a batch of samples per step, like the IMU FIFO and the pressure sensors
+  for (int i = 0; i < 4 && num_acquired.load() < kNumSamples; i++) {
+    Message message;
+    message.timestamp_us = Now();
+    message.type = MessageType::kPressureData;
+    message.payload.pressure = {1, 2, 3, 4};
+    sample_ring.Push(message);
+    if (num_acquired.fetch_add(1) % kReinitializeInterval == kReinitializeInterval - 1) {
+      message.type = MessageType::kImuReinitialized;
+      transport_queue.Push(message);
+    }
+  }
+}
+
+void GeneratorStep() {
+  Message message;
+  while (generator_queue.Pop(message)) {
+    if (message.type != MessageType::kSequence) {
+      num_errors++;
+      continue;
+    }
+    num_applied++;
+    message.type = MessageType::kSequenceApplied;
+    acknowledge_queue.Push(message);
+  }
+}
+
+void TransportStep() {
+  Message message;
+  while (transport_queue.Pop(message)) {
+    num_reinitialized += message.type == MessageType::kImuReinitialized;
+  }
+  while (acknowledge_queue.Pop(message)) {
+    num_acknowledged += message.type == MessageType::kSequenceApplied;
+  }
+  RecordedSample sample;
+  while (sample_ring.Peek(sample)) {
+    // the samples are sent in the order of their acquisition and without gaps
+    if (sample.index != next_index || sample.message.timestamp_us < last_timestamp_us) {
+      num_errors++;
+    }
+    next_index = sample.index + 1;
+    last_timestamp_us = sample.message.timestamp_us;
+    sample_ring.Advance();
+    num_sent++;
+  }
+}
+
+std::atomic<uint32_t> num_steps{0};
+
+void CountStep() { num_steps++; }
+
+void BusyStep() { std::this_thread::sleep_for(std::chrono::milliseconds(2)); }
+
+template <typename Predicate>
+bool WaitFor(Predicate predicate, const int timeout_ms = 5000) {
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+  while (!predicate()) {
+    if (std::chrono::steady_clock::now() > deadline) {
+      return false;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return true;
+}
+
+}  // namespace
+
+TEST(PipelineTask, ExecutesTheStepPeriodically) {
+  num_steps = 0;
+  PipelineTask task("count", CountStep, 5, 4096, 1, 0);
+  EXPECT_STREQ("count", task.GetName());
+  ASSERT_TRUE(task.Start());
+  EXPECT_FALSE(task.Start());
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  task.Stop();
+  const auto statistics = task.GetStatistics();
+  // 20 periods, with some slack for a loaded machine
+  EXPECT_GE(statistics.iterations, 10u);
+  EXPECT_LE(statistics.iterations, 22u);
+  EXPECT_EQ(num_steps.load(), statistics.iterations);
+  EXPECT_EQ(0u, statistics.stack_free_bytes);
+
+  // the task is stopped, i.e. the step is not executed anymore
+  const auto steps = num_steps.load();
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  EXPECT_EQ(steps, num_steps.load());
+  EXPECT_EQ(0u, task.GetStatistics().iterations);
+  // and it can be started again
+  ASSERT_TRUE(task.Start());
+  EXPECT_TRUE(WaitFor([&] { return num_steps.load() > steps; }));
+}
+
+TEST(PipelineTask, MeasuresTheLoad) {
+  PipelineTask task("busy", BusyStep, 4, 4096, 1, 0);
+  ASSERT_TRUE(task.Start());
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  const auto statistics = task.GetStatistics();
+  task.Stop();
+  EXPECT_GE(statistics.max_step_us, 2000u);
+  EXPECT_GT(statistics.cpu_load_percent, 25.f);
+  EXPECT_LT(statistics.cpu_load_percent, 90.f);
+}
+
+TEST(PipelineTask, IsStoppedWhenDestroyed) {
+  num_steps = 0;
+  {
+    PipelineTask task("count", CountStep, 1, 4096, 1, 0);
+    ASSERT_TRUE(task.Start());
+    EXPECT_TRUE(WaitFor([] { return num_steps.load() > 0; }));
+  }
+  const auto steps = num_steps.load();
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  EXPECT_EQ(steps, num_steps.load());
+}
+
+TEST(SpscQueue, KeepsTheOrderBetweenThreads) {
+  static SpscQueue<uint32_t, 16> queue;
+  constexpr uint32_t kNumElements = 50000;
+  std::thread producer([] {
+    for (uint32_t i = 0; i < kNumElements;) {
+      i += queue.Push(i);
+    }
+  });
+  uint32_t expected = 0;
+  uint32_t element;
+  while (expected < kNumElements) {
+    if (queue.Pop(element)) {
+      ASSERT_EQ(expected, element);
+      expected++;
+    }
+  }
+  producer.join();
+  EXPECT_EQ(0u, queue.Size());
+}
+
+/**
+ * The three tasks of the shoe and the BLE stack as producer of the generator_queue. All samples
+ * and messages have to pass the pipeline in order and without drops.
+ */
+TEST(Pipeline, PassesTheMessagesBetweenTheTasks) {
+  ASSERT_TRUE(sample_ring.Init(1024, 1024));
+  PipelineTask sensor_task("sensor", SensorStep, 1, 4096, 3, 1);
+  PipelineTask generator_task("generator", GeneratorStep, 2, 4096, 2, 1);
+  PipelineTask transport_task("transport", TransportStep, 1, 4096, 1, 0);
+  ASSERT_TRUE(transport_task.Start());
+  ASSERT_TRUE(generator_task.Start());
+  ASSERT_TRUE(sensor_task.Start());
+
+  // the notifications of the server, which are received in the context of the BLE stack
+  std::thread ble_stack([] {
+    for (uint32_t i = 0; i < kNumSequences; i++) {
+      Message message;
+      message.timestamp_us = Now();
+      message.type = MessageType::kSequence;
+      message.payload.value = i;
+      generator_queue.Push(message);
+      std::this_thread::sleep_for(std::chrono::milliseconds(3));
+    }
+  });
+  ble_stack.join();
+
+  EXPECT_TRUE(WaitFor([] {
+    return num_sent.load() == kNumSamples && num_acknowledged.load() == kNumSequences;
+  }));
+  sensor_task.Stop();
+  generator_task.Stop();
+  transport_task.Stop();
+
+  EXPECT_EQ(kNumSamples, num_acquired.load());
+  EXPECT_EQ(kNumSamples, num_sent.load());
+  EXPECT_EQ(kNumSequences, num_applied.load());
+  EXPECT_EQ(kNumSequences, num_acknowledged.load());
+  EXPECT_EQ(kNumSamples / kReinitializeInterval, num_reinitialized.load());
+  EXPECT_EQ(0u, num_errors.load());
+  EXPECT_EQ(0u, sample_ring.GetDropped());
+  EXPECT_EQ(0u, sample_ring.GetPending());
+  EXPECT_EQ(0u, transport_queue.GetDropped());
+  EXPECT_EQ(0u, generator_queue.GetDropped());
+  EXPECT_EQ(0u, acknowledge_queue.GetDropped());
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
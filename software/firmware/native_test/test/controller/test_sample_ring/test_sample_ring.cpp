@@ -0,0 +1,188 @@
+#include <gtest/gtest.h>
+#include <sample_ring.h>
+
+#include <atomic>
+#include <thread>
+
+using namespace sensint::pipeline;
+
+namespace {
+
+Message CreateMessage(const uint32_t timestamp_us) {
+  Message message;
+  message.timestamp_us = timestamp_us;
+  message.type = MessageType::kPressureData;
+  message.payload.value = timestamp_us;
+  return message;
+}
+
+/**
+ * @brief Read the next sample like the transport task does, i.e. peek and advance.
+ *
+ * @return The index of the sample.
+ */
+uint32_t Read(SampleRing &ring) {
+  RecordedSample sample;
+  EXPECT_TRUE(ring.Peek(sample));
+  ring.Advance();
+  return sample.index;
+}
+
+}  // namespace
+
+TEST(SampleRing, RequiresAPowerOfTwo) {
+  SampleRing ring;
+  EXPECT_FALSE(ring.Push(CreateMessage(0)));
+  EXPECT_EQ(1u, ring.GetDropped());
+  EXPECT_FALSE(ring.Init(16, 12));
+  EXPECT_FALSE(ring.Init(1, 1));
+  ASSERT_TRUE(ring.Init(64, 16));
+  // the host has no PSRAM
+  EXPECT_EQ(16u, ring.GetCapacity());
+  EXPECT_FALSE(ring.IsExternal());
+}
+
+TEST(SampleRing, ReadsTheSamplesInOrder) {
+  SampleRing ring;
+  ASSERT_TRUE(ring.Init(16, 16));
+  RecordedSample sample;
+  EXPECT_FALSE(ring.Peek(sample));
+  for (uint32_t i = 0; i < 5; i++) {
+    ASSERT_TRUE(ring.Push(CreateMessage(100 * i)));
+  }
+  EXPECT_EQ(5u, ring.GetPending());
+  ASSERT_TRUE(ring.Peek(sample));
+  EXPECT_EQ(0u, sample.index);
+  // a peek does not advance the read position
+  ASSERT_TRUE(ring.Peek(sample));
+  EXPECT_EQ(0u, sample.index);
+  for (uint32_t i = 0; i < 5; i++) {
+    ASSERT_TRUE(ring.Peek(sample));
+    EXPECT_EQ(i, sample.index);
+    EXPECT_EQ(100 * i, sample.message.timestamp_us);
+    ring.Advance();
+  }
+  EXPECT_EQ(0u, ring.GetPending());
+  EXPECT_FALSE(ring.Peek(sample));
+  // an advance without a pending sample is ignored
+  ring.Advance();
+  ASSERT_TRUE(ring.Push(CreateMessage(500)));
+  EXPECT_EQ(5u, Read(ring));
+}
+
+TEST(SampleRing, DropsWhenFullAndMarksTheGap) {
+  SampleRing ring;
+  ASSERT_TRUE(ring.Init(8, 8));
+  for (uint32_t i = 0; i < 10; i++) {
+    EXPECT_EQ(i < 8, ring.Push(CreateMessage(i)));
+  }
+  EXPECT_EQ(2u, ring.GetDropped());
+  EXPECT_EQ(8u, ring.GetPending());
+  for (uint32_t i = 0; i < 8; i++) {
+    EXPECT_EQ(i, Read(ring));
+  }
+  // half of the ring is kept for a rewind, the other half is free
+  for (uint32_t i = 10; i < 14; i++) {
+    ASSERT_TRUE(ring.Push(CreateMessage(i)));
+  }
+  EXPECT_FALSE(ring.Push(CreateMessage(14)));
+  // the dropped samples are missing in the indices
+  EXPECT_EQ(10u, Read(ring));
+}
+
+TEST(SampleRing, RewindsToASampleThatIsKept) {
+  SampleRing ring;
+  ASSERT_TRUE(ring.Init(16, 16));
+  for (uint32_t i = 0; i < 12; i++) {
+    ASSERT_TRUE(ring.Push(CreateMessage(i)));
+  }
+  for (uint32_t i = 0; i < 10; i++) {
+    ASSERT_EQ(i, Read(ring));
+  }
+  // the server received the samples up to 6 before the disconnect
+  ASSERT_TRUE(ring.Rewind(7));
+  EXPECT_EQ(5u, ring.GetPending());
+  for (uint32_t i = 7; i < 12; i++) {
+    EXPECT_EQ(i, Read(ring));
+  }
+  // the samples are not read twice if the server received all of them
+  EXPECT_FALSE(ring.Rewind(12));
+  EXPECT_FALSE(ring.Rewind(20));
+  EXPECT_EQ(0u, ring.GetPending());
+}
+
+TEST(SampleRing, RewindsToTheOldestSampleIfReleased) {
+  SampleRing ring;
+  ASSERT_TRUE(ring.Init(16, 16));
+  for (uint32_t i = 0; i < 30; i++) {
+    ASSERT_TRUE(ring.Push(CreateMessage(i))) << "sample " << i;
+    EXPECT_EQ(i, Read(ring));
+  }
+  // only the last half of the ring is kept, i.e. the samples 22 to 29
+  ASSERT_TRUE(ring.Rewind(3));
+  EXPECT_EQ(8u, ring.GetPending());
+  EXPECT_EQ(22u, Read(ring));
+}
+
+/**
+ * The shoe records while the transport task sends the samples and rewinds after every simulated
+ * reconnect. The samples have to be read in order, i.e. with gaps only for the dropped samples, and
+ * a rewind has to restart at the requested sample or at the next one that was recorded.
+ */
+TEST(SampleRing, RewindsWhileRecording) {
+  SampleRing ring;
+  ASSERT_TRUE(ring.Init(256, 256));
+  constexpr uint32_t kNumSamples = 200000;
+  std::atomic<bool> done{false};
+  std::thread sensor([&] {
+    for (uint32_t i = 0; i < kNumSamples; i++) {
+      ring.Push(CreateMessage(i));
+    }
+    done.store(true);
+  });
+
+  // the index of the next sample that was not read yet
+  uint32_t next_new = 0;
+  uint32_t num_received = 0;
+  uint32_t last_index = 0;
+  uint32_t num_rewinds = 0;
+  uint32_t num_errors = 0;
+  bool is_first = true;
+  RecordedSample sample;
+  while (!done.load() || ring.GetPending() > 0) {
+    if (!ring.Peek(sample)) {
+      continue;
+    }
+    // every sample is pushed once, hence the index equals the timestamp
+    if (sample.index != sample.message.timestamp_us ||
+        (!is_first && static_cast<int32_t>(sample.index - last_index) <= 0)) {
+      num_errors++;
+    }
+    ring.Advance();
+    is_first = false;
+    last_index = sample.index;
+    if (sample.index >= next_new) {
+      next_new = sample.index + 1;
+      num_received++;
+      if (num_received % 1000 == 0) {
+        // the server lost the last packets
+        const uint32_t next_sample = sample.index - 20;
+        ASSERT_TRUE(ring.Rewind(next_sample));
+        ASSERT_TRUE(ring.Peek(sample));
+        EXPECT_GE(sample.index, next_sample);
+        EXPECT_LE(sample.index, last_index);
+        last_index = sample.index - 1;
+        num_rewinds++;
+      }
+    }
+  }
+  sensor.join();
+  EXPECT_EQ(0u, num_errors);
+  EXPECT_EQ(kNumSamples, num_received + ring.GetDropped());
+  EXPECT_EQ(num_received / 1000, num_rewinds);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
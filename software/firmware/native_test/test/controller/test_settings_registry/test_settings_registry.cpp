@@ -0,0 +1,195 @@
+#include <BLEDevice.h>
+#include <gtest/gtest.h>
+#include <settings_registry.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+using namespace sensint;
+using namespace sensint::settings;
+
+namespace {
+
+uint32_t ReadValue(const BLECharacteristic &characteristic) {
+  uint32_t value = 0;
+  const auto data = characteristic.getValue();
+  EXPECT_EQ(sizeof(value), data.size());
+  memcpy(&value, data.data(), std::min(sizeof(value), data.size()));
+  return value;
+}
+
+/**
+ * @brief A subset of the settings of controller_shoe_pc, one of every type.
+ */
+class SettingsRegistryTest : public ::testing::Test {
+ protected:
+  SettingsRegistryTest()
+      : recording_status_char_("recording status"),
+        augmentation_active_char_("augmentation active"),
+        shoe_sequence_char_("shoe sequence") {
+    registry_.Register(SettingId::kRecordingStatus, "recording status", &recording_status_,
+                       &recording_status_char_, recording_status_cb_);
+    registry_.Register(SettingId::kAugmentationActive, "augmentation active",
+                       &augmentation_active_, &augmentation_active_char_,
+                       augmentation_active_cb_);
+    registry_.Register(GetShoeSequenceId(1), "shoe sequence", &shoe_sequence_,
+                       &shoe_sequence_char_, shoe_sequence_cb_);
+    recording_status_cb_.value_ = &recording_status_;
+    augmentation_active_cb_.value_ = &augmentation_active_;
+    shoe_sequence_cb_.value_ = &shoe_sequence_;
+    recording_status_char_.setCallbacks(&recording_status_cb_);
+    augmentation_active_char_.setCallbacks(&augmentation_active_cb_);
+    shoe_sequence_char_.setCallbacks(&shoe_sequence_cb_);
+  }
+
+  uint32_t recording_status_ = 0;
+  bool augmentation_active_ = false;
+  uint8_t shoe_sequence_ = 0;
+  BLECharacteristic recording_status_char_;
+  BLECharacteristic augmentation_active_char_;
+  BLECharacteristic shoe_sequence_char_;
+  ble::BleUInteger32Callback recording_status_cb_;
+  ble::BleBooleanCallback augmentation_active_cb_;
+  ble::BleUInteger8Callback shoe_sequence_cb_;
+  SettingsRegistry registry_;
+};
+
+}  // namespace
+
+TEST_F(SettingsRegistryTest, StartsClean) {
+  EXPECT_FALSE(registry_.IsDirty());
+  EXPECT_EQ(0u, registry_.Flush());
+  EXPECT_EQ(0u, recording_status_char_.GetNumNotifications());
+}
+
+TEST_F(SettingsRegistryTest, SetOfAnUnchangedValueIsNotDirty) {
+  EXPECT_TRUE(registry_.Set(SettingId::kRecordingStatus, 0));
+  EXPECT_TRUE(registry_.Set(SettingId::kAugmentationActive, 0));
+  EXPECT_TRUE(registry_.Set(GetShoeSequenceId(1), 0));
+  EXPECT_FALSE(registry_.IsDirty());
+  // the value is converted to the type of the setting before it is compared
+  EXPECT_TRUE(registry_.Set(GetShoeSequenceId(1), 0x100));
+  EXPECT_FALSE(registry_.IsDirty());
+  EXPECT_TRUE(registry_.Set(SettingId::kAugmentationActive, 1));
+  EXPECT_TRUE(registry_.IsDirty());
+  EXPECT_EQ(1u, registry_.Flush());
+  EXPECT_TRUE(registry_.Set(SettingId::kAugmentationActive, 5));
+  EXPECT_FALSE(registry_.IsDirty());
+}
+
+TEST_F(SettingsRegistryTest, SetOfAnUnregisteredSettingIsRejected) {
+  EXPECT_FALSE(registry_.Set(SettingId::kRecordingInterval, 100));
+  EXPECT_FALSE(registry_.Set(GetShoeSequenceId(0), 1));
+  EXPECT_FALSE(registry_.IsDirty());
+}
+
+TEST_F(SettingsRegistryTest, FlushNotifiesEveryChangedSettingOnce) {
+  registry_.Set(SettingId::kRecordingStatus, 1);
+  registry_.Set(SettingId::kRecordingStatus, 2);
+  registry_.Set(GetShoeSequenceId(1), 3);
+  EXPECT_EQ(2u, registry_.Flush());
+  EXPECT_FALSE(registry_.IsDirty());
+  EXPECT_EQ(1u, recording_status_char_.GetNumNotifications());
+  EXPECT_EQ(1u, shoe_sequence_char_.GetNumNotifications());
+  EXPECT_EQ(0u, augmentation_active_char_.GetNumNotifications());
+  EXPECT_EQ(2u, ReadValue(recording_status_char_));
+  EXPECT_EQ(3u, ReadValue(shoe_sequence_char_));
+  EXPECT_EQ(0u, registry_.Flush());
+}
+
+TEST_F(SettingsRegistryTest, WriteOfAConnectedDeviceMarksTheSettingDirty) {
+  const uint8_t unchanged = 0;
+  shoe_sequence_char_.Write(&unchanged, sizeof(unchanged));
+  EXPECT_FALSE(registry_.IsDirty());
+  const uint8_t sequence = 4;
+  shoe_sequence_char_.Write(&sequence, sizeof(sequence));
+  EXPECT_EQ(4, shoe_sequence_);
+  EXPECT_TRUE(registry_.IsDirty());
+  EXPECT_EQ(1u, registry_.Flush());
+  EXPECT_EQ(4u, ReadValue(shoe_sequence_char_));
+}
+
+/**
+ * A change of a setting that was already sent marks its bit again, i.e. the new value is sent with
+ * the next flush.
+ */
+TEST_F(SettingsRegistryTest, SetDuringTheNotificationIsSentWithTheNextFlush) {
+  registry_.Set(SettingId::kRecordingStatus, 1);
+  registry_.Set(SettingId::kAugmentationActive, 1);
+  augmentation_active_char_.SetNotifyHook([this]() {
+    registry_.Set(SettingId::kRecordingStatus, 2);
+    registry_.Set(SettingId::kAugmentationActive, 0);
+    // a setting that was not dirty when the flush started
+    const uint8_t sequence = 5;
+    shoe_sequence_char_.Write(&sequence, sizeof(sequence));
+  });
+  EXPECT_EQ(2u, registry_.Flush());
+  augmentation_active_char_.SetNotifyHook(nullptr);
+  EXPECT_EQ(1u, ReadValue(recording_status_char_));
+  EXPECT_EQ(1u, ReadValue(augmentation_active_char_));
+  EXPECT_EQ(0u, shoe_sequence_char_.GetNumNotifications());
+  EXPECT_TRUE(registry_.IsDirty());
+
+  EXPECT_EQ(3u, registry_.Flush());
+  EXPECT_EQ(2u, ReadValue(recording_status_char_));
+  EXPECT_EQ(0u, ReadValue(augmentation_active_char_));
+  EXPECT_EQ(5u, ReadValue(shoe_sequence_char_));
+  EXPECT_FALSE(registry_.IsDirty());
+}
+
+/**
+ * A change of a setting whose value was not read yet is sent by the same flush, i.e. it is not
+ * notified again by the next one.
+ */
+TEST_F(SettingsRegistryTest, SetBeforeTheValueIsReadIsSentByTheSameFlush) {
+  registry_.Set(SettingId::kRecordingStatus, 1);
+  registry_.Set(GetShoeSequenceId(1), 1);
+  recording_status_char_.SetNotifyHook([this]() { registry_.Set(GetShoeSequenceId(1), 6); });
+  EXPECT_EQ(2u, registry_.Flush());
+  recording_status_char_.SetNotifyHook(nullptr);
+  EXPECT_EQ(6u, ReadValue(shoe_sequence_char_));
+  EXPECT_FALSE(registry_.IsDirty());
+  EXPECT_EQ(0u, registry_.Flush());
+  EXPECT_EQ(1u, shoe_sequence_char_.GetNumNotifications());
+}
+
+/**
+ * The settings are broadcast to a newly connected device, as the main loop of controller_shoe_pc
+ * does when the number of connected devices changed.
+ */
+TEST_F(SettingsRegistryTest, MarkAllAfterAReconnectNotifiesEverySetting) {
+  BLEDevice::init("test");
+  auto *server = BLEDevice::createServer();
+  ble::BleConnectionCallback connection_cb;
+  server->setCallbacks(&connection_cb);
+  uint8_t connected_devices = 0;
+  const auto update = [&]() {
+    if (connected_devices != connection_cb.connected_devices_) {
+      connected_devices = connection_cb.connected_devices_;
+      registry_.MarkAll();
+    }
+    return registry_.IsDirty() ? registry_.Flush() : 0;
+  };
+
+  registry_.Set(SettingId::kRecordingStatus, 7);
+  server->Connect();
+  EXPECT_EQ(3u, update());
+  EXPECT_EQ(0u, update());
+  server->Disconnect();
+  EXPECT_EQ(3u, update());
+  server->Connect();
+  EXPECT_EQ(3u, update());
+  EXPECT_EQ(7u, ReadValue(recording_status_char_));
+  EXPECT_EQ(0u, ReadValue(augmentation_active_char_));
+  EXPECT_EQ(3u, recording_status_char_.GetNumNotifications());
+  EXPECT_EQ(3u, shoe_sequence_char_.GetNumNotifications());
+  // the link parameters are requested for every connection
+  EXPECT_EQ(2u, native::GetLinkRequests().num_requests);
+  BLEDevice::deinit(true);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
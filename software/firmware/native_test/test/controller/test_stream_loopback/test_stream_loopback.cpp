@@ -0,0 +1,230 @@
+#include <gtest/gtest.h>
+#include <loopback_harness.h>
+
+#include <algorithm>
+#include <vector>
+
+using namespace sensint::transport;
+
+namespace {
+
+constexpr size_t kLeft = 0;
+constexpr size_t kRight = 1;
+//! the samples of a shoe per second, i.e. the pressure sensors at 1 kHz and the IMU at 400 Hz
+constexpr uint32_t kSamplesPerSecond = 1400;
+
+uint32_t GetPercentile(std::vector<uint32_t> values, const double percentile) {
+  if (values.empty()) {
+    return 0;
+  }
+  const auto nth = values.begin() + static_cast<size_t>(percentile * (values.size() - 1));
+  std::nth_element(values.begin(), nth, values.end());
+  return *nth;
+}
+
+/**
+ * @brief Expect that the central received every sample of the shoe exactly once and in order,
+ * except for the samples that were dropped by the sample ring and the ones that are still pending
+ * or in flight at the end of the run.
+ */
+void ExpectComplete(const LoopbackHarness &harness, const size_t shoe,
+                    const uint32_t max_outstanding) {
+  const auto &result = harness.GetResult(shoe);
+  const auto &statistics = harness.GetStreamStatistics(shoe);
+  EXPECT_EQ(0u, result.corrupt_samples) << "shoe " << shoe;
+  EXPECT_EQ(0u, statistics.lost_packets) << "shoe " << shoe;
+  EXPECT_EQ(0u, statistics.dropped_packets) << "shoe " << shoe;
+  EXPECT_EQ(0u, statistics.duplicate_samples) << "shoe " << shoe;
+  EXPECT_EQ(result.dropped_samples, statistics.missing_samples) << "shoe " << shoe;
+  EXPECT_LE(result.received_samples + result.dropped_samples, result.recorded_samples)
+      << "shoe " << shoe;
+  EXPECT_GE(result.received_samples + result.dropped_samples + max_outstanding,
+            result.recorded_samples)
+      << "shoe " << shoe;
+}
+
+//! the samples that may be outstanding at the end of a run, i.e. the samples of 40 ms
+constexpr uint32_t kMaxOutstanding = kSamplesPerSecond * 40 / 1000;
+
+}  // namespace
+
+TEST(StreamLoopback, DeliversEverySampleOfBothShoes) {
+  LoopbackHarness harness;
+  harness.Connect(kLeft);
+  harness.Connect(kRight);
+  harness.Run(10000000);
+  for (size_t shoe = 0; shoe < harness.GetNumShoes(); shoe++) {
+    // the first and the last sample of both sensors are recorded at 0 s and 10 s
+    EXPECT_EQ(10 * kSamplesPerSecond + 2, harness.GetResult(shoe).recorded_samples);
+    EXPECT_EQ(0u, harness.GetResult(shoe).dropped_samples);
+    ExpectComplete(harness, shoe, kMaxOutstanding);
+  }
+}
+
+TEST(StreamLoopback, DeliversEverySampleOfSeveralSubjects) {
+  // the shoes of four subjects
+  LoopbackHarness harness(std::vector<HarnessShoeConfig>(8));
+  ASSERT_EQ(8u, harness.GetNumShoes());
+  for (size_t shoe = 0; shoe < harness.GetNumShoes(); shoe++) {
+    harness.Connect(shoe);
+  }
+  harness.Run(2000000);
+  for (size_t shoe = 0; shoe < harness.GetNumShoes(); shoe++) {
+    EXPECT_EQ(2 * kSamplesPerSecond + 2, harness.GetResult(shoe).recorded_samples);
+    ExpectComplete(harness, shoe, kMaxOutstanding);
+  }
+}
+
+/**
+ * A packet is sent when it is full or after the flush interval. With an MTU of 247, a packet is
+ * full after about 13 ms, i.e. the latency is bound by the time to fill a packet, the latency of
+ * the link and its jitter.
+ */
+TEST(StreamLoopback, LatencyIsBoundByTheFlushInterval) {
+  HarnessShoeConfig config;
+  config.link.jitter_us = 5000;
+  HarnessShoeConfig slow_config = config;
+  // a single pressure sample per packet interval, i.e. the packets are sent by the flush interval
+  slow_config.pressure_period_us = 10000;
+  slow_config.imu_period_us = 1000000;
+  LoopbackHarness harness(config, slow_config);
+  harness.Connect(kLeft);
+  harness.Connect(kRight);
+  harness.Run(10000000);
+  for (size_t shoe = 0; shoe < harness.GetNumShoes(); shoe++) {
+    const auto &latencies = harness.GetResult(shoe).latencies_us;
+    const uint32_t max_latency_us = config.sender.flush_interval_ms * 1000 +
+                                    config.link.latency_us + config.link.jitter_us +
+                                    LoopbackHarness::kStepUs;
+    EXPECT_GE(GetPercentile(latencies, 0.0), config.link.latency_us) << "shoe " << shoe;
+    EXPECT_LE(GetPercentile(latencies, 1.0), max_latency_us) << "shoe " << shoe;
+    ExpectComplete(harness, shoe, kMaxOutstanding);
+  }
+  // a full packet is sent before the flush interval elapsed
+  EXPECT_LT(GetPercentile(harness.GetResult(kLeft).latencies_us, 0.5),
+            GetPercentile(harness.GetResult(kRight).latencies_us, 0.5));
+}
+
+/**
+ * The smallest MTU (23 bytes, i.e. without a data length extension) carries a single IMU sample
+ * per packet. The shoe still keeps up with the sensors, but it sends six times as many packets.
+ */
+TEST(StreamLoopback, KeepsUpWithTheSensorsAtTheSmallestMtu) {
+  HarnessShoeConfig config;
+  config.link.mtu = 23;
+  LoopbackHarness harness(config, HarnessShoeConfig());
+  harness.Connect(kLeft);
+  harness.Connect(kRight);
+  harness.Run(10000000);
+  ExpectComplete(harness, kLeft, kMaxOutstanding);
+  ExpectComplete(harness, kRight, kMaxOutstanding);
+  const auto &small = harness.GetStreamStatistics(kLeft);
+  const auto &large = harness.GetStreamStatistics(kRight);
+  EXPECT_GT(small.packets, 5 * large.packets);
+  // the header of a packet is shared by at least 10 samples with the default MTU
+  EXPECT_GE(large.samples, 10 * large.packets);
+  EXPECT_LT(harness.GetPending(kLeft), kMaxOutstanding);
+}
+
+/**
+ * The backfill after a reconnect congests a slow link, i.e. the packets are rejected while too many
+ * are in flight. The shoe sends the packet again with the next step, hence the samples are delayed
+ * but not lost.
+ */
+TEST(StreamLoopback, DelaysTheSamplesOfACongestedLink) {
+  HarnessShoeConfig config;
+  config.link.latency_us = 20000;
+  config.sample_ring_size = 16384;
+  LoopbackHarness harness(config, HarnessShoeConfig());
+  harness.Connect(kLeft);
+  harness.Connect(kRight);
+  harness.Run(1000000);
+  harness.Disconnect(kLeft);
+  harness.Run(2000000);
+  harness.Connect(kLeft);
+  harness.Run(3000000);
+  EXPECT_GT(harness.GetLinkStatistics(kLeft).rejected_packets, 0u);
+  ExpectComplete(harness, kLeft, kMaxOutstanding);
+  ExpectComplete(harness, kRight, kMaxOutstanding);
+}
+
+/**
+ * The packets that are lost on the air are detected by the central via the sequence numbers, and
+ * their samples via the sample indices. The other shoe is not affected.
+ */
+TEST(StreamLoopback, DetectsTheLostPackets) {
+  HarnessShoeConfig config;
+  config.link.loss_ppm = 20000;
+  config.link.seed = 7;
+  LoopbackHarness harness(config, HarnessShoeConfig());
+  harness.Connect(kLeft);
+  harness.Connect(kRight);
+  harness.Run(10000000);
+  const auto &result = harness.GetResult(kLeft);
+  const auto &statistics = harness.GetStreamStatistics(kLeft);
+  const auto &link = harness.GetLinkStatistics(kLeft);
+  EXPECT_NEAR(0.02 * link.sent_packets, link.lost_packets, 0.01 * link.sent_packets);
+  EXPECT_EQ(link.lost_packets, statistics.lost_packets);
+  EXPECT_EQ(link.delivered_packets, statistics.packets);
+  EXPECT_EQ(0u, result.corrupt_samples);
+  EXPECT_EQ(0u, statistics.duplicate_samples);
+  // every sample is either received or reported as missing
+  EXPECT_LE(result.received_samples + statistics.missing_samples, result.recorded_samples);
+  EXPECT_GE(result.received_samples + statistics.missing_samples + kMaxOutstanding,
+            result.recorded_samples);
+  EXPECT_GT(statistics.missing_samples, statistics.lost_packets);
+  ExpectComplete(harness, kRight, kMaxOutstanding);
+}
+
+/**
+ * After a reconnect, the shoe sends the samples again that the central did not receive, including
+ * the packets that were in flight. The samples are sent back to back until the shoe caught up.
+ */
+TEST(StreamLoopback, BackfillsTheSamplesAfterAReconnect) {
+  HarnessShoeConfig config;
+  // the ring of a shoe with PSRAM keeps the samples of several seconds
+  config.sample_ring_size = 16384;
+  LoopbackHarness harness(config, HarnessShoeConfig());
+  harness.Connect(kLeft);
+  harness.Connect(kRight);
+  harness.Run(2000000);
+  harness.Disconnect(kLeft);
+  harness.Run(3000000);
+  EXPECT_EQ(3 * kSamplesPerSecond, harness.GetPending(kLeft));
+  harness.Connect(kLeft);
+  const uint32_t reconnect_us = harness.GetTime();
+  while (harness.GetPending(kLeft) > kMaxOutstanding &&
+         harness.GetTime() - reconnect_us < 1000000) {
+    harness.Run(LoopbackHarness::kStepUs);
+  }
+  // the link accepts about four packets per millisecond (32 packets in flight for 7.5 ms), i.e.
+  // about 70 samples per millisecond
+  EXPECT_LT(harness.GetTime() - reconnect_us, 150000u);
+  harness.Run(2000000);
+  EXPECT_GT(harness.GetLinkStatistics(kLeft).discarded_packets, 0u);
+  ExpectComplete(harness, kLeft, kMaxOutstanding);
+  ExpectComplete(harness, kRight, kMaxOutstanding);
+}
+
+/**
+ * Without PSRAM, the ring keeps half of its samples for a rewind. The samples that did not fit
+ * while the link was down are reported as missing by the central.
+ */
+TEST(StreamLoopback, ReportsTheSamplesDroppedWhileDisconnected) {
+  LoopbackHarness harness;
+  harness.Connect(kLeft);
+  harness.Connect(kRight);
+  harness.Run(2000000);
+  harness.Disconnect(kLeft);
+  harness.Run(1000000);
+  harness.Connect(kLeft);
+  harness.Run(2000000);
+  EXPECT_GT(harness.GetResult(kLeft).dropped_samples, kSamplesPerSecond / 2);
+  ExpectComplete(harness, kLeft, kMaxOutstanding);
+  ExpectComplete(harness, kRight, kMaxOutstanding);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,265 @@
+#include <Arduino.h>
+#include <gtest/gtest.h>
+#include <latency_trace.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace sensint;
+using namespace sensint::latency_trace;
+
+namespace {
+
+//! the cycles of a microsecond, the cycle counter follows the simulated time (see Arduino.h)
+constexpr uint32_t kCyclesPerUs = F_CPU / 1000000;
+
+struct DumpHeader {
+  uint32_t cpu_hz = 0;
+  uint32_t sample_rate = 0;
+  uint32_t block_samples = 0;
+  uint32_t num_traces = 0;
+  uint32_t dropped = 0;
+};
+
+/**
+ * @brief Parse the frames of a dump like parse_frames of software/latency_trace/latency_trace.py.
+ */
+bool ParseDump(const std::string &dump, DumpHeader &header, std::vector<Trace> &traces) {
+  bool has_header = false;
+  std::istringstream lines(dump);
+  std::string line;
+  while (std::getline(lines, line)) {
+    if (line.size() < 2 || line.front() != '<' || line.back() != '>') {
+      continue;
+    }
+    std::vector<std::string> tokens;
+    std::istringstream frame(line.substr(1, line.size() - 2));
+    std::string token;
+    while (std::getline(frame, token, ',')) {
+      tokens.push_back(token);
+    }
+    if (tokens[0] == "T" && tokens.size() == 6) {
+      header.cpu_hz = std::stoul(tokens[1]);
+      header.sample_rate = std::stoul(tokens[2]);
+      header.block_samples = std::stoul(tokens[3]);
+      header.num_traces = std::stoul(tokens[4]);
+      header.dropped = std::stoul(tokens[5]);
+      has_header = true;
+    } else if (tokens[0] == "t" && tokens.size() == kNumStages + 3) {
+      Trace trace;
+      trace.channel = static_cast<uint8_t>(std::stoul(tokens[1]));
+      for (uint8_t stage = 0; stage < kNumStages; stage++) {
+        trace.cycles[stage] = std::stoul(tokens[2 + stage]);
+      }
+      trace.first_sample = static_cast<uint16_t>(std::stoul(tokens[2 + kNumStages]));
+      traces.push_back(trace);
+    }
+  }
+  return has_header;
+}
+
+//! the time between two stages, the cycle counter wraps around after 2^32 cycles
+uint32_t GetElapsedUs(const Trace &trace, const Stage start, const Stage end) {
+  return (trace.cycles[static_cast<uint8_t>(end)] - trace.cycles[static_cast<uint8_t>(start)]) /
+         kCyclesPerUs;
+}
+
+//! the percentile of latency_trace.py, i.e. the nearest rank
+uint32_t GetPercentile(std::vector<uint32_t> values, const double percentile) {
+  std::sort(values.begin(), values.end());
+  const auto index = static_cast<size_t>(std::nearbyint(percentile / 100. * (values.size() - 1)));
+  return values[std::min(index, values.size() - 1)];
+}
+
+/**
+ * @brief The tracer and its probe, the probe is updated like by the audio interrupt.
+ */
+class LatencyTraceTest : public ::testing::Test {
+ protected:
+  LatencyTraceTest() : probe_(tracer_) {
+    host_audio::SetMicros(0);
+    Serial.Reset();
+    Serial.SetCapture(true);
+    tracer_.Init();
+    std::fill(std::begin(silence_.data), std::end(silence_.data), 0);
+  }
+  ~LatencyTraceTest() { Serial.SetCapture(false); }
+
+  void StampAt(const uint32_t micros, const uint8_t channel, const Stage stage) {
+    host_audio::SetMicros(micros);
+    tracer_.Stamp(channel, stage);
+  }
+
+  /**
+   * @brief Render a block at the given time, which contains the first non-zero sample of the
+   * grain at the given index (or silence if the index is beyond the block).
+   */
+  void RenderAt(const uint32_t micros, const uint8_t channel, const uint16_t first_sample) {
+    host_audio::SetMicros(micros);
+    std::fill(std::begin(block_.data), std::end(block_.data), 0);
+    if (first_sample < AUDIO_BLOCK_SAMPLES) {
+      std::fill(std::begin(block_.data) + first_sample, std::end(block_.data), 1000);
+    }
+    probe_.Send(channel, &block_);
+    probe_.Send(1 - channel, &silence_);
+    probe_.update();
+  }
+
+  /**
+   * @brief Trace a grain with the given stage intervals, starting at the given time.
+   */
+  void TraceGrain(const uint32_t start_us, const uint8_t channel, const uint32_t filter_us,
+                  const uint32_t grain_us, const uint32_t note_on_us, const uint32_t block_us,
+                  const uint16_t first_sample) {
+    uint32_t micros = start_us;
+    StampAt(micros, channel, Stage::kAdcSample);
+    StampAt(micros += filter_us, channel, Stage::kFilterOutput);
+    StampAt(micros += grain_us, channel, Stage::kGrainResolved);
+    StampAt(micros += note_on_us, channel, Stage::kNoteOn);
+    RenderAt(micros += block_us, channel, first_sample);
+  }
+
+  std::vector<Trace> Dump(DumpHeader &header) {
+    tracer_.Dump();
+    std::vector<Trace> traces;
+    EXPECT_TRUE(ParseDump(Serial.TakeOutput(), header, traces));
+    EXPECT_EQ(header.num_traces, traces.size());
+    return traces;
+  }
+
+  LatencyTracer tracer_;
+  AudioTraceProbe probe_;
+  audio_block_t block_;
+  audio_block_t silence_;
+};
+
+}  // namespace
+
+TEST_F(LatencyTraceTest, DumpsTheHeaderOfAnEmptyTracer) {
+  DumpHeader header;
+  EXPECT_TRUE(Dump(header).empty());
+  EXPECT_EQ(static_cast<uint32_t>(F_CPU), header.cpu_hz);
+  EXPECT_EQ(44117u, header.sample_rate);
+  EXPECT_EQ(static_cast<uint32_t>(AUDIO_BLOCK_SAMPLES), header.block_samples);
+  EXPECT_EQ(0u, header.dropped);
+}
+
+TEST_F(LatencyTraceTest, StampsTheIntervalsOfEveryStage) {
+  TraceGrain(1000, kLeftChannel, 12, 30, 2, 1500, 17);
+  DumpHeader header;
+  const auto traces = Dump(header);
+  ASSERT_EQ(1u, traces.size());
+  const auto &trace = traces[0];
+  EXPECT_EQ(kLeftChannel, trace.channel);
+  EXPECT_EQ(1000 * kCyclesPerUs, trace.cycles[static_cast<uint8_t>(Stage::kAdcSample)]);
+  EXPECT_EQ(12u, GetElapsedUs(trace, Stage::kAdcSample, Stage::kFilterOutput));
+  EXPECT_EQ(30u, GetElapsedUs(trace, Stage::kFilterOutput, Stage::kGrainResolved));
+  EXPECT_EQ(2u, GetElapsedUs(trace, Stage::kGrainResolved, Stage::kNoteOn));
+  EXPECT_EQ(1500u, GetElapsedUs(trace, Stage::kNoteOn, Stage::kFirstAudioBlock));
+  EXPECT_EQ(17u, trace.first_sample);
+  EXPECT_EQ(0u, header.dropped);
+}
+
+TEST_F(LatencyTraceTest, WaitsForTheFirstNonZeroSample) {
+  StampAt(100, kRightChannel, Stage::kAdcSample);
+  StampAt(200, kRightChannel, Stage::kNoteOn);
+  // the grain is silent in the first blocks, e.g. because of its attack
+  RenderAt(3000, kRightChannel, AUDIO_BLOCK_SAMPLES);
+  RenderAt(5900, kRightChannel, AUDIO_BLOCK_SAMPLES);
+  RenderAt(8800, kRightChannel, 0);
+  // a later block of the same grain does not change the trace
+  RenderAt(11700, kRightChannel, 0);
+  DumpHeader header;
+  const auto traces = Dump(header);
+  ASSERT_EQ(1u, traces.size());
+  EXPECT_EQ(kRightChannel, traces[0].channel);
+  EXPECT_EQ(8700u, GetElapsedUs(traces[0], Stage::kAdcSample, Stage::kFirstAudioBlock));
+  EXPECT_EQ(0u, traces[0].first_sample);
+}
+
+TEST_F(LatencyTraceTest, TracesTheChannelsIndependently) {
+  StampAt(100, kLeftChannel, Stage::kAdcSample);
+  StampAt(150, kRightChannel, Stage::kAdcSample);
+  StampAt(200, kLeftChannel, Stage::kNoteOn);
+  StampAt(260, kRightChannel, Stage::kNoteOn);
+  RenderAt(3000, kRightChannel, 3);
+  RenderAt(5900, kLeftChannel, 4);
+  DumpHeader header;
+  const auto traces = Dump(header);
+  ASSERT_EQ(2u, traces.size());
+  // the traces are dumped in the order of their first audio block
+  EXPECT_EQ(kRightChannel, traces[0].channel);
+  EXPECT_EQ(2850u, GetElapsedUs(traces[0], Stage::kAdcSample, Stage::kFirstAudioBlock));
+  EXPECT_EQ(3u, traces[0].first_sample);
+  EXPECT_EQ(kLeftChannel, traces[1].channel);
+  EXPECT_EQ(5800u, GetElapsedUs(traces[1], Stage::kAdcSample, Stage::kFirstAudioBlock));
+  EXPECT_EQ(4u, traces[1].first_sample);
+}
+
+TEST_F(LatencyTraceTest, CountsTheReplacedAndTheOverwrittenTraces) {
+  // the first grain never produced a non-zero sample
+  StampAt(100, kLeftChannel, Stage::kNoteOn);
+  StampAt(200, kLeftChannel, Stage::kNoteOn);
+  RenderAt(3000, kLeftChannel, 0);
+  for (uint32_t i = 0; i < kCapacity + 2; i++) {
+    TraceGrain(10000 + 10000 * i, kLeftChannel, 10, 10, 10, 1000 + i, 0);
+  }
+  DumpHeader header;
+  const auto traces = Dump(header);
+  ASSERT_EQ(kCapacity, traces.size());
+  EXPECT_EQ(1u + 3u, header.dropped);
+  // the three oldest traces, i.e. the one of the replaced grain and of the first two grains, were
+  // overwritten
+  EXPECT_EQ(1002u, GetElapsedUs(traces.front(), Stage::kNoteOn, Stage::kFirstAudioBlock));
+  EXPECT_EQ(1000u + kCapacity + 1,
+            GetElapsedUs(traces.back(), Stage::kNoteOn, Stage::kFirstAudioBlock));
+  // the dump clears the ring buffer and the counter of the dropped traces
+  EXPECT_TRUE(Dump(header).empty());
+  EXPECT_EQ(0u, header.dropped);
+}
+
+TEST_F(LatencyTraceTest, IntervalsAreValidAcrossTheWrapAroundOfTheCycleCounter) {
+  // the cycle counter wraps around after about 7.16 s at 600 MHz
+  const uint32_t wrap_us = static_cast<uint32_t>((1ULL << 32) / kCyclesPerUs);
+  TraceGrain(wrap_us - 20, kLeftChannel, 10, 20, 5, 2900, 1);
+  DumpHeader header;
+  const auto traces = Dump(header);
+  ASSERT_EQ(1u, traces.size());
+  EXPECT_LT(traces[0].cycles[static_cast<uint8_t>(Stage::kFirstAudioBlock)],
+            traces[0].cycles[static_cast<uint8_t>(Stage::kAdcSample)]);
+  EXPECT_EQ(2935u, GetElapsedUs(traces[0], Stage::kAdcSample, Stage::kFirstAudioBlock));
+}
+
+/**
+ * The percentiles that latency_trace.py reports from a dump, here of 100 grains with a latency of
+ * 1 to 100 ms from the ADC sample to the first audio block.
+ */
+TEST_F(LatencyTraceTest, DumpYieldsThePercentilesOfTheStampedLatencies) {
+  for (uint32_t i = 0; i < 100; i++) {
+    // a permutation of 1 to 100 ms
+    const uint32_t latency_us = ((i * 37) % 100 + 1) * 1000;
+    TraceGrain(i * 200000, kLeftChannel, 10, 20, 30, latency_us - 60, 0);
+  }
+  DumpHeader header;
+  const auto traces = Dump(header);
+  ASSERT_EQ(100u, traces.size());
+  std::vector<uint32_t> latencies_us;
+  for (const auto &trace : traces) {
+    EXPECT_EQ(10u, GetElapsedUs(trace, Stage::kAdcSample, Stage::kFilterOutput));
+    latencies_us.push_back(GetElapsedUs(trace, Stage::kAdcSample, Stage::kFirstAudioBlock));
+  }
+  EXPECT_EQ(1000u, GetPercentile(latencies_us, 0));
+  EXPECT_EQ(51000u, GetPercentile(latencies_us, 50));
+  EXPECT_EQ(90000u, GetPercentile(latencies_us, 90));
+  EXPECT_EQ(99000u, GetPercentile(latencies_us, 99));
+  EXPECT_EQ(100000u, GetPercentile(latencies_us, 100));
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,200 @@
+#include <EEPROM.h>
+#include <gtest/gtest.h>
+#include <library_image.h>
+
+#include <vector>
+
+using namespace sensint;
+
+namespace {
+
+constexpr uint32_t kPresetsCrc = 0x1234;
+
+Material CreateMaterial(const uint8_t id, const float frequency = 100.f) {
+  Material material;
+  material.id = id;
+  material.grain_params.raw_signal_params.frequency = frequency;
+  return material;
+}
+
+GrainSequence CreateSequence(const uint8_t id, const uint16_t num_grains,
+                             const uint16_t first_position = 0) {
+  GrainSequence sequence;
+  sequence.id = id;
+  for (uint16_t i = 0; i < num_grains; i++) {
+    const auto position = static_cast<uint16_t>(first_position + 10 * i);
+    sequence.grains.push_back(Grain{id, position, static_cast<uint16_t>(position + 5)});
+  }
+  return sequence;
+}
+
+size_t GetSlotSize(const LibraryStorage &storage) {
+  return storage.Capacity() / library_image::kNumSlots;
+}
+
+class LibraryImage : public ::testing::Test {
+ protected:
+  void SetUp() override { EEPROM.Erase(); }
+
+  void Commit(LibraryBuffer &buffer) {
+    buffer.MarkEdited();
+    ASSERT_TRUE(buffer.Commit());
+  }
+
+  /**
+   * @brief Load the image into a fresh buffer like the signal generator does at boot.
+   */
+  bool Restore(LibraryBuffer &buffer, const uint32_t presets_crc = kPresetsCrc) {
+    if (!library_image::Load(storage, presets_crc, buffer)) {
+      return false;
+    }
+    return buffer.Commit();
+  }
+
+  float GetFrequency(const LibraryBuffer &buffer, const uint8_t id) {
+    Material material;
+    if (!buffer.GetMaterialLib().GetMaterialByID(id, material)) {
+      return -1.f;
+    }
+    return material.grain_params.raw_signal_params.frequency;
+  }
+
+  LibraryBuffer libraries;
+  LibraryStorage storage;
+};
+
+}  // namespace
+
+TEST_F(LibraryImage, RestoresTheSavedLibraries) {
+  ASSERT_TRUE(libraries.GetShadowMaterialLib().AddMaterials(
+      {CreateMaterial(1, 150.f), CreateMaterial(7, 350.f)}));
+  ASSERT_TRUE(
+      libraries.GetShadowSequenceLib().AddSequences({CreateSequence(3, 4), CreateSequence(5, 2)}));
+  ASSERT_TRUE(libraries.GetShadowSequenceLib().DeleteSequence(kDefaultGrainSequenceID));
+  Commit(libraries);
+  ASSERT_TRUE(library_image::Save(libraries, kPresetsCrc, storage));
+
+  LibraryBuffer restored;
+  ASSERT_TRUE(Restore(restored));
+  EXPECT_FLOAT_EQ(150.f, GetFrequency(restored, 1));
+  EXPECT_FLOAT_EQ(350.f, GetFrequency(restored, 7));
+  EXPECT_TRUE(restored.GetMaterialLib().MaterialExists(kDefaultMaterialID));
+  EXPECT_FALSE(restored.GetSequenceLib().SequenceExists(kDefaultGrainSequenceID));
+  for (const auto &expected : {CreateSequence(3, 4), CreateSequence(5, 2)}) {
+    GrainSequence sequence;
+    ASSERT_TRUE(restored.GetSequenceLib().GetSequenceByID(expected.id, sequence));
+    ASSERT_EQ(expected.grains.size(), sequence.grains.size());
+    for (size_t i = 0; i < expected.grains.size(); i++) {
+      EXPECT_EQ(expected.grains[i].material_id, sequence.grains[i].material_id);
+      EXPECT_EQ(expected.grains[i].pos_start, sequence.grains[i].pos_start);
+      EXPECT_EQ(expected.grains[i].pos_end, sequence.grains[i].pos_end);
+    }
+  }
+}
+
+TEST_F(LibraryImage, FallsBackToTheOlderSlotIfTheNewestIsCorrupted) {
+  ASSERT_TRUE(libraries.GetShadowMaterialLib().AddMaterial(CreateMaterial(1, 150.f)));
+  Commit(libraries);
+  ASSERT_TRUE(library_image::Save(libraries, kPresetsCrc, storage));
+  ASSERT_TRUE(libraries.GetShadowMaterialLib().UpdateMaterial(CreateMaterial(1, 250.f)));
+  Commit(libraries);
+  ASSERT_TRUE(library_image::Save(libraries, kPresetsCrc, storage));
+  {
+    LibraryBuffer restored;
+    ASSERT_TRUE(Restore(restored));
+    EXPECT_FLOAT_EQ(250.f, GetFrequency(restored, 1));
+  }
+
+  // the second save went to the second slot, e.g. its payload was not written completely
+  const auto address = GetSlotSize(storage) + sizeof(library_image::ImageHeader) + 1;
+  EEPROM.write(static_cast<int>(address), EEPROM.read(static_cast<int>(address)) ^ 0xFF);
+  LibraryBuffer restored;
+  ASSERT_TRUE(Restore(restored));
+  EXPECT_FLOAT_EQ(150.f, GetFrequency(restored, 1));
+
+  // the next save overwrites the corrupted slot, i.e. the intact image is kept
+  ASSERT_TRUE(library_image::Save(libraries, kPresetsCrc, storage));
+  library_image::ImageHeader header;
+  ASSERT_TRUE(storage.Read(0, reinterpret_cast<uint8_t *>(&header), sizeof(header)));
+  EXPECT_EQ(0u, header.generation);
+  ASSERT_TRUE(
+      storage.Read(GetSlotSize(storage), reinterpret_cast<uint8_t *>(&header), sizeof(header)));
+  EXPECT_EQ(1u, header.generation);
+}
+
+TEST_F(LibraryImage, RejectsTheImageOfOtherPresets) {
+  ASSERT_TRUE(libraries.GetShadowMaterialLib().AddMaterial(CreateMaterial(1)));
+  Commit(libraries);
+  ASSERT_TRUE(library_image::Save(libraries, kPresetsCrc, storage));
+  LibraryBuffer restored;
+  EXPECT_FALSE(Restore(restored, kPresetsCrc + 1));
+  EXPECT_FALSE(restored.GetShadowMaterialLib().MaterialExists(1));
+  EXPECT_FALSE(restored.Commit());
+}
+
+TEST_F(LibraryImage, UnchangedLibrariesAreNotWrittenAgain) {
+  ASSERT_TRUE(libraries.GetShadowMaterialLib().AddMaterial(CreateMaterial(1)));
+  Commit(libraries);
+  ASSERT_TRUE(library_image::Save(libraries, kPresetsCrc, storage));
+  const auto num_written_bytes = EEPROM.GetNumWrittenBytes();
+  EXPECT_GT(num_written_bytes, 0u);
+  ASSERT_TRUE(library_image::Save(libraries, kPresetsCrc, storage));
+  EXPECT_EQ(num_written_bytes, EEPROM.GetNumWrittenBytes());
+  // the image of other presets is replaced
+  ASSERT_TRUE(library_image::Save(libraries, kPresetsCrc + 1, storage));
+  EXPECT_GT(EEPROM.GetNumWrittenBytes(), num_written_bytes);
+}
+
+TEST_F(LibraryImage, RefusesALibraryLargerThanASlot) {
+  std::vector<Material> materials;
+  for (int id = 1; id < 256; id++) {
+    materials.push_back(CreateMaterial(static_cast<uint8_t>(id)));
+  }
+  ASSERT_TRUE(libraries.GetShadowMaterialLib().AddMaterials(materials));
+  Commit(libraries);
+  EXPECT_FALSE(library_image::Save(libraries, kPresetsCrc, storage));
+  EXPECT_EQ(0u, EEPROM.GetNumWrittenBytes());
+  LibraryBuffer restored;
+  EXPECT_FALSE(Restore(restored));
+}
+
+TEST_F(LibraryImage, FailedApplyLeavesTheLibrariesUnchanged) {
+  ASSERT_TRUE(libraries.GetShadowMaterialLib().AddMaterials(
+      {CreateMaterial(1, 150.f), CreateMaterial(2, 250.f)}));
+  Commit(libraries);
+  ASSERT_TRUE(library_image::Save(libraries, kPresetsCrc, storage));
+
+  // an intact image, which holds a material twice, i.e. it was not written by Save
+  library_image::ImageHeader header;
+  ASSERT_TRUE(storage.Read(0, reinterpret_cast<uint8_t *>(&header), sizeof(header)));
+  std::vector<uint8_t> payload(header.payload_size);
+  ASSERT_TRUE(storage.Read(sizeof(header), payload.data(), payload.size()));
+  ASSERT_EQ(3u, header.num_materials);
+  const auto record_size = payload.size() / header.num_materials;
+  ASSERT_EQ(2, payload[2 * record_size]);
+  payload[2 * record_size] = 1;
+  header.payload_crc = library_image::Crc32(payload.data(), payload.size());
+  header.header_crc = library_image::Crc32(reinterpret_cast<const uint8_t *>(&header),
+                                           offsetof(library_image::ImageHeader, header_crc));
+  ASSERT_TRUE(storage.Write(sizeof(header), payload.data(), payload.size()));
+  ASSERT_TRUE(storage.Write(0, reinterpret_cast<const uint8_t *>(&header), sizeof(header)));
+
+  LibraryBuffer restored;
+  ASSERT_TRUE(restored.GetShadowMaterialLib().AddMaterial(CreateMaterial(9)));
+  restored.MarkEdited();
+  ASSERT_TRUE(restored.Commit());
+  EXPECT_FALSE(library_image::Load(storage, kPresetsCrc, restored));
+  // neither the active nor the shadow libraries hold a part of the image
+  EXPECT_FALSE(restored.Commit());
+  const MaterialLib &shadow_lib = restored.GetShadowMaterialLib();
+  for (const auto *material_lib : {&restored.GetMaterialLib(), &shadow_lib}) {
+    EXPECT_TRUE(material_lib->MaterialExists(9));
+    EXPECT_FALSE(material_lib->MaterialExists(1));
+    EXPECT_FALSE(material_lib->MaterialExists(2));
+  }
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
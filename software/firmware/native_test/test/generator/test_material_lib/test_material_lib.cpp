@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+#include <material_lib.h>
+
+using namespace sensint;
+
+namespace {
+
+Material CreateMaterial(const uint8_t id, const float frequency = 100.f) {
+  Material material;
+  material.id = id;
+  material.grain_params.raw_signal_params.frequency = frequency;
+  return material;
+}
+
+}  // namespace
+
+TEST(MaterialLib, ContainsTheDefaultMaterial) {
+  MaterialLib lib;
+  EXPECT_TRUE(lib.MaterialExists(kDefaultMaterialID));
+  Material material;
+  ASSERT_TRUE(lib.GetMaterialByID(kDefaultMaterialID, material));
+  EXPECT_FLOAT_EQ(200.f, material.grain_params.raw_signal_params.frequency);
+  EXPECT_EQ(&lib.GetDefaultMaterial(), lib.GetMaterial(MaterialHandle()));
+}
+
+TEST(MaterialLib, AddsUpdatesAndDeletesAMaterial) {
+  MaterialLib lib;
+  ASSERT_TRUE(lib.AddMaterial(CreateMaterial(5, 100.f)));
+  EXPECT_FALSE(lib.AddMaterial(CreateMaterial(5, 300.f)));
+  Material material;
+  ASSERT_TRUE(lib.GetMaterialByID(5, material));
+  EXPECT_FLOAT_EQ(100.f, material.grain_params.raw_signal_params.frequency);
+
+  ASSERT_TRUE(lib.UpdateMaterial(CreateMaterial(5, 300.f)));
+  ASSERT_TRUE(lib.GetMaterialByID(5, material));
+  EXPECT_FLOAT_EQ(300.f, material.grain_params.raw_signal_params.frequency);
+  EXPECT_FALSE(lib.UpdateMaterial(CreateMaterial(6)));
+
+  ASSERT_TRUE(lib.DeleteMaterial(5));
+  EXPECT_FALSE(lib.MaterialExists(5));
+  EXPECT_FALSE(lib.DeleteMaterial(5));
+  EXPECT_EQ(-1, lib.GetMaterialIndexByID(5));
+}
+
+TEST(MaterialLib, ReusesTheSlotOfADeletedMaterial) {
+  MaterialLib lib;
+  ASSERT_TRUE(lib.AddMaterial(CreateMaterial(1)));
+  ASSERT_TRUE(lib.AddMaterial(CreateMaterial(2)));
+  const auto slot = lib.GetMaterialIndexByID(1);
+  ASSERT_TRUE(lib.DeleteMaterial(1));
+  ASSERT_TRUE(lib.AddMaterial(CreateMaterial(3)));
+  EXPECT_EQ(slot, lib.GetMaterialIndexByID(3));
+  // the other materials are not moved
+  Material material;
+  ASSERT_TRUE(lib.GetMaterialByID(2, material));
+  EXPECT_EQ(2, material.id);
+}
+
+TEST(MaterialLib, HandleSeesUpdatesAndBecomesStaleOnDelete) {
+  MaterialLib lib;
+  ASSERT_TRUE(lib.AddMaterial(CreateMaterial(7, 100.f)));
+  const auto handle = lib.GetMaterialHandle(7);
+  ASSERT_FALSE(handle.IsNull());
+  ASSERT_TRUE(lib.UpdateMaterial(CreateMaterial(7, 150.f)));
+  ASSERT_NE(nullptr, lib.GetMaterial(handle));
+  EXPECT_FLOAT_EQ(150.f, lib.GetMaterial(handle)->grain_params.raw_signal_params.frequency);
+
+  ASSERT_TRUE(lib.DeleteMaterial(7));
+  EXPECT_EQ(nullptr, lib.GetMaterial(handle));
+  // the slot is reused by another material, the old handle must not refer to it
+  ASSERT_TRUE(lib.AddMaterial(CreateMaterial(8)));
+  EXPECT_EQ(nullptr, lib.GetMaterial(handle));
+  EXPECT_TRUE(lib.GetMaterialHandle(9).IsNull());
+}
+
+TEST(MaterialLib, ListsAreAppliedEntirelyOrNotAtAll) {
+  MaterialLib lib;
+  EXPECT_FALSE(lib.AddMaterials({CreateMaterial(1), CreateMaterial(1)}));
+  EXPECT_FALSE(lib.MaterialExists(1));
+  EXPECT_FALSE(lib.AddMaterials({CreateMaterial(1), CreateMaterial(kDefaultMaterialID)}));
+  EXPECT_FALSE(lib.MaterialExists(1));
+  ASSERT_TRUE(lib.AddMaterials({CreateMaterial(1), CreateMaterial(2), CreateMaterial(3)}));
+
+  EXPECT_FALSE(lib.UpdateMaterials({CreateMaterial(1, 500.f), CreateMaterial(4, 500.f)}));
+  Material material;
+  ASSERT_TRUE(lib.GetMaterialByID(1, material));
+  EXPECT_FLOAT_EQ(100.f, material.grain_params.raw_signal_params.frequency);
+  ASSERT_TRUE(lib.UpdateMaterials({CreateMaterial(1, 500.f), CreateMaterial(3, 500.f)}));
+  ASSERT_TRUE(lib.GetMaterialByID(3, material));
+  EXPECT_FLOAT_EQ(500.f, material.grain_params.raw_signal_params.frequency);
+
+  EXPECT_FALSE(lib.DeleteMaterials({1, 2, 2}));
+  EXPECT_FALSE(lib.DeleteMaterials({1, 4}));
+  EXPECT_TRUE(lib.MaterialExists(1));
+  ASSERT_TRUE(lib.DeleteMaterials({1, 2}));
+  EXPECT_FALSE(lib.MaterialExists(1));
+  EXPECT_FALSE(lib.MaterialExists(2));
+  EXPECT_TRUE(lib.MaterialExists(3));
+}
+
+TEST(MaterialLib, HoldsAllIds) {
+  MaterialLib lib;
+  for (int id = 1; id < 256; id++) {
+    ASSERT_TRUE(lib.AddMaterial(CreateMaterial(static_cast<uint8_t>(id), static_cast<float>(id))));
+  }
+  for (int id = 1; id < 256; id++) {
+    Material material;
+    ASSERT_TRUE(lib.GetMaterialByID(static_cast<uint8_t>(id), material));
+    EXPECT_FLOAT_EQ(static_cast<float>(id), material.grain_params.raw_signal_params.frequency);
+  }
+  ASSERT_TRUE(lib.DeleteMaterial(128));
+  EXPECT_EQ(-1, lib.GetMaterialIndexByID(128));
+  EXPECT_NE(-1, lib.GetMaterialIndexByID(255));
+}
+
+TEST(MaterialLib, ResetKeepsOnlyTheDefaultMaterial) {
+  MaterialLib lib;
+  ASSERT_TRUE(lib.AddMaterial(CreateMaterial(1)));
+  ASSERT_TRUE(lib.AddMaterial(CreateMaterial(2)));
+  ASSERT_TRUE(lib.DeleteMaterial(kDefaultMaterialID));
+  lib.Reset();
+  EXPECT_TRUE(lib.MaterialExists(kDefaultMaterialID));
+  EXPECT_FALSE(lib.MaterialExists(1));
+  EXPECT_FALSE(lib.MaterialExists(2));
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,232 @@
+#include <gtest/gtest.h>
+#include <sequence_lib.h>
+
+#include <utility>
+#include <vector>
+
+using namespace sensint;
+
+namespace {
+
+GrainSequence CreateSequence(const uint8_t id, const uint16_t num_grains,
+                             const uint16_t first_position = 0) {
+  GrainSequence sequence;
+  sequence.id = id;
+  for (uint16_t i = 0; i < num_grains; i++) {
+    const auto position = static_cast<uint16_t>(first_position + 10 * i);
+    sequence.grains.push_back(Grain{id, position, static_cast<uint16_t>(position + 5)});
+  }
+  return sequence;
+}
+
+void ExpectSequence(const SequenceLib &lib, const GrainSequence &expected) {
+  GrainSequence actual;
+  ASSERT_TRUE(lib.GetSequenceByID(expected.id, actual));
+  ASSERT_EQ(expected.grains.size(), actual.grains.size()) << "sequence " << (int)expected.id;
+  for (size_t i = 0; i < expected.grains.size(); i++) {
+    EXPECT_EQ(expected.grains[i].material_id, actual.grains[i].material_id);
+    EXPECT_EQ(expected.grains[i].pos_start, actual.grains[i].pos_start);
+    EXPECT_EQ(expected.grains[i].pos_end, actual.grains[i].pos_end);
+  }
+}
+
+}  // namespace
+
+TEST(SequenceLib, ContainsTheDefaultSequence) {
+  SequenceLib lib;
+  EXPECT_TRUE(lib.SequenceExists(kDefaultGrainSequenceID));
+  EXPECT_EQ(1u, lib.GetNumSequences());
+  const auto &sequence = lib.GetDefaultSequence();
+  ASSERT_EQ(20, sequence.size);
+  EXPECT_EQ(120, sequence.pos_start[0]);
+  EXPECT_EQ(880, sequence.pos_start[19]);
+  EXPECT_EQ(&sequence, lib.GetSequence(SequenceHandle()));
+  EXPECT_EQ(20u, lib.GetNumGrains());
+}
+
+TEST(SequenceLib, AddsUpdatesAndDeletesASequence) {
+  SequenceLib lib;
+  const auto sequence = CreateSequence(3, 4);
+  ASSERT_TRUE(lib.AddSequence(sequence));
+  EXPECT_FALSE(lib.AddSequence(sequence));
+  ExpectSequence(lib, sequence);
+
+  const auto update = CreateSequence(3, 6, 100);
+  ASSERT_TRUE(lib.UpdateSequence(update));
+  ExpectSequence(lib, update);
+  EXPECT_FALSE(lib.UpdateSequence(CreateSequence(4, 1)));
+
+  ASSERT_TRUE(lib.DeleteSequence(3));
+  EXPECT_FALSE(lib.SequenceExists(3));
+  EXPECT_FALSE(lib.DeleteSequence(3));
+  // the grains of the deleted sequence are released
+  EXPECT_EQ(20u, lib.GetNumGrains());
+}
+
+TEST(SequenceLib, RejectsEmptyAndUnorderedSequences) {
+  SequenceLib lib;
+  EXPECT_FALSE(lib.AddSequence(CreateSequence(1, 0)));
+  auto sequence = CreateSequence(1, 3);
+  sequence.grains[1].pos_start = 3;  // overlaps the first grain
+  EXPECT_FALSE(lib.AddSequence(sequence));
+  sequence = CreateSequence(1, 3);
+  std::swap(sequence.grains[1].pos_start, sequence.grains[1].pos_end);
+  EXPECT_FALSE(lib.AddSequence(sequence));
+  EXPECT_FALSE(lib.AddSequences({CreateSequence(2, 2), sequence}));
+  EXPECT_FALSE(lib.SequenceExists(2));
+
+  ASSERT_TRUE(lib.AddSequence(CreateSequence(1, 3)));
+  EXPECT_FALSE(lib.UpdateSequence(sequence));
+  EXPECT_FALSE(lib.UpdateSequences({sequence}));
+  ExpectSequence(lib, CreateSequence(1, 3));
+}
+
+TEST(SequenceLib, DeleteShiftsTheFollowingSequences) {
+  SequenceLib lib;
+  const std::vector<GrainSequence> sequences{CreateSequence(1, 3), CreateSequence(2, 5),
+                                             CreateSequence(3, 2)};
+  ASSERT_TRUE(lib.AddSequences(sequences));
+  EXPECT_EQ(30u, lib.GetNumGrains());
+  ASSERT_TRUE(lib.DeleteSequence(1));
+  EXPECT_EQ(27u, lib.GetNumGrains());
+  ExpectSequence(lib, sequences[1]);
+  ExpectSequence(lib, sequences[2]);
+}
+
+TEST(SequenceLib, HandlesBecomeStaleOnUpdateAndDelete) {
+  SequenceLib lib;
+  ASSERT_TRUE(lib.AddSequences({CreateSequence(1, 3), CreateSequence(2, 3)}));
+  auto handle = lib.GetSequenceHandle(1);
+  ASSERT_NE(nullptr, lib.GetSequence(handle));
+  ASSERT_TRUE(lib.UpdateSequence(CreateSequence(1, 4)));
+  EXPECT_EQ(nullptr, lib.GetSequence(handle));
+
+  handle = lib.GetSequenceHandle(2);
+  ASSERT_TRUE(lib.DeleteSequence(1));
+  // the grains were shifted, but the view of the handle is updated
+  ASSERT_NE(nullptr, lib.GetSequence(handle));
+  EXPECT_EQ(3, lib.GetSequence(handle)->size);
+  EXPECT_EQ(0, lib.GetSequence(handle)->pos_start[0]);
+  ASSERT_TRUE(lib.DeleteSequence(2));
+  EXPECT_EQ(nullptr, lib.GetSequence(handle));
+}
+
+TEST(SequenceLib, UpdateReplacesTheGrainsInPlace) {
+  SequenceLib lib;
+  ASSERT_TRUE(lib.AddSequences({CreateSequence(1, 3), CreateSequence(2, 5), CreateSequence(3, 2)}));
+  const auto handle = lib.GetSequenceHandle(3);
+  ASSERT_TRUE(lib.UpdateSequence(CreateSequence(2, 7, 100)));
+  ASSERT_TRUE(lib.UpdateSequence(CreateSequence(1, 1, 50)));
+  EXPECT_EQ(30u, lib.GetNumGrains());
+  ExpectSequence(lib, CreateSequence(1, 1, 50));
+  ExpectSequence(lib, CreateSequence(2, 7, 100));
+  ExpectSequence(lib, CreateSequence(3, 2));
+  // the views of the other sequences follow their grains
+  ASSERT_NE(nullptr, lib.GetSequence(handle));
+  EXPECT_EQ(3, lib.GetSequence(handle)->material_id[0]);
+}
+
+TEST(SequenceLib, ListsAreAppliedEntirelyOrNotAtAll) {
+  SequenceLib lib;
+  EXPECT_FALSE(lib.AddSequences({CreateSequence(1, 2), CreateSequence(1, 3)}));
+  EXPECT_FALSE(lib.SequenceExists(1));
+  ASSERT_TRUE(lib.AddSequences({CreateSequence(1, 2), CreateSequence(2, 3)}));
+  EXPECT_FALSE(lib.UpdateSequences({CreateSequence(1, 4), CreateSequence(5, 1)}));
+  ExpectSequence(lib, CreateSequence(1, 2));
+  ASSERT_TRUE(lib.UpdateSequences({CreateSequence(1, 4), CreateSequence(2, 1)}));
+  ExpectSequence(lib, CreateSequence(1, 4));
+  ExpectSequence(lib, CreateSequence(2, 1));
+  EXPECT_FALSE(lib.DeleteSequences({1, 1}));
+  EXPECT_FALSE(lib.DeleteSequences({1, 3}));
+  ASSERT_TRUE(lib.DeleteSequences({1, 2}));
+  EXPECT_EQ(1u, lib.GetNumSequences());
+  EXPECT_EQ(20u, lib.GetNumGrains());
+}
+
+TEST(SequenceLib, RejectsSequencesBeyondTheCapacityOfTheArena) {
+  SequenceLib lib;
+  const auto capacity = GrainArena::kCapacity - lib.GetNumGrains();
+  ASSERT_TRUE(lib.AddSequence(CreateSequence(1, static_cast<uint16_t>(capacity - 1))));
+  EXPECT_FALSE(lib.AddSequence(CreateSequence(2, 2)));
+  EXPECT_FALSE(lib.AddSequences({CreateSequence(2, 1), CreateSequence(3, 1)}));
+  ASSERT_TRUE(lib.AddSequence(CreateSequence(2, 1)));
+  EXPECT_EQ(static_cast<size_t>(GrainArena::kCapacity), lib.GetNumGrains());
+  // an update may reuse the grains of the old sequence
+  ASSERT_TRUE(lib.UpdateSequence(CreateSequence(2, 1, 500)));
+  EXPECT_FALSE(lib.UpdateSequence(CreateSequence(2, 2, 500)));
+  ExpectSequence(lib, CreateSequence(2, 1, 500));
+}
+
+TEST(SequenceLib, PatchesASequenceInPlace) {
+  SequenceLib lib;
+  ASSERT_TRUE(lib.AddSequences({CreateSequence(1, 4), CreateSequence(2, 2)}));
+  const auto handle = lib.GetSequenceHandle(1);
+
+  // replace the second grain, i.e. the size remains and the handle stays valid
+  GrainSequencePatch patch;
+  patch.id = 1;
+  patch.first = 1;
+  patch.num_removed = 1;
+  patch.grains = {Grain{9, 11, 12}};
+  ASSERT_TRUE(lib.PatchSequence(patch));
+  ASSERT_NE(nullptr, lib.GetSequence(handle));
+  EXPECT_EQ(9, lib.GetSequence(handle)->material_id[1]);
+
+  // insert two grains at the end
+  patch.first = 4;
+  patch.num_removed = 0;
+  patch.grains = {Grain{1, 40, 45}, Grain{1, 50, 55}};
+  ASSERT_TRUE(lib.PatchSequence(patch));
+  EXPECT_EQ(nullptr, lib.GetSequence(handle));
+  auto expected = CreateSequence(1, 6);
+  expected.grains[1] = Grain{9, 11, 12};
+  ExpectSequence(lib, expected);
+  ExpectSequence(lib, CreateSequence(2, 2));
+
+  // the patch has to keep the order and the range has to exist
+  patch.first = 0;
+  patch.num_removed = 1;
+  patch.grains = {Grain{1, 20, 25}};
+  EXPECT_FALSE(lib.PatchSequence(patch));
+  patch.first = 6;
+  patch.grains = {};
+  EXPECT_FALSE(lib.PatchSequence(patch));
+  patch.first = 0;
+  patch.num_removed = 6;
+  EXPECT_FALSE(lib.PatchSequence(patch));
+  patch.id = 3;
+  patch.num_removed = 1;
+  EXPECT_FALSE(lib.PatchSequence(patch));
+  ExpectSequence(lib, expected);
+}
+
+TEST(SequenceLib, PatchOfTheDefaultSequenceCopiesItsGrains) {
+  SequenceLib lib;
+  GrainSequencePatch patch;
+  patch.id = kDefaultGrainSequenceID;
+  patch.first = 0;
+  patch.num_removed = 1;
+  patch.grains = {Grain{1, 0, 10}};
+  ASSERT_TRUE(lib.PatchSequence(patch));
+  GrainSequence sequence;
+  ASSERT_TRUE(lib.GetSequenceByID(kDefaultGrainSequenceID, sequence));
+  ASSERT_EQ(20u, sequence.grains.size());
+  EXPECT_EQ(0, sequence.grains[0].pos_start);
+  // the default sequence of the library remains as is
+  EXPECT_EQ(120, lib.GetDefaultSequence().pos_start[0]);
+}
+
+TEST(SequenceLib, CopyRefersToItsOwnArena) {
+  SequenceLib lib;
+  ASSERT_TRUE(lib.AddSequence(CreateSequence(1, 3)));
+  SequenceLib copy = lib;
+  ASSERT_TRUE(lib.UpdateSequence(CreateSequence(1, 3, 100)));
+  ExpectSequence(copy, CreateSequence(1, 3));
+  ExpectSequence(lib, CreateSequence(1, 3, 100));
+  EXPECT_EQ(20, copy.GetDefaultSequence().size);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,283 @@
+#include <Arduino.h>
+#include <gtest/gtest.h>
+#include <helper.h>
+#include <state_management.h>
+
+#include <string>
+#include <vector>
+
+using namespace sensint;
+using namespace sensint::communication;
+
+namespace {
+
+/**
+ * @brief Tokenize a message like the controller does, i.e. (destination, type, length, payload).
+ */
+std::vector<std::string> CreateTokens(const MessageTypes type, const int length = 0,
+                                      const std::string &payload = "") {
+  std::string message = "0," + ToString((long)type) + "," + ToString((long)length);
+  if (!payload.empty()) {
+    message += "," + payload;
+  }
+  std::vector<std::string> tokens;
+  helper::SplitString(message, tokens);
+  return tokens;
+}
+
+class StateManagement : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    host_audio::SetMicros(0);
+    state_management::HandleLibraryCommit(state, libraries);
+  }
+
+  void Send(const MessageTypes type, const int length = 0, const std::string &payload = "") {
+    state_management::UpdateConfig(type, CreateTokens(type, length, payload), state, libraries);
+  }
+
+  void Commit() {
+    if (libraries.Commit()) {
+      state_management::HandleLibraryCommit(state, libraries);
+    }
+  }
+
+  AugmentationState state;
+  LibraryBuffer libraries;
+  tactile_audio::MonoAudio audio;
+};
+
+}  // namespace
+
+TEST_F(StateManagement, StartsWithTheDefaults) {
+  ASSERT_NE(nullptr, state.current_sequence);
+  ASSERT_NE(nullptr, state.current_material);
+  EXPECT_EQ(&libraries.GetSequenceLib().GetDefaultSequence(), state.current_sequence);
+  EXPECT_EQ(&libraries.GetMaterialLib().GetDefaultMaterial(), state.current_material);
+}
+
+TEST_F(StateManagement, StartsAndStopsTheAugmentation) {
+  Send(MessageTypes::kStopAugmentation);
+  EXPECT_FALSE(state.should_augment);
+  Send(MessageTypes::kStartAugmentation);
+  EXPECT_TRUE(state.should_augment);
+}
+
+TEST_F(StateManagement, EditsAreAppliedToTheShadowLibrariesUntilTheCommit) {
+  Send(MessageTypes::kAddMaterial, 6, "5,0,1,300.00,0.50,20.00");
+  EXPECT_FALSE(libraries.GetMaterialLib().MaterialExists(5));
+  EXPECT_TRUE(libraries.GetShadowMaterialLib().MaterialExists(5));
+  Send(MessageTypes::kAddGrainSequence, 2, "3,5,100,100,5,200,300");
+  EXPECT_FALSE(libraries.GetSequenceLib().SequenceExists(3));
+
+  ASSERT_TRUE(libraries.Commit());
+  state_management::HandleLibraryCommit(state, libraries);
+  EXPECT_TRUE(libraries.GetMaterialLib().MaterialExists(5));
+  EXPECT_TRUE(libraries.GetSequenceLib().SequenceExists(3));
+  // the shadow libraries start from the committed ones
+  EXPECT_TRUE(libraries.GetShadowSequenceLib().SequenceExists(3));
+  EXPECT_FALSE(libraries.Commit());
+}
+
+TEST_F(StateManagement, RejectedEditsAreNotCommitted) {
+  // the default material exists already, and sequence 9 does not exist
+  Send(MessageTypes::kAddMaterial, 6, "0,0,1,300.00,0.50,20.00");
+  Send(MessageTypes::kUpdateGrainSequence, 1, "9,0,10,10");
+  Send(MessageTypes::kDeleteMaterial, 1, "42");
+  // the grains are not ordered
+  Send(MessageTypes::kAddGrainSequence, 2, "3,0,200,200,0,100,100");
+  EXPECT_FALSE(libraries.Commit());
+  EXPECT_FALSE(libraries.GetShadowSequenceLib().SequenceExists(3));
+}
+
+TEST_F(StateManagement, RevertDiscardsTheEdits) {
+  Send(MessageTypes::kAddMaterial, 6, "5,0,1,300.00,0.50,20.00");
+  ASSERT_TRUE(libraries.GetShadowMaterialLib().MaterialExists(5));
+  libraries.Revert();
+  EXPECT_FALSE(libraries.GetShadowMaterialLib().MaterialExists(5));
+  EXPECT_FALSE(libraries.Commit());
+  EXPECT_FALSE(libraries.GetMaterialLib().MaterialExists(5));
+}
+
+TEST_F(StateManagement, ListUpdateIsCommittedAsAWhole) {
+  Send(MessageTypes::kBeginLibraryUpdate);
+  Send(MessageTypes::kAddMaterial, 6, "1,0,1,300.00,0.50,20.00");
+  EXPECT_FALSE(libraries.Commit());
+  Send(MessageTypes::kAddMaterial, 6, "2,0,1,300.00,0.50,20.00");
+  Send(MessageTypes::kCommitLibraryUpdate);
+  ASSERT_TRUE(libraries.Commit());
+  EXPECT_TRUE(libraries.GetMaterialLib().MaterialExists(1));
+  EXPECT_TRUE(libraries.GetMaterialLib().MaterialExists(2));
+}
+
+TEST_F(StateManagement, ListWithAnInvalidEntryIsRejectedAsAWhole) {
+  // the second material is the default material, which exists already
+  Send(MessageTypes::kAddMaterialList, 2, "1,0,1,300.00,0.50,20.00,0,0,1,300.00,0.50,20.00");
+  EXPECT_FALSE(libraries.GetShadowMaterialLib().MaterialExists(1));
+  EXPECT_FALSE(libraries.Commit());
+  Send(MessageTypes::kAddMaterialList, 2, "1,0,1,300.00,0.50,20.00,2,0,1,300.00,0.50,20.00");
+  ASSERT_TRUE(libraries.Commit());
+  EXPECT_TRUE(libraries.GetMaterialLib().MaterialExists(1));
+  EXPECT_TRUE(libraries.GetMaterialLib().MaterialExists(2));
+}
+
+TEST_F(StateManagement, AbortedUpdateIsDiscarded) {
+  Send(MessageTypes::kBeginLibraryUpdate);
+  Send(MessageTypes::kAddMaterial, 6, "1,0,1,300.00,0.50,20.00");
+  Send(MessageTypes::kAbortLibraryUpdate);
+  EXPECT_FALSE(libraries.IsUpdateOpen());
+  EXPECT_FALSE(libraries.Commit());
+  EXPECT_FALSE(libraries.GetShadowMaterialLib().MaterialExists(1));
+}
+
+TEST_F(StateManagement, StalledUpdateIsDiscardedAfterTheTimeout) {
+  // the time wraps around during the update
+  const uint32_t start_ms = UINT32_MAX - 1000;
+  libraries.KeepAlive(start_ms);
+  EXPECT_FALSE(libraries.CheckUpdateTimeout(start_ms + LibraryBuffer::kUpdateTimeout));
+  Send(MessageTypes::kBeginLibraryUpdate);
+  Send(MessageTypes::kAddMaterial, 6, "1,0,1,300.00,0.50,20.00");
+  // every message keeps the update alive
+  libraries.KeepAlive(start_ms + 3000);
+  EXPECT_FALSE(libraries.CheckUpdateTimeout(start_ms + 3000 + LibraryBuffer::kUpdateTimeout - 1));
+  EXPECT_TRUE(libraries.IsUpdateOpen());
+  EXPECT_TRUE(libraries.CheckUpdateTimeout(start_ms + 3000 + LibraryBuffer::kUpdateTimeout));
+  EXPECT_FALSE(libraries.IsUpdateOpen());
+  EXPECT_FALSE(libraries.Commit());
+  EXPECT_FALSE(libraries.GetShadowMaterialLib().MaterialExists(1));
+}
+
+TEST_F(StateManagement, SaveIsRequestedByAMessage) {
+  EXPECT_FALSE(state.should_save_libraries);
+  Send(MessageTypes::kSaveLibraries);
+  EXPECT_TRUE(state.should_save_libraries);
+  // the request does not edit the libraries
+  EXPECT_FALSE(libraries.Commit());
+}
+
+TEST_F(StateManagement, SelectsACommittedSequence) {
+  Send(MessageTypes::kAddGrainSequence, 2, "3,0,100,100,0,200,300");
+  // the sequence is not committed yet
+  Send(MessageTypes::kSelectGrainSequence, 1, "3");
+  EXPECT_EQ(kDefaultGrainSequenceID, state.current_sequence->id);
+  Commit();
+  Send(MessageTypes::kSelectGrainSequence, 1, "3");
+  ASSERT_EQ(3, state.current_sequence->id);
+  EXPECT_EQ(100, state.closest_grain.pos_start);
+  EXPECT_TRUE(state.should_reinitialize_material);
+}
+
+TEST_F(StateManagement, DeletedSequenceFallsBackToTheDefault) {
+  Send(MessageTypes::kAddGrainSequence, 1, "3,0,100,100");
+  Commit();
+  Send(MessageTypes::kSelectGrainSequence, 1, "3");
+  ASSERT_EQ(3, state.current_sequence->id);
+  Send(MessageTypes::kDeleteGrainSequence, 1, "3");
+  // the active sequence is still played until the commit
+  EXPECT_EQ(3, state.current_sequence->id);
+  Commit();
+  EXPECT_EQ(&libraries.GetSequenceLib().GetDefaultSequence(), state.current_sequence);
+}
+
+TEST_F(StateManagement, UpdatedSequenceIsResolvedAgain) {
+  Send(MessageTypes::kAddGrainSequence, 1, "3,0,100,100");
+  Commit();
+  Send(MessageTypes::kSelectGrainSequence, 1, "3");
+  Send(MessageTypes::kUpdateGrainSequence, 2, "3,0,50,50,0,500,500");
+  Commit();
+  ASSERT_EQ(3, state.current_sequence->id);
+  ASSERT_EQ(2, state.current_sequence->size);
+  EXPECT_EQ(500, state.current_sequence->pos_start[1]);
+}
+
+TEST_F(StateManagement, PatchedSequenceIsResolvedAgain) {
+  Send(MessageTypes::kAddGrainSequence, 2, "3,0,100,100,0,200,200");
+  Commit();
+  Send(MessageTypes::kSelectGrainSequence, 1, "3");
+  // the inserted grain has to be between the grains around it
+  Send(MessageTypes::kPatchGrainSequence, 1, "3,1,0,0,300,300");
+  EXPECT_FALSE(libraries.Commit());
+  Send(MessageTypes::kPatchGrainSequence, 1, "3,1,0,0,150,150");
+  Commit();
+  ASSERT_EQ(3, state.current_sequence->id);
+  ASSERT_EQ(3, state.current_sequence->size);
+  EXPECT_EQ(150, state.current_sequence->pos_start[1]);
+}
+
+TEST_F(StateManagement, StartsAndStopsAGrain) {
+  Send(MessageTypes::kAddMaterial, 6, "5,0,1,300.00,0.50,2000.00");
+  Send(MessageTypes::kAddGrainSequence, 1, "3,5,100,100");
+  Commit();
+  Send(MessageTypes::kSelectGrainSequence, 1, "3");
+  const auto &sequence = *state.current_sequence;
+
+  state.current_sensor_value = 90;
+  auto idx = tactile_audio::FindClosestGrainIndex(sequence, state.current_sensor_value);
+  state.closest_grain = sequence[idx];
+  EXPECT_FALSE(state_management::CheckAndStartClosestGrain(idx, state, audio,
+                                                           libraries.GetMaterialLib()));
+  state.current_sensor_value = 100;
+  ASSERT_TRUE(state_management::CheckAndStartClosestGrain(idx, state, audio,
+                                                          libraries.GetMaterialLib()));
+  EXPECT_TRUE(audio.is_playing);
+  EXPECT_TRUE(audio.envelope.isActive());
+  // the material of the grain is applied
+  EXPECT_EQ(5, state.current_material->id);
+  EXPECT_FLOAT_EQ(300.f, audio.raw_signal.GetFrequency());
+  // the jitter around the grain does not retrigger it
+  state.current_sensor_value = 101;
+  EXPECT_FALSE(state_management::CheckAndStartClosestGrain(idx, state, audio,
+                                                           libraries.GetMaterialLib()));
+  EXPECT_TRUE(state.is_jitter);
+
+  host_audio::SetMicros(1999);
+  EXPECT_FALSE(state_management::CheckAndStopGrain(idx, state, audio));
+  host_audio::SetMicros(2000);
+  ASSERT_TRUE(state_management::CheckAndStopGrain(idx, state, audio));
+  EXPECT_FALSE(audio.is_playing);
+  EXPECT_FALSE(audio.envelope.isActive());
+}
+
+TEST_F(StateManagement, StartsAndStopsAContinuousVibration) {
+  Send(MessageTypes::kAddMaterial, 6, "5,1,1,300.00,0.50,2000.00");
+  Send(MessageTypes::kAddGrainSequence, 1, "3,5,100,200");
+  Commit();
+  Send(MessageTypes::kSelectGrainSequence, 1, "3");
+  const auto &sequence = *state.current_sequence;
+
+  state.current_sensor_value = 150;
+  const auto idx = tactile_audio::FindClosestGrainIndex(sequence, state.current_sensor_value);
+  state.closest_grain = sequence[idx];
+  ASSERT_TRUE(state_management::CheckAndStartClosestGrain(idx, state, audio,
+                                                          libraries.GetMaterialLib()));
+  EXPECT_TRUE(audio.is_playing);
+  EXPECT_FLOAT_EQ(0.5f, audio.raw_signal.GetAmplitude());
+  EXPECT_FALSE(state_management::CheckAndStartClosestGrain(idx, state, audio,
+                                                           libraries.GetMaterialLib()));
+  // a continuous vibration is not stopped by its duration
+  host_audio::SetMicros(10000);
+  EXPECT_FALSE(state_management::CheckAndStopGrain(idx, state, audio));
+  EXPECT_FALSE(state_management::CheckAndStopContinuousVibration(idx, state, audio));
+  state.current_sensor_value = 201;
+  ASSERT_TRUE(state_management::CheckAndStopContinuousVibration(idx, state, audio));
+  EXPECT_FALSE(audio.is_playing);
+  EXPECT_FLOAT_EQ(0.f, audio.raw_signal.GetAmplitude());
+}
+
+TEST_F(StateManagement, DeletedMaterialFallsBackToTheDefault) {
+  Send(MessageTypes::kAddMaterial, 6, "5,0,1,300.00,0.50,2000.00");
+  Commit();
+  state.material = libraries.GetMaterialLib().GetMaterialHandle(5);
+  state_management::ResolveHandles(state, libraries.GetMaterialLib(),
+                                   libraries.GetSequenceLib());
+  ASSERT_EQ(5, state.current_material->id);
+  Send(MessageTypes::kDeleteMaterial, 1, "5");
+  Commit();
+  EXPECT_EQ(&libraries.GetMaterialLib().GetDefaultMaterial(), state.current_material);
+  EXPECT_TRUE(state.should_reinitialize_material);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,134 @@
+#include <gtest/gtest.h>
+#include <sequence_lib.h>
+#include <tactile_audio.h>
+
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using namespace sensint;
+using namespace sensint::tactile_audio;
+
+namespace {
+
+//! the sensor range of the signal generator (10 bit ADC)
+constexpr int kMaxSensorValue = 1023;
+
+/**
+ * @brief The distance of a sensor value to a grain, which is zero inside of a continuous grain.
+ */
+int GetDistance(const GrainSequenceView &sequence, const int idx, const int sensor_val) {
+  if (sensor_val < sequence.pos_start[idx]) {
+    return sequence.pos_start[idx] - sensor_val;
+  }
+  if (sensor_val > sequence.pos_end[idx]) {
+    return sensor_val - sequence.pos_end[idx];
+  }
+  return 0;
+}
+
+int GetMinDistance(const GrainSequenceView &sequence, const int sensor_val) {
+  auto min_distance = kMaxSensorValue + 1;
+  for (int idx = 0; idx < sequence.size; idx++) {
+    min_distance = std::min(min_distance, GetDistance(sequence, idx, sensor_val));
+  }
+  return min_distance;
+}
+
+/**
+ * @brief Add a sequence to the library and get its view.
+ */
+const GrainSequenceView &AddSequence(SequenceLib &lib, const std::vector<Grain> &grains) {
+  GrainSequence sequence;
+  sequence.id = 1;
+  sequence.grains = grains;
+  lib.DeleteSequence(sequence.id);
+  EXPECT_TRUE(lib.AddSequence(sequence));
+  return *lib.GetSequence(lib.GetSequenceHandle(sequence.id));
+}
+
+}  // namespace
+
+TEST(FindClosestGrainIndex, ClampsToTheFirstAndTheLastGrain) {
+  SequenceLib lib;
+  const auto &sequence = lib.GetDefaultSequence();
+  EXPECT_EQ(0, FindClosestGrainIndex(sequence, 0));
+  EXPECT_EQ(0, FindClosestGrainIndex(sequence, 120));
+  EXPECT_EQ(19, FindClosestGrainIndex(sequence, 880));
+  EXPECT_EQ(19, FindClosestGrainIndex(sequence, kMaxSensorValue));
+}
+
+TEST(FindClosestGrainIndex, FindsTheExactAndTheClosestGrain) {
+  SequenceLib lib;
+  // the default grains are at 120, 160, ..., 880
+  const auto &sequence = lib.GetDefaultSequence();
+  EXPECT_EQ(1, FindClosestGrainIndex(sequence, 160));
+  EXPECT_EQ(1, FindClosestGrainIndex(sequence, 170));
+  EXPECT_EQ(2, FindClosestGrainIndex(sequence, 190));
+  // a tie selects the upper grain
+  EXPECT_EQ(2, FindClosestGrainIndex(sequence, 180));
+  EXPECT_EQ(18, FindClosestGrainIndex(sequence, 845));
+}
+
+TEST(FindClosestGrainIndex, FindsAContinuousGrain) {
+  SequenceLib lib;
+  const auto &sequence =
+      AddSequence(lib, {Grain{1, 100, 100}, Grain{2, 200, 400}, Grain{3, 600, 600}});
+  EXPECT_EQ(1, FindClosestGrainIndex(sequence, 200));
+  EXPECT_EQ(1, FindClosestGrainIndex(sequence, 300));
+  EXPECT_EQ(1, FindClosestGrainIndex(sequence, 499));
+  EXPECT_EQ(2, FindClosestGrainIndex(sequence, 501));
+  EXPECT_EQ(0, FindClosestGrainIndex(sequence, 149));
+}
+
+TEST(FindClosestGrainIndex, PrefersTheContinuousGrainThatContainsTheValue) {
+  SequenceLib lib;
+  // the continuous grain touches the next grain, whose start is as close as the start of the
+  // continuous grain
+  const auto &sequence = AddSequence(lib, {Grain{1, 200, 400}, Grain{2, 400, 400}});
+  EXPECT_EQ(0, FindClosestGrainIndex(sequence, 300));
+  EXPECT_EQ(0, FindClosestGrainIndex(sequence, 399));
+  EXPECT_EQ(1, FindClosestGrainIndex(sequence, 400));
+}
+
+TEST(FindClosestGrainIndex, SingleGrain) {
+  SequenceLib lib;
+  const auto &sequence = AddSequence(lib, {Grain{1, 500, 500}});
+  for (int sensor_val = 0; sensor_val <= kMaxSensorValue; sensor_val += 31) {
+    EXPECT_EQ(0, FindClosestGrainIndex(sequence, sensor_val));
+  }
+}
+
+/**
+ * The binary search is compared against a linear search for all sensor values of random
+ * sequences with single and continuous grains, which may also touch each other.
+ */
+TEST(FindClosestGrainIndex, MatchesALinearSearch) {
+  std::mt19937 random(42);
+  for (int run = 0; run < 200; run++) {
+    const int num_grains = 1 + static_cast<int>(random() % 64);
+    std::vector<Grain> grains;
+    int position = static_cast<int>(random() % 50);
+    for (int i = 0; i < num_grains && position < kMaxSensorValue; i++) {
+      const int length = (random() % 3 == 0) ? static_cast<int>(random() % 40) : 0;
+      const int end = std::min(position + length, kMaxSensorValue);
+      grains.push_back(Grain{0, static_cast<analog_sensor_t>(position),
+                             static_cast<analog_sensor_t>(end)});
+      position = end + static_cast<int>(random() % 40);
+    }
+    SequenceLib lib;
+    const auto &sequence = AddSequence(lib, grains);
+    for (int sensor_val = 0; sensor_val <= kMaxSensorValue; sensor_val++) {
+      const auto idx = FindClosestGrainIndex(sequence, sensor_val);
+      ASSERT_GE(idx, 0);
+      ASSERT_LT(idx, sequence.size);
+      ASSERT_EQ(GetMinDistance(sequence, sensor_val), GetDistance(sequence, idx, sensor_val))
+          << "run " << run << " sensor value " << sensor_val << " index " << idx;
+    }
+  }
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,199 @@
+#include <Arduino.h>
+#include <Wire.h>
+#include <communication.h>
+#include <gtest/gtest.h>
+#include <helper.h>
+
+#include <string>
+#include <vector>
+
+using namespace sensint;
+using namespace sensint::communication;
+
+namespace {
+
+Material CreateMaterial(const uint8_t id, const float frequency) {
+  Material material;
+  material.id = id;
+  material.grain_params.is_continuous = (id % 2) == 0;
+  material.grain_params.raw_signal_params.waveform = Waveform::kSquare;
+  material.grain_params.raw_signal_params.frequency = frequency;
+  material.grain_params.raw_signal_params.amplitude = 0.5f;
+  material.grain_params.duration = 25.f;
+  return material;
+}
+
+GrainSequence CreateSequence(const uint8_t id, const uint16_t num_grains) {
+  GrainSequence sequence;
+  sequence.id = id;
+  for (uint16_t i = 0; i < num_grains; i++) {
+    sequence.grains.push_back(Grain{static_cast<uint8_t>(i % 3), static_cast<uint16_t>(10 * i),
+                                    static_cast<uint16_t>(10 * i + 5)});
+  }
+  return sequence;
+}
+
+void ExpectEqual(const GrainSequence &expected, const GrainSequence &actual) {
+  EXPECT_EQ(expected.id, actual.id);
+  ASSERT_EQ(expected.grains.size(), actual.grains.size());
+  for (size_t i = 0; i < expected.grains.size(); i++) {
+    EXPECT_EQ(expected.grains[i].material_id, actual.grains[i].material_id) << "grain " << i;
+    EXPECT_EQ(expected.grains[i].pos_start, actual.grains[i].pos_start) << "grain " << i;
+    EXPECT_EQ(expected.grains[i].pos_end, actual.grains[i].pos_end) << "grain " << i;
+  }
+}
+
+std::vector<std::string> Split(const std::string &str) {
+  std::vector<std::string> tokens;
+  helper::SplitString(str, tokens);
+  return tokens;
+}
+
+}  // namespace
+
+TEST(Communication, FormatsNumbersIndependentOfTheFramework) {
+  EXPECT_EQ("-42", ToString(-42L));
+  EXPECT_EQ("200.00", ToString(200.f, 2));
+  EXPECT_EQ("0.123457", ToString(0.1234567f, 6));
+}
+
+TEST(Communication, SerializesADataFrame) {
+  DataFrame frame;
+  frame.destination = static_cast<uint8_t>(Devices::kPD1);
+  frame.type = MessageTypes::kSelectGrainSequence;
+  frame.length = 1;
+  frame.payload = "7";
+  std::string str = "stale";
+  SerializeDataFrame(frame, str);
+  EXPECT_EQ("<3,34,1,7>", str);
+}
+
+TEST(Communication, MaterialRoundTrip) {
+  const auto material = CreateMaterial(12, 250.f);
+  std::string str;
+  SerializeMaterial(material, str);
+  Material parsed;
+  ASSERT_TRUE(ParseMaterial(str, parsed));
+  EXPECT_EQ(material.id, parsed.id);
+  EXPECT_EQ(material.grain_params.is_continuous, parsed.grain_params.is_continuous);
+  EXPECT_EQ(material.grain_params.raw_signal_params.waveform,
+            parsed.grain_params.raw_signal_params.waveform);
+  EXPECT_FLOAT_EQ(250.f, parsed.grain_params.raw_signal_params.frequency);
+  EXPECT_FLOAT_EQ(0.5f, parsed.grain_params.raw_signal_params.amplitude);
+  EXPECT_FLOAT_EQ(25.f, parsed.grain_params.duration);
+}
+
+TEST(Communication, RejectsAMaterialWithMissingFields) {
+  Material parsed;
+  EXPECT_FALSE(ParseMaterial("12,1,2,250.00,0.50", parsed));
+  EXPECT_FALSE(ParseMaterial("", parsed));
+}
+
+TEST(Communication, MaterialListRoundTrip) {
+  const std::vector<Material> materials{CreateMaterial(1, 100.f), CreateMaterial(2, 300.f)};
+  std::string str;
+  SerializeMaterialList(materials, str);
+  std::vector<Material> parsed;
+  ASSERT_TRUE(ParseMaterialList(str, 2, parsed));
+  ASSERT_EQ(2u, parsed.size());
+  EXPECT_EQ(2, parsed[1].id);
+  EXPECT_FLOAT_EQ(300.f, parsed[1].grain_params.raw_signal_params.frequency);
+  EXPECT_FALSE(ParseMaterialList(str, 3, parsed));
+}
+
+TEST(Communication, GrainSequenceRoundTrip) {
+  const auto sequence = CreateSequence(5, 4);
+  std::string str;
+  SerializeGrainSequence(sequence, str);
+  EXPECT_EQ("5,0,0,5,1,10,15,2,20,25,0,30,35", str);
+  GrainSequence parsed;
+  ASSERT_TRUE(ParseGrainSequence(str, 4, parsed));
+  ExpectEqual(sequence, parsed);
+}
+
+TEST(Communication, RejectsAGrainSequenceWithAWrongLength) {
+  GrainSequence parsed;
+  EXPECT_FALSE(ParseGrainSequence("5,0,0,5,1,10,15", 3, parsed));
+  EXPECT_FALSE(ParseGrainSequence("5,0,0,5,1,10", 2, parsed));
+}
+
+TEST(Communication, GrainSequenceListRoundTrip) {
+  const std::vector<GrainSequence> sequences{CreateSequence(1, 3), CreateSequence(2, 1),
+                                             CreateSequence(3, 20)};
+  std::string str;
+  SerializeGrainSequenceList(sequences, str);
+  std::vector<GrainSequence> parsed;
+  ASSERT_TRUE(ParseGrainSequenceList(Split(str), 3, parsed));
+  ASSERT_EQ(3u, parsed.size());
+  for (size_t i = 0; i < sequences.size(); i++) {
+    ExpectEqual(sequences[i], parsed[i]);
+  }
+}
+
+TEST(Communication, RejectsAGrainSequenceListWithInvalidCounts) {
+  std::vector<GrainSequence> parsed;
+  // a single sequence with one grain: num_grains, id, material_id, pos_start, pos_end
+  const auto tokens = Split("1,4,0,10,20");
+  EXPECT_TRUE(ParseGrainSequenceList(tokens, 1, parsed));
+  EXPECT_FALSE(ParseGrainSequenceList(tokens, 0, parsed));
+  EXPECT_FALSE(ParseGrainSequenceList(tokens, -1, parsed));
+  EXPECT_FALSE(ParseGrainSequenceList(tokens, 2, parsed));
+  // the length must not be trusted for the allocation
+  EXPECT_FALSE(ParseGrainSequenceList(tokens, INT32_MAX, parsed));
+  EXPECT_TRUE(parsed.empty());
+  EXPECT_FALSE(ParseGrainSequenceList(Split("0,4,0,10,20"), 1, parsed));
+  EXPECT_FALSE(ParseGrainSequenceList(Split("-1,4,0,10,20"), 1, parsed));
+  EXPECT_FALSE(ParseGrainSequenceList(Split("2,4,0,10,20"), 1, parsed));
+  EXPECT_FALSE(ParseGrainSequenceList(Split("2147483647,4,0,10,20"), 1, parsed));
+  // trailing tokens
+  EXPECT_FALSE(ParseGrainSequenceList(Split("1,4,0,10,20,7"), 1, parsed));
+  EXPECT_FALSE(ParseGrainSequenceList({}, 1, parsed));
+}
+
+TEST(Communication, GrainSequencePatchRoundTrip) {
+  GrainSequencePatch patch;
+  patch.id = 9;
+  patch.first = 2;
+  patch.num_removed = 1;
+  patch.grains = CreateSequence(0, 2).grains;
+  std::string str;
+  SerializeGrainSequencePatch(patch, str);
+  GrainSequencePatch parsed;
+  ASSERT_TRUE(ParseGrainSequencePatch(Split(str), 2, parsed));
+  EXPECT_EQ(9, parsed.id);
+  EXPECT_EQ(2, parsed.first);
+  EXPECT_EQ(1, parsed.num_removed);
+  ASSERT_EQ(2u, parsed.grains.size());
+  EXPECT_EQ(15, parsed.grains[1].pos_end);
+  EXPECT_FALSE(ParseGrainSequencePatch(Split(str), 3, parsed));
+  EXPECT_FALSE(ParseGrainSequencePatch(Split(str), -1, parsed));
+}
+
+TEST(Communication, ReadsADataFrameFromTheSerialPort) {
+  Serial.Reset();
+  Serial.Receive("noise<2,34,1,7>");
+  std::string str;
+  ASSERT_TRUE(GetSerializedDataFrameFromSerial(str));
+  EXPECT_EQ("2,34,1,7", str);
+  EXPECT_EQ(0, Serial.available());
+  Serial.Receive("no start");
+  EXPECT_FALSE(GetSerializedDataFrameFromSerial(str));
+  EXPECT_TRUE(str.empty());
+}
+
+TEST(Communication, ReadsADataFrameFromI2CInChunks) {
+  Wire.Reset();
+  std::string str;
+  bool start_found = false;
+  Wire.Receive("x<2,34,");
+  EXPECT_FALSE(GetSerializedDataFrameFromI2C(str, start_found));
+  EXPECT_TRUE(start_found);
+  Wire.Receive("1,7>");
+  ASSERT_TRUE(GetSerializedDataFrameFromI2C(str, start_found));
+  EXPECT_EQ("2,34,1,7", str);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
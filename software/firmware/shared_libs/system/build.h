@@ -16,4 +16,12 @@
 #define SENSINT_PARALLEL_DATA
 #endif
 
+#if SENSINT_TRACE == 1
+#define SENSINT_LATENCY_TRACE
+#endif
+
+#if SENSINT_PROFILE == 1
+#define SENSINT_LOOP_PROFILER
+#endif
+
 #endif  // __SENSINST_BUILD_H__
@@ -1,16 +1,21 @@
 
 #include "communication.h"
 
+#ifdef ARDUINO
 #include <Arduino.h>
 #include <Wire.h>
+#endif  // ARDUINO
 #include <helper.h>
 
 #include "debug.h"
+#ifdef ARDUINO
 #include "i2c.h"
+#endif  // ARDUINO
 
 namespace sensint {
 namespace communication {
 
+#ifdef ARDUINO
 void ClearSerialPort() {
   while (Serial.available()) {
     Serial.read();
@@ -59,6 +64,7 @@ bool GetSerializedDataFrameFromI2C(std::string &str, bool &start_found) {
   }
   return false;
 }
+#endif  // ARDUINO
 
 void SerializeDataFrame(const DataFrame &src, std::string &dest, const bool append,
                         const char delimiter) {
@@ -66,11 +72,11 @@ void SerializeDataFrame(const DataFrame &src, std::string &dest, const bool appe
     dest.clear();
   }
   dest += src.start;
-  dest += String((int)src.destination).c_str();
+  dest += ToString((int)src.destination);
   dest += delimiter;
-  dest += String((int)src.type).c_str();
+  dest += ToString((int)src.type);
   dest += delimiter;
-  dest += String(src.length).c_str();
+  dest += ToString(src.length);
   dest += delimiter;
   dest += src.payload;
   dest += src.end;
@@ -99,11 +105,11 @@ void SerializeRawSignalParameters(const RawSignalParameters src, std::string &de
   if (!append && !dest.empty()) {
     dest.clear();
   }
-  dest += String((uint8_t)src.waveform).c_str();
+  dest += ToString((uint8_t)src.waveform);
   dest += delimiter;
-  dest += String(src.frequency, 2).c_str();
+  dest += ToString(src.frequency, 2);
   dest += delimiter;
-  dest += String(src.amplitude, 2).c_str();
+  dest += ToString(src.amplitude, 2);
 }
 
 bool ParseEnvelopeParameters(const std::string &src, EnvelopeParameters &dest) {
@@ -130,13 +136,13 @@ void SerializeEnvelopeParameters(const EnvelopeParameters &src, std::string &des
   if (!append && !dest.empty()) {
     dest.clear();
   }
-  dest += String(src.attack, 2).c_str();
+  dest += ToString(src.attack, 2);
   dest += delimiter;
-  dest += String(src.decay, 2).c_str();
+  dest += ToString(src.decay, 2);
   dest += delimiter;
-  dest += String(src.sustain, 2).c_str();
+  dest += ToString(src.sustain, 2);
   dest += delimiter;
-  dest += String(src.release, 2).c_str();
+  dest += ToString(src.release, 2);
 }
 
 bool ParseFilterParameters(const std::string &src, FilterParameters &dest) {
@@ -163,13 +169,13 @@ void SerializeFilterParameters(const FilterParameters &src, std::string &dest, c
   if (!append && !dest.empty()) {
     dest.clear();
   }
-  dest += String(src.highCutFrequency, 2).c_str();
+  dest += ToString(src.highCutFrequency, 2);
   dest += delimiter;
-  dest += String(src.highCutResonance, 2).c_str();
+  dest += ToString(src.highCutResonance, 2);
   dest += delimiter;
-  dest += String(src.lowCutFrequency, 2).c_str();
+  dest += ToString(src.lowCutFrequency, 2);
   dest += delimiter;
-  dest += String(src.lowCutResonance, 2).c_str();
+  dest += ToString(src.lowCutResonance, 2);
 }
 
 bool ParseGrainParameters(const std::string &src, GrainParameters &dest) {
@@ -232,7 +238,7 @@ void SerializeGrainParameters(const GrainParameters &src, std::string &dest, con
   dest += delimiter;
   dest += filter_str;
   dest += delimiter;
-  dest += String(src.duration, 2).c_str();
+  dest += ToString(src.duration, 2);
   dest += delimiter;
   dest += src.is_continuous ? "1" : "0";
 }
@@ -291,17 +297,17 @@ void SerializeMaterial(const Material &src, std::string &dest, const bool append
   if (!append && !dest.empty()) {
     dest.clear();
   }
-  dest += String((int)src.id).c_str();
+  dest += ToString((int)src.id);
   dest += delimiter;
   dest += src.grain_params.is_continuous ? "1" : "0";
   dest += delimiter;
-  dest += String((uint8_t)src.grain_params.raw_signal_params.waveform).c_str();
+  dest += ToString((uint8_t)src.grain_params.raw_signal_params.waveform);
   dest += delimiter;
-  dest += String(src.grain_params.raw_signal_params.frequency, 2).c_str();
+  dest += ToString(src.grain_params.raw_signal_params.frequency, 2);
   dest += delimiter;
-  dest += String(src.grain_params.raw_signal_params.amplitude, 2).c_str();
+  dest += ToString(src.grain_params.raw_signal_params.amplitude, 2);
   dest += delimiter;
-  dest += String(src.grain_params.duration, 2).c_str();
+  dest += ToString(src.grain_params.duration, 2);
 
   //! ---------------------------------------------------------------------
   //! This is the actual implementation.
@@ -309,7 +315,7 @@ void SerializeMaterial(const Material &src, std::string &dest, const bool append
   //  if (!append && !dest.empty()) {
   //    dest.clear();
   //  }
-  //  dest += String((int)src.id).c_str();
+  //  dest += ToString((int)src.id);
   //  dest += delimiter;
   //  std::string grain_str;
   //  SerializeGrainParameters(src.grain_params, grain_str);
@@ -407,11 +413,11 @@ void SerializeGrain(const Grain &src, std::string &dest, const bool append, cons
   if (!append && !dest.empty()) {
     dest.clear();
   }
-  dest += String((int)src.material_id).c_str();
+  dest += ToString((int)src.material_id);
   dest += delimiter;
-  dest += String((int)src.pos_start).c_str();
+  dest += ToString((int)src.pos_start);
   dest += delimiter;
-  dest += String((int)src.pos_end).c_str();
+  dest += ToString((int)src.pos_end);
 }
 
 bool ParseGrainSequence(const std::string &src, const int length, GrainSequence &dest) {
@@ -451,7 +457,8 @@ void SerializeGrainSequence(const GrainSequence &src, std::string &dest, const b
   if (!append && !dest.empty()) {
     dest.clear();
   }
-  dest += String((int)src.id).c_str();
+  dest += ToString((int)src.id);
+  dest += delimiter;
   for (const auto &grain : src.grains) {
     std::string grains_str;
     SerializeGrain(grain, grains_str);
@@ -461,14 +468,106 @@ void SerializeGrainSequence(const GrainSequence &src, std::string &dest, const b
   dest.pop_back();
 }
 
+bool ParseGrainSequenceList(const std::vector<std::string> &tokens, const int length,
+                            std::vector<GrainSequence> &dest) {
+  if (!dest.empty()) {
+    dest.clear();
+  }
+  //! every sequence takes at least the count, the id and one grain, hence the counts are checked
+  //! against the remaining tokens before anything is allocated
+  constexpr size_t kMinSequenceTokens = 2 + kGrainNumFields;
+  if (length <= 0 || static_cast<size_t>(length) > tokens.size() / kMinSequenceTokens) {
+    return false;
+  }
+  dest.reserve(length);
+  size_t cursor = 0;
+  for (int i = 0; i < length; i++) {
+    if (tokens.size() - cursor < kMinSequenceTokens) {
+      return false;
+    }
+    const auto num_grains = atol(tokens[cursor].c_str());
+    if (num_grains <= 0 ||
+        static_cast<size_t>(num_grains) > (tokens.size() - cursor - 2) / kGrainNumFields) {
+      return false;
+    }
+    const auto end = cursor + 2 + (static_cast<size_t>(num_grains) * kGrainNumFields);
+    GrainSequence sequence;
+    sequence.id = static_cast<uint8_t>(atoi(tokens[cursor + 1].c_str()));
+    sequence.grains.reserve(num_grains);
+    for (cursor += 2; cursor < end; cursor += kGrainNumFields) {
+      Grain grain;
+      grain.material_id = static_cast<uint8_t>(atoi(tokens[cursor].c_str()));
+      grain.pos_start = static_cast<analog_sensor_t>(atoi(tokens[cursor + 1].c_str()));
+      grain.pos_end = static_cast<analog_sensor_t>(atoi(tokens[cursor + 2].c_str()));
+      sequence.grains.push_back(grain);
+    }
+    dest.push_back(std::move(sequence));
+  }
+  return cursor == tokens.size();
+}
+
+void SerializeGrainSequenceList(const std::vector<GrainSequence> &src, std::string &dest,
+                                const bool append, const char delimiter) {
+  if (!append && !dest.empty()) {
+    dest.clear();
+  }
+  for (const auto &sequence : src) {
+    dest += ToString((long)sequence.grains.size());
+    dest += delimiter;
+    std::string sequence_str;
+    SerializeGrainSequence(sequence, sequence_str, false, delimiter);
+    dest += sequence_str;
+    dest += delimiter;
+  }
+  dest.pop_back();
+}
+
+bool ParseGrainSequencePatch(const std::vector<std::string> &tokens, const int length,
+                             GrainSequencePatch &dest) {
+  if (length < 0 || tokens.size() != (kGrainNumFields * length) + 3) {
+    return false;
+  }
+  dest.id = static_cast<uint8_t>(atoi(tokens[0].c_str()));
+  dest.first = static_cast<uint16_t>(atoi(tokens[1].c_str()));
+  dest.num_removed = static_cast<uint16_t>(atoi(tokens[2].c_str()));
+  dest.grains.clear();
+  dest.grains.reserve(length);
+  for (size_t i = 3; i < tokens.size(); i += kGrainNumFields) {
+    Grain grain;
+    grain.material_id = static_cast<uint8_t>(atoi(tokens[i].c_str()));
+    grain.pos_start = static_cast<analog_sensor_t>(atoi(tokens[i + 1].c_str()));
+    grain.pos_end = static_cast<analog_sensor_t>(atoi(tokens[i + 2].c_str()));
+    dest.grains.push_back(grain);
+  }
+  return true;
+}
+
+void SerializeGrainSequencePatch(const GrainSequencePatch &src, std::string &dest,
+                                 const bool append, const char delimiter) {
+  if (!append && !dest.empty()) {
+    dest.clear();
+  }
+  dest += ToString((int)src.id);
+  dest += delimiter;
+  dest += ToString((int)src.first);
+  dest += delimiter;
+  dest += ToString((int)src.num_removed);
+  for (const auto &grain : src.grains) {
+    std::string grain_str;
+    SerializeGrain(grain, grain_str);
+    dest += delimiter;
+    dest += grain_str;
+  }
+}
+
 void SerializeSensorData(const AnalogSensorData &src, std::string &dest, const bool append,
                          const char delimiter) {
   if (!append && !dest.empty()) {
     dest.clear();
   }
-  dest += String((int)src.device_id).c_str();
+  dest += ToString((int)src.device_id);
   dest += delimiter;
-  dest += String((int)src.value).c_str();
+  dest += ToString((int)src.value);
 }
 
 void SerializeSensorDataList(const std::vector<AnalogSensorData> &src, std::string &dest,
@@ -509,9 +608,9 @@ void SerializeImuData(const ImuData &src, std::string &dest, const bool append,
   dest += delimiter;
   SerializeVector3D<float>(src.acceleration_linear, dest, true);
   dest += delimiter;
-  dest += String((int)src.calibration).c_str();
+  dest += ToString((int)src.calibration);
   dest += delimiter;
-  dest += String((int)src.time_offset).c_str();
+  dest += ToString((int)src.time_offset);
 }
 
 }  // namespace communication
@@ -3,6 +3,7 @@
 
 #include <types.h>
 
+#include <cstdio>
 #include <string>
 #include <vector>
 
@@ -20,6 +21,12 @@ enum class Devices : uint8_t {
   kRightShoe = 0x07  // right shoe's proxy
 };
 
+//! A controller reads the loop profile of a signal generator (see LoopProfileSummary) by writing
+//! this single byte and then reading the summary with a repeated start. Only this read is answered
+//! with the profile, i.e. it never replaces the sensor data of another read. The byte is not
+//! printable, hence it cannot be part of a message.
+static constexpr uint8_t kLoopProfileRegister = 0x03;
+
 enum class MessageTypes : uint8_t {
   /******** status range 0x00 - 0x0F ********/
   // !reserved for generic things!
@@ -36,6 +43,16 @@ enum class MessageTypes : uint8_t {
   kStartAugmentation = 0x20,
   kStopAugmentation = 0x21,
   kSelectGrainSequence = 0x22,
+  // the library edits between these messages are applied together by the generator (see
+  // LibraryBuffer), otherwise every edit is applied on its own. An aborted update discards its
+  // edits, which the generator also does if the update is not committed in time.
+  kBeginLibraryUpdate = 0x23,
+  kCommitLibraryUpdate = 0x24,
+  kAbortLibraryUpdate = 0x25,
+  // the generator saves its libraries to the EEPROM, which restores them at boot (see
+  // library_image.h). The save blocks the loop, hence it is deferred until the augmentation is
+  // stopped.
+  kSaveLibraries = 0x26,
 
   /******** material range 0x30 - 0x3F ********/
   kAddMaterial = 0x30,
@@ -57,6 +74,10 @@ enum class MessageTypes : uint8_t {
   kDeleteAllMaterials = 0x3C,
   kDeleteAllGrainSequences = 0x3D,
 
+  // replace, insert, or remove a range of grains of a sequence: num_grains, id, first grain,
+  // number of removed grains, grains
+  kPatchGrainSequence = 0x3E,
+
   /******** peripheral data range 0x40 - 0x4F ********/
   kSingleAnalogSensorData = 0x40,
   kAnalogSensorDataList = 0x41,
@@ -64,6 +85,24 @@ enum class MessageTypes : uint8_t {
   kIMUDataList = 0x43,
   kShoeData = 0x44,
   kReinitializeIMU = 0x45,
+  // the shoe related messages include the device and the subject (i.e. the pair of shoes)
+  // single sample of a shoe's stream: device, subject, sample type, timestamp [us], values
+  kShoeStreamData = 0x46,
+  // counters of a shoe's stream: device, subject, packets, samples, bytes/s, lost packets,
+  // dropped packets, missing samples
+  kStreamStatistics = 0x47,
+  // round trip time of a command from the PC to a shoe's generator: device, subject, command type,
+  // rtt [us]
+  kLinkLatency = 0x48,
+  // clock synchronization of a shoe: device, subject, synchronized, offset [us], drift [ppb],
+  // residual [us], round trip [us]
+  kClockSync = 0x49,
+  // samples that are missing in the recording of a shoe: device, subject, first sample, number of
+  // samples, timestamp of the next sample [us]
+  kRecordingGap = 0x4A,
+  // aggregated throughput of all shoes: subjects, connected shoes, samples/s, bytes/s, dropped
+  // packets
+  kStreamThroughput = 0x4B,
 };
 
 // TODO: Remove this as soon as the GUI implements the full protocol!
@@ -130,6 +169,7 @@ struct __attribute__((__packed__)) BinaryDataFrame {
   uint8_t payload[kMaxPayload] = {0};
 };
 
+#ifdef ARDUINO
 /**
  * @brief Clear the serial port if there is still data available.
  */
@@ -138,6 +178,29 @@ void ClearSerialPort();
 bool GetSerializedDataFrameFromSerial(std::string &str);
 
 bool GetSerializedDataFrameFromI2C(std::string &str, bool &start_found);
+#endif  // ARDUINO
+
+/**
+ * @brief Format an integer for a serialized message.
+ *
+ * //! In contrast to Arduino's String the formatting does not depend on the
+ * //! framework, hence the messages can be created on a PC, too.
+ */
+inline std::string ToString(const long value) {
+  char buffer[24];
+  snprintf(buffer, sizeof(buffer), "%ld", value);
+  return buffer;
+}
+
+/**
+ * @brief Format a floating point number with a fixed number of decimals for a
+ * serialized message (e.g. 200.00 for two decimals).
+ */
+inline std::string ToString(const float value, const uint8_t decimals) {
+  char buffer[48];
+  snprintf(buffer, sizeof(buffer), "%.*f", decimals, static_cast<double>(value));
+  return buffer;
+}
 
 void SerializeDataFrame(const DataFrame &src, std::string &dest, const bool append = false,
                         const char delimiter = kMessageDelimiter);
@@ -357,6 +420,42 @@ bool ParseGrainSequence(const std::vector<std::string> &tokens, const int length
 void SerializeGrainSequence(const GrainSequence &src, std::string &dest, const bool append = false,
                             const char delimiter = kMessageDelimiter);
 
+/**
+ * @brief Parse a list of grain sequences from a list of strings. Every sequence
+ * is given as in the message of a single sequence, i.e. the strings should be
+ * ordered as follows: (num_grains, id, grains) for each sequence
+ *
+ * @param tokens parameters as strings
+ * @param length number of sequences
+ * @param dest data structure for the sequences
+ *
+ * @return true if parsing was successful, false if the list is empty or a count
+ * exceeds the remaining strings
+ */
+bool ParseGrainSequenceList(const std::vector<std::string> &tokens, const int length,
+                            std::vector<GrainSequence> &dest);
+
+void SerializeGrainSequenceList(const std::vector<GrainSequence> &src, std::string &dest,
+                                const bool append = false,
+                                const char delimiter = kMessageDelimiter);
+
+/**
+ * @brief Parse a patch of a grain sequence from a list of strings. The strings
+ * should be ordered as follows: (id, first, num_removed, grains)
+ *
+ * @param tokens parameters as strings
+ * @param length number of grains
+ * @param dest data structure for the patch
+ *
+ * @return true if parsing was successful
+ */
+bool ParseGrainSequencePatch(const std::vector<std::string> &tokens, const int length,
+                             GrainSequencePatch &dest);
+
+void SerializeGrainSequencePatch(const GrainSequencePatch &src, std::string &dest,
+                                 const bool append = false,
+                                 const char delimiter = kMessageDelimiter);
+
 void SerializeSensorData(const AnalogSensorData &src, std::string &dest, const bool append = false,
                          const char delimiter = kMessageDelimiter);
 
@@ -386,13 +485,13 @@ void SerializeVector2D(const Vector2D<T> &vector, std::string &dest, const bool
     dest.clear();
   }
   if (is_float) {
-    dest += String(vector.x, 6).c_str();
+    dest += ToString(vector.x, 6);
     dest += delimiter;
-    dest += String(vector.y, 6).c_str();
+    dest += ToString(vector.y, 6);
   } else {
-    dest += String((int)vector.x).c_str();
+    dest += ToString((int)vector.x);
     dest += delimiter;
-    dest += String((int)vector.y).c_str();
+    dest += ToString((int)vector.y);
   }
 }
 
@@ -421,17 +520,17 @@ void SerializeVector3D(const Vector3D<T> &vector, std::string &dest, const bool
     dest.clear();
   }
   if (is_float) {
-    dest += String(vector.x, 6).c_str();
+    dest += ToString(vector.x, 6);
     dest += delimiter;
-    dest += String(vector.y, 6).c_str();
+    dest += ToString(vector.y, 6);
     dest += delimiter;
-    dest += String(vector.z, 6).c_str();
+    dest += ToString(vector.z, 6);
   } else {
-    dest += String((int)vector.x).c_str();
+    dest += ToString((int)vector.x);
     dest += delimiter;
-    dest += String((int)vector.y).c_str();
+    dest += ToString((int)vector.y);
     dest += delimiter;
-    dest += String((int)vector.z).c_str();
+    dest += ToString((int)vector.z);
   }
 }
 
@@ -462,21 +561,21 @@ void SerializeVector4D(const Vector4D<T> &vector, std::string &dest, const bool
     dest.clear();
   }
   if (is_float) {
-    dest += String(vector.w, 6).c_str();
+    dest += ToString(vector.w, 6);
     dest += delimiter;
-    dest += String(vector.x, 6).c_str();
+    dest += ToString(vector.x, 6);
     dest += delimiter;
-    dest += String(vector.y, 6).c_str();
+    dest += ToString(vector.y, 6);
     dest += delimiter;
-    dest += String(vector.z, 6).c_str();
+    dest += ToString(vector.z, 6);
   } else {
-    dest += String((int)vector.w).c_str();
+    dest += ToString((int)vector.w);
     dest += delimiter;
-    dest += String((int)vector.x).c_str();
+    dest += ToString((int)vector.x);
     dest += delimiter;
-    dest += String((int)vector.y).c_str();
+    dest += ToString((int)vector.y);
     dest += delimiter;
-    dest += String((int)vector.z).c_str();
+    dest += ToString((int)vector.z);
   }
 }
 
@@ -0,0 +1,121 @@
+#include "debug.h"
+
+#ifdef SENSINT_DEBUG
+
+#if !defined(ESP32) && !defined(__arm__)
+#include <mutex>
+#endif
+
+namespace sensint {
+namespace debug {
+
+namespace {
+struct LogMessage {
+  uint32_t timestamp;
+  uint16_t token;
+  uint8_t num_arguments;
+  uint32_t arguments[kMaxLogArguments];
+};
+
+LogMessage messages[kLogCapacity];
+size_t head = 0;
+size_t count = 0;
+uint32_t dropped = 0;
+
+//! The log is written by tasks and interrupts, hence the buffer is protected by a critical
+//! section. Only the copy of a message is done inside of it.
+#ifdef ESP32
+portMUX_TYPE log_mux = portMUX_INITIALIZER_UNLOCKED;
+
+inline uint32_t Lock() {
+  portENTER_CRITICAL_SAFE(&log_mux);
+  return 0;
+}
+
+inline void Unlock(const uint32_t) { portEXIT_CRITICAL_SAFE(&log_mux); }
+#elif defined(__arm__)
+inline uint32_t Lock() {
+  uint32_t primask;
+  __asm__ volatile("mrs %0, primask\n\tcpsid i" : "=r"(primask)::"memory");
+  return primask;
+}
+
+inline void Unlock(const uint32_t primask) {
+  __asm__ volatile("msr primask, %0" ::"r"(primask) : "memory");
+}
+#else
+//! the unit tests on a PC (see native_test) log from threads instead of interrupts
+std::mutex log_mutex;
+
+inline uint32_t Lock() {
+  log_mutex.lock();
+  return 0;
+}
+
+inline void Unlock(const uint32_t) { log_mutex.unlock(); }
+#endif  // ESP32
+
+void WriteMessage(const LogMessage &message) {
+  uint8_t frame[8 + sizeof(message.arguments)];
+  frame[0] = kLogFrameStart;
+  frame[1] = message.num_arguments;
+  memcpy(&frame[2], &message.token, sizeof(message.token));
+  memcpy(&frame[4], &message.timestamp, sizeof(message.timestamp));
+  memcpy(&frame[8], message.arguments, message.num_arguments * sizeof(uint32_t));
+  Serial.write(frame, 8 + message.num_arguments * sizeof(uint32_t));
+}
+}  // namespace
+
+void EnqueueLog(const LogToken token, const uint32_t *arguments, const uint8_t num_arguments) {
+  const auto timestamp = micros();
+  const auto state = Lock();
+  if (count == kLogCapacity) {
+    dropped++;
+    Unlock(state);
+    return;
+  }
+  auto &message = messages[(head + count) % kLogCapacity];
+  message.timestamp = timestamp;
+  message.token = static_cast<uint16_t>(token);
+  message.num_arguments = num_arguments;
+  memcpy(message.arguments, arguments, num_arguments * sizeof(uint32_t));
+  count++;
+  Unlock(state);
+}
+
+/**
+ * The messages are copied one by one, hence the critical section is short. Dropped messages are
+ * reported once the buffer is empty, because they are newer than the buffered messages.
+ */
+size_t DrainLog(const size_t max_messages) {
+  size_t drained = 0;
+  while (drained < max_messages) {
+    const auto state = Lock();
+    if (count == 0) {
+      const auto num_dropped = dropped;
+      dropped = 0;
+      Unlock(state);
+      if (num_dropped > 0) {
+        LogMessage message;
+        message.timestamp = micros();
+        message.token = static_cast<uint16_t>(LogToken::kLogDropped);
+        message.num_arguments = 1;
+        message.arguments[0] = num_dropped;
+        WriteMessage(message);
+      }
+      break;
+    }
+    const LogMessage message = messages[head];
+    head = (head + 1) % kLogCapacity;
+    count--;
+    Unlock(state);
+    WriteMessage(message);
+    drained++;
+  }
+  return drained;
+}
+
+}  // namespace debug
+}  // namespace sensint
+
+#endif  // SENSINT_DEBUG
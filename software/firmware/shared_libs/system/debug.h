@@ -1,7 +1,15 @@
 #ifndef __SENSINT_DEBUG_H__
 #define __SENSINT_DEBUG_H__
 
+#ifdef ARDUINO
 #include <Arduino.h>
+#endif  // ARDUINO
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "log_tokens.h"
 
 namespace sensint {
 namespace debug {
@@ -11,9 +19,11 @@ namespace debug {
  *
  * @param message the message to log
  */
+#ifdef ARDUINO
 static void printToDisplay(const String& message) {
   // placeholder
 }
+#endif  // ARDUINO
 
 /**
  * @brief levels of debug output
@@ -23,6 +33,12 @@ static void printToDisplay(const String& message) {
  */
 enum class DebugLevel { none, basic, verbose };
 
+//! Builds without the Arduino framework (e.g. the hardware independent libraries on a PC) have no
+//! serial port, hence the debug output is disabled.
+#ifndef ARDUINO
+#undef SENSINT_DEBUG
+#endif  // ARDUINO
+
 #if SENSINT_DEBUG == 0
 #undef SENSINT_DEBUG
 const auto kDebugLevel = DebugLevel::none;
@@ -89,6 +105,93 @@ static void Log(const String& file, const String& func, const int line, const St
   }
 }
 
+/*******************************************************************************
+                                tokenized logging
+ ******************************************************************************/
+
+static constexpr uint8_t kMaxLogArguments = 6;
+static constexpr size_t kLogCapacity = 64;
+static constexpr size_t kLogDrainBatch = 8;
+//! first byte of a binary log message on the serial port
+static constexpr uint8_t kLogFrameStart = 0x1E;
+
+/**
+ * @brief Count the conversions of a printf format string at compile time.
+ */
+constexpr uint8_t CountLogArguments(const char* format) {
+  return (*format == '\0')    ? 0
+         : (*format != '%')   ? CountLogArguments(format + 1)
+         : (format[1] == '%') ? CountLogArguments(format + 2)
+                              : 1 + CountLogArguments(format + 1);
+}
+
+enum class LogToken : uint16_t {
+#define SENSINT_LOG_TOKEN_ENUM(token, function, format) token,
+  SENSINT_LOG_TOKENS(SENSINT_LOG_TOKEN_ENUM)
+#undef SENSINT_LOG_TOKEN_ENUM
+      kNumLogTokens
+};
+
+constexpr uint8_t kLogTokenArguments[] = {
+#define SENSINT_LOG_TOKEN_ARGUMENTS(token, function, format) CountLogArguments(format),
+    SENSINT_LOG_TOKENS(SENSINT_LOG_TOKEN_ARGUMENTS)
+#undef SENSINT_LOG_TOKEN_ARGUMENTS
+};
+
+template <typename T>
+inline uint32_t ToLogWord(const T value) {
+  return static_cast<uint32_t>(value);
+}
+
+inline uint32_t ToLogWord(const float value) {
+  uint32_t word;
+  memcpy(&word, &value, sizeof(word));
+  return word;
+}
+
+inline uint32_t ToLogWord(const double value) { return ToLogWord(static_cast<float>(value)); }
+
+/**
+ * @brief Add a message to the log buffer. Use @ref LogTokenized instead, which checks the
+ * arguments.
+ */
+void EnqueueLog(const LogToken token, const uint32_t* arguments, const uint8_t num_arguments);
+
+/**
+ * @brief Log a message of the token table (see log_tokens.h) without formatting it. Only the
+ * token, a timestamp, and the raw arguments are copied into a ring buffer, which is written to
+ * the serial port by @ref DrainLog. This is safe to call from interrupts.
+ *
+ * EXAMPLE: LogTokenized<LogToken::kMaterialChange>(DebugLevel::verbose, material_id);
+ *
+ * @param level the level of the message
+ * @param args the values of the conversions of the format string
+ */
+template <LogToken token, typename... Args>
+void LogTokenized(const DebugLevel level, const Args... args) {
+  static_assert(sizeof...(Args) == kLogTokenArguments[static_cast<uint16_t>(token)],
+                "the number of arguments does not match the format string of the token");
+  static_assert(sizeof...(Args) <= kMaxLogArguments, "too many arguments");
+  if (static_cast<uint8_t>(level) <= static_cast<uint8_t>(kDebugLevel)) {
+    // the additional element avoids an empty array
+    const uint32_t words[] = {ToLogWord(args)..., 0};
+    EnqueueLog(token, words, sizeof...(Args));
+  }
+}
+
+/**
+ * @brief Write the buffered tokenized messages to the serial port. This should be called where
+ * the timing does not matter, e.g. at the end of the loop.
+ *
+ * Every message is written as binary frame, which is decoded on the host:
+ * start (0x1E) | number of arguments (uint8) | token (uint16) | timestamp [us] (uint32) |
+ * arguments (uint32[])
+ *
+ * @param max_messages the maximum number of messages to write
+ * @return the number of written messages
+ */
+size_t DrainLog(const size_t max_messages = kLogDrainBatch);
+
 #endif  // SENSINT_DEBUG
 
 }  // namespace debug
@@ -0,0 +1,28 @@
+#ifndef __SENSINT_LOG_TOKENS_H__
+#define __SENSINT_LOG_TOKENS_H__
+
+/**
+ * @brief The table of the tokenized log messages (see debug::LogTokenized). Every entry is given
+ * as X(token, function, format).
+ *
+ * The format strings are only used at compile time to check the number of arguments, they are not
+ * part of the firmware. The host decoder (software/log_decoder) reads them from this file to
+ * restore the text. Hence, the format supports the printf conversions of 32 bit values (%d, %u,
+ * %x, %c, and %f) but no strings.
+ *
+ * //! The token of a message is its position in the table. Append new messages at the end and
+ * //! use the decoder with the table of the firmware that produced the log.
+ */
+#define SENSINT_LOG_TOKENS(X)                                                                    \
+  X(kLogDropped, "DrainLog", "dropped %u messages")                                              \
+  X(kStartContinuousVibration, "CheckAndStartContinuousVibration",                              \
+    "entered continuous vibration - grain idx: %d pos_start:%d pos_end:%d | sensor:%d | mat:%d") \
+  X(kStopContinuousVibration, "CheckAndStopContinuousVibration",                                \
+    "left continuous vibration - grain idx: %d pos_start:%d pos_end:%d | sensor:%d | mat:%d")    \
+  X(kStartGrain, "CheckAndStartGrain", "trigger grain - idx:%d pos:%d | sensor:%d | mat:%d")    \
+  X(kStopGrain, "CheckAndStopGrain", "stop grain - idx:%d pos:%d | sensor:%d | mat:%d")         \
+  X(kMaterialChange, "CheckAndApplyMaterialChange", "change to material %d")                    \
+  X(kSendSensorData, "HandleI2COnRequest", "send sensor data - bytes written: %u/%u | x:%u y:%u") \
+  X(kGrainArenaUsage, "SequenceLib", "grain arena - used:%u/%u | sequences:%u")
+
+#endif  // __SENSINT_LOG_TOKENS_H__
@@ -1,8 +1,11 @@
 #ifndef __SENSINT_TYPES_H__
 #define __SENSINT_TYPES_H__
 
+#ifdef ARDUINO
 #include <Arduino.h>
+#endif  // ARDUINO
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -307,6 +310,19 @@ static void PrintGrainSequence(const GrainSequence &sequence) {
 }
 #endif  // SENSINT_DEBUG
 
+/**
+ * @brief A data structure to edit a range of grains of an existing sequence,
+ * i.e. the grains [first, first + num_removed) are replaced by the given grains.
+ * A patch without removed grains inserts the grains, a patch without grains
+ * removes the range.
+ */
+struct GrainSequencePatch {
+  uint8_t id = kDefaultGrainSequenceID;
+  uint16_t first = 0;
+  uint16_t num_removed = 0;
+  std::vector<sensint::Grain> grains;
+};
+
 //! Update this parameter if the number of fields in the struct changes.
 static constexpr uint32_t kAnalogSensorDataNumFields = 2;
 
@@ -0,0 +1,670 @@
+// include std headers
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// include shared libraries
+#include <communication.h>
+#include <helper.h>
+#include <library_buffer.h>
+#include <library_image.h>
+#include <library_storage.h>
+#include <material_lib.h>
+#include <sequence_lib.h>
+#include <state_management.h>
+#include <tactile_audio.h>
+#include <types.h>
+
+// include the presets of the signal generator
+#include "local_settings.h"
+
+namespace {
+using namespace sensint;
+
+/*******************************************************************************
+                          (namespace) constants and types
+ ******************************************************************************/
+
+//! columns of the shoe recordings of the logger (software/haptic_shoe_logger)
+constexpr size_t kTimestampColumn = 0;
+constexpr size_t kAugmentationColumn[2] = {2, 3};
+constexpr size_t kSequenceColumn[2] = {4, 5};
+//! the first FSR column of each shoe, which are ordered VT, VB, HI, HO
+constexpr size_t kSensorColumn[2] = {6, 19};
+constexpr size_t kNumColumns = 32;
+
+constexpr uint8_t kNumChannels = 2;
+//! the channel names of the vertical (A, B) and horizontal (a, b) orientation
+constexpr char kChannelNames[2][kNumChannels] = {{'A', 'B'}, {'a', 'b'}};
+//! use the sequence recorded by the logger
+constexpr int kRecordedSequence = -1;
+
+enum class EventType : uint8_t {
+  kTrigger = 0,
+  kStop,
+  kContinuousStart,
+  kContinuousStop,
+  kMaterialChange,
+  kMissedGrain,
+  kNumEventTypes
+};
+
+constexpr uint8_t kNumEventTypes = static_cast<uint8_t>(EventType::kNumEventTypes);
+const char* const kEventNames[kNumEventTypes] = {"trigger",  "stop",     "cv_start",
+                                                 "cv_stop",  "material", "missed"};
+
+struct Options {
+  std::string trace_path;
+  std::string events_path;
+  std::string metrics_path;
+  std::string storage_path;
+  //! 0: left shoe, 1: right shoe
+  uint8_t shoe = 0;
+  //! 0: vertical (A + B), 1: horizontal (a + b)
+  uint8_t orientation = 0;
+  int sequence = kRecordedSequence;
+  bool allow_retrigger = false;
+  //! upload the presets as one list message per library instead of one message per entry
+  bool batched_presets = false;
+};
+
+struct Sample {
+  uint32_t timestamp_ms = 0;
+  bool should_augment = true;
+  int sequence = 0;
+  analog_sensor_t values[kNumChannels] = {0, 0};
+};
+
+struct Event {
+  uint32_t timestamp_ms = 0;
+  uint8_t channel = 0;
+  EventType type = EventType::kTrigger;
+  int grain_idx = 0;
+  analog_sensor_t position = 0;
+  analog_sensor_t sensor_value = 0;
+  int material = 0;
+};
+
+/**
+ * @brief The augmentation state and the audio of a single channel (i.e. sensor) of the signal
+ * generator.
+ */
+struct Channel {
+  AugmentationState state;
+  tactile_audio::MonoAudio audio;
+  analog_sensor_t last_value = 0;
+  bool has_last_value = false;
+  uint32_t counts[kNumEventTypes] = {0};
+};
+
+/*******************************************************************************
+                          (namespace) global variables
+ ******************************************************************************/
+
+Options options;
+std::vector<Sample> samples;
+std::vector<Event> events;
+//! the number of messages and the processing time of the preset upload
+size_t num_preset_messages = 0;
+double preset_upload_time = 0.0;
+//! the libraries were restored from the storage instead of uploading the presets
+bool is_library_restored = false;
+
+// augmentation - the same objects as used by the signal generator
+LibraryBuffer libraries;
+LibraryStorage library_storage;
+uint32_t presets_crc = 0;
+Channel channels[kNumChannels];
+
+/*******************************************************************************
+                              extracted functions
+ ******************************************************************************/
+
+void PrintUsage() {
+  std::cerr << "usage: generator_replay <trace.csv> [options]\n"
+               "       generator_replay --compare <events_a.csv> <events_b.csv>\n"
+               "\n"
+               "  --shoe left|right     shoe of the recording to replay (default: left)\n"
+               "  --orientation 0|1     0: vertical (A + B), 1: horizontal (a + b) (default: 0)\n"
+               "  --sequence ID         replay with this sequence instead of the recorded one\n"
+               "  --retrigger           allow retriggering a playing grain (slider setup)\n"
+               "  --batched-presets     upload the presets as one list message per library\n"
+               "  --events FILE         write the event log to FILE\n"
+               "  --metrics FILE        append the metrics of the replay to FILE\n"
+               "  --storage FILE        restore the libraries from the EEPROM image in FILE and\n"
+               "                        save the uploaded presets to FILE (created if it does not\n"
+               "                        exist)\n";
+}
+
+bool ParseOptions(const int argc, char** argv) {
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+    const bool has_value = i + 1 < argc;
+    if (arg == "--shoe" && has_value) {
+      options.shoe = (std::string(argv[++i]) == "right") ? 1 : 0;
+    } else if (arg == "--orientation" && has_value) {
+      options.orientation = (atoi(argv[++i]) == 1) ? 1 : 0;
+    } else if (arg == "--sequence" && has_value) {
+      options.sequence = atoi(argv[++i]);
+    } else if (arg == "--retrigger") {
+      options.allow_retrigger = true;
+    } else if (arg == "--batched-presets") {
+      options.batched_presets = true;
+    } else if (arg == "--events" && has_value) {
+      options.events_path = argv[++i];
+    } else if (arg == "--metrics" && has_value) {
+      options.metrics_path = argv[++i];
+    } else if (arg == "--storage" && has_value) {
+      options.storage_path = argv[++i];
+    } else if (arg[0] != '-' && options.trace_path.empty()) {
+      options.trace_path = arg;
+    } else {
+      return false;
+    }
+  }
+  return !options.trace_path.empty();
+}
+
+/**
+ * @brief Load the recording of the logger. The recorded FSR values are the filtered values of the
+ * signal generator, hence they are replayed without filtering.
+ */
+bool LoadTrace(const std::string& path) {
+  std::ifstream file(path);
+  if (!file) {
+    std::cerr << "could not open " << path << std::endl;
+    return false;
+  }
+  std::string line;
+  std::vector<std::string> tokens;
+  // skip the header
+  std::getline(file, line);
+  while (std::getline(file, line)) {
+    if (!helper::SplitString(line, tokens, ',') || tokens.size() < kNumColumns) {
+      continue;
+    }
+    Sample sample;
+    sample.timestamp_ms = static_cast<uint32_t>(strtoul(tokens[kTimestampColumn].c_str(), 0, 10));
+    sample.should_augment = tokens[kAugmentationColumn[options.shoe]] == "true";
+    sample.sequence = (options.sequence == kRecordedSequence)
+                          ? atoi(tokens[kSequenceColumn[options.shoe]].c_str())
+                          : options.sequence;
+    for (uint8_t i = 0; i < kNumChannels; i++) {
+      const auto column = kSensorColumn[options.shoe] + options.orientation * kNumChannels + i;
+      sample.values[i] = static_cast<analog_sensor_t>(atoi(tokens[column].c_str()));
+    }
+    samples.push_back(sample);
+  }
+  if (samples.empty()) {
+    std::cerr << "no samples in " << path << std::endl;
+    return false;
+  }
+  return true;
+}
+
+/**
+ * @brief Handle a serialized message like the signal generator does (see UpdateConfig of
+ * generator_stereo_out). All messages are applied to the state of the first channel.
+ */
+void UpdateConfig(const std::string& message) {
+  std::vector<std::string> tokens;
+  if (!helper::SplitString(message, tokens)) {
+    return;
+  }
+  auto msg_type = static_cast<communication::MessageTypes>(atoi(tokens[1].c_str()));
+  auto& state_a = channels[0].state;
+  auto& state_b = channels[1].state;
+  state_management::UpdateConfig(msg_type, tokens, state_a, libraries);
+  const auto& sequence_lib = libraries.GetSequenceLib();
+  if (state_b.sequence != state_a.sequence) {
+    state_management::SelectSequence(state_b, state_a.sequence, sequence_lib);
+  }
+  state_management::ResolveHandles(state_b, libraries.GetMaterialLib(), sequence_lib);
+}
+
+/**
+ * @brief Make the edited libraries active like the signal generator does between two loop
+ * iterations (see CommitLibraries of generator_stereo_out).
+ */
+void CommitLibraries() {
+  if (!libraries.Commit()) {
+    return;
+  }
+  for (auto& channel : channels) {
+    state_management::HandleLibraryCommit(channel.state, libraries);
+  }
+}
+
+/**
+ * @brief Save the libraries on request once the augmentation is stopped like the signal generator
+ * does (see SaveLibraries of generator_stereo_out).
+ *
+ * @param is_stopped true if the augmentation is stopped regardless of the state, i.e. at the end
+ * of the trace
+ */
+void SaveLibraries(const bool is_stopped = false) {
+  auto& state_a = channels[0].state;
+  if (!state_a.should_save_libraries || (state_a.should_augment && !is_stopped)) {
+    return;
+  }
+  library_image::Save(libraries, presets_crc, library_storage);
+  state_a.should_save_libraries = false;
+}
+
+/**
+ * @brief Combine the messages of the presets into one list message per library, i.e. the way a
+ * controller uploads an entire library in a single exchange.
+ */
+std::vector<std::string> GetBatchedPresets() {
+  using communication::MessageTypes;
+  std::string materials;
+  std::string sequences;
+  std::vector<std::string> tokens;
+  // the fields of a material follow its length, those of a sequence start with its length
+  const auto append_fields = [&tokens](const std::string& message, const size_t first_field,
+                                       std::string& dest) {
+    std::string fields = message;
+    fields.erase(std::remove(fields.begin(), fields.end(), '<'), fields.end());
+    fields.erase(std::remove(fields.begin(), fields.end(), '>'), fields.end());
+    helper::SplitString(fields, tokens);
+    for (size_t i = first_field; i < tokens.size(); i++) {
+      dest += ',' + tokens[i];
+    }
+  };
+  for (const auto& material : settings::local::presets::kMaterials) {
+    append_fields(material, 3, materials);
+  }
+  for (const auto& sequence : settings::local::presets::kSequences) {
+    append_fields(sequence, 2, sequences);
+  }
+  const auto num_materials = settings::local::presets::kMaterials.size();
+  const auto num_sequences = settings::local::presets::kSequences.size();
+  return {"0," + std::to_string(static_cast<int>(MessageTypes::kAddMaterialList)) + ',' +
+              std::to_string(num_materials) + materials,
+          "0," + std::to_string(static_cast<int>(MessageTypes::kAddGrainSequenceList)) + ',' +
+              std::to_string(num_sequences) + sequences};
+}
+
+/**
+ * @brief Set up the channels and load the presets in the same way as the signal generator (see
+ * SetupSensors, SetupAugmentation, and LoadPresets of generator_stereo_out).
+ */
+void SetupAugmentation() {
+  for (auto& channel : channels) {
+    channel.state.allow_retrigger = options.allow_retrigger;
+    state_management::SelectSequence(channel.state, SequenceHandle(), libraries.GetSequenceLib());
+    state_management::ResolveHandles(channel.state, libraries.GetMaterialLib(),
+                                     libraries.GetSequenceLib());
+    tactile_audio::ApplyGrainParameters(channel.state.current_material->grain_params,
+                                        channel.audio);
+  }
+  presets_crc = library_image::GetPresetsCrc(settings::local::presets::kMaterials,
+                                             settings::local::presets::kSequences);
+  auto start = std::chrono::steady_clock::now();
+  if (!options.storage_path.empty() &&
+      library_image::Load(library_storage, presets_crc, libraries)) {
+    CommitLibraries();
+    const auto duration = std::chrono::steady_clock::now() - start;
+    is_library_restored = true;
+    preset_upload_time = std::chrono::duration<double>(duration).count();
+    return;
+  }
+  std::vector<std::string> messages;
+  if (options.batched_presets) {
+    messages = GetBatchedPresets();
+  } else {
+    messages = settings::local::presets::kMaterials;
+    messages.insert(messages.end(), settings::local::presets::kSequences.begin(),
+                    settings::local::presets::kSequences.end());
+  }
+  start = std::chrono::steady_clock::now();
+  for (const auto& message : messages) {
+    UpdateConfig(message);
+  }
+  CommitLibraries();
+  const auto duration = std::chrono::steady_clock::now() - start;
+  num_preset_messages = messages.size();
+  // the controller asks the signal generator to keep the uploaded libraries
+  if (!options.storage_path.empty()) {
+    const auto save_type = static_cast<int>(communication::MessageTypes::kSaveLibraries);
+    UpdateConfig("0," + std::to_string(save_type) + ",0");
+  }
+  preset_upload_time = std::chrono::duration<double>(duration).count();
+}
+
+void AddEvent(const uint32_t timestamp_ms, const uint8_t channel_idx, const EventType type,
+              const int grain_idx) {
+  auto& channel = channels[channel_idx];
+  const auto grain = (*channel.state.current_sequence)[grain_idx];
+  Event event;
+  event.timestamp_ms = timestamp_ms;
+  event.channel = channel_idx;
+  event.type = type;
+  event.grain_idx = grain_idx;
+  event.position = grain.pos_start;
+  event.sensor_value = channel.state.current_sensor_value;
+  event.material = (type == EventType::kMissedGrain) ? grain.material_id
+                                                     : channel.state.current_material->id;
+  events.push_back(event);
+  channel.counts[static_cast<uint8_t>(type)]++;
+}
+
+/**
+ * @brief Add a missed grain for every single grain which the sensor value passed since the last
+ * sample but which was not triggered. A grain is passed if its position is between the last
+ * (exclusive) and the current (inclusive) sensor value.
+ */
+void CheckMissedGrains(const uint32_t timestamp_ms, const uint8_t channel_idx,
+                       const int triggered_grain_idx) {
+  auto& channel = channels[channel_idx];
+  if (!channel.has_last_value || channel.last_value == channel.state.current_sensor_value) {
+    return;
+  }
+  const auto& grains = *channel.state.current_sequence;
+  const auto low = std::min(channel.last_value, channel.state.current_sensor_value);
+  const auto high = std::max(channel.last_value, channel.state.current_sensor_value);
+  for (size_t i = 0; i < grains.size; i++) {
+    const auto position = grains.pos_start[i];
+    if (grains.pos_end[i] != position || position < low || position > high ||
+        position == channel.last_value || static_cast<int>(i) == triggered_grain_idx) {
+      continue;
+    }
+    AddEvent(timestamp_ms, channel_idx, EventType::kMissedGrain, static_cast<int>(i));
+  }
+}
+
+/**
+ * @brief Run the augmentation of all channels in the same order as the signal generator (see
+ * HandleAugmentation of generator_stereo_out) and record the events.
+ */
+void HandleAugmentation(const uint32_t timestamp_ms) {
+  using namespace sensint::state_management;
+
+  int grain_idx[kNumChannels];
+  for (uint8_t i = 0; i < kNumChannels; i++) {
+    grain_idx[i] = tactile_audio::FindClosestGrainIndex(*channels[i].state.current_sequence,
+                                                        channels[i].state.current_sensor_value);
+  }
+  for (uint8_t i = 0; i < kNumChannels; i++) {
+    if (CheckAndStopContinuousVibration(grain_idx[i], channels[i].state, channels[i].audio)) {
+      AddEvent(timestamp_ms, i, EventType::kContinuousStop, grain_idx[i]);
+    }
+  }
+  for (uint8_t i = 0; i < kNumChannels; i++) {
+    if (CheckAndStopGrain(grain_idx[i], channels[i].state, channels[i].audio)) {
+      AddEvent(timestamp_ms, i, EventType::kStop, grain_idx[i]);
+    }
+  }
+  for (uint8_t i = 0; i < kNumChannels; i++) {
+    auto& state = channels[i].state;
+    state.closest_grain = (*state.current_sequence)[grain_idx[i]];
+  }
+  for (uint8_t i = 0; i < kNumChannels; i++) {
+    auto& state = channels[i].state;
+    const auto material = state.current_material->id;
+    const auto is_continuous = state.closest_grain.pos_start != state.closest_grain.pos_end;
+    const auto started = CheckAndStartClosestGrain(grain_idx[i], state, channels[i].audio,
+                                                   libraries.GetMaterialLib());
+    if (started && state.current_material->id != material) {
+      AddEvent(timestamp_ms, i, EventType::kMaterialChange, grain_idx[i]);
+    }
+    if (started) {
+      AddEvent(timestamp_ms, i, is_continuous ? EventType::kContinuousStart : EventType::kTrigger,
+               grain_idx[i]);
+    }
+    CheckMissedGrains(timestamp_ms, i, (started && !is_continuous) ? grain_idx[i] : -1);
+  }
+}
+
+/**
+ * @brief Replay all samples of the trace.
+ *
+ * @return processing time in seconds
+ */
+double Replay() {
+  const auto start = std::chrono::steady_clock::now();
+  auto should_augment = true;
+  auto sequence = kRecordedSequence;
+  for (const auto& sample : samples) {
+    host_audio::SetMicros(sample.timestamp_ms * 1000);
+    if (sample.should_augment != should_augment) {
+      should_augment = sample.should_augment;
+      UpdateConfig(should_augment ? "0,32,0" : "0,33,0");
+      CommitLibraries();
+    }
+    if (sample.sequence != sequence) {
+      sequence = sample.sequence;
+      UpdateConfig("0,34,1," + std::to_string(sequence));
+      CommitLibraries();
+    }
+    SaveLibraries();
+    for (uint8_t i = 0; i < kNumChannels; i++) {
+      channels[i].state.current_sensor_value = sample.values[i];
+    }
+    if (channels[0].state.should_augment) {
+      HandleAugmentation(sample.timestamp_ms);
+    }
+    for (auto& channel : channels) {
+      channel.last_value = channel.state.current_sensor_value;
+      channel.has_last_value = channels[0].state.should_augment;
+    }
+  }
+  const auto duration = std::chrono::steady_clock::now() - start;
+  SaveLibraries(true);
+  return std::chrono::duration<double>(duration).count();
+}
+
+bool WriteEvents(const std::string& path) {
+  std::ofstream file(path);
+  if (!file) {
+    std::cerr << "could not write " << path << std::endl;
+    return false;
+  }
+  file << "timestamp,channel,event,grain_idx,position,sensor,material\n";
+  for (const auto& event : events) {
+    file << event.timestamp_ms << ',' << kChannelNames[options.orientation][event.channel] << ','
+         << kEventNames[static_cast<uint8_t>(event.type)] << ',' << event.grain_idx << ','
+         << event.position << ',' << event.sensor_value << ',' << event.material << '\n';
+  }
+  return true;
+}
+
+/**
+ * @brief The missed grain rate is the share of the passed single grains which were not
+ * triggered.
+ */
+float GetMissedGrainRate(const uint32_t triggers, const uint32_t missed) {
+  return (triggers + missed > 0) ? 100.f * missed / (triggers + missed) : 0.f;
+}
+
+void PrintSummary(const double processing_time) {
+  const auto duration = (samples.back().timestamp_ms - samples.front().timestamp_ms) / 1000.f;
+  printf("\n============================================\n");
+  printf("trace: %s\n", options.trace_path.c_str());
+  printf("%zu samples (%.1f s) of the %s shoe\n", samples.size(), duration,
+         (options.shoe == 0) ? "left" : "right");
+  if (options.sequence == kRecordedSequence) {
+    printf("sequence: recorded\n");
+  } else {
+    printf("sequence: %d\n", options.sequence);
+  }
+  printf("--------------------------------------------\n");
+  printf("channel ");
+  for (const auto name : kEventNames) {
+    printf(" %9s", name);
+  }
+  printf("  missed[%%]\n");
+  uint32_t triggers = 0;
+  uint32_t missed = 0;
+  for (uint8_t i = 0; i < kNumChannels; i++) {
+    const auto& counts = channels[i].counts;
+    printf("%-8c", kChannelNames[options.orientation][i]);
+    for (const auto count : counts) {
+      printf(" %9u", count);
+    }
+    printf("  %9.1f\n", GetMissedGrainRate(counts[static_cast<uint8_t>(EventType::kTrigger)],
+                                            counts[static_cast<uint8_t>(EventType::kMissedGrain)]));
+    triggers += counts[static_cast<uint8_t>(EventType::kTrigger)];
+    missed += counts[static_cast<uint8_t>(EventType::kMissedGrain)];
+  }
+  printf("--------------------------------------------\n");
+  printf("missed grain rate: %.1f %%\n", GetMissedGrainRate(triggers, missed));
+  printf("throughput: %.0f samples/s\n", samples.size() / processing_time);
+  const auto& sequence_lib = libraries.GetSequenceLib();
+  printf("grain arena: %zu/%zu grains of %zu sequences\n", sequence_lib.GetNumGrains(),
+         GrainArena::kCapacity, sequence_lib.GetNumSequences());
+  if (is_library_restored) {
+    printf("libraries: restored from the storage in %.1f us\n", preset_upload_time * 1e6);
+  } else {
+    printf("preset upload: %zu messages in %.1f us\n", num_preset_messages,
+           preset_upload_time * 1e6);
+  }
+  if (!options.storage_path.empty()) {
+    printf("storage: %zu bytes written\n", library_storage.GetNumWrittenBytes());
+  }
+  printf("============================================\n\n");
+}
+
+/**
+ * @brief Append the metrics of the replay to a CSV file, which allows to track them across
+ * firmware changes.
+ */
+bool WriteMetrics(const std::string& path, const double processing_time) {
+  std::ifstream existing(path);
+  const auto has_header = existing.good();
+  existing.close();
+  std::ofstream file(path, std::ios::app);
+  if (!file) {
+    std::cerr << "could not write " << path << std::endl;
+    return false;
+  }
+  if (!has_header) {
+    file << "trace,shoe,orientation,sequence,samples,triggers,missed,missed_grain_rate,"
+            "samples_per_second\n";
+  }
+  uint32_t triggers = 0;
+  uint32_t missed = 0;
+  for (const auto& channel : channels) {
+    triggers += channel.counts[static_cast<uint8_t>(EventType::kTrigger)];
+    missed += channel.counts[static_cast<uint8_t>(EventType::kMissedGrain)];
+  }
+  file << options.trace_path << ',' << static_cast<int>(options.shoe) << ','
+       << static_cast<int>(options.orientation) << ',' << options.sequence << ','
+       << samples.size() << ',' << triggers << ',' << missed << ','
+       << GetMissedGrainRate(triggers, missed) << ','
+       << static_cast<uint32_t>(samples.size() / processing_time) << '\n';
+  return true;
+}
+
+/**
+ * @brief Compare two event logs. The number of events is compared per channel and type, and the
+ * first differing event is reported.
+ *
+ * @return 0 if the event logs are equal, 1 if they differ, 2 on error
+ */
+int CompareEvents(const std::string& path_a, const std::string& path_b) {
+  std::ifstream files[2] = {std::ifstream(path_a), std::ifstream(path_b)};
+  if (!files[0] || !files[1]) {
+    std::cerr << "could not open the event logs" << std::endl;
+    return 2;
+  }
+  std::vector<std::string> lines[2];
+  for (uint8_t i = 0; i < 2; i++) {
+    std::string line;
+    while (std::getline(files[i], line)) {
+      lines[i].push_back(line);
+    }
+  }
+  // the counts per channel (row) and event type (column)
+  std::vector<std::string> channel_names;
+  std::vector<std::vector<uint32_t>> counts[2];
+  std::vector<std::string> tokens;
+  for (uint8_t i = 0; i < 2; i++) {
+    for (size_t j = 1; j < lines[i].size(); j++) {
+      if (!helper::SplitString(lines[i][j], tokens, ',') || tokens.size() < 3) {
+        continue;
+      }
+      const auto type = std::find(std::begin(kEventNames), std::end(kEventNames), tokens[2]);
+      if (type == std::end(kEventNames)) {
+        continue;
+      }
+      auto channel = std::find(channel_names.begin(), channel_names.end(), tokens[1]);
+      if (channel == channel_names.end()) {
+        channel = channel_names.insert(channel_names.end(), tokens[1]);
+        counts[0].emplace_back(kNumEventTypes, 0);
+        counts[1].emplace_back(kNumEventTypes, 0);
+      }
+      counts[i][channel - channel_names.begin()][type - std::begin(kEventNames)]++;
+    }
+  }
+  printf("\n============================================\n");
+  printf("a: %s\nb: %s\n", path_a.c_str(), path_b.c_str());
+  printf("--------------------------------------------\n");
+  printf("channel  event            a          b      delta\n");
+  for (size_t channel = 0; channel < channel_names.size(); channel++) {
+    for (uint8_t type = 0; type < kNumEventTypes; type++) {
+      const auto a = counts[0][channel][type];
+      const auto b = counts[1][channel][type];
+      printf("%-8s %-9s %9u  %9u  %+9d\n", channel_names[channel].c_str(), kEventNames[type], a,
+             b, static_cast<int>(b) - static_cast<int>(a));
+    }
+  }
+  printf("--------------------------------------------\n");
+  const auto num_lines = std::min(lines[0].size(), lines[1].size());
+  auto first_difference = num_lines;
+  for (size_t i = 0; i < num_lines && first_difference == num_lines; i++) {
+    if (lines[0][i] != lines[1][i]) {
+      first_difference = i;
+    }
+  }
+  const auto are_equal = first_difference == num_lines && lines[0].size() == lines[1].size();
+  if (are_equal) {
+    printf("the event logs are equal\n");
+  } else if (first_difference < num_lines) {
+    printf("first difference in line %zu:\na: %s\nb: %s\n", first_difference + 1,
+           lines[0][first_difference].c_str(), lines[1][first_difference].c_str());
+  } else {
+    printf("the event logs are equal up to line %zu, but differ in length\n", num_lines);
+  }
+  printf("============================================\n\n");
+  return are_equal ? 0 : 1;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc == 4 && strcmp(argv[1], "--compare") == 0) {
+    return CompareEvents(argv[2], argv[3]);
+  }
+  if (!ParseOptions(argc, argv)) {
+    PrintUsage();
+    return 2;
+  }
+  if (!LoadTrace(options.trace_path)) {
+    return 2;
+  }
+  if (!options.storage_path.empty() && !library_storage.LoadFile(options.storage_path)) {
+    std::cerr << "could not load " << options.storage_path << std::endl;
+    return 2;
+  }
+  SetupAugmentation();
+  const auto processing_time = Replay();
+  PrintSummary(processing_time);
+  if (!options.events_path.empty() && !WriteEvents(options.events_path)) {
+    return 2;
+  }
+  if (!options.metrics_path.empty() && !WriteMetrics(options.metrics_path, processing_time)) {
+    return 2;
+  }
+  if (!options.storage_path.empty() && !library_storage.SaveFile(options.storage_path)) {
+    std::cerr << "could not write " << options.storage_path << std::endl;
+    return 2;
+  }
+  return 0;
+}
@@ -0,0 +1,185 @@
+#ifndef __SENSINT_GRAIN_ARENA_H__
+#define __SENSINT_GRAIN_ARENA_H__
+
+#include <types.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+//! The number of grains of all sequences in the library (incl. the default sequence). Every grain
+//! takes 5 bytes of RAM.
+#ifndef SENSINT_GRAIN_ARENA_CAPACITY
+#define SENSINT_GRAIN_ARENA_CAPACITY 2048
+#endif  // SENSINT_GRAIN_ARENA_CAPACITY
+
+namespace sensint {
+
+/**
+ * @brief A read-only view of a grain sequence that is stored in a GrainArena. The grains are
+ * stored as structure of arrays, i.e. the start positions (and end positions and material IDs) of
+ * consecutive grains are contiguous.
+ */
+struct GrainSequenceView {
+  uint8_t id = kDefaultGrainSequenceID;
+  // the position of the first grain in the arena
+  uint16_t offset = 0;
+  // the number of grains
+  uint16_t size = 0;
+  const analog_sensor_t *pos_start = nullptr;
+  const analog_sensor_t *pos_end = nullptr;
+  const uint8_t *material_id = nullptr;
+
+  /**
+   * @brief Get a copy of a grain.
+   */
+  Grain operator[](const size_t idx) const {
+    return Grain{material_id[idx], pos_start[idx], pos_end[idx]};
+  }
+};
+
+#ifdef SENSINT_DEBUG
+static void PrintGrainSequence(const GrainSequenceView &sequence) {
+  Serial.printf("Grain Sequence >>> id:%d\n", (int)sequence.id);
+  for (size_t i = 0; i < sequence.size; i++) {
+    Serial.printf("[%d] ", (int)i);
+    PrintGrain(sequence[i]);
+  }
+}
+#endif  // SENSINT_DEBUG
+
+/**
+ * @brief A fixed-capacity pool of grains, which is used by the sequence library instead of
+ * allocating the grains of every sequence on the heap.
+ *
+ * //! The grains are appended to the end of the pool. The owner closes the gaps of erased grains by
+ * //! moving the subsequent grains (see Move and Truncate), hence the views of the moved sequences
+ * //! have to be renewed (see GetView).
+ */
+class GrainArena final {
+ public:
+  static constexpr size_t kCapacity = SENSINT_GRAIN_ARENA_CAPACITY;
+  static constexpr int kNoOffset = -1;
+  static_assert(kCapacity <= UINT16_MAX, "the grains are addressed with 16 bit offsets");
+
+  GrainArena() = default;
+  GrainArena(const GrainArena &other) { *this = other; }
+
+  /**
+   * @brief Copy the grains of another pool, i.e. only the used part of the pool is copied.
+   */
+  GrainArena &operator=(const GrainArena &other) {
+    if (this != &other) {
+      memcpy(pos_start_, other.pos_start_, other.size_ * sizeof(analog_sensor_t));
+      memcpy(pos_end_, other.pos_end_, other.size_ * sizeof(analog_sensor_t));
+      memcpy(material_id_, other.material_id_, other.size_ * sizeof(uint8_t));
+      size_ = other.size_;
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Append grains to the end of the pool.
+   *
+   * @param grains the grains to append
+   * @return int the offset of the first grain or kNoOffset if the capacity is exceeded
+   */
+  int Append(const std::vector<Grain> &grains) {
+    if (grains.size() > kCapacity - size_) {
+      return kNoOffset;
+    }
+    const auto offset = size_;
+    for (const auto &grain : grains) {
+      pos_start_[size_] = grain.pos_start;
+      pos_end_[size_] = grain.pos_end;
+      material_id_[size_] = grain.material_id;
+      size_++;
+    }
+    return static_cast<int>(offset);
+  }
+
+  /**
+   * @brief Move grains to a lower offset, e.g. to close the gap of erased grains. The ranges may
+   * overlap.
+   *
+   * @param from the offset of the first grain to move
+   * @param to the new offset of the first grain
+   * @param size the number of grains to move
+   */
+  void Move(const uint16_t from, const uint16_t to, const uint16_t size) {
+    if (to >= from || from >= size_ || size > size_ - from) {
+      return;
+    }
+    memmove(&pos_start_[to], &pos_start_[from], size * sizeof(analog_sensor_t));
+    memmove(&pos_end_[to], &pos_end_[from], size * sizeof(analog_sensor_t));
+    memmove(&material_id_[to], &material_id_[from], size * sizeof(uint8_t));
+  }
+
+  /**
+   * @brief Replace a range of grains with other grains in place. If the number of grains changes,
+   * all subsequent grains are shifted.
+   *
+   * @param offset the offset of the first grain to replace
+   * @param num_removed the number of grains to replace
+   * @param grains the new grains
+   * @return false if the range exceeds the pool or the capacity is exceeded
+   */
+  bool Splice(const uint16_t offset, const uint16_t num_removed,
+              const std::vector<Grain> &grains) {
+    if (offset > size_ || num_removed > size_ - offset ||
+        grains.size() > kCapacity - (size_ - num_removed)) {
+      return false;
+    }
+    const size_t from = offset + num_removed;
+    const size_t to = offset + grains.size();
+    if (from != to) {
+      const auto tail = size_ - from;
+      memmove(&pos_start_[to], &pos_start_[from], tail * sizeof(analog_sensor_t));
+      memmove(&pos_end_[to], &pos_end_[from], tail * sizeof(analog_sensor_t));
+      memmove(&material_id_[to], &material_id_[from], tail * sizeof(uint8_t));
+      size_ = size_ - num_removed + grains.size();
+    }
+    for (size_t i = 0; i < grains.size(); i++) {
+      pos_start_[offset + i] = grains[i].pos_start;
+      pos_end_[offset + i] = grains[i].pos_end;
+      material_id_[offset + i] = grains[i].material_id;
+    }
+    return true;
+  }
+
+  /**
+   * @brief Erase all grains from the given size on.
+   */
+  void Truncate(const size_t size) {
+    if (size < size_) {
+      size_ = size;
+    }
+  }
+
+  /**
+   * @brief Get a view of a sequence of grains in the pool.
+   */
+  GrainSequenceView GetView(const uint8_t id, const uint16_t offset, const uint16_t size) const {
+    GrainSequenceView view;
+    view.id = id;
+    view.offset = offset;
+    view.size = size;
+    view.pos_start = &pos_start_[offset];
+    view.pos_end = &pos_end_[offset];
+    view.material_id = &material_id_[offset];
+    return view;
+  }
+
+  size_t Size() const { return size_; }
+
+ private:
+  analog_sensor_t pos_start_[kCapacity];
+  analog_sensor_t pos_end_[kCapacity];
+  uint8_t material_id_[kCapacity];
+  size_t size_ = 0;
+};
+
+}  // namespace sensint
+
+#endif  // __SENSINT_GRAIN_ARENA_H__
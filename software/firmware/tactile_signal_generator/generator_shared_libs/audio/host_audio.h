@@ -0,0 +1,163 @@
+#ifndef __SENSINT_HOST_AUDIO_H__
+#define __SENSINT_HOST_AUDIO_H__
+
+#include <cstdint>
+
+/**
+ * @brief Stand-ins of the Teensy Audio objects used by the signal generator. They are used when
+ * the libraries are compiled without the Arduino framework (e.g. by the sensor trace replay in
+ * generator_replay).
+ *
+ * //! The objects only store their parameters and do not render any audio. The time is simulated,
+ * //! i.e. it is only advanced by SetMicros(), which makes a replay deterministic.
+ */
+namespace sensint {
+namespace host_audio {
+
+inline uint32_t &SimulatedMicros() {
+  static uint32_t micros = 0;
+  return micros;
+}
+
+/**
+ * @brief Get the simulated time.
+ *
+ * @return time in microseconds
+ */
+inline uint32_t Micros() { return SimulatedMicros(); }
+
+/**
+ * @brief Set the simulated time.
+ *
+ * @param micros time in microseconds
+ */
+inline void SetMicros(const uint32_t micros) { SimulatedMicros() = micros; }
+
+}  // namespace host_audio
+}  // namespace sensint
+
+#define AUDIO_BLOCK_SAMPLES 128
+#define AUDIO_SAMPLE_RATE_EXACT 44117.64706f
+
+struct audio_block_t {
+  int16_t data[AUDIO_BLOCK_SAMPLES];
+};
+
+//! the audio objects are updated by the caller, i.e. there is no audio interrupt to block
+inline void AudioNoInterrupts() {}
+inline void AudioInterrupts() {}
+
+/**
+ * @brief An audio object with inputs receives the blocks that were handed to it with @ref Send,
+ * one per input and update().
+ */
+class AudioStream {
+ public:
+  AudioStream() {}
+  AudioStream(const unsigned char num_inputs, audio_block_t **input_queue)
+      : num_inputs_(num_inputs), input_queue_(input_queue) {
+    for (unsigned char input = 0; input < num_inputs_; input++) {
+      input_queue_[input] = nullptr;
+    }
+  }
+  virtual ~AudioStream() {}
+  virtual void update(void) {}
+
+  /**
+   * @brief Hand a block to an input, it is received by the next update(). The block is owned by
+   * the caller.
+   */
+  void Send(const unsigned char input, audio_block_t *block) {
+    if (input < num_inputs_) {
+      input_queue_[input] = block;
+    }
+  }
+
+ protected:
+  audio_block_t *receiveReadOnly(const unsigned int input = 0) {
+    if (input >= num_inputs_) {
+      return nullptr;
+    }
+    audio_block_t *block = input_queue_[input];
+    input_queue_[input] = nullptr;
+    return block;
+  }
+  void release(audio_block_t *block) {}
+
+ private:
+  unsigned char num_inputs_ = 0;
+  audio_block_t **input_queue_ = nullptr;
+};
+
+class AudioSynthWaveform : public AudioStream {
+ public:
+  void begin(const short waveform) { waveform_ = waveform; }
+  void frequency(const float frequency) { frequency_ = frequency; }
+  void amplitude(const float amplitude) { amplitude_ = amplitude; }
+  void phase(const float phase) { phase_ = phase; }
+
+  short GetWaveform() const { return waveform_; }
+  float GetFrequency() const { return frequency_; }
+  float GetAmplitude() const { return amplitude_; }
+
+ private:
+  short waveform_ = 0;
+  float frequency_ = 0.f;
+  float amplitude_ = 0.f;
+  float phase_ = 0.f;
+};
+
+class AudioEffectEnvelope : public AudioStream {
+ public:
+  void noteOn() { is_active_ = true; }
+  void noteOff() { is_active_ = false; }
+  bool isActive() const { return is_active_; }
+  void attack(const float milliseconds) { attack_ = milliseconds; }
+  void hold(const float milliseconds) { hold_ = milliseconds; }
+  void decay(const float milliseconds) { decay_ = milliseconds; }
+  void sustain(const float level) { sustain_ = level; }
+  void release(const float milliseconds) { release_ = milliseconds; }
+
+ private:
+  bool is_active_ = false;
+  float attack_ = 0.f;
+  float hold_ = 0.f;
+  float decay_ = 0.f;
+  float sustain_ = 0.f;
+  float release_ = 0.f;
+};
+
+class AudioFilterBiquad : public AudioStream {
+ public:
+  void setHighpass(const uint32_t stage, const float frequency, const float q = 0.7071f) {}
+  void setLowpass(const uint32_t stage, const float frequency, const float q = 0.7071f) {}
+  void setBandpass(const uint32_t stage, const float frequency, const float q = 1.f) {}
+  void setNotch(const uint32_t stage, const float frequency, const float q = 1.f) {}
+};
+
+class AudioOutputPT8211 : public AudioStream {};
+
+class AudioConnection {
+ public:
+  AudioConnection(AudioStream &source, AudioStream &destination) {}
+  AudioConnection(AudioStream &source, const unsigned char source_output,
+                  AudioStream &destination, const unsigned char destination_input) {}
+};
+
+/**
+ * @brief Counts the simulated microseconds since it was (re)set, like the one of the Teensy core.
+ */
+class elapsedMicros {
+ public:
+  elapsedMicros(const uint32_t value = 0) : start_(sensint::host_audio::Micros() - value) {}
+  operator uint32_t() const { return sensint::host_audio::Micros() - start_; }
+  elapsedMicros &operator=(const uint32_t value) {
+    start_ = sensint::host_audio::Micros() - value;
+    return *this;
+  }
+
+ private:
+  uint32_t start_;
+};
+
+#endif  // __SENSINT_HOST_AUDIO_H__
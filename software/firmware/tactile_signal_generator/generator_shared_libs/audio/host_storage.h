@@ -0,0 +1,93 @@
+#ifndef __SENSINT_HOST_STORAGE_H__
+#define __SENSINT_HOST_STORAGE_H__
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace sensint {
+
+/**
+ * @brief Stand-in of the EEPROM storage of the library image (see library_storage.h). It is used
+ * when the libraries are compiled without the Arduino framework (e.g. by the sensor trace replay
+ * in generator_replay).
+ *
+ * //! The storage is kept in memory and can be loaded from and saved to a file, which simulates a
+ * //! power cycle of the signal generator. An erased EEPROM reads as 0xFF.
+ */
+class LibraryStorage final {
+ public:
+  //! the EEPROM size of the Teensy 4.1
+  static constexpr size_t kDefaultCapacity = 4284;
+
+  explicit LibraryStorage(const size_t capacity = kDefaultCapacity) : data_(capacity, 0xFF) {}
+
+  size_t Capacity() const { return data_.size(); }
+
+  bool Read(const size_t address, uint8_t *data, const size_t size) const {
+    if (address > Capacity() || size > Capacity() - address) {
+      return false;
+    }
+    memcpy(data, &data_[address], size);
+    return true;
+  }
+
+  bool Write(const size_t address, const uint8_t *data, const size_t size) {
+    if (address > Capacity() || size > Capacity() - address) {
+      return false;
+    }
+    for (size_t i = 0; i < size; i++) {
+      if (data_[address + i] != data[i]) {
+        data_[address + i] = data[i];
+        num_written_bytes_++;
+      }
+    }
+    return true;
+  }
+
+  /**
+   * @brief Get the number of bytes that were changed by all writes, i.e. the wear of the EEPROM.
+   */
+  size_t GetNumWrittenBytes() const { return num_written_bytes_; }
+
+  /**
+   * @brief Load the content of the storage from a file. A missing file is an erased storage.
+   *
+   * @return false if the file is larger than the capacity
+   */
+  bool LoadFile(const std::string &path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+      return true;
+    }
+    const std::vector<uint8_t> content{std::istreambuf_iterator<char>(file),
+                                       std::istreambuf_iterator<char>()};
+    if (content.size() > Capacity()) {
+      return false;
+    }
+    std::copy(content.begin(), content.end(), data_.begin());
+    return true;
+  }
+
+  bool SaveFile(const std::string &path) const {
+    std::ofstream file(path, std::ios::binary);
+    if (!file) {
+      return false;
+    }
+    file.write(reinterpret_cast<const char *>(data_.data()), data_.size());
+    return file.good();
+  }
+
+ private:
+  std::vector<uint8_t> data_;
+  size_t num_written_bytes_ = 0;
+};
+
+}  // namespace sensint
+
+#endif  // __SENSINT_HOST_STORAGE_H__
@@ -0,0 +1,157 @@
+#ifndef __SENSINT_ID_INDEX_H__
+#define __SENSINT_ID_INDEX_H__
+
+#include <cstddef>
+#include <cstdint>
+
+namespace sensint {
+
+/**
+ * @brief Maps the IDs (uint8_t) of the entries of a library (e.g. materials or sequences) to
+ * their slots in the data vector of the library. All lookups are constant time.
+ *
+ * //! The slots are stable, i.e. the slot of an entry does not change until it is deleted. The
+ * //! slot of a deleted entry is reused by the next added entry, hence adding and deleting entries
+ * //! never shifts the data of the library.
+ */
+class IdIndex final {
+ public:
+  static constexpr size_t kNumIds = 256;
+  static constexpr int kNoSlot = -1;
+
+  IdIndex() {
+    for (size_t i = 0; i < kNumIds; i++) {
+      slots_[i] = kNoSlot;
+      generations_[i] = 0;
+    }
+  }
+
+  /**
+   * @brief Remove all IDs from the index. All handles become stale.
+   */
+  void Clear() {
+    for (size_t id = 0; id < kNumIds; id++) {
+      if (slots_[id] != kNoSlot) {
+        generations_[slots_[id]]++;
+      }
+      slots_[id] = kNoSlot;
+    }
+    num_free_slots_ = 0;
+    num_ids_ = 0;
+  }
+
+  /**
+   * @brief Get the slot of an ID.
+   *
+   * @param id of the entry
+   * @return int the slot of the entry or kNoSlot if the ID does not exist
+   */
+  int GetSlot(const uint8_t id) const { return slots_[id]; }
+
+  bool Contains(const uint8_t id) const { return slots_[id] != kNoSlot; }
+
+  /**
+   * @brief Get the number of IDs in the index.
+   */
+  size_t Size() const { return num_ids_; }
+
+  /**
+   * @brief Get the generation of a slot, which is incremented every time the slot is freed.
+   */
+  uint16_t GetGeneration(const int slot) const { return generations_[slot]; }
+
+  /**
+   * @brief Check if a slot is still occupied by the entry of the given generation.
+   */
+  bool IsCurrent(const int slot, const uint16_t generation) const {
+    return slot >= 0 && slot < static_cast<int>(kNumIds) && generations_[slot] == generation;
+  }
+
+  /**
+   * @brief Add an ID to the index. A free slot is reused if available, otherwise the entry has to
+   * be appended to the data, i.e. the slot is the current size of the data.
+   *
+   * @param id of the new entry
+   * @param num_slots the current size of the data
+   * @return int the slot of the new entry or kNoSlot if the ID exists already
+   */
+  int Insert(const uint8_t id, const size_t num_slots) {
+    if (Contains(id)) {
+      return kNoSlot;
+    }
+    if (num_free_slots_ == 0) {
+      slots_[id] = static_cast<int16_t>(num_slots);
+    } else {
+      slots_[id] = free_slots_[--num_free_slots_];
+    }
+    num_ids_++;
+    return slots_[id];
+  }
+
+  /**
+   * @brief Remove an ID from the index. Its slot is reused by the next inserted ID.
+   *
+   * @param id of the entry to remove
+   * @return int the slot of the removed entry or kNoSlot if the ID does not exist
+   */
+  int Erase(const uint8_t id) {
+    const int slot = slots_[id];
+    if (slot != kNoSlot) {
+      FreeSlot(slot);
+      slots_[id] = kNoSlot;
+      num_ids_--;
+    }
+    return slot;
+  }
+
+  /**
+   * @brief Make all handles of an existing ID stale, e.g. because its data is replaced. The ID
+   * keeps its slot.
+   *
+   * @param id of the entry
+   * @return int the slot of the entry or kNoSlot if the ID does not exist
+   */
+  int Invalidate(const uint8_t id) {
+    const int slot = slots_[id];
+    if (slot != kNoSlot) {
+      generations_[slot]++;
+    }
+    return slot;
+  }
+
+ private:
+  void FreeSlot(const int slot) {
+    generations_[slot]++;
+    free_slots_[num_free_slots_++] = static_cast<int16_t>(slot);
+  }
+
+  int16_t slots_[kNumIds];
+  uint16_t generations_[kNumIds];
+  //! there is at most one slot per ID, hence the free slots never exceed the number of IDs
+  int16_t free_slots_[kNumIds];
+  size_t num_free_slots_ = 0;
+  size_t num_ids_ = 0;
+};
+
+/**
+ * @brief A lightweight reference to an entry of a library. The handle is stale once the entry is
+ * deleted (or replaced, see IdIndex::Invalidate), which is detected by the generation of the slot. A null
+ * handle (i.e. without slot) refers to the default entry of the library.
+ */
+template <typename T>
+struct LibraryHandle {
+  int16_t slot = IdIndex::kNoSlot;
+  uint16_t generation = 0;
+  //! the ID of the entry, which allows to look up the entry again if the handle is stale
+  uint8_t id = 0;
+
+  bool IsNull() const { return slot == IdIndex::kNoSlot; }
+  bool operator==(const LibraryHandle &other) const {
+    return slot == other.slot && generation == other.generation;
+  }
+  bool operator!=(const LibraryHandle &other) const { return !(*this == other); }
+};
+
+}  // namespace sensint
+
+#endif  // __SENSINT_ID_INDEX_H__
@@ -0,0 +1,57 @@
+#include "library_buffer.h"
+
+namespace sensint {
+
+LibraryBuffer::LibraryBuffer() {}
+
+LibraryBuffer::~LibraryBuffer() {}
+
+const MaterialLib &LibraryBuffer::GetMaterialLib() const { return material_libs_[active_]; }
+
+const SequenceLib &LibraryBuffer::GetSequenceLib() const { return sequence_libs_[active_]; }
+
+MaterialLib &LibraryBuffer::GetShadowMaterialLib() { return material_libs_[active_ ^ 1]; }
+
+SequenceLib &LibraryBuffer::GetShadowSequenceLib() { return sequence_libs_[active_ ^ 1]; }
+
+void LibraryBuffer::MarkEdited() { has_edits_ = true; }
+
+void LibraryBuffer::BeginUpdate() { is_update_open_ = true; }
+
+void LibraryBuffer::EndUpdate() { is_update_open_ = false; }
+
+void LibraryBuffer::AbortUpdate() {
+  is_update_open_ = false;
+  Revert();
+}
+
+bool LibraryBuffer::IsUpdateOpen() const { return is_update_open_; }
+
+void LibraryBuffer::KeepAlive(const uint32_t now_ms) { last_message_ms_ = now_ms; }
+
+bool LibraryBuffer::CheckUpdateTimeout(const uint32_t now_ms) {
+  // the difference is wrap-around safe
+  if (!is_update_open_ || now_ms - last_message_ms_ < kUpdateTimeout) {
+    return false;
+  }
+  AbortUpdate();
+  return true;
+}
+
+bool LibraryBuffer::Commit() {
+  if (!has_edits_ || is_update_open_) {
+    return false;
+  }
+  active_ ^= 1;
+  // the next edits start from the committed libraries
+  Revert();
+  return true;
+}
+
+void LibraryBuffer::Revert() {
+  material_libs_[active_ ^ 1] = material_libs_[active_];
+  sequence_libs_[active_ ^ 1] = sequence_libs_[active_];
+  has_edits_ = false;
+}
+
+}  // namespace sensint
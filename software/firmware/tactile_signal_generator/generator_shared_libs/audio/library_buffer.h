@@ -0,0 +1,118 @@
+#ifndef __SENSINT_LIBRARY_BUFFER_H__
+#define __SENSINT_LIBRARY_BUFFER_H__
+
+#include <cstdint>
+
+#include "material_lib.h"
+#include "sequence_lib.h"
+
+namespace sensint {
+
+/**
+ * @brief Double buffer of the material and the sequence library. The augmentation only reads the
+ * active libraries, while all edits are applied to the shadow libraries. A commit swaps the
+ * active and the shadow libraries at a safe point between two iterations of the loop.
+ *
+ * //! Edits between BeginUpdate and EndUpdate are committed together, i.e. the augmentation never
+ * //! plays a partially uploaded library. Edits outside of an update are committed with the next
+ * //! commit.
+ */
+class LibraryBuffer final {
+ public:
+  //! an open update is discarded if the controller stops sending messages before it commits the
+  //! update, e.g. because it was reset during an upload
+  static constexpr uint32_t kUpdateTimeout = 5000;  // [ms]
+
+  LibraryBuffer();
+  ~LibraryBuffer();
+
+  /**
+   * @brief Get the active material library, which is played by the augmentation.
+   */
+  const MaterialLib &GetMaterialLib() const;
+
+  /**
+   * @brief Get the active sequence library, which is played by the augmentation.
+   */
+  const SequenceLib &GetSequenceLib() const;
+
+  /**
+   * @brief Get the shadow material library to edit it. The edits become active with the next
+   * commit after they are marked (see MarkEdited).
+   */
+  MaterialLib &GetShadowMaterialLib();
+
+  /**
+   * @brief Get the shadow sequence library to edit it. The edits become active with the next
+   * commit after they are marked (see MarkEdited).
+   */
+  SequenceLib &GetShadowSequenceLib();
+
+  /**
+   * @brief Mark the shadow libraries as edited, i.e. they are swapped with the next commit. This
+   * is called after an edit succeeded, hence a rejected edit does not cause a commit.
+   */
+  void MarkEdited();
+
+  /**
+   * @brief Start an update, i.e. the edits are not committed until the update is ended.
+   */
+  void BeginUpdate();
+
+  /**
+   * @brief End an update, i.e. its edits are committed with the next commit.
+   */
+  void EndUpdate();
+
+  /**
+   * @brief End an update and discard all edits of the shadow libraries (see Revert), e.g. if the
+   * controller aborts an upload or the update is not committed in time.
+   */
+  void AbortUpdate();
+
+  bool IsUpdateOpen() const;
+
+  /**
+   * @brief Note that a message of the controller was received, i.e. an open update is kept alive.
+   *
+   * @param now_ms the current time in milliseconds
+   */
+  void KeepAlive(const uint32_t now_ms);
+
+  /**
+   * @brief Abort an open update if no message was received for kUpdateTimeout (see KeepAlive).
+   *
+   * @param now_ms the current time in milliseconds
+   * @return true the update was aborted
+   * @return false there is no open update or it is still alive
+   */
+  bool CheckUpdateTimeout(const uint32_t now_ms);
+
+  /**
+   * @brief Swap the active and the shadow libraries if there are edits and no update is open.
+   * Afterwards the shadow libraries are a copy of the active ones again. All pointers into the
+   * previously active libraries (i.e. resolved handles) have to be renewed.
+   *
+   * @return true the libraries were swapped
+   * @return false there was nothing to commit
+   */
+  bool Commit();
+
+  /**
+   * @brief Discard all edits of the shadow libraries, i.e. they are a copy of the active ones
+   * again.
+   */
+  void Revert();
+
+ private:
+  MaterialLib material_libs_[2];
+  SequenceLib sequence_libs_[2];
+  uint8_t active_ = 0;
+  bool is_update_open_ = false;
+  uint32_t last_message_ms_ = 0;
+  bool has_edits_ = false;
+};
+
+}  // namespace sensint
+
+#endif  // __SENSINT_LIBRARY_BUFFER_H__
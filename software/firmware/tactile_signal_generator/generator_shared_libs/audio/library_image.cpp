@@ -0,0 +1,329 @@
+#include "library_image.h"
+
+#include <debug.h>
+#include <tactile_audio.h>
+#include <types.h>
+
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+namespace sensint {
+namespace library_image {
+
+static_assert(kMaterialNumFields == 14, "update the material record and the version of the image");
+static_assert(sizeof(ImageHeader) == 32, "the header has to be packed");
+
+namespace {
+
+template <typename T>
+void Append(const T &value, std::vector<uint8_t> &dest) {
+  const auto *bytes = reinterpret_cast<const uint8_t *>(&value);
+  dest.insert(dest.end(), bytes, bytes + sizeof(T));
+}
+
+template <typename T>
+bool Take(const uint8_t *&cursor, const uint8_t *end, T &value) {
+  if (static_cast<size_t>(end - cursor) < sizeof(T)) {
+    return false;
+  }
+  memcpy(&value, cursor, sizeof(T));
+  cursor += sizeof(T);
+  return true;
+}
+
+void AppendMaterial(const Material &material, std::vector<uint8_t> &dest) {
+  const auto &params = material.grain_params;
+  Append(material.id, dest);
+  Append(static_cast<uint8_t>(params.raw_signal_params.waveform), dest);
+  Append(params.raw_signal_params.frequency, dest);
+  Append(params.raw_signal_params.amplitude, dest);
+  Append(params.envelope_params.attack, dest);
+  Append(params.envelope_params.decay, dest);
+  Append(params.envelope_params.sustain, dest);
+  Append(params.envelope_params.release, dest);
+  Append(params.filter_params.highCutFrequency, dest);
+  Append(params.filter_params.highCutResonance, dest);
+  Append(params.filter_params.lowCutFrequency, dest);
+  Append(params.filter_params.lowCutResonance, dest);
+  Append(params.duration, dest);
+  Append(static_cast<uint8_t>(params.is_continuous), dest);
+}
+
+bool TakeMaterial(const uint8_t *&cursor, const uint8_t *end, Material &material) {
+  auto &params = material.grain_params;
+  uint8_t waveform = 0;
+  uint8_t is_continuous = 0;
+  const auto is_complete = Take(cursor, end, material.id) && Take(cursor, end, waveform) &&
+                           Take(cursor, end, params.raw_signal_params.frequency) &&
+                           Take(cursor, end, params.raw_signal_params.amplitude) &&
+                           Take(cursor, end, params.envelope_params.attack) &&
+                           Take(cursor, end, params.envelope_params.decay) &&
+                           Take(cursor, end, params.envelope_params.sustain) &&
+                           Take(cursor, end, params.envelope_params.release) &&
+                           Take(cursor, end, params.filter_params.highCutFrequency) &&
+                           Take(cursor, end, params.filter_params.highCutResonance) &&
+                           Take(cursor, end, params.filter_params.lowCutFrequency) &&
+                           Take(cursor, end, params.filter_params.lowCutResonance) &&
+                           Take(cursor, end, params.duration) && Take(cursor, end, is_continuous);
+  params.raw_signal_params.waveform = static_cast<Waveform>(waveform);
+  params.is_continuous = is_continuous != 0;
+  return is_complete;
+}
+
+void AppendSequence(const GrainSequenceView &sequence, std::vector<uint8_t> &dest) {
+  Append(sequence.id, dest);
+  Append(sequence.size, dest);
+  for (size_t i = 0; i < sequence.size; i++) {
+    Append(sequence.material_id[i], dest);
+    Append(sequence.pos_start[i], dest);
+    Append(sequence.pos_end[i], dest);
+  }
+}
+
+bool TakeSequence(const uint8_t *&cursor, const uint8_t *end, GrainSequence &sequence) {
+  uint16_t num_grains = 0;
+  if (!Take(cursor, end, sequence.id) || !Take(cursor, end, num_grains)) {
+    return false;
+  }
+  sequence.grains.resize(num_grains);
+  for (auto &grain : sequence.grains) {
+    if (!Take(cursor, end, grain.material_id) || !Take(cursor, end, grain.pos_start) ||
+        !Take(cursor, end, grain.pos_end)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief Replace the shadow libraries with the content of the payload.
+ */
+bool ApplyPayload(const ImageHeader &header, const std::vector<uint8_t> &payload,
+                  LibraryBuffer &libraries) {
+  const uint8_t *cursor = payload.data();
+  const uint8_t *end = cursor + payload.size();
+  std::vector<Material> materials(header.num_materials);
+  for (auto &material : materials) {
+    if (!TakeMaterial(cursor, end, material)) {
+      return false;
+    }
+  }
+  std::vector<GrainSequence> sequences(header.num_sequences);
+  for (auto &sequence : sequences) {
+    if (!TakeSequence(cursor, end, sequence)) {
+      return false;
+    }
+  }
+  if (cursor != end) {
+    return false;
+  }
+  // the default entries exist in a reset library, hence they are updated or deleted instead of
+  // added
+  auto &material_lib = libraries.GetShadowMaterialLib();
+  material_lib.Reset();
+  for (auto material = materials.begin(); material != materials.end();) {
+    if (material->id == kDefaultMaterialID) {
+      material_lib.UpdateMaterial(*material);
+      material = materials.erase(material);
+    } else {
+      ++material;
+    }
+  }
+  auto &sequence_lib = libraries.GetShadowSequenceLib();
+  sequence_lib.Reset();
+  for (auto sequence = sequences.begin(); sequence != sequences.end();) {
+    if (sequence->id == kDefaultGrainSequenceID) {
+      if (!sequence_lib.UpdateSequence(*sequence)) {
+        return false;
+      }
+      sequence = sequences.erase(sequence);
+    } else {
+      ++sequence;
+    }
+  }
+  if (((header.flags & kDefaultMaterialDeleted) &&
+       !material_lib.DeleteMaterial(kDefaultMaterialID)) ||
+      ((header.flags & kDefaultSequenceDeleted) &&
+       !sequence_lib.DeleteSequence(kDefaultGrainSequenceID))) {
+    return false;
+  }
+  return material_lib.AddMaterials(materials) && sequence_lib.AddSequences(sequences);
+}
+
+size_t GetSlotSize(const LibraryStorage &storage) { return storage.Capacity() / kNumSlots; }
+
+uint32_t GetHeaderCrc(const ImageHeader &header) {
+  return Crc32(reinterpret_cast<const uint8_t *>(&header), offsetof(ImageHeader, header_crc));
+}
+
+bool IsNewer(const ImageHeader &header, const ImageHeader &other) {
+  return static_cast<int32_t>(header.generation - other.generation) > 0;
+}
+
+/**
+ * @brief Read the image of a slot.
+ *
+ * @return true if the header and the payload of the slot are intact and of the current version
+ */
+bool ReadSlot(const LibraryStorage &storage, const size_t slot, ImageHeader &header,
+              std::vector<uint8_t> &payload) {
+  const auto slot_size = GetSlotSize(storage);
+  const auto address = slot * slot_size;
+  if (slot_size < sizeof(header) ||
+      !storage.Read(address, reinterpret_cast<uint8_t *>(&header), sizeof(header)) ||
+      header.magic != kMagic || header.version != kVersion ||
+      header.header_crc != GetHeaderCrc(header) ||
+      header.payload_size > slot_size - sizeof(header)) {
+    return false;
+  }
+  payload.resize(header.payload_size);
+  if (!storage.Read(address + sizeof(header), payload.data(), payload.size()) ||
+      Crc32(payload.data(), payload.size()) != header.payload_crc) {
+#ifdef SENSINT_DEBUG
+    debug::Log("LibraryImage", "the image in slot " + String((uint32_t)slot) + " is corrupted");
+#endif  // SENSINT_DEBUG
+    return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+uint32_t Crc32(const uint8_t *data, const size_t size, const uint32_t crc) {
+  auto value = ~crc;
+  for (size_t i = 0; i < size; i++) {
+    value ^= data[i];
+    for (uint8_t bit = 0; bit < 8; bit++) {
+      value = (value >> 1) ^ (0xEDB88320 & (0 - (value & 1)));
+    }
+  }
+  return ~value;
+}
+
+uint32_t GetPresetsCrc(const std::vector<std::string> &materials,
+                       const std::vector<std::string> &sequences) {
+  uint32_t crc = 0;
+  for (const auto &presets : {&materials, &sequences}) {
+    for (const auto &preset : *presets) {
+      crc = Crc32(reinterpret_cast<const uint8_t *>(preset.data()), preset.size(), crc);
+    }
+  }
+  return crc;
+}
+
+bool Save(const LibraryBuffer &libraries, const uint32_t presets_crc, LibraryStorage &storage) {
+#ifdef SENSINT_DEBUG
+  elapsedMicros save_time = 0;
+#endif  // SENSINT_DEBUG
+  const auto &material_lib = libraries.GetMaterialLib();
+  const auto &sequence_lib = libraries.GetSequenceLib();
+  ImageHeader header;
+  header.presets_crc = presets_crc;
+  std::vector<uint8_t> payload;
+  // the IDs are stored in ascending order, i.e. in the same order as they are printed
+  for (size_t id = 0; id < IdIndex::kNumIds; id++) {
+    Material material;
+    if (material_lib.GetMaterialByID(id, material)) {
+      AppendMaterial(material, payload);
+      header.num_materials++;
+    }
+  }
+  const auto &default_sequence = sequence_lib.GetDefaultSequence();
+  for (size_t id = 0; id < IdIndex::kNumIds; id++) {
+    const auto *sequence = sequence_lib.GetSequence(sequence_lib.GetSequenceHandle(id));
+    if (!sequence_lib.SequenceExists(id) || sequence == nullptr ||
+        sequence->pos_start == default_sequence.pos_start) {
+      continue;
+    }
+    AppendSequence(*sequence, payload);
+    header.num_sequences++;
+  }
+  if (!material_lib.MaterialExists(kDefaultMaterialID)) {
+    header.flags |= kDefaultMaterialDeleted;
+  }
+  if (!sequence_lib.SequenceExists(kDefaultGrainSequenceID)) {
+    header.flags |= kDefaultSequenceDeleted;
+  }
+  header.payload_size = static_cast<uint32_t>(payload.size());
+  header.payload_crc = Crc32(payload.data(), payload.size());
+  const auto slot_size = GetSlotSize(storage);
+  if (sizeof(header) + payload.size() > slot_size) {
+#ifdef SENSINT_DEBUG
+    debug::Log("LibraryImage", "the library (" + String((uint32_t)payload.size()) +
+                                   " bytes) exceeds the storage");
+#endif  // SENSINT_DEBUG
+    return false;
+  }
+  // the image is written to the slot of the older (or an invalid) image
+  size_t slot = 0;
+  bool has_newest = false;
+  ImageHeader newest;
+  for (size_t idx = 0; idx < kNumSlots; idx++) {
+    ImageHeader slot_header;
+    std::vector<uint8_t> slot_payload;
+    if (ReadSlot(storage, idx, slot_header, slot_payload) &&
+        (!has_newest || IsNewer(slot_header, newest))) {
+      newest = slot_header;
+      has_newest = true;
+      slot = (idx + 1) % kNumSlots;
+    }
+  }
+  if (has_newest && newest.flags == header.flags && newest.presets_crc == header.presets_crc &&
+      newest.payload_size == header.payload_size && newest.payload_crc == header.payload_crc) {
+    // the newest image is up to date, i.e. nothing is written
+    return true;
+  }
+  header.generation = has_newest ? newest.generation + 1 : 0;
+  header.header_crc = GetHeaderCrc(header);
+  //! the header is written last, i.e. an interrupted save leaves a slot with an invalid CRC and
+  //! the previous image in the other slot is loaded
+  if (!storage.Write((slot * slot_size) + sizeof(header), payload.data(), payload.size()) ||
+      !storage.Write(slot * slot_size, reinterpret_cast<const uint8_t *>(&header),
+                     sizeof(header))) {
+#ifdef SENSINT_DEBUG
+    debug::Log("LibraryImage", "writing slot " + String((uint32_t)slot) + " failed");
+#endif  // SENSINT_DEBUG
+    return false;
+  }
+#ifdef SENSINT_DEBUG
+  debug::Log("LibraryImage", "saved " + String((uint32_t)(sizeof(header) + payload.size())) +
+                                 " bytes to slot " + String((uint32_t)slot) + " in " +
+                                 String((uint32_t)save_time) + " us");
+#endif  // SENSINT_DEBUG
+  return true;
+}
+
+bool Load(const LibraryStorage &storage, const uint32_t presets_crc, LibraryBuffer &libraries) {
+  bool has_image = false;
+  ImageHeader header;
+  std::vector<uint8_t> payload;
+  for (size_t slot = 0; slot < kNumSlots; slot++) {
+    ImageHeader slot_header;
+    std::vector<uint8_t> slot_payload;
+    if (ReadSlot(storage, slot, slot_header, slot_payload) &&
+        slot_header.presets_crc == presets_crc && (!has_image || IsNewer(slot_header, header))) {
+      header = slot_header;
+      payload.swap(slot_payload);
+      has_image = true;
+    }
+  }
+  if (!has_image) {
+#ifdef SENSINT_DEBUG
+    debug::Log("LibraryImage", "no image of the current presets");
+#endif  // SENSINT_DEBUG
+    return false;
+  }
+  if (!ApplyPayload(header, payload, libraries)) {
+#ifdef SENSINT_DEBUG
+    debug::Log("LibraryImage", "the image does not match the libraries");
+#endif  // SENSINT_DEBUG
+    libraries.Revert();
+    return false;
+  }
+  libraries.MarkEdited();
+  return true;
+}
+
+}  // namespace library_image
+}  // namespace sensint
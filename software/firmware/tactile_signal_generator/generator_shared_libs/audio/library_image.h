@@ -0,0 +1,106 @@
+#ifndef __SENSINT_LIBRARY_IMAGE_H__
+#define __SENSINT_LIBRARY_IMAGE_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "library_buffer.h"
+#include "library_storage.h"
+
+namespace sensint {
+namespace library_image {
+
+/**
+ * @brief A binary image of the material and the sequence library, which is kept in non-volatile
+ * storage to restore the libraries at boot without parsing the presets or uploading the libraries
+ * again.
+ *
+ * //! The storage is split into two slots, which are written alternately. A save never overwrites
+ * //! the newest image, i.e. an interrupted save (e.g. a power loss) leaves the previous image
+ * //! intact. A slot starts with the header, followed by the payload:
+ * //!   materials: id, waveform, frequency, amplitude, attack, decay, sustain, release,
+ * //!              highCutFrequency, highCutResonance, lowCutFrequency, lowCutResonance,
+ * //!              duration, is_continuous
+ * //!   sequences: id, num_grains, (material_id, pos_start, pos_end) for each grain
+ * //! All values are stored in the byte order of the controller. The default sequence is not
+ * //! stored unless it was replaced. A deleted default material or sequence is stored as a flag.
+ */
+
+//! "SLIB"
+constexpr uint32_t kMagic = 0x42494C53;
+//! Increment the version if the layout of the image changes.
+constexpr uint16_t kVersion = 2;
+constexpr size_t kNumSlots = 2;
+
+//! flags of the image
+constexpr uint16_t kDefaultMaterialDeleted = 1 << 0;
+constexpr uint16_t kDefaultSequenceDeleted = 1 << 1;
+
+struct ImageHeader {
+  uint32_t magic = kMagic;
+  uint16_t version = kVersion;
+  uint16_t flags = 0;
+  uint16_t num_materials = 0;
+  uint16_t num_sequences = 0;
+  /**
+   * @brief The number of the save, i.e. the slot with the higher generation holds the newer
+   * image.
+   */
+  uint32_t generation = 0;
+  /**
+   * @brief The CRC of the presets of the firmware which saved the image. The image is discarded
+   * if the presets change, i.e. after the firmware is updated.
+   */
+  uint32_t presets_crc = 0;
+  uint32_t payload_size = 0;
+  uint32_t payload_crc = 0;
+  //! the CRC of all previous fields of the header
+  uint32_t header_crc = 0;
+};
+
+/**
+ * @brief Compute the CRC-32 (IEEE 802.3) of a block of bytes. The CRC of consecutive blocks is
+ * computed by passing the CRC of the previous block.
+ *
+ * @param data the bytes
+ * @param size number of bytes
+ * @param crc the CRC of the previous blocks
+ */
+uint32_t Crc32(const uint8_t *data, const size_t size, const uint32_t crc = 0);
+
+/**
+ * @brief Compute the CRC of the preset messages of the firmware (see local_settings.h), which
+ * identifies the presets an image was derived from.
+ */
+uint32_t GetPresetsCrc(const std::vector<std::string> &materials,
+                       const std::vector<std::string> &sequences);
+
+/**
+ * @brief Save the active libraries as an image to the slot of the storage which does not hold
+ * the newest image. A write to the EEPROM blocks for a few milliseconds, hence this should not be
+ * called while the augmentation is running.
+ *
+ * @param libraries the libraries to save
+ * @param presets_crc the CRC of the presets of the firmware
+ * @param storage
+ * @return false if the image exceeds the capacity of a slot or a write failed
+ */
+bool Save(const LibraryBuffer &libraries, const uint32_t presets_crc, LibraryStorage &storage);
+
+/**
+ * @brief Load the newest valid image from the storage into the shadow libraries, i.e. the caller
+ * has to commit the libraries. The shadow libraries remain as is if there is no valid image.
+ *
+ * @param storage
+ * @param presets_crc the CRC of the presets of the firmware
+ * @param libraries the libraries to load into
+ * @return true if the storage contains a valid image of the same presets
+ */
+bool Load(const LibraryStorage &storage, const uint32_t presets_crc, LibraryBuffer &libraries);
+
+}  // namespace library_image
+}  // namespace sensint
+
+#endif  // __SENSINT_LIBRARY_IMAGE_H__
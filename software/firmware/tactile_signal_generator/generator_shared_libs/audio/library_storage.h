@@ -0,0 +1,66 @@
+#ifndef __SENSINT_LIBRARY_STORAGE_H__
+#define __SENSINT_LIBRARY_STORAGE_H__
+
+#ifdef ARDUINO
+#include <EEPROM.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace sensint {
+
+/**
+ * @brief Non-volatile storage of the library image (see library_image.h), which is the EEPROM of
+ * the Teensy (4 KB on the Teensy 3.5 and 4.1, 1 KB on the Teensy 4.0).
+ *
+ * //! Only the bytes that differ from the stored ones are written (see EEPROM.update), hence
+ * //! saving an unchanged image does not wear the EEPROM.
+ */
+class LibraryStorage final {
+ public:
+  size_t Capacity() const { return EEPROM.length(); }
+
+  /**
+   * @brief Read bytes from the storage.
+   *
+   * @param address of the first byte
+   * @param data destination of the bytes
+   * @param size number of bytes
+   * @return false if the range exceeds the capacity
+   */
+  bool Read(const size_t address, uint8_t *data, const size_t size) const {
+    if (address > Capacity() || size > Capacity() - address) {
+      return false;
+    }
+    for (size_t i = 0; i < size; i++) {
+      data[i] = EEPROM.read(static_cast<int>(address + i));
+    }
+    return true;
+  }
+
+  /**
+   * @brief Write bytes to the storage.
+   *
+   * @param address of the first byte
+   * @param data the bytes to write
+   * @param size number of bytes
+   * @return false if the range exceeds the capacity
+   */
+  bool Write(const size_t address, const uint8_t *data, const size_t size) {
+    if (address > Capacity() || size > Capacity() - address) {
+      return false;
+    }
+    for (size_t i = 0; i < size; i++) {
+      EEPROM.update(static_cast<int>(address + i), data[i]);
+    }
+    return true;
+  }
+};
+
+}  // namespace sensint
+
+#else
+#include "host_storage.h"
+#endif  // ARDUINO
+
+#endif  // __SENSINT_LIBRARY_STORAGE_H__
@@ -17,89 +17,133 @@ MaterialLib::MaterialLib() {
   default_material_.grain_params.envelope_params.sustain = 1.f;
   default_material_.grain_params.envelope_params.release = 0.f;
 
-  materials_.push_back(default_material_);
+  AddMaterial(default_material_);
 }
 
 MaterialLib::~MaterialLib() {}
 
 bool MaterialLib::AddMaterial(const sensint::Material &material) {
-  for (size_t i = 0; i < materials_.size(); i++) {
-    if (materials_[i].id == material.id) {
-      return false;
-    }
-    if (materials_[i].id > material.id) {
-      materials_.insert(materials_.begin() + i, material);
-      return true;
-    }
-    if (i == materials_.size() - 1) {
-      materials_.push_back(material);
-      return true;
-    }
+  const auto slot = index_.Insert(material.id, materials_.size());
+  if (slot == IdIndex::kNoSlot) {
+    return false;
+  }
+  if (static_cast<size_t>(slot) == materials_.size()) {
+    materials_.push_back(material);
+  } else {
+    materials_[slot] = material;
   }
-  return false;
+  return true;
 }
 
 bool MaterialLib::UpdateMaterial(const sensint::Material &material) {
-  for (size_t i = 0; i < materials_.size(); i++) {
-    if (materials_[i].id == material.id) {
-      materials_[i] = material;
-      return true;
-    }
+  const auto slot = index_.GetSlot(material.id);
+  if (slot == IdIndex::kNoSlot) {
+    return false;
   }
-  return false;
+  materials_[slot] = material;
+  return true;
 }
 
 bool MaterialLib::DeleteMaterial(const uint8_t id) {
-  for (size_t i = 0; i < materials_.size(); i++) {
-    if (materials_[i].id == id) {
-      materials_.erase(materials_.begin() + i);
-      return true;
+  //! the data of the slot remains until the slot is reused
+  return index_.Erase(id) != IdIndex::kNoSlot;
+}
+
+bool MaterialLib::AddMaterials(const std::vector<sensint::Material> &materials) {
+  bool is_in_list[IdIndex::kNumIds] = {};
+  for (const auto &material : materials) {
+    if (index_.Contains(material.id) || is_in_list[material.id]) {
+      return false;
     }
+    is_in_list[material.id] = true;
   }
-  return false;
+  // the library grows at most once for the entire list
+  materials_.reserve(materials_.size() + materials.size());
+  for (const auto &material : materials) {
+    AddMaterial(material);
+  }
+  return true;
 }
 
-bool MaterialLib::MaterialExists(const uint8_t id) const {
-  for (const auto &mat : materials_) {
-    if (mat.id == id) {
-      return true;
+bool MaterialLib::UpdateMaterials(const std::vector<sensint::Material> &materials) {
+  bool is_in_list[IdIndex::kNumIds] = {};
+  for (const auto &material : materials) {
+    if (!index_.Contains(material.id) || is_in_list[material.id]) {
+      return false;
     }
+    is_in_list[material.id] = true;
+  }
+  for (const auto &material : materials) {
+    materials_[index_.GetSlot(material.id)] = material;
   }
-  return false;
+  return true;
 }
 
-int MaterialLib::GetMaterialIndexByID(const uint8_t id) const {
-  for (size_t idx = 0; idx < materials_.size(); idx++) {
-    if (id == materials_[idx].id) {
-      return idx;
+bool MaterialLib::DeleteMaterials(const std::vector<uint8_t> &ids) {
+  bool is_in_list[IdIndex::kNumIds] = {};
+  for (const auto id : ids) {
+    if (!index_.Contains(id) || is_in_list[id]) {
+      return false;
     }
+    is_in_list[id] = true;
+  }
+  for (const auto id : ids) {
+    index_.Erase(id);
   }
-  return -1;
+  return true;
 }
 
+bool MaterialLib::MaterialExists(const uint8_t id) const { return index_.Contains(id); }
+
+int MaterialLib::GetMaterialIndexByID(const uint8_t id) const { return index_.GetSlot(id); }
+
 bool MaterialLib::GetMaterialByID(const uint8_t id, sensint::Material &destination) const {
-  for (size_t idx = 0; idx < materials_.size(); idx++) {
-    if (id == materials_[idx].id) {
-      destination = materials_[idx];
-      return true;
-    }
+  const auto slot = index_.GetSlot(id);
+  if (slot == IdIndex::kNoSlot) {
+    return false;
+  }
+  destination = materials_[slot];
+  return true;
+}
+
+MaterialHandle MaterialLib::GetMaterialHandle(const uint8_t id) const {
+  MaterialHandle handle;
+  handle.id = id;
+  const auto slot = index_.GetSlot(id);
+  if (slot != IdIndex::kNoSlot) {
+    handle.slot = static_cast<int16_t>(slot);
+    handle.generation = index_.GetGeneration(slot);
+  }
+  return handle;
+}
+
+const sensint::Material *MaterialLib::GetMaterial(const MaterialHandle &handle) const {
+  if (handle.IsNull()) {
+    return &default_material_;
+  }
+  if (!index_.IsCurrent(handle.slot, handle.generation)) {
+    return nullptr;
   }
-  return false;
+  return &materials_[handle.slot];
 }
 
 const sensint::Material &MaterialLib::GetDefaultMaterial() const { return default_material_; }
 
 void MaterialLib::Reset() {
   materials_.clear();
-  materials_.push_back(default_material_);
+  index_.Clear();
+  AddMaterial(default_material_);
 }
 
 #ifdef SENSINT_DEBUG
 void MaterialLib::PrintLib() const {
   if (debug::kDebugLevel == debug::DebugLevel::verbose) {
     Serial.println("\n======== Material Lib ========");
-    for (const auto &material : materials_) {
-      PrintMaterial(material);
+    // deleted materials remain in their slots, hence the materials are printed by ID
+    for (size_t id = 0; id < IdIndex::kNumIds; id++) {
+      if (index_.Contains(id)) {
+        PrintMaterial(materials_[index_.GetSlot(id)]);
+      }
     }
   }
 }
@@ -6,16 +6,21 @@
 #include <string>
 #include <vector>
 
+#include "id_index.h"
+
 namespace sensint {
 
+using MaterialHandle = LibraryHandle<sensint::Material>;
+
 class MaterialLib final {
  public:
   MaterialLib();
   ~MaterialLib();
 
   /**
-   * @brief Add a material to the library. Materials are ordered by their IDs.
-   * If a material with the same ID exists already the library remains as is.
+   * @brief Add a material to the library. The material is stored in a free slot
+   * or appended, hence no other material is moved. If a material with the same ID
+   * exists already the library remains as is.
    *
    * @param material the material object to add
    * @return true material was added
@@ -42,6 +47,37 @@ class MaterialLib final {
    */
   bool DeleteMaterial(const uint8_t id);
 
+  /**
+   * @brief Add a list of materials to the library. The list is validated first,
+   * i.e. either all materials are added or none (e.g. if an ID exists already or
+   * appears twice in the list).
+   *
+   * @param materials the materials to add
+   * @return true all materials were added
+   * @return false no material was added
+   */
+  bool AddMaterials(const std::vector<sensint::Material> &materials);
+
+  /**
+   * @brief Update a list of existing materials. Either all materials are updated
+   * or none.
+   *
+   * @param materials the materials to update
+   * @return true all materials were updated
+   * @return false no material was updated
+   */
+  bool UpdateMaterials(const std::vector<sensint::Material> &materials);
+
+  /**
+   * @brief Delete a list of materials from the library. Either all materials are
+   * deleted or none.
+   *
+   * @param ids of the materials to delete
+   * @return true all materials were deleted
+   * @return false no material was deleted
+   */
+  bool DeleteMaterials(const std::vector<uint8_t> &ids);
+
   /**
    * @brief Check if a material with a given ID exists in the library.
    *
@@ -52,11 +88,10 @@ class MaterialLib final {
   bool MaterialExists(const uint8_t id) const;
 
   /**
-   * @brief Find a material in a vector based on its unique identifier
+   * @brief Find a material based on its unique identifier in constant time.
    *
-   * @param materials vector of materials
-   * @param material_id unique identifier
-   * @return int the index of the vector where the material is placed. Returns
+   * @param id unique identifier
+   * @return int the slot of the library where the material is placed. Returns
    * -1 if the material does not exist.
    */
   int GetMaterialIndexByID(const uint8_t id) const;
@@ -71,6 +106,25 @@ class MaterialLib final {
    */
   bool GetMaterialByID(uint8_t id, sensint::Material &destination) const;
 
+  /**
+   * @brief Get a handle of a material. The handle stays valid until the
+   * material is deleted, updates of the material are visible through it.
+   *
+   * @param id
+   * @return the handle or a null handle if the material does not exist
+   */
+  MaterialHandle GetMaterialHandle(const uint8_t id) const;
+
+  /**
+   * @brief Get the material of a handle without copying it. The pointer is valid
+   * until the library is modified.
+   *
+   * @param handle
+   * @return the material, the default material for a null handle, or nullptr if the
+   * handle is stale
+   */
+  const sensint::Material *GetMaterial(const MaterialHandle &handle) const;
+
   /**
    * @brief Get a material by its ID.
    * @return the default material
@@ -95,6 +149,8 @@ class MaterialLib final {
   sensint::Material default_material_;
   // the library data
   std::vector<sensint::Material> materials_;
+  // the slots of the library data by ID
+  IdIndex index_;
 };
 
 }  // namespace sensint
@@ -3,6 +3,8 @@
 #include <debug.h>
 #include <tactile_audio.h>
 
+#include <algorithm>
+
 namespace sensint {
 
 SequenceLib::SequenceLib() {
@@ -12,95 +14,389 @@ SequenceLib::SequenceLib() {
   auto sensor_range = sensor_lim_u - sensor_lim_l;
   auto sensor_steps = (analog_sensor_t)(sensor_range / num_grains);
   auto half_step = (analog_sensor_t)(sensor_steps >> 1);
+  std::vector<Grain> grains;
   for (auto idx = 0; idx < num_grains; idx++) {
     auto pos_start = static_cast<analog_sensor_t>((idx * sensor_steps) + sensor_lim_l + half_step);
     auto pos_end = pos_start;
     Grain grain{0x00, pos_start, pos_end};
-    default_sequence_.grains.push_back(grain);
+    grains.push_back(grain);
   }
-  sequences_.push_back(default_sequence_);
+  const auto offset = arena_.Append(grains);
+  default_sequence_ =
+      arena_.GetView(kDefaultGrainSequenceID, offset, static_cast<uint16_t>(grains.size()));
+  Reset();
 }
 
 SequenceLib::~SequenceLib() {}
 
+SequenceLib::SequenceLib(const SequenceLib &other) { *this = other; }
+
+SequenceLib &SequenceLib::operator=(const SequenceLib &other) {
+  if (this == &other) {
+    return *this;
+  }
+  arena_ = other.arena_;
+  index_ = other.index_;
+  num_slots_ = other.num_slots_;
+  const auto &view = other.default_sequence_;
+  default_sequence_ = arena_.GetView(view.id, view.offset, view.size);
+  for (size_t slot = 0; slot < num_slots_; slot++) {
+    const auto &view = other.sequences_[slot];
+    sequences_[slot] = arena_.GetView(view.id, view.offset, view.size);
+  }
+  return *this;
+}
+
 bool SequenceLib::AddSequence(const sensint::GrainSequence &sequence) {
-  for (size_t i = 0; i < sequences_.size(); i++) {
-    if (sequences_[i].id == sequence.id) {
+  if (index_.Contains(sequence.id) || sequence.grains.empty() || !IsOrdered(sequence)) {
+    return false;
+  }
+  if (!HasCapacity(sequence.grains.size(), 0)) {
+    return false;
+  }
+  const auto slot = index_.Insert(sequence.id, num_slots_);
+  if (static_cast<size_t>(slot) == num_slots_) {
+    num_slots_++;
+  }
+  AppendGrains(slot, sequence);
+#ifdef SENSINT_DEBUG
+  LogUsage();
+#endif  // SENSINT_DEBUG
+  return true;
+}
+
+bool SequenceLib::UpdateSequence(const sensint::GrainSequence &sequence) {
+  const auto slot = index_.GetSlot(sequence.id);
+  if (slot == IdIndex::kNoSlot || sequence.grains.empty() || !IsOrdered(sequence)) {
+    return false;
+  }
+  if (!HasCapacity(sequence.grains.size(), GetNumOwnGrains(slot))) {
+    return false;
+  }
+  // the grains are replaced in place, i.e. only the grains of the following sequences are shifted
+  if (GetNumOwnGrains(slot) > 0) {
+    SpliceGrains(slot, 0, sequences_[slot].size, sequence.grains);
+  } else {
+    AppendGrains(slot, sequence);
+  }
+  index_.Invalidate(sequence.id);
+#ifdef SENSINT_DEBUG
+  LogUsage();
+#endif  // SENSINT_DEBUG
+  return true;
+}
+
+bool SequenceLib::DeleteSequence(const uint8_t id) {
+  const auto slot = index_.GetSlot(id);
+  if (slot == IdIndex::kNoSlot) {
+    return false;
+  }
+  if (GetNumOwnGrains(slot) > 0) {
+    SpliceGrains(slot, 0, sequences_[slot].size, {});
+  }
+  index_.Erase(id);
+#ifdef SENSINT_DEBUG
+  LogUsage();
+#endif  // SENSINT_DEBUG
+  return true;
+}
+
+bool SequenceLib::AddSequences(const std::vector<sensint::GrainSequence> &sequences) {
+  bool is_in_list[IdIndex::kNumIds] = {};
+  size_t num_new_grains = 0;
+  for (const auto &sequence : sequences) {
+    if (index_.Contains(sequence.id) || is_in_list[sequence.id] || sequence.grains.empty() ||
+        !IsOrdered(sequence)) {
       return false;
     }
-    if (sequences_[i].id > sequence.id) {
-      sequences_.insert(sequences_.begin() + i, sequence);
-      return true;
-    }
-    if (i == sequences_.size() - 1) {
-      sequences_.push_back(sequence);
-      return true;
+    is_in_list[sequence.id] = true;
+    num_new_grains += sequence.grains.size();
+  }
+  if (!HasCapacity(num_new_grains, 0)) {
+    return false;
+  }
+  for (const auto &sequence : sequences) {
+    const auto slot = index_.Insert(sequence.id, num_slots_);
+    if (static_cast<size_t>(slot) == num_slots_) {
+      num_slots_++;
     }
+    AppendGrains(slot, sequence);
   }
-  return false;
+#ifdef SENSINT_DEBUG
+  LogUsage();
+#endif  // SENSINT_DEBUG
+  return true;
 }
 
-bool SequenceLib::UpdateSequence(const sensint::GrainSequence &sequence) {
-  for (size_t i = 0; i < sequences_.size(); i++) {
-    if (sequences_[i].id == sequence.id) {
-      sequences_[i] = sequence;
-      return true;
+bool SequenceLib::UpdateSequences(const std::vector<sensint::GrainSequence> &sequences) {
+  bool is_in_list[IdIndex::kNumIds] = {};
+  size_t num_new_grains = 0;
+  size_t num_old_grains = 0;
+  for (const auto &sequence : sequences) {
+    const auto slot = index_.GetSlot(sequence.id);
+    if (slot == IdIndex::kNoSlot || is_in_list[sequence.id] || sequence.grains.empty() ||
+        !IsOrdered(sequence)) {
+      return false;
     }
+    is_in_list[sequence.id] = true;
+    num_new_grains += sequence.grains.size();
+    num_old_grains += GetNumOwnGrains(slot);
   }
-  return false;
+  if (!HasCapacity(num_new_grains, num_old_grains)) {
+    return false;
+  }
+  for (const auto &sequence : sequences) {
+    sequences_[index_.GetSlot(sequence.id)].size = 0;
+  }
+  Compact();
+  for (const auto &sequence : sequences) {
+    AppendGrains(index_.GetSlot(sequence.id), sequence);
+    index_.Invalidate(sequence.id);
+  }
+#ifdef SENSINT_DEBUG
+  LogUsage();
+#endif  // SENSINT_DEBUG
+  return true;
 }
 
-bool SequenceLib::DeleteSequence(const uint8_t id) {
-  for (size_t i = 0; i < sequences_.size(); i++) {
-    if (sequences_[i].id == id) {
-      sequences_.erase(sequences_.begin() + i);
-      return true;
+bool SequenceLib::DeleteSequences(const std::vector<uint8_t> &ids) {
+  bool is_in_list[IdIndex::kNumIds] = {};
+  for (const auto id : ids) {
+    if (!index_.Contains(id) || is_in_list[id]) {
+      return false;
     }
+    is_in_list[id] = true;
+  }
+  for (const auto id : ids) {
+    index_.Erase(id);
+  }
+  Compact();
+#ifdef SENSINT_DEBUG
+  LogUsage();
+#endif  // SENSINT_DEBUG
+  return true;
+}
+
+bool SequenceLib::PatchSequence(const sensint::GrainSequencePatch &patch) {
+  const auto slot = index_.GetSlot(patch.id);
+  if (slot == IdIndex::kNoSlot) {
+    return false;
+  }
+  auto &sequence = sequences_[slot];
+  if (patch.first > sequence.size || patch.num_removed > sequence.size - patch.first ||
+      sequence.size - patch.num_removed + patch.grains.size() == 0 ||
+      !IsOrdered(sequence, patch)) {
+    return false;
+  }
+  // the grains of the default sequence are shared, hence the sequence gets its own grains
+  if (GetNumOwnGrains(slot) == 0) {
+    GrainSequence copy;
+    GetSequenceByID(patch.id, copy);
+    copy.grains.erase(copy.grains.begin() + patch.first,
+                      copy.grains.begin() + patch.first + patch.num_removed);
+    copy.grains.insert(copy.grains.begin() + patch.first, patch.grains.begin(),
+                       patch.grains.end());
+    return UpdateSequence(copy);
   }
+  if (!HasCapacity(patch.grains.size(), patch.num_removed)) {
+    return false;
+  }
+  const auto size = sequence.size;
+  SpliceGrains(slot, patch.first, patch.num_removed, patch.grains);
+  if (sequence.size != size) {
+    index_.Invalidate(patch.id);
+  }
+#ifdef SENSINT_DEBUG
+  LogUsage();
+#endif  // SENSINT_DEBUG
+  return true;
+}
+
+bool SequenceLib::SequenceExists(const uint8_t id) const { return index_.Contains(id); }
+
+int SequenceLib::GetSequenceIndexByID(const uint8_t id) const { return index_.GetSlot(id); }
+
+bool SequenceLib::GetSequenceByID(const uint8_t id, sensint::GrainSequence &destination) const {
+  const auto slot = index_.GetSlot(id);
+  if (slot == IdIndex::kNoSlot) {
+    return false;
+  }
+  const auto &sequence = sequences_[slot];
+  destination.id = sequence.id;
+  destination.grains.clear();
+  for (size_t i = 0; i < sequence.size; i++) {
+    destination.grains.push_back(sequence[i]);
+  }
+  return true;
+}
+
+SequenceHandle SequenceLib::GetSequenceHandle(const uint8_t id) const {
+  SequenceHandle handle;
+  handle.id = id;
+  const auto slot = index_.GetSlot(id);
+  if (slot != IdIndex::kNoSlot) {
+    handle.slot = static_cast<int16_t>(slot);
+    handle.generation = index_.GetGeneration(slot);
+  }
+  return handle;
+}
+
+const sensint::GrainSequenceView *SequenceLib::GetSequence(const SequenceHandle &handle) const {
+  if (handle.IsNull()) {
+    return &default_sequence_;
+  }
+  if (!index_.IsCurrent(handle.slot, handle.generation)) {
+    return nullptr;
+  }
+  return &sequences_[handle.slot];
+}
+
+const sensint::GrainSequenceView &SequenceLib::GetDefaultSequence() const {
+  return default_sequence_;
+}
+
+size_t SequenceLib::GetNumGrains() const { return arena_.Size(); }
+
+size_t SequenceLib::GetNumSequences() const { return index_.Size(); }
+
+void SequenceLib::Reset() {
+  index_.Clear();
+  num_slots_ = 0;
+  arena_.Truncate(default_sequence_.size);
+  // the entry of the default sequence shares its grains
+  const auto slot = index_.Insert(default_sequence_.id, num_slots_);
+  num_slots_++;
+  sequences_[slot] = default_sequence_;
+}
+
+bool SequenceLib::HasCapacity(const size_t num_new_grains, const size_t num_old_grains) const {
+  if (arena_.Size() - num_old_grains + num_new_grains <= GrainArena::kCapacity) {
+    return true;
+  }
+#ifdef SENSINT_DEBUG
+  debug::Log("SequenceLib", "the grain arena is full");
+#endif  // SENSINT_DEBUG
   return false;
 }
 
-bool SequenceLib::SequenceExists(const uint8_t id) const {
-  for (const auto &sequence : sequences_) {
-    if (sequence.id == id) {
-      return true;
+size_t SequenceLib::GetNumOwnGrains(const int slot) const {
+  const auto &view = sequences_[slot];
+  return (view.offset < default_sequence_.size) ? 0 : view.size;
+}
+
+bool SequenceLib::IsOrdered(const sensint::GrainSequenceView &sequence,
+                            const sensint::GrainSequencePatch &patch) const {
+  const auto next = patch.first + patch.num_removed;
+  bool has_previous = patch.first > 0;
+  Grain previous = has_previous ? sequence[patch.first - 1] : Grain();
+  for (const auto &grain : patch.grains) {
+    if (grain.pos_end < grain.pos_start || (has_previous && grain.pos_start < previous.pos_end)) {
+      return false;
     }
+    previous = grain;
+    has_previous = true;
   }
-  return false;
+  return !has_previous || next >= sequence.size || previous.pos_end <= sequence[next].pos_start;
 }
 
-int SequenceLib::GetSequenceIndexByID(const uint8_t id) const {
-  for (size_t idx = 0; idx < sequences_.size(); idx++) {
-    if (id == sequences_[idx].id) {
-      return idx;
+bool SequenceLib::IsOrdered(const sensint::GrainSequence &sequence) const {
+  const auto &grains = sequence.grains;
+  for (size_t i = 0; i < grains.size(); i++) {
+    if (grains[i].pos_end < grains[i].pos_start ||
+        (i > 0 && grains[i].pos_start < grains[i - 1].pos_end)) {
+      return false;
     }
   }
-  return -1;
+  return true;
 }
 
-bool SequenceLib::GetSequenceByID(const uint8_t id, sensint::GrainSequence &destination) const {
-  for (size_t idx = 0; idx < sequences_.size(); idx++) {
-    if (id == sequences_[idx].id) {
-      destination = sequences_[idx];
-      return true;
+void SequenceLib::AppendGrains(const int slot, const sensint::GrainSequence &sequence) {
+  const auto offset = arena_.Append(sequence.grains);
+  sequences_[slot] =
+      arena_.GetView(sequence.id, offset, static_cast<uint16_t>(sequence.grains.size()));
+}
+
+void SequenceLib::SpliceGrains(const int slot, const uint16_t first, const uint16_t num_removed,
+                               const std::vector<Grain> &grains) {
+  auto &sequence = sequences_[slot];
+  const auto offset = sequence.offset;
+  const auto num_grains = static_cast<uint16_t>(sequence.size - num_removed + grains.size());
+  arena_.Splice(offset + first, num_removed, grains);
+  if (num_grains == sequence.size) {
+    return;
+  }
+  const auto delta = static_cast<int>(num_grains) - static_cast<int>(sequence.size);
+  for (size_t id = 0; id < IdIndex::kNumIds; id++) {
+    if (!index_.Contains(id)) {
+      continue;
+    }
+    auto &view = sequences_[index_.GetSlot(id)];
+    if (view.offset > offset) {
+      view = arena_.GetView(view.id, static_cast<uint16_t>(view.offset + delta), view.size);
     }
   }
-  return false;
+  sequence = arena_.GetView(sequence.id, offset, num_grains);
 }
 
-const sensint::GrainSequence &SequenceLib::GetDefaultSequence() const { return default_sequence_; }
+void SequenceLib::Compact() {
+  // the slots of the sequences that own grains, ordered by the offset of their grains
+  int16_t slots[IdIndex::kNumIds];
+  size_t num_owners = 0;
+  for (size_t id = 0; id < IdIndex::kNumIds; id++) {
+    if (!index_.Contains(id)) {
+      continue;
+    }
+    const auto slot = static_cast<int16_t>(index_.GetSlot(id));
+    if (GetNumOwnGrains(slot) > 0) {
+      slots[num_owners++] = slot;
+    }
+  }
+  //! an updated sequence is appended to the end, hence the order of the grains is unrelated to
+  //! the order of the IDs after some updates
+  std::sort(slots, slots + num_owners, [this](const int16_t a, const int16_t b) {
+    return sequences_[a].offset < sequences_[b].offset;
+  });
+  uint16_t end = default_sequence_.size;
+  size_t first = 0;
+  while (first < num_owners) {
+    // the sequences between two gaps are contiguous, hence they are moved at once
+    const uint16_t from = sequences_[slots[first]].offset;
+    uint16_t size = 0;
+    size_t last = first;
+    for (; last < num_owners && sequences_[slots[last]].offset == from + size; last++) {
+      size += sequences_[slots[last]].size;
+    }
+    if (from != end) {
+      arena_.Move(from, end, size);
+      for (size_t idx = first; idx < last; idx++) {
+        auto &view = sequences_[slots[idx]];
+        view = arena_.GetView(view.id, static_cast<uint16_t>(end + view.offset - from), view.size);
+      }
+    }
+    end += size;
+    first = last;
+  }
+  arena_.Truncate(end);
+}
 
-void SequenceLib::Reset() {
-  sequences_.clear();
-  sequences_.push_back(default_sequence_);
+#ifdef SENSINT_DEBUG
+void SequenceLib::LogUsage() const {
+  debug::LogTokenized<debug::LogToken::kGrainArenaUsage>(
+      debug::DebugLevel::verbose, static_cast<uint32_t>(arena_.Size()),
+      static_cast<uint32_t>(GrainArena::kCapacity), static_cast<uint32_t>(index_.Size()));
 }
+#endif  // SENSINT_DEBUG
 
 #ifdef SENSINT_DEBUG
 void SequenceLib::PrintLib() const {
   if (debug::kDebugLevel == debug::DebugLevel::verbose) {
     Serial.println("\n======== Sequence Lib ========");
-    for (const auto &sequence : sequences_) {
-      PrintGrainSequence(sequence);
+    Serial.printf("grain arena - used:%d/%d\n", (int)arena_.Size(), (int)GrainArena::kCapacity);
+    // the slots are reused, hence the sequences are printed by ID
+    for (size_t id = 0; id < IdIndex::kNumIds; id++) {
+      if (index_.Contains(id)) {
+        PrintGrainSequence(sequences_[index_.GetSlot(id)]);
+      }
     }
   }
 }
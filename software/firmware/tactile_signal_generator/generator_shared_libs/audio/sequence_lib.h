@@ -6,16 +6,32 @@
 #include <string>
 #include <vector>
 
+#include "grain_arena.h"
+#include "id_index.h"
+
 namespace sensint {
 
+using SequenceHandle = LibraryHandle<sensint::GrainSequenceView>;
+
+/**
+ * @brief The library of the grain sequences. The grains of all sequences are stored in a
+ * fixed-capacity arena (see GrainArena), hence the library does not use the heap at runtime.
+ */
 class SequenceLib final {
  public:
   SequenceLib();
   ~SequenceLib();
 
   /**
-   * @brief Add a sequence to the library. Sequences are ordered by their IDs.
-   * If a sequence with the same ID exists already the library remains as is.
+   * @brief Copy another library. The views of the copy refer to its own arena.
+   */
+  SequenceLib(const SequenceLib &other);
+  SequenceLib &operator=(const SequenceLib &other);
+
+  /**
+   * @brief Add a sequence to the library. Its grains are appended to the arena.
+   * If a sequence with the same ID exists already, its grains are not ordered
+   * (see IsOrdered), or the arena is full the library remains as is.
    *
    * @param sequence the sequence object to add
    * @return true sequence was added
@@ -24,17 +40,21 @@ class SequenceLib final {
   bool AddSequence(const sensint::GrainSequence &sequence);
 
   /**
-   * @brief Update the properties of an existing sequence. If the sequence does
-   * not exist the library remains as is.
+   * @brief Update the properties of an existing sequence. The grains are
+   * replaced, thus all handles of the sequence become stale. If the sequence does
+   * not exist, its grains are not ordered, or the arena is too small the library
+   * remains as is.
    *
    * @param sequence the sequence to update
    * @return true update was successful
-   * @return false no sequence with this ID found
+   * @return false no sequence with this ID found, the grains are not ordered, or
+   * the arena is full
    */
   bool UpdateSequence(const sensint::GrainSequence &sequence);
 
   /**
-   * @brief Delete a sequence from the library.
+   * @brief Delete a sequence from the library. Its grains are removed from the
+   * arena, i.e. the grains of the subsequent sequences are shifted.
    *
    * @param id of the sequence to delete
    * @return true delete was successful
@@ -42,6 +62,52 @@ class SequenceLib final {
    */
   bool DeleteSequence(const uint8_t id);
 
+  /**
+   * @brief Add a list of sequences to the library. The list is validated first,
+   * i.e. either all sequences are added or none (e.g. if an ID exists already,
+   * appears twice in the list, a sequence is not ordered, or the arena is too
+   * small).
+   *
+   * @param sequences the sequences to add
+   * @return true all sequences were added
+   * @return false no sequence was added
+   */
+  bool AddSequences(const std::vector<sensint::GrainSequence> &sequences);
+
+  /**
+   * @brief Update a list of existing sequences. The list is validated first,
+   * i.e. either all sequences are updated or none. The arena is compacted once
+   * for the entire list.
+   *
+   * @param sequences the sequences to update
+   * @return true all sequences were updated
+   * @return false no sequence was updated
+   */
+  bool UpdateSequences(const std::vector<sensint::GrainSequence> &sequences);
+
+  /**
+   * @brief Delete a list of sequences from the library. Either all sequences are
+   * deleted or none. The arena is compacted once for the entire list.
+   *
+   * @param ids of the sequences to delete
+   * @return true all sequences were deleted
+   * @return false no sequence was deleted
+   */
+  bool DeleteSequences(const std::vector<uint8_t> &ids);
+
+  /**
+   * @brief Replace, insert, or remove a range of grains of an existing sequence
+   * in place, i.e. only the grains behind the range are shifted. The patched
+   * grains have to keep the sequence ordered (see IsOrdered). If the number of
+   * grains changes all handles of the sequence become stale.
+   *
+   * @param patch the range of grains and the new grains
+   * @return true patch was applied
+   * @return false no sequence with this ID found, the range or the order is
+   * invalid, or the arena is full
+   */
+  bool PatchSequence(const sensint::GrainSequencePatch &patch);
+
   /**
    * @brief Check if a sequence with a given ID exists in the library.
    *
@@ -52,11 +118,10 @@ class SequenceLib final {
   bool SequenceExists(const uint8_t id) const;
 
   /**
-   * @brief Find a sequence in a vector based on its unique identifier
+   * @brief Find a sequence based on its unique identifier in constant time.
    *
-   * @param sequences vector of sequences
-   * @param sequence_id unique identifier
-   * @return int the index of the vector where the sequence is placed. Returns
+   * @param id unique identifier
+   * @return int the slot of the library where the sequence is placed. Returns
    * -1 if the sequence does not exist.
    */
   int GetSequenceIndexByID(const uint8_t id) const;
@@ -71,11 +136,41 @@ class SequenceLib final {
    */
   bool GetSequenceByID(uint8_t id, sensint::GrainSequence &destination) const;
 
+  /**
+   * @brief Get a handle of a sequence. The handle stays valid until the
+   * sequence is deleted or updated (see state_management::ResolveHandles).
+   *
+   * @param id
+   * @return the handle or a null handle if the sequence does not exist
+   */
+  SequenceHandle GetSequenceHandle(const uint8_t id) const;
+
+  /**
+   * @brief Get the view of the sequence of a handle without copying it. The
+   * address of the view is stable, but its grains might be shifted when the
+   * library is modified.
+   *
+   * @param handle
+   * @return the sequence, the default sequence for a null handle, or nullptr if the
+   * handle is stale
+   */
+  const sensint::GrainSequenceView *GetSequence(const SequenceHandle &handle) const;
+
   /**
    * @brief Get a sequence by its ID.
    * @return the default sequence
    */
-  const sensint::GrainSequence &GetDefaultSequence() const;
+  const sensint::GrainSequenceView &GetDefaultSequence() const;
+
+  /**
+   * @brief Get the number of grains in the arena (incl. the default sequence).
+   */
+  size_t GetNumGrains() const;
+
+  /**
+   * @brief Get the number of sequences in the library.
+   */
+  size_t GetNumSequences() const;
 
   /**
    * @brief Reset the entire library, i.e. all sequences are removed but the
@@ -91,10 +186,66 @@ class SequenceLib final {
 #endif  // SENSINT_DEBUG
 
  private:
-  // there is a default sequence which is used when the controller is booted
-  sensint::GrainSequence default_sequence_;
-  // the library data
-  std::vector<sensint::GrainSequence> sequences_;
+  /**
+   * @brief Check if the arena has room for new grains, i.e. after the grains of
+   * the replaced sequences are erased.
+   */
+  bool HasCapacity(const size_t num_new_grains, const size_t num_old_grains) const;
+
+  /**
+   * @brief Get the number of grains a sequence owns in the arena. The grains of
+   * the default sequence are shared, i.e. they are not owned by its entry.
+   */
+  size_t GetNumOwnGrains(const int slot) const;
+
+  /**
+   * @brief Check if the grains of a sequence are ordered, i.e. every grain
+   * starts not before the end of its predecessor and does not end before its
+   * start. The closest grain is found by a binary search, which relies on it.
+   */
+  bool IsOrdered(const sensint::GrainSequence &sequence) const;
+
+  /**
+   * @brief Check if a patch keeps a sequence ordered (see above). Only the
+   * patched grains and their neighbors are checked.
+   */
+  bool IsOrdered(const sensint::GrainSequenceView &sequence,
+                 const sensint::GrainSequencePatch &patch) const;
+
+  /**
+   * @brief Append the grains of a sequence to the arena and set the view of its
+   * slot. The capacity has to be checked before.
+   */
+  void AppendGrains(const int slot, const sensint::GrainSequence &sequence);
+
+  /**
+   * @brief Replace a range of the grains of a sequence in the arena and shift
+   * the views of the following sequences. The capacity and the order have to be
+   * checked before.
+   */
+  void SpliceGrains(const int slot, const uint16_t first, const uint16_t num_removed,
+                    const std::vector<sensint::Grain> &grains);
+
+  /**
+   * @brief Close all gaps of erased and replaced grains in a single pass over
+   * the arena and renew the views of the moved sequences.
+   */
+  void Compact();
+
+#ifdef SENSINT_DEBUG
+  void LogUsage() const;
+#endif  // SENSINT_DEBUG
+
+  // the grains of all sequences
+  sensint::GrainArena arena_;
+  // there is a default sequence which is used when the controller is booted. Its grains are the
+  // first ones of the arena and are never erased.
+  sensint::GrainSequenceView default_sequence_;
+  // the views of the sequences by slot
+  sensint::GrainSequenceView sequences_[IdIndex::kNumIds];
+  size_t num_slots_ = 0;
+  // the slots of the library data by ID
+  IdIndex index_;
 };
 
 }  // namespace sensint
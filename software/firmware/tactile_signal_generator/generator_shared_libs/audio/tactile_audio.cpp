@@ -240,22 +240,29 @@ void ApplyGrainParameters(const GrainParameters &params, MonoAudio &audio) {
 #endif  // SENSINT_DEBUG
 }
 
-int FindClosestGrainIndex(const std::vector<sensint::Grain> &sequence,
+int FindClosestGrainIndex(const sensint::GrainSequenceView &sequence,
                           const sensint::analog_sensor_t sensor_val) {
-  int max = sequence.size() - 1;
-  if (sensor_val <= sequence.front().pos_start) {
+  // the search only reads the positions, which are contiguous in the grain arena
+  const auto *pos_start = sequence.pos_start;
+  const auto *pos_end = sequence.pos_end;
+  int max = sequence.size - 1;
+  if (sensor_val <= pos_start[0]) {
     return 0;
   }
-  if (sensor_val >= sequence.back().pos_end) {
+  if (sensor_val >= pos_end[max]) {
     return max;
   }
 
   auto GetClosest = [&](const int a, const int b) {
-    auto a_start = sequence[a].pos_start;
-    auto a_end = sequence[a].pos_end;
+    // inside of the range of a continuous grain, even if the next grain is closer to an end
+    if (sensor_val >= pos_start[a] && sensor_val <= pos_end[a]) {
+      return a;
+    }
+    auto a_start = pos_start[a];
+    auto a_end = pos_end[a];
     auto a_min = a_start;
-    auto b_start = sequence[b].pos_start;
-    auto b_end = sequence[b].pos_end;
+    auto b_start = pos_start[b];
+    auto b_end = pos_end[b];
     auto b_min = b_start;
     if (a_start != a_end) {
       a_min = (abs(sensor_val - a_start) <= abs(sensor_val - a_end)) ? a_start : a_end;
@@ -266,19 +273,19 @@ int FindClosestGrainIndex(const std::vector<sensint::Grain> &sequence,
     return (sensor_val - a_min >= b_min - sensor_val) ? b : a;
   };
 
-  int left = 0, right = sequence.size(), mid = 0;
+  int left = 0, right = sequence.size, mid = 0;
   while (left < right) {
     mid = (left + right) / 2;
-    if (sequence[mid].pos_start == sensor_val || sequence[mid].pos_end == sensor_val) {
+    if (pos_start[mid] == sensor_val || pos_end[mid] == sensor_val) {
       return mid;
     }
-    if (sensor_val < sequence[mid].pos_start) {
-      if (mid > 0 && sensor_val > sequence[mid - 1].pos_end) {
+    if (sensor_val < pos_start[mid]) {
+      if (mid > 0 && sensor_val > pos_end[mid - 1]) {
         return GetClosest(mid - 1, mid);
       }
       right = mid;
     } else {
-      if (mid < max && sensor_val < sequence[mid + 1].pos_start) {
+      if (mid < max && sensor_val < pos_start[mid + 1]) {
         return GetClosest(mid, mid + 1);
       }
       left = mid + 1;
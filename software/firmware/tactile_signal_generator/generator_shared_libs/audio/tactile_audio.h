@@ -1,9 +1,15 @@
 #ifndef __SENSINT_TACTILE_AUDIO_H__
 #define __SENSINT_TACTILE_AUDIO_H__
 
+#ifdef ARDUINO
 #include <Audio.h>
+#else
+#include "host_audio.h"
+#endif  // ARDUINO
 #include <types.h>
 
+#include "grain_arena.h"
+
 namespace sensint {
 namespace tactile_audio {
 
@@ -212,11 +218,11 @@ void ApplyGrainParameters(const GrainParameters &params, MonoAudio &audio);
  * @brief Find the closest grain index based on a given sensor value. We apply a
  * binary search scheme.
  *
- * @param sequence vector of grains with their positions
+ * @param sequence view of the grains with their positions
  * @param sensor_val the sensor value to match with a grain position
  * @return int index of the closest grain
  */
-int FindClosestGrainIndex(const std::vector<sensint::Grain> &sequence,
+int FindClosestGrainIndex(const sensint::GrainSequenceView &sequence,
                           const sensint::analog_sensor_t sensor_val);
 
 }  // namespace tactile_audio
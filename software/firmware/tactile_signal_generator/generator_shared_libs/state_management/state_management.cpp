@@ -25,7 +25,7 @@ void HandleStopAugmentationMsg(AugmentationState &state) {
   state.should_augment = false;
 }
 
-void HandleAddMaterialMsg(const std::vector<std::string> &tokens, AugmentationState &state,
+bool HandleAddMaterialMsg(const std::vector<std::string> &tokens, AugmentationState &state,
                           MaterialLib &material_lib) {
 #ifdef SENSINT_DEBUG
   Log("UpdateConfig", "add single material");
@@ -36,20 +36,21 @@ void HandleAddMaterialMsg(const std::vector<std::string> &tokens, AugmentationSt
 #ifdef SENSINT_DEBUG
     Log("UpdateConfig", "Parsing the material information failed!");
 #endif  // SENSINT_DEBUG
-    return;
+    return false;
   }
   if (!material_lib.AddMaterial(material)) {
 #ifdef SENSINT_DEBUG
     Log("UpdateConfig", "A material with this ID already exists!");
 #endif  // SENSINT_DEBUG
-    return;
+    return false;
   }
 #ifdef SENSINT_DEBUG
   material_lib.PrintLib();
 #endif  // SENSINT_DEBUG
+  return true;
 }
 
-void HandleUpdateMaterialMsg(const std::vector<std::string> &tokens, AugmentationState &state,
+bool HandleUpdateMaterialMsg(const std::vector<std::string> &tokens, AugmentationState &state,
                              MaterialLib &material_lib) {
 #ifdef SENSINT_DEBUG
   Log("UpdateConfig", "update single material");
@@ -60,45 +61,55 @@ void HandleUpdateMaterialMsg(const std::vector<std::string> &tokens, Augmentatio
 #ifdef SENSINT_DEBUG
     Log("UpdateConfig", "Parsing the material information failed!");
 #endif  // SENSINT_DEBUG
-    return;
+    return false;
   }
   if (!material_lib.UpdateMaterial(mat)) {
 #ifdef SENSINT_DEBUG
     Log("UpdateConfig", "A material with this ID does not exist!");
 #endif  // SENSINT_DEBUG
-    return;
+    return false;
   }
 #ifdef SENSINT_DEBUG
   material_lib.PrintLib();
 #endif  // SENSINT_DEBUG
-  if (mat.id == state.current_material->id) {
-    material_lib.GetMaterialByID(mat.id, *state.current_material);
-    state.should_reinitialize_material = true;
-  }
+  return true;
 }
 
-void HandleDeleteMaterialMsg(const std::vector<std::string> &tokens, AugmentationState &state,
+bool HandleDeleteMaterialMsg(const std::vector<std::string> &tokens, AugmentationState &state,
                              MaterialLib &material_lib) {
 #ifdef SENSINT_DEBUG
   Log("UpdateConfig", "delete single material");
 #endif  // SENSINT_DEBUG
   auto mat_id = atoi(tokens[3].c_str());
-  if (mat_id == state.current_material->id) {
-    state.current_material = &material_lib.GetDefaultMaterial();
-    state.should_reinitialize_material = true;
-  }
   if (!material_lib.DeleteMaterial(mat_id)) {
 #ifdef SENSINT_DEBUG
     Log("UpdateConfig", "A material with this ID does not exist!");
 #endif  // SENSINT_DEBUG
-    return;
+    return false;
   }
 #ifdef SENSINT_DEBUG
   material_lib.PrintLib();
 #endif  // SENSINT_DEBUG
+  return true;
+}
+
+bool ParseIdList(const std::vector<std::string> &tokens, std::vector<uint8_t> &ids) {
+  if (tokens.size() < 3) {
+    return false;
+  }
+  const auto num_ids = atoi(tokens[2].c_str());
+  if (num_ids <= 0 || tokens.size() != static_cast<size_t>(num_ids) + 3) {
+    return false;
+  }
+  ids.clear();
+  ids.reserve(num_ids);
+  for (auto token = tokens.begin() + 3; token != tokens.end(); ++token) {
+    ids.push_back(static_cast<uint8_t>(atoi(token->c_str())));
+  }
+  return true;
 }
 
-void HandleAddMaterialListMsg(const std::vector<std::string> &tokens, AugmentationState &state,
+bool HandleAddMaterialListMsg(const std::vector<std::string> &tokens, AugmentationState &state,
                               MaterialLib &material_lib) {
 #ifdef SENSINT_DEBUG
   Log("UpdateConfig", "add list of materials");
@@ -110,32 +121,25 @@ void HandleAddMaterialListMsg(const std::vector<std::string> &tokens, Augmentati
 #ifdef SENSINT_DEBUG
     Log("UpdateConfig", "Parsing the list of material information failed!");
 #endif  // SENSINT_DEBUG
-    return;
+    return false;
   }
-  //! Hack start
-  // TODO: This overwrites the material library each time!
-  material_lib.Reset();
-  state.current_material = &material_lib.GetDefaultMaterial();
-  //! Hack end
-  state.should_reinitialize_material = true;
-  for (const auto &material : materials) {
-    if (!material_lib.AddMaterial(material)) {
+  if (!material_lib.AddMaterials(materials)) {
 #ifdef SENSINT_DEBUG
-      Log("UpdateConfig", "A material with this ID already exists!");
+    Log("UpdateConfig", "A material of the list already exists or appears twice!");
 #endif  // SENSINT_DEBUG
-    }
+    return false;
   }
 #ifdef SENSINT_DEBUG
   material_lib.PrintLib();
 #endif  // SENSINT_DEBUG
+  return true;
 }
 
-void HandleUpdateMaterialListMsg(const std::vector<std::string> &tokens, AugmentationState &state,
+bool HandleUpdateMaterialListMsg(const std::vector<std::string> &tokens, AugmentationState &state,
                                  MaterialLib &material_lib) {
 #ifdef SENSINT_DEBUG
   Log("UpdateConfig", "update list of materials");
 #endif  // SENSINT_DEBUG
-  // example string for two materials:
   std::vector<Material> materials;
   int num_materials = atoi(tokens[2].c_str());
   std::vector<std::string> material_tokens{tokens.begin() + 3, tokens.end()};
@@ -143,62 +147,57 @@ void HandleUpdateMaterialListMsg(const std::vector<std::string> &tokens, Augment
 #ifdef SENSINT_DEBUG
     Log("UpdateConfig", "Parsing the list of material information failed!");
 #endif  // SENSINT_DEBUG
-    return;
+    return false;
   }
-  for (auto &material : materials) {
-    if (!material_lib.UpdateMaterial(material)) {
+  if (!material_lib.UpdateMaterials(materials)) {
 #ifdef SENSINT_DEBUG
-      Log("UpdateConfig", "A material with this ID does not exist!");
+    Log("UpdateConfig", "A material of the list does not exist or appears twice!");
 #endif  // SENSINT_DEBUG
-      continue;
-    }
-    if (state.current_material->id == material.id) {
-      state.current_material = &material;
-      state.should_reinitialize_material = true;
-    }
+    return false;
   }
 #ifdef SENSINT_DEBUG
   material_lib.PrintLib();
 #endif  // SENSINT_DEBUG
+  return true;
 }
 
-void HandleDeleteMaterialListMsg(const std::vector<std::string> &tokens, AugmentationState &state,
+bool HandleDeleteMaterialListMsg(const std::vector<std::string> &tokens, AugmentationState &state,
                                  MaterialLib &material_lib) {
 #ifdef SENSINT_DEBUG
   Log("UpdateConfig", "delete list of materials");
 #endif  // SENSINT_DEBUG
-  int num_materials = atoi(tokens[2].c_str());
-  for (int i = 0; i < num_materials; i++) {
-    auto id = atoi(tokens[i + 3].c_str());
-    if (id == state.current_material->id) {
-      state.current_material = &material_lib.GetDefaultMaterial();
-      state.should_reinitialize_material = true;
-    }
-    if (!material_lib.DeleteMaterial(id)) {
+  std::vector<uint8_t> ids;
+  if (!ParseIdList(tokens, ids)) {
 #ifdef SENSINT_DEBUG
-      Log("UpdateConfig", "A material with this ID does not exist!");
+    Log("UpdateConfig", "Parsing the list of material IDs failed!");
 #endif  // SENSINT_DEBUG
-    }
+    return false;
+  }
+  if (!material_lib.DeleteMaterials(ids)) {
+#ifdef SENSINT_DEBUG
+    Log("UpdateConfig", "A material of the list does not exist or appears twice!");
+#endif  // SENSINT_DEBUG
+    return false;
   }
 #ifdef SENSINT_DEBUG
   material_lib.PrintLib();
 #endif  // SENSINT_DEBUG
+  return true;
 }
 
-void HandleDeleteAllMaterialsMsg(const std::vector<std::string> &tokens, AugmentationState &state,
+bool HandleDeleteAllMaterialsMsg(const std::vector<std::string> &tokens, AugmentationState &state,
                                  MaterialLib &material_lib) {
 #ifdef SENSINT_DEBUG
   Log("UpdateConfig", "delete all materials");
 #endif  // SENSINT_DEBUG
   material_lib.Reset();
-  state.current_material = &material_lib.GetDefaultMaterial();
-  state.should_reinitialize_material = true;
 #ifdef SENSINT_DEBUG
   material_lib.PrintLib();
 #endif  // SENSINT_DEBUG
+  return true;
 }
 
-void HandleAddSequenceMsg(const std::vector<std::string> &tokens, AugmentationState &state,
+bool HandleAddSequenceMsg(const std::vector<std::string> &tokens, AugmentationState &state,
                           SequenceLib &sequence_lib) {
   auto id = atoi(tokens[3].c_str());
 #ifdef SENSINT_DEBUG
@@ -208,14 +207,14 @@ void HandleAddSequenceMsg(const std::vector<std::string> &tokens, AugmentationSt
 #ifdef SENSINT_DEBUG
     Log("UpdateConfig", "Sequence with this ID already exists!");
 #endif  // SENSINT_DEBUG
-    return;
+    return false;
   }
   int num_grains = atoi(tokens[2].c_str());
   if (num_grains == 0) {
 #ifdef SENSINT_DEBUG
     Log("UpdateConfig", "Sequence without grains!");
 #endif  // SENSINT_DEBUG
-    return;
+    return false;
   }
   GrainSequence sequence;
   std::vector<std::string> grain_tokens{tokens.begin() + 3, tokens.end()};
@@ -223,15 +222,21 @@ void HandleAddSequenceMsg(const std::vector<std::string> &tokens, AugmentationSt
 #ifdef SENSINT_DEBUG
     Log("UpdateConfig", "Parsing the sequence information failed!");
 #endif  // SENSINT_DEBUG
-    return;
+    return false;
+  }
+  if (!sequence_lib.AddSequence(sequence)) {
+#ifdef SENSINT_DEBUG
+    Log("UpdateConfig", "The grains are not ordered or the grain arena is full!");
+#endif  // SENSINT_DEBUG
+    return false;
   }
-  sequence_lib.AddSequence(sequence);
 #ifdef SENSINT_DEBUG
   sequence_lib.PrintLib();
 #endif  // SENSINT_DEBUG
+  return true;
 }
 
-void HandleUpdateSequenceMsg(const std::vector<std::string> &tokens, AugmentationState &state,
+bool HandleUpdateSequenceMsg(const std::vector<std::string> &tokens, AugmentationState &state,
                              SequenceLib &sequence_lib) {
   auto id = atoi(tokens[3].c_str());
 #ifdef SENSINT_DEBUG
@@ -241,14 +246,14 @@ void HandleUpdateSequenceMsg(const std::vector<std::string> &tokens, Augmentatio
 #ifdef SENSINT_DEBUG
     Log("UpdateConfig", "Sequence with this ID does not exist!");
 #endif  // SENSINT_DEBUG
-    return;
+    return false;
   }
   int num_grains = atoi(tokens[2].c_str());
   if (num_grains == 0) {
 #ifdef SENSINT_DEBUG
     Log("UpdateConfig", "Sequence without grains!");
 #endif  // SENSINT_DEBUG
-    return;
+    return false;
   }
   GrainSequence sequence;
   std::vector<std::string> grain_tokens{tokens.begin() + 3, tokens.end()};
@@ -256,88 +261,155 @@ void HandleUpdateSequenceMsg(const std::vector<std::string> &tokens, Augmentatio
 #ifdef SENSINT_DEBUG
     Log("UpdateConfig", "Parsing the sequence information failed!");
 #endif  // SENSINT_DEBUG
-    return;
+    return false;
   }
-  sequence_lib.UpdateSequence(sequence);
+  if (!sequence_lib.UpdateSequence(sequence)) {
 #ifdef SENSINT_DEBUG
-  sequence_lib.PrintLib();
+    Log("UpdateConfig", "The grains are not ordered or the grain arena is full!");
 #endif  // SENSINT_DEBUG
-  if (sequence.id == state.current_sequence->id) {
-    sequence_lib.GetSequenceByID(sequence.id, *state.current_sequence);
-    state.should_reinitialize_material = true;
+    return false;
   }
+#ifdef SENSINT_DEBUG
+  sequence_lib.PrintLib();
+#endif  // SENSINT_DEBUG
+  return true;
 }
 
-void HandleDeleteSequenceMsg(const std::vector<std::string> &tokens, AugmentationState &state,
+bool HandleDeleteSequenceMsg(const std::vector<std::string> &tokens, AugmentationState &state,
                              SequenceLib &sequence_lib) {
   auto id = atoi(tokens[3].c_str());
 #ifdef SENSINT_DEBUG
   Log("UpdateConfig", "delete grain sequence id: " + String(id));
 #endif  // SENSINT_DEBUG
-  if (id == state.current_sequence->id) {
-    state.current_sequence = &sequence_lib.GetDefaultSequence();
-  }
   if (!sequence_lib.DeleteSequence(id)) {
 #ifdef SENSINT_DEBUG
     Log("UpdateConfig", "A sequence with this ID does not exist!");
 #endif  // SENSINT_DEBUG
-    return;
+    return false;
+  }
+#ifdef SENSINT_DEBUG
+  sequence_lib.PrintLib();
+#endif  // SENSINT_DEBUG
+  return true;
+}
+
+bool HandlePatchSequenceMsg(const std::vector<std::string> &tokens, AugmentationState &state,
+                            SequenceLib &sequence_lib) {
+  GrainSequencePatch patch;
+  int num_grains = atoi(tokens[2].c_str());
+  std::vector<std::string> patch_tokens{tokens.begin() + 3, tokens.end()};
+  if (!ParseGrainSequencePatch(patch_tokens, num_grains, patch)) {
+#ifdef SENSINT_DEBUG
+    Log("UpdateConfig", "Parsing the sequence patch failed!");
+#endif  // SENSINT_DEBUG
+    return false;
+  }
+#ifdef SENSINT_DEBUG
+  Log("UpdateConfig", "patch grain sequence id: " + String(patch.id) + " | grains: " +
+                          String(patch.first) + "-" + String(patch.first + patch.num_removed));
+#endif  // SENSINT_DEBUG
+  if (!sequence_lib.PatchSequence(patch)) {
+#ifdef SENSINT_DEBUG
+    Log("UpdateConfig", "The sequence does not exist or the patch is invalid!");
+#endif  // SENSINT_DEBUG
+    return false;
   }
 #ifdef SENSINT_DEBUG
   sequence_lib.PrintLib();
 #endif  // SENSINT_DEBUG
+  return true;
 }
 
-void HandleAddSequenceListMsg(const std::vector<std::string> &tokens, AugmentationState &state,
+bool HandleAddSequenceListMsg(const std::vector<std::string> &tokens, AugmentationState &state,
                               SequenceLib &sequence_lib) {
 #ifdef SENSINT_DEBUG
   Log("UpdateConfig", "add list of grain sequences");
-  Log("NOT IMPLEMENTED YET");
 #endif  // SENSINT_DEBUG
-        // TODO: implement
+  std::vector<GrainSequence> sequences;
+  int num_sequences = atoi(tokens[2].c_str());
+  std::vector<std::string> sequence_tokens{tokens.begin() + 3, tokens.end()};
+  if (!ParseGrainSequenceList(sequence_tokens, num_sequences, sequences)) {
 #ifdef SENSINT_DEBUG
-  // sequence_lib.PrintLib();
+    Log("UpdateConfig", "Parsing the list of sequence information failed!");
 #endif  // SENSINT_DEBUG
+    return false;
+  }
+  if (!sequence_lib.AddSequences(sequences)) {
+#ifdef SENSINT_DEBUG
+    Log("UpdateConfig", "A sequence of the list already exists or appears twice!");
+#endif  // SENSINT_DEBUG
+    return false;
+  }
+#ifdef SENSINT_DEBUG
+  sequence_lib.PrintLib();
+#endif  // SENSINT_DEBUG
+  return true;
 }
 
-void HandleUpdateSequenceListMsg(const std::vector<std::string> &tokens, AugmentationState &state,
+bool HandleUpdateSequenceListMsg(const std::vector<std::string> &tokens, AugmentationState &state,
                                  SequenceLib &sequence_lib) {
 #ifdef SENSINT_DEBUG
   Log("UpdateConfig", "update list of grain sequences");
-  Log("NOT IMPLEMENTED YET");
 #endif  // SENSINT_DEBUG
-        // TODO: implement
+  std::vector<GrainSequence> sequences;
+  int num_sequences = atoi(tokens[2].c_str());
+  std::vector<std::string> sequence_tokens{tokens.begin() + 3, tokens.end()};
+  if (!ParseGrainSequenceList(sequence_tokens, num_sequences, sequences)) {
+#ifdef SENSINT_DEBUG
+    Log("UpdateConfig", "Parsing the list of sequence information failed!");
+#endif  // SENSINT_DEBUG
+    return false;
+  }
+  if (!sequence_lib.UpdateSequences(sequences)) {
 #ifdef SENSINT_DEBUG
-  // sequence_lib.PrintLib();
+    Log("UpdateConfig", "A sequence of the list does not exist or appears twice!");
 #endif  // SENSINT_DEBUG
+    return false;
+  }
+#ifdef SENSINT_DEBUG
+  sequence_lib.PrintLib();
+#endif  // SENSINT_DEBUG
+  return true;
 }
 
-void HandleDeleteSequenceListMsg(const std::vector<std::string> &tokens, AugmentationState &state,
+bool HandleDeleteSequenceListMsg(const std::vector<std::string> &tokens, AugmentationState &state,
                                  SequenceLib &sequence_lib) {
 #ifdef SENSINT_DEBUG
   Log("UpdateConfig", "delete list of grain sequences");
-  Log("NOT IMPLEMENTED YET");
 #endif  // SENSINT_DEBUG
-        // TODO: implement
+  std::vector<uint8_t> ids;
+  if (!ParseIdList(tokens, ids)) {
 #ifdef SENSINT_DEBUG
-  // sequence_lib.PrintLib();
+    Log("UpdateConfig", "Parsing the list of sequence IDs failed!");
 #endif  // SENSINT_DEBUG
+    return false;
+  }
+  if (!sequence_lib.DeleteSequences(ids)) {
+#ifdef SENSINT_DEBUG
+    Log("UpdateConfig", "A sequence of the list does not exist or appears twice!");
+#endif  // SENSINT_DEBUG
+    return false;
+  }
+#ifdef SENSINT_DEBUG
+  sequence_lib.PrintLib();
+#endif  // SENSINT_DEBUG
+  return true;
 }
 
-void HandleDeleteAllSequencesMsg(const std::vector<std::string> &tokens, AugmentationState &state,
+bool HandleDeleteAllSequencesMsg(const std::vector<std::string> &tokens, AugmentationState &state,
                                  SequenceLib &sequence_lib) {
 #ifdef SENSINT_DEBUG
   Log("UpdateConfig", "delete all grain sequences");
 #endif  // SENSINT_DEBUG
   sequence_lib.Reset();
-  state.current_sequence = &sequence_lib.GetDefaultSequence();
 #ifdef SENSINT_DEBUG
   sequence_lib.PrintLib();
 #endif  // SENSINT_DEBUG
+  return true;
 }
 
 void HandleSelectSequenceMsg(const std::vector<std::string> &tokens, AugmentationState &state,
-                             SequenceLib &sequence_lib) {
+                             const SequenceLib &sequence_lib) {
   auto id = atoi(tokens[3].c_str());
 #ifdef SENSINT_DEBUG
   Log("UpdateConfig", "select grain sequence " + String(id));
@@ -348,16 +420,62 @@ void HandleSelectSequenceMsg(const std::vector<std::string> &tokens, Augmentatio
 #endif  // SENSINT_DEBUG
     return;
   }
-  sequence_lib.GetSequenceByID(id, *state.current_sequence);
-  state.should_reinitialize_material = true;
+  SelectSequence(state, sequence_lib.GetSequenceHandle(id), sequence_lib);
 #ifdef SENSINT_DEBUG
   Log("======== Active Sequence ========");
   PrintGrainSequence(*state.current_sequence);
 #endif  // SENSINT_DEBUG
 }
 
+bool SelectSequence(AugmentationState &state, const SequenceHandle &handle,
+                    const SequenceLib &sequence_lib) {
+  const auto sequence = sequence_lib.GetSequence(handle);
+  if (!sequence) {
+    return false;
+  }
+  state.sequence = handle;
+  state.current_sequence = sequence;
+  state.closest_grain = (*sequence)[0];
+  state.last_grain = state.closest_grain;
+  state.should_reinitialize_material = true;
+  return true;
+}
+
+bool ResolveHandles(AugmentationState &state, const MaterialLib &material_lib,
+                    const SequenceLib &sequence_lib) {
+  auto are_valid = true;
+  state.current_material = material_lib.GetMaterial(state.material);
+  if (!state.current_material) {
+    are_valid = false;
+    state.material = material_lib.GetMaterialHandle(state.material.id);
+    state.current_material = material_lib.GetMaterial(state.material);
+    state.should_reinitialize_material = true;
+  }
+  const auto sequence = sequence_lib.GetSequence(state.sequence);
+  if (sequence) {
+    state.current_sequence = sequence;
+  } else {
+    are_valid = false;
+    SelectSequence(state, sequence_lib.GetSequenceHandle(state.sequence.id), sequence_lib);
+  }
+#ifdef SENSINT_DEBUG
+  if (!are_valid) {
+    Log("ResolveHandles", "replaced a stale handle");
+  }
+#endif  // SENSINT_DEBUG
+  return are_valid;
+}
+
+void HandleLibraryCommit(AugmentationState &state, const LibraryBuffer &libraries) {
+  // the current material might have been updated, hence it is reapplied in any case
+  state.should_reinitialize_material = true;
+  ResolveHandles(state, libraries.GetMaterialLib(), libraries.GetSequenceLib());
+}
+
 void UpdateConfig(const MessageTypes msg_type, const std::vector<std::string> &tokens,
-                  AugmentationState &state, MaterialLib &material_lib, SequenceLib &sequence_lib) {
+                  AugmentationState &state, LibraryBuffer &libraries) {
+  // a rejected edit leaves the shadow libraries as they are, i.e. there is nothing to commit
+  auto is_edited = false;
   switch (msg_type) {
     case MessageTypes::kStartAugmentation: {
       HandleStartAugmentationMsg(state);
@@ -368,63 +486,95 @@ void UpdateConfig(const MessageTypes msg_type, const std::vector<std::string> &t
       break;
     }
     case MessageTypes::kAddMaterial: {
-      HandleAddMaterialMsg(tokens, state, material_lib);
+      is_edited = HandleAddMaterialMsg(tokens, state, libraries.GetShadowMaterialLib());
       break;
     }
     case MessageTypes::kUpdateMaterial: {
-      HandleUpdateMaterialMsg(tokens, state, material_lib);
+      is_edited = HandleUpdateMaterialMsg(tokens, state, libraries.GetShadowMaterialLib());
       break;
     }
     case MessageTypes::kDeleteMaterial: {
-      HandleDeleteMaterialMsg(tokens, state, material_lib);
+      is_edited = HandleDeleteMaterialMsg(tokens, state, libraries.GetShadowMaterialLib());
       break;
     }
     case MessageTypes::kAddMaterialList: {
-      HandleAddMaterialListMsg(tokens, state, material_lib);
+      is_edited = HandleAddMaterialListMsg(tokens, state, libraries.GetShadowMaterialLib());
       break;
     }
     case MessageTypes::kUpdateMaterialList: {
-      HandleUpdateMaterialListMsg(tokens, state, material_lib);
+      is_edited = HandleUpdateMaterialListMsg(tokens, state, libraries.GetShadowMaterialLib());
       break;
     }
     case MessageTypes::kDeleteMaterialList: {
-      HandleDeleteMaterialListMsg(tokens, state, material_lib);
+      is_edited = HandleDeleteMaterialListMsg(tokens, state, libraries.GetShadowMaterialLib());
       break;
     }
     case MessageTypes::kDeleteAllMaterials: {
-      HandleDeleteAllMaterialsMsg(tokens, state, material_lib);
+      is_edited = HandleDeleteAllMaterialsMsg(tokens, state, libraries.GetShadowMaterialLib());
+      break;
+    }
+    case MessageTypes::kBeginLibraryUpdate: {
+#ifdef SENSINT_DEBUG
+      Log("UpdateConfig", "begin library update");
+#endif  // SENSINT_DEBUG
+      libraries.BeginUpdate();
+      break;
+    }
+    case MessageTypes::kCommitLibraryUpdate: {
+#ifdef SENSINT_DEBUG
+      Log("UpdateConfig", "commit library update");
+#endif  // SENSINT_DEBUG
+      libraries.EndUpdate();
+      break;
+    }
+    case MessageTypes::kSaveLibraries: {
+#ifdef SENSINT_DEBUG
+      Log("UpdateConfig", "save libraries");
+#endif  // SENSINT_DEBUG
+      state.should_save_libraries = true;
+      break;
+    }
+    case MessageTypes::kAbortLibraryUpdate: {
+#ifdef SENSINT_DEBUG
+      Log("UpdateConfig", "abort library update");
+#endif  // SENSINT_DEBUG
+      libraries.AbortUpdate();
       break;
     }
     case MessageTypes::kSelectGrainSequence: {
-      HandleSelectSequenceMsg(tokens, state, sequence_lib);
+      HandleSelectSequenceMsg(tokens, state, libraries.GetSequenceLib());
       break;
     }
     case MessageTypes::kAddGrainSequence: {
-      HandleAddSequenceMsg(tokens, state, sequence_lib);
+      is_edited = HandleAddSequenceMsg(tokens, state, libraries.GetShadowSequenceLib());
       break;
     }
     case MessageTypes::kUpdateGrainSequence: {
-      HandleUpdateSequenceMsg(tokens, state, sequence_lib);
+      is_edited = HandleUpdateSequenceMsg(tokens, state, libraries.GetShadowSequenceLib());
       break;
     }
     case MessageTypes::kDeleteGrainSequence: {
-      HandleDeleteSequenceMsg(tokens, state, sequence_lib);
+      is_edited = HandleDeleteSequenceMsg(tokens, state, libraries.GetShadowSequenceLib());
+      break;
+    }
+    case MessageTypes::kPatchGrainSequence: {
+      is_edited = HandlePatchSequenceMsg(tokens, state, libraries.GetShadowSequenceLib());
       break;
     }
     case MessageTypes::kAddGrainSequenceList: {
-      HandleAddSequenceListMsg(tokens, state, sequence_lib);
+      is_edited = HandleAddSequenceListMsg(tokens, state, libraries.GetShadowSequenceLib());
       break;
     }
     case MessageTypes::kUpdateGrainSequenceList: {
-      HandleUpdateSequenceListMsg(tokens, state, sequence_lib);
+      is_edited = HandleUpdateSequenceListMsg(tokens, state, libraries.GetShadowSequenceLib());
       break;
     }
     case MessageTypes::kDeleteGrainSequenceList: {
-      HandleDeleteSequenceListMsg(tokens, state, sequence_lib);
+      is_edited = HandleDeleteSequenceListMsg(tokens, state, libraries.GetShadowSequenceLib());
       break;
     }
     case MessageTypes::kDeleteAllGrainSequences: {
-      HandleDeleteAllSequencesMsg(tokens, state, sequence_lib);
+      is_edited = HandleDeleteAllSequencesMsg(tokens, state, libraries.GetShadowSequenceLib());
       break;
     }
     default: {
@@ -434,14 +584,19 @@ void UpdateConfig(const MessageTypes msg_type, const std::vector<std::string> &t
       break;
     }
   }
+  if (is_edited) {
+    libraries.MarkEdited();
+  }
+  ResolveHandles(state, libraries.GetMaterialLib(), libraries.GetSequenceLib());
 }
 
 bool CheckAndStartContinuousVibration(const int grain_idx, AugmentationState &state,
-                                      tactile_audio::MonoAudio &audio, MaterialLib &material_lib,
+                                      tactile_audio::MonoAudio &audio,
+                                      const MaterialLib &material_lib,
                                       const sensint::analog_sensor_t jitterThreshold) {
   using namespace sensint::tactile_audio;
-  if (state.current_sensor_value < state.closest_grain->pos_start ||
-      state.current_sensor_value > state.closest_grain->pos_end) {
+  if (state.current_sensor_value < state.closest_grain.pos_start ||
+      state.current_sensor_value > state.closest_grain.pos_end) {
     return false;
   }
   if (state.cv_was_triggered) {
@@ -455,33 +610,25 @@ bool CheckAndStartContinuousVibration(const int grain_idx, AugmentationState &st
   state.last_grain = state.closest_grain;
   state.cv_was_triggered = true;
 #ifdef SENSINT_DEBUG
-  Log("CheckAndStartContinuousVibration",
-      "entered continuous vibration - grain idx: " + String(grain_idx) +
-          " pos_start:" + String(state.closest_grain->pos_start) +
-          " pos_end:" + String(state.closest_grain->pos_end) +
-          " | sensor:" + String((int)state.current_sensor_value) +
-          " | mat:" + String((int)state.closest_grain->material_id),
-      DebugLevel::verbose);
+  LogTokenized<LogToken::kStartContinuousVibration>(
+      DebugLevel::verbose, grain_idx, state.closest_grain.pos_start,
+      state.closest_grain.pos_end, state.current_sensor_value, state.closest_grain.material_id);
 #endif  // SENSINT_DEBUG
   return true;
 }
 
 bool CheckAndStopContinuousVibration(const int grain_idx, AugmentationState &state,
                                      tactile_audio::MonoAudio &audio) {
-  if (state.cv_was_triggered && (state.current_sensor_value < state.last_grain->pos_start ||
-                                 state.current_sensor_value > state.last_grain->pos_end)) {
+  if (state.cv_was_triggered && (state.current_sensor_value < state.last_grain.pos_start ||
+                                 state.current_sensor_value > state.last_grain.pos_end)) {
     audio.envelope.noteOff();
     audio.raw_signal.amplitude(0.0);
     audio.is_playing = false;
     state.cv_was_triggered = false;
 #ifdef SENSINT_DEBUG
-    Log("CheckAndStopContinuousVibration",
-        "left continuous vibration - grain idx: " + String(grain_idx) +
-            " pos_start:" + String(state.closest_grain->pos_start) +
-            " pos_end:" + String(state.closest_grain->pos_end) +
-            " | sensor:" + String((int)state.current_sensor_value) +
-            " | mat:" + String((int)state.closest_grain->material_id),
-        DebugLevel::verbose);
+    LogTokenized<LogToken::kStopContinuousVibration>(
+        DebugLevel::verbose, grain_idx, state.closest_grain.pos_start,
+        state.closest_grain.pos_end, state.current_sensor_value, state.closest_grain.material_id);
 #endif  // SENSINT_DEBUG
     return true;
   }
@@ -489,13 +636,13 @@ bool CheckAndStopContinuousVibration(const int grain_idx, AugmentationState &sta
 }
 
 bool CheckAndStartGrain(const int grain_idx, AugmentationState &state,
-                        tactile_audio::MonoAudio &audio, MaterialLib &material_lib,
+                        tactile_audio::MonoAudio &audio, const MaterialLib &material_lib,
                         const sensint::analog_sensor_t jitterThreshold) {
   using namespace sensint::tactile_audio;
   // Once a grain has been triggered, the sensor needs to be moved/pressed/etc.
   // a bit before it allows new triggers (incl. retrigger).
   if (state.grain_was_triggered) {
-    auto distance = abs(state.closest_grain->pos_start - state.current_sensor_value);
+    auto distance = abs(state.closest_grain.pos_start - state.current_sensor_value);
     if (distance < jitterThreshold) {
       state.is_jitter = true;
       return false;
@@ -504,7 +651,7 @@ bool CheckAndStartGrain(const int grain_idx, AugmentationState &state,
       state.is_jitter = false;
     }
   }
-  if (state.closest_grain->pos_start != state.current_sensor_value) {
+  if (state.closest_grain.pos_start != state.current_sensor_value) {
     return false;
   }
   // A grain could have a very long duration. If the `allow_retrigger` flag is
@@ -520,16 +667,21 @@ bool CheckAndStartGrain(const int grain_idx, AugmentationState &state,
   state.last_grain = state.closest_grain;
   state.grain_was_triggered = true;
 #ifdef SENSINT_DEBUG
-  Log("CheckAndStartGrain",
-      "trigger grain - idx:" + String(grain_idx) +
-          " pos:" + String(state.closest_grain->pos_start) +
-          " | sensor:" + String((int)state.current_sensor_value) +
-          " | mat:" + String((int)state.closest_grain->material_id),
-      DebugLevel::verbose);
+  LogTokenized<LogToken::kStartGrain>(DebugLevel::verbose, grain_idx,
+                                      state.closest_grain.pos_start, state.current_sensor_value,
+                                      state.closest_grain.material_id);
 #endif  // SENSINT_DEBUG
   return true;
 }
 
+bool CheckAndStartClosestGrain(const int grain_idx, AugmentationState &state,
+                               tactile_audio::MonoAudio &audio, const MaterialLib &material_lib) {
+  if (state.closest_grain.pos_start != state.closest_grain.pos_end) {
+    return CheckAndStartContinuousVibration(grain_idx, state, audio, material_lib);
+  }
+  return CheckAndStartGrain(grain_idx, state, audio, material_lib);
+}
+
 bool CheckAndStopGrain(const int grain_idx, AugmentationState &state,
                        tactile_audio::MonoAudio &audio) {
   if (!state.current_material->grain_params.is_continuous && audio.is_playing &&
@@ -538,11 +690,9 @@ bool CheckAndStopGrain(const int grain_idx, AugmentationState &state,
     audio.is_playing = false;
     audio.play_time = 0;
 #ifdef SENSINT_DEBUG
-    Log("CheckAndStopGrain",
-        "stop grain - idx:" + String(grain_idx) + " pos:" + String(state.closest_grain->pos_start) +
-            " | sensor:" + String((int)state.current_sensor_value) +
-            " | mat:" + String((int)state.closest_grain->material_id),
-        DebugLevel::verbose);
+    LogTokenized<LogToken::kStopGrain>(DebugLevel::verbose, grain_idx,
+                                       state.closest_grain.pos_start, state.current_sensor_value,
+                                       state.closest_grain.material_id);
 #endif  // SENSINT_DEBUG
     return true;
   }
@@ -550,16 +700,16 @@ bool CheckAndStopGrain(const int grain_idx, AugmentationState &state,
 }
 
 bool CheckAndApplyMaterialChange(AugmentationState &state, tactile_audio::MonoAudio &audio,
-                                 MaterialLib &material_lib) {
+                                 const MaterialLib &material_lib) {
   if (state.should_reinitialize_material ||
-      state.closest_grain->material_id != state.last_grain->material_id) {
+      state.closest_grain.material_id != state.last_grain.material_id) {
     state.should_reinitialize_material = false;
-    auto mat_idx = material_lib.GetMaterialIndexByID(state.closest_grain->material_id);
-    if (mat_idx != -1) {
-      material_lib.GetMaterialByID(mat_idx, *state.current_material);
+    const auto handle = material_lib.GetMaterialHandle(state.closest_grain.material_id);
+    if (!handle.IsNull()) {
+      state.material = handle;
+      state.current_material = material_lib.GetMaterial(handle);
 #ifdef SENSINT_DEBUG
-      Log("CheckAndApplyMaterialChange",
-          "change to material " + String((int)state.current_material->id), DebugLevel::verbose);
+      LogTokenized<LogToken::kMaterialChange>(DebugLevel::verbose, state.current_material->id);
 #endif  // SENSINT_DEBUG
       ApplyGrainParameters(state.current_material->grain_params, audio);
       return true;
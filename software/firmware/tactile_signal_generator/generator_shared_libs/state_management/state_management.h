@@ -2,6 +2,7 @@
 #define __SENSINT_STATE_MANAGEMENT_H__
 
 #include <communication.h>
+#include <library_buffer.h>
 #include <material_lib.h>
 #include <sequence_lib.h>
 #include <tactile_audio.h>
@@ -13,16 +14,22 @@
 namespace sensint {
 
 struct AugmentationState {
-  // the currently selected grain sequence
-  GrainSequence *current_sequence = nullptr;
+  // the handle of the currently selected grain sequence in the sequence library
+  SequenceHandle sequence;
+  // the currently selected grain sequence, i.e. the resolved handle (see
+  // state_management::ResolveHandles)
+  const GrainSequenceView *current_sequence = nullptr;
   // the most recent sensor value
   analog_sensor_t current_sensor_value = 0;
-  // the closest grain from the current sensor value
-  Grain *closest_grain = nullptr;
+  // the closest grain from the current sensor value (a copy, since the grains
+  // are shifted in the arena when a sequence is deleted)
+  Grain closest_grain;
   // the last grain that was triggered
-  Grain *last_grain = nullptr;
-  // the most recent material used to play a grain
-  Material *current_material = nullptr;
+  Grain last_grain;
+  // the handle of the most recent material in the material library
+  MaterialHandle material;
+  // the most recent material used to play a grain, i.e. the resolved handle
+  const Material *current_material = nullptr;
   // If true a playing grain would be interrupted and a new one is started
   // immediately. If false the current grain will be played in full length which
   // might lead to "missed grains".
@@ -35,6 +42,9 @@ struct AugmentationState {
   bool grain_was_triggered = false;
   bool cv_was_triggered = false;
   bool should_update_config = false;
+  // the libraries are saved as soon as the augmentation is stopped (see
+  // communication::MessageTypes::kSaveLibraries)
+  bool should_save_libraries = false;
   bool should_send_sensor_data = false;
   bool should_augment = true;
   bool should_reinitialize_material = false;
@@ -42,6 +52,34 @@ struct AugmentationState {
 
 namespace state_management {
 
+/**
+ * @brief Select a grain sequence. The state refers to the sequence in the
+ * library, i.e. nothing is copied.
+ *
+ * @param state reference to the system's augmentation state
+ * @param handle handle of the sequence
+ * @param sequence_lib reference to the local sequence library
+ * @return true if the sequence was selected
+ * @return false if the handle is stale
+ */
+bool SelectSequence(AugmentationState &state, const SequenceHandle &handle,
+                    const SequenceLib &sequence_lib);
+
+/**
+ * @brief Resolve the handles of the state after the libraries were modified,
+ * because this might move the materials and sequences. A stale handle (i.e.
+ * the material or sequence was deleted or updated) is looked up again by its
+ * ID. If the ID does not exist anymore the default is used.
+ *
+ * @param state reference to the system's augmentation state
+ * @param material_lib reference to the local material library
+ * @param sequence_lib reference to the local sequence library
+ * @return true if all handles were valid
+ * @return false if a stale handle was replaced
+ */
+bool ResolveHandles(AugmentationState &state, const MaterialLib &material_lib,
+                    const SequenceLib &sequence_lib);
+
 /**
  * @brief Handle a message received from a controller device. This message is
  * used to start (activate) the augmentation. If no grain sequence was defined
@@ -67,8 +105,9 @@ void HandleStopAugmentationMsg(AugmentationState &state);
  * @param tokens parameters of the material
  * @param state reference to the system's augmentation state
  * @param material_lib reference to the local material library
+ * @return true if the library was edited
  */
-void HandleAddMaterialMsg(const std::vector<std::string> &tokens, AugmentationState &state,
+bool HandleAddMaterialMsg(const std::vector<std::string> &tokens, AugmentationState &state,
                           MaterialLib &material_lib);
 
 /**
@@ -80,8 +119,9 @@ void HandleAddMaterialMsg(const std::vector<std::string> &tokens, AugmentationSt
  * @param tokens parameters of the material
  * @param state reference to the system's augmentation state
  * @param material_lib reference to the local material library
+ * @return true if the library was edited
  */
-void HandleUpdateMaterialMsg(const std::vector<std::string> &tokens, AugmentationState &state,
+bool HandleUpdateMaterialMsg(const std::vector<std::string> &tokens, AugmentationState &state,
                              MaterialLib &material_lib);
 
 /**
@@ -93,46 +133,61 @@ void HandleUpdateMaterialMsg(const std::vector<std::string> &tokens, Augmentatio
  * @param tokens parameters of the material
  * @param state reference to the system's augmentation state
  * @param material_lib reference to the local material library
+ * @return true if the library was edited
  */
-void HandleDeleteMaterialMsg(const std::vector<std::string> &tokens, AugmentationState &state,
+bool HandleDeleteMaterialMsg(const std::vector<std::string> &tokens, AugmentationState &state,
                              MaterialLib &material_lib);
 
+/**
+ * @brief Parse the IDs of a message which deletes a list of materials or
+ * sequences, i.e. the tokens are ordered as follows: (0, msg_type, num_ids, ids)
+ *
+ * @param tokens tokenized message (i.e. parameters as strings)
+ * @param ids data structure for the IDs
+ * @return true if parsing was successful
+ */
+bool ParseIdList(const std::vector<std::string> &tokens, std::vector<uint8_t> &ids);
+
 /**
  * @brief Handle a message received from a controller device. This message is
- * used to add a list of materials to the local material library. If a material
- * with the same ID exists already in the material library it will not be added.
+ * used to add a list of materials to the local material library. The list is
+ * applied as a single batch, i.e. if a material with the same ID exists already
+ * in the material library (or appears twice in the list) no material is added.
  *
  * @param tokens tokenized message (i.e. parameters as strings)
  * @param state reference to the system's augmentation state
  * @param material_lib reference to the local material library
+ * @return true if the library was edited
  */
-void HandleAddMaterialListMsg(const std::vector<std::string> &tokens, AugmentationState &state,
+bool HandleAddMaterialListMsg(const std::vector<std::string> &tokens, AugmentationState &state,
                               MaterialLib &material_lib);
 
 /**
  * @brief Handle a message received from a controller device. This message is
- * used to update a list of materials to the local material library. If one of
- * the materials with the specified ID does not exist in the material library it
- * will not be modified (nor added).
+ * used to update a list of materials to the local material library. The list is
+ * applied as a single batch, i.e. if one of the materials with the specified ID
+ * does not exist in the material library no material is modified (nor added).
  *
  * @param tokens tokenized message (i.e. parameters as strings)
  * @param state reference to the system's augmentation state
  * @param material_lib reference to the local material library
+ * @return true if the library was edited
  */
-void HandleUpdateMaterialListMsg(const std::vector<std::string> &tokens, AugmentationState &state,
+bool HandleUpdateMaterialListMsg(const std::vector<std::string> &tokens, AugmentationState &state,
                                  MaterialLib &material_lib);
 
 /**
  * @brief Handle a message received from a controller device. This message is
- * used to delete a list of materials from the local material library. If one of
- * the materials with the specified ID does not exist in the material library it
- * will not be deleted.
+ * used to delete a list of materials from the local material library. The list
+ * is applied as a single batch, i.e. if one of the materials with the specified
+ * ID does not exist in the material library no material is deleted.
  *
  * @param tokens tokenized message (i.e. parameters as strings)
  * @param state reference to the system's augmentation state
  * @param material_lib reference to the local material library
+ * @return true if the library was edited
  */
-void HandleDeleteMaterialListMsg(const std::vector<std::string> &tokens, AugmentationState &state,
+bool HandleDeleteMaterialListMsg(const std::vector<std::string> &tokens, AugmentationState &state,
                                  MaterialLib &material_lib);
 
 /**
@@ -143,8 +198,9 @@ void HandleDeleteMaterialListMsg(const std::vector<std::string> &tokens, Augment
  * @param tokens tokenized message (i.e. parameters as strings)
  * @param state reference to the system's augmentation state
  * @param material_lib reference to the local material library
+ * @return true if the library was edited
  */
-void HandleDeleteAllMaterialsMsg(const std::vector<std::string> &tokens, AugmentationState &state,
+bool HandleDeleteAllMaterialsMsg(const std::vector<std::string> &tokens, AugmentationState &state,
                                  MaterialLib &material_lib);
 
 /**
@@ -156,8 +212,9 @@ void HandleDeleteAllMaterialsMsg(const std::vector<std::string> &tokens, Augment
  * @param tokens parameters of the material
  * @param state reference to the system's augmentation state
  * @param sequence_lib reference to the local sequence library
+ * @return true if the library was edited
  */
-void HandleAddSequenceMsg(const std::vector<std::string> &tokens, AugmentationState &state,
+bool HandleAddSequenceMsg(const std::vector<std::string> &tokens, AugmentationState &state,
                           SequenceLib &sequence_lib);
 
 /**
@@ -169,8 +226,9 @@ void HandleAddSequenceMsg(const std::vector<std::string> &tokens, AugmentationSt
  * @param tokens parameters of the material
  * @param state reference to the system's augmentation state
  * @param sequence_lib reference to the local sequence library
+ * @return true if the library was edited
  */
-void HandleUpdateSequenceMsg(const std::vector<std::string> &tokens, AugmentationState &state,
+bool HandleUpdateSequenceMsg(const std::vector<std::string> &tokens, AugmentationState &state,
                              SequenceLib &sequence_lib);
 
 /**
@@ -182,47 +240,67 @@ void HandleUpdateSequenceMsg(const std::vector<std::string> &tokens, Augmentatio
  * @param tokens parameters of the material
  * @param state reference to the system's augmentation state
  * @param sequence_lib reference to the local sequence library
+ * @return true if the library was edited
  */
-void HandleDeleteSequenceMsg(const std::vector<std::string> &tokens, AugmentationState &state,
+bool HandleDeleteSequenceMsg(const std::vector<std::string> &tokens, AugmentationState &state,
                              SequenceLib &sequence_lib);
 
 /**
  * @brief Handle a message received from a controller device. This message is
- * used to add a list of sequences to the local sequence library. If a Sequence
- * with the same ID exists already in the sequence library it will not be
+ * used to replace, insert, or remove a range of grains of a single sequence in
+ * the local sequence library, i.e. an edit costs only the changed grains. If the
+ * Sequence does not exist or the patched grains are not ordered the sequence
+ * will not be modified.
+ *
+ * @param tokens tokenized message (i.e. parameters as strings)
+ * @param state reference to the system's augmentation state
+ * @param sequence_lib reference to the local sequence library
+ * @return true if the library was edited
+ */
+bool HandlePatchSequenceMsg(const std::vector<std::string> &tokens, AugmentationState &state,
+                            SequenceLib &sequence_lib);
+
+/**
+ * @brief Handle a message received from a controller device. This message is
+ * used to add a list of sequences to the local sequence library. The list is
+ * applied as a single batch, i.e. if a Sequence with the same ID exists already
+ * in the sequence library (or the grain arena is too small) no sequence is
  * added.
  *
  * @param tokens parameters of the material
  * @param state reference to the system's augmentation state
  * @param sequence_lib reference to the local sequence library
+ * @return true if the library was edited
  */
-void HandleAddSequenceListMsg(const std::vector<std::string> &tokens, AugmentationState &state,
+bool HandleAddSequenceListMsg(const std::vector<std::string> &tokens, AugmentationState &state,
                               SequenceLib &sequence_lib);
 
 /**
  * @brief Handle a message received from a controller device. This message is
- * used to update a list of sequences in the local sequence library. If a
- * Sequence with the same ID does not exist in the sequence library it will not
- * be modified (nor added).
+ * used to update a list of sequences in the local sequence library. The list is
+ * applied as a single batch, i.e. if a Sequence with the same ID does not exist
+ * in the sequence library no sequence is modified (nor added).
  *
  * @param tokens parameters of the material
  * @param state reference to the system's augmentation state
  * @param sequence_lib reference to the local sequence library
+ * @return true if the library was edited
  */
-void HandleUpdateSequenceListMsg(const std::vector<std::string> &tokens, AugmentationState &state,
+bool HandleUpdateSequenceListMsg(const std::vector<std::string> &tokens, AugmentationState &state,
                                  SequenceLib &sequence_lib);
 
 /**
  * @brief Handle a message received from a controller device. This message is
- * used to delete a list of sequences from the local sequence library. If a
- * Sequence with the same ID does not exist in the sequence library it will not
- * be deleted.
+ * used to delete a list of sequences from the local sequence library. The list
+ * is applied as a single batch, i.e. if a Sequence with the same ID does not
+ * exist in the sequence library no sequence is deleted.
  *
  * @param tokens parameters of the material
  * @param state reference to the system's augmentation state
  * @param sequence_lib reference to the local sequence library
+ * @return true if the library was edited
  */
-void HandleDeleteSequenceListMsg(const std::vector<std::string> &tokens, AugmentationState &state,
+bool HandleDeleteSequenceListMsg(const std::vector<std::string> &tokens, AugmentationState &state,
                                  SequenceLib &sequence_lib);
 
 /**
@@ -233,8 +311,9 @@ void HandleDeleteSequenceListMsg(const std::vector<std::string> &tokens, Augment
  * @param tokens tokenized message (i.e. parameters as strings)
  * @param state reference to the system's augmentation state
  * @param sequence_lib reference to the local sequence library
+ * @return true if the library was edited
  */
-void HandleDeleteAllSequencesMsg(const std::vector<std::string> &tokens, AugmentationState &state,
+bool HandleDeleteAllSequencesMsg(const std::vector<std::string> &tokens, AugmentationState &state,
                                  SequenceLib &sequence_lib);
 
 /**
@@ -246,21 +325,35 @@ void HandleDeleteAllSequencesMsg(const std::vector<std::string> &tokens, Augment
  * @param sequence_lib reference to the local sequence library
  */
 void HandleSelectSequenceMsg(const std::vector<std::string> &tokens, AugmentationState &state,
-                             SequenceLib &sequence_lib);
+                             const SequenceLib &sequence_lib);
+
+/**
+ * @brief Renew the state after the libraries were committed (see
+ * LibraryBuffer::Commit). The handles are resolved against the new active
+ * libraries and the material is reapplied, because it might have been updated.
+ *
+ * @param state reference to the system's augmentation state
+ * @param libraries reference to the local libraries
+ */
+void HandleLibraryCommit(AugmentationState &state, const LibraryBuffer &libraries);
 
 /**
  * @brief Handle a message (string) received from a controller device. This
- * function forwards the tokenized message to the dedicated handler.
+ * function forwards the tokenized message to the dedicated handler. Afterwards
+ * the handles of the state are resolved (see ResolveHandles).
+ *
+ * //! All edits of the libraries are applied to the shadow libraries, i.e. the
+ * //! state keeps playing the active ones until the libraries are committed (see
+ * //! HandleLibraryCommit).
  *
  * @param msg_type the received type of message
  * @param tokens tokenized message (i.e. parameters as strings)
  * @param state reference to the system's augmentation state
- * @param material_lib reference to the local material library
- * @param sequence_lib reference to the local sequence library
+ * @param libraries reference to the local libraries
  */
 void UpdateConfig(const communication::MessageTypes msg_type,
                   const std::vector<std::string> &tokens, AugmentationState &state,
-                  MaterialLib &material_lib, SequenceLib &sequence_lib);
+                  LibraryBuffer &libraries);
 
 /**
  * @brief Check if a continuous vibration should be started.
@@ -275,7 +368,8 @@ void UpdateConfig(const communication::MessageTypes msg_type,
  * @return false if no cv has been started
  */
 bool CheckAndStartContinuousVibration(const int grain_idx, AugmentationState &state,
-                                      tactile_audio::MonoAudio &audio, MaterialLib &material_lib,
+                                      tactile_audio::MonoAudio &audio,
+                                      const MaterialLib &material_lib,
                                       const sensint::analog_sensor_t jitterThreshold = 2);
 
 /**
@@ -304,9 +398,25 @@ bool CheckAndStopContinuousVibration(const int grain_idx, AugmentationState &sta
  * @return false if no grain has been stopped
  */
 bool CheckAndStartGrain(const int grain_idx, AugmentationState &state,
-                        tactile_audio::MonoAudio &audio, MaterialLib &material_lib,
+                        tactile_audio::MonoAudio &audio, const MaterialLib &material_lib,
                         const sensint::analog_sensor_t jitterThreshold = 2);
 
+/**
+ * @brief Check if the closest grain of the sequence should be started, which is
+ * either a continuous vibration (i.e. a range of sensor values) or a single
+ * grain.
+ *
+ * @param grain_idx
+ * @param state
+ * @param audio
+ * @param material_lib
+ *
+ * @return true if a grain or a cv has been started
+ * @return false if nothing has been started
+ */
+bool CheckAndStartClosestGrain(const int grain_idx, AugmentationState &state,
+                               tactile_audio::MonoAudio &audio, const MaterialLib &material_lib);
+
 /**
  * @brief  Check if a new grain should be stopped.
  *
@@ -331,7 +441,7 @@ bool CheckAndStopGrain(const int grain_idx, AugmentationState &state,
  * @return false if no material was applied
  */
 bool CheckAndApplyMaterialChange(AugmentationState &state, tactile_audio::MonoAudio &audio,
-                                 MaterialLib &material_lib);
+                                 const MaterialLib &material_lib);
 
 }  // namespace state_management
 }  // namespace sensint
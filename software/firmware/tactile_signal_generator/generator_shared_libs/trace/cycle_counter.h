@@ -0,0 +1,50 @@
+#ifndef __SENSINT_CYCLE_COUNTER_H__
+#define __SENSINT_CYCLE_COUNTER_H__
+
+#include <cstdint>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <chrono>
+#endif  // ARDUINO
+
+namespace sensint {
+namespace cycle_counter {
+
+/**
+ * @brief Access to the DWT cycle counter of the Cortex-M. On the host, the counter is emulated
+ * with a steady clock of nanoseconds.
+ *
+ * //! The counter wraps around after 2^32 cycles (about 7s at 600MHz), hence only differences of
+ * //! shorter durations are valid.
+ */
+#ifdef ARDUINO
+static constexpr uint32_t kFrequency = F_CPU;
+
+inline void Enable() {
+  ARM_DEMCR |= ARM_DEMCR_TRCENA;
+  ARM_DWT_CTRL |= ARM_DWT_CTRL_CYCCNTENA;
+}
+
+inline uint32_t Get() { return ARM_DWT_CYCCNT; }
+#else
+static constexpr uint32_t kFrequency = 1000000000;
+
+inline void Enable() {}
+
+inline uint32_t Get() {
+  using namespace std::chrono;
+  return static_cast<uint32_t>(
+      duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+}
+#endif  // ARDUINO
+
+inline uint32_t ToMicroseconds(const uint64_t cycles) {
+  return static_cast<uint32_t>(cycles / (kFrequency / 1000000));
+}
+
+}  // namespace cycle_counter
+}  // namespace sensint
+
+#endif  // __SENSINT_CYCLE_COUNTER_H__
@@ -0,0 +1,99 @@
+#include "latency_trace.h"
+
+#include "cycle_counter.h"
+
+namespace sensint {
+namespace latency_trace {
+
+LatencyTracer::LatencyTracer() {}
+
+LatencyTracer::~LatencyTracer() {}
+
+void LatencyTracer::Init() { cycle_counter::Enable(); }
+
+void LatencyTracer::Stamp(const uint8_t channel, const Stage stage) {
+  auto &trace = pending_[channel];
+  trace.cycles[static_cast<uint8_t>(stage)] = cycle_counter::Get();
+  if (stage != Stage::kNoteOn) {
+    return;
+  }
+  trace.channel = channel;
+  AudioNoInterrupts();
+  if (is_armed_[channel]) {
+    // the previous grain never produced a non-zero sample
+    dropped_++;
+  }
+  armed_[channel] = trace;
+  is_armed_[channel] = true;
+  AudioInterrupts();
+}
+
+void LatencyTracer::CompleteTrace(const uint8_t channel, const uint32_t cycles,
+                                  const uint16_t first_sample) {
+  auto &trace = armed_[channel];
+  trace.cycles[static_cast<uint8_t>(Stage::kFirstAudioBlock)] = cycles;
+  trace.first_sample = first_sample;
+  is_armed_[channel] = false;
+  if (count_ == kCapacity) {
+    dropped_++;
+  } else {
+    count_++;
+  }
+  traces_[head_] = trace;
+  head_ = (head_ + 1) % kCapacity;
+}
+
+/**
+ * The traces are copied one by one, hence the audio interrupt is only blocked for a short time.
+ */
+void LatencyTracer::Dump() {
+  AudioNoInterrupts();
+  auto num_traces = count_;
+  auto dropped = dropped_;
+  dropped_ = 0;
+  AudioInterrupts();
+
+  Serial.printf("<T,%lu,%lu,%u,%u,%lu>\n", static_cast<unsigned long>(cycle_counter::kFrequency),
+                static_cast<unsigned long>(AUDIO_SAMPLE_RATE_EXACT), AUDIO_BLOCK_SAMPLES,
+                static_cast<unsigned>(num_traces), static_cast<unsigned long>(dropped));
+  for (size_t i = 0; i < num_traces; i++) {
+    AudioNoInterrupts();
+    if (count_ == 0) {
+      AudioInterrupts();
+      break;
+    }
+    Trace trace = traces_[(head_ + kCapacity - count_) % kCapacity];
+    count_--;
+    AudioInterrupts();
+
+    Serial.printf("<t,%u", trace.channel);
+    for (uint8_t stage = 0; stage < kNumStages; stage++) {
+      Serial.printf(",%lu", static_cast<unsigned long>(trace.cycles[stage]));
+    }
+    Serial.printf(",%u>\n", trace.first_sample);
+  }
+}
+
+AudioTraceProbe::AudioTraceProbe(LatencyTracer &tracer)
+    : AudioStream(kNumChannels, input_queue_array_), tracer_(tracer) {}
+
+void AudioTraceProbe::update(void) {
+  for (uint8_t channel = 0; channel < kNumChannels; channel++) {
+    audio_block_t *block = receiveReadOnly(channel);
+    if (!block) {
+      continue;
+    }
+    if (tracer_.is_armed_[channel]) {
+      for (uint16_t i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
+        if (block->data[i] != 0) {
+          tracer_.CompleteTrace(channel, cycle_counter::Get(), i);
+          break;
+        }
+      }
+    }
+    release(block);
+  }
+}
+
+}  // namespace latency_trace
+}  // namespace sensint
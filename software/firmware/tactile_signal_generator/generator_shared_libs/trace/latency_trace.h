@@ -0,0 +1,133 @@
+#ifndef __SENSINT_LATENCY_TRACE_H__
+#define __SENSINT_LATENCY_TRACE_H__
+
+#include <Arduino.h>
+#include <Audio.h>
+
+namespace sensint {
+namespace latency_trace {
+
+/**
+ * @brief The stages between a sensor reading and the audio output. Every stage is stamped with
+ * the cycle counter of the CPU.
+ *
+ *  ┌────────────┐   ┌────────────┐   ┌────────────┐   ┌─────────┐   ┌─────────────┐
+ *  │ ADC sample ├──>│ filter out ├──>│ grain idx  ├──>│ noteOn  ├──>│ first block │
+ *  └────────────┘   └────────────┘   └────────────┘   └─────────┘   └─────────────┘
+ *
+ * //! The ADC stage is stamped before the conversion starts, thus the filter stage includes the
+ * //! conversion time.
+ */
+enum class Stage : uint8_t {
+  kAdcSample = 0,
+  kFilterOutput,
+  kGrainResolved,
+  kNoteOn,
+  kFirstAudioBlock,
+  kNumStages
+};
+
+static constexpr uint8_t kNumStages = static_cast<uint8_t>(Stage::kNumStages);
+static constexpr uint8_t kNumChannels = 2;
+static constexpr uint8_t kLeftChannel = 0;
+static constexpr uint8_t kRightChannel = 1;
+static constexpr size_t kCapacity = 128;
+//! the traces are dumped when this character is received via serial
+static constexpr int kDumpCommand = 't';
+
+/**
+ * @brief The timestamps of a single grain from the sensor reading to the audio block that
+ * contains its first non-zero sample.
+ */
+struct Trace {
+  uint32_t cycles[kNumStages] = {0};
+  //! index of the first non-zero sample in the audio block
+  uint16_t first_sample = 0;
+  uint8_t channel = 0;
+};
+
+/**
+ * @brief Collects the timestamps of the stages of every triggered grain in a fixed ring buffer.
+ *
+ * The stages up to @ref Stage::kNoteOn are stamped in the loop and overwritten in every
+ * iteration. When a grain is started, the timestamps are handed over to the
+ * @ref AudioTraceProbe, which stamps the audio block containing the first non-zero sample and
+ * completes the trace.
+ *
+ * //! The ring buffer is written in the audio interrupt only. The loop accesses it with the audio
+ * //! interrupt disabled.
+ */
+class LatencyTracer {
+ public:
+  LatencyTracer();
+  ~LatencyTracer();
+
+  /**
+   * @brief Enable the cycle counter of the CPU. This should be called once in the setup()
+   * function.
+   */
+  void Init();
+
+  /**
+   * @brief Stamp a stage of the current loop iteration. Stamping @ref Stage::kNoteOn hands the
+   * trace over to the audio probe, which replaces a trace still waiting for its audio block.
+   *
+   * @param channel @ref kLeftChannel or @ref kRightChannel
+   * @param stage the stage that was reached
+   */
+  void Stamp(const uint8_t channel, const Stage stage);
+
+  /**
+   * @brief Print all completed traces to the serial port and clear the ring buffer.
+   *
+   * The header frame contains the clock of the CPU, the sample rate, the number of samples per
+   * audio block, the number of traces, and the number of traces that were overwritten or replaced
+   * before they were dumped:
+   * <T,cpu_hz,sample_rate,block_samples,num_traces,dropped>
+   *
+   * Every trace is sent as a frame of raw cycle counts:
+   * <t,channel,adc,filter,grain,note_on,first_block,first_sample>
+   */
+  void Dump();
+
+ private:
+  friend class AudioTraceProbe;
+
+  /**
+   * @brief Complete the armed trace of the channel. This is called in the audio interrupt.
+   */
+  void CompleteTrace(const uint8_t channel, const uint32_t cycles, const uint16_t first_sample);
+
+  Trace pending_[kNumChannels];
+  Trace armed_[kNumChannels];
+  volatile bool is_armed_[kNumChannels] = {false};
+
+  Trace traces_[kCapacity];
+  size_t head_ = 0;
+  size_t count_ = 0;
+  uint32_t dropped_ = 0;
+};
+
+/**
+ * @brief An audio object without output that looks for the first non-zero sample of an armed
+ * trace. It needs to be created after the audio objects it is connected to, so that it is updated
+ * after them.
+ *
+ * //! The block is stamped when it is rendered. The output object plays it with the next block,
+ * //! which adds the duration of one audio block.
+ */
+class AudioTraceProbe : public AudioStream {
+ public:
+  explicit AudioTraceProbe(LatencyTracer &tracer);
+
+  virtual void update(void);
+
+ private:
+  LatencyTracer &tracer_;
+  audio_block_t *input_queue_array_[kNumChannels];
+};
+
+}  // namespace latency_trace
+}  // namespace sensint
+
+#endif  // __SENSINT_LATENCY_TRACE_H__
@@ -0,0 +1,118 @@
+#include "loop_profiler.h"
+
+namespace sensint {
+namespace loop_profiler {
+
+namespace {
+static const char *const kSectionNames[kNumSections] = {
+    "loop", "sensor A", "sensor B", "augmentation", "update config", "control pins"};
+
+uint8_t GetHistogramBucket(const uint32_t microseconds) {
+  uint8_t bucket = 0;
+  uint32_t limit = 1;
+  while (bucket < kNumHistogramBuckets - 1 && microseconds >= limit) {
+    bucket++;
+    limit <<= 1;
+  }
+  return bucket;
+}
+
+uint16_t Saturate(const uint32_t value) {
+  return static_cast<uint16_t>((value > UINT16_MAX) ? UINT16_MAX : value);
+}
+}  // namespace
+
+LoopProfiler::LoopProfiler() {}
+
+LoopProfiler::~LoopProfiler() {}
+
+void LoopProfiler::Reset() {
+  for (auto &section : sections_) {
+    section = SectionStatistics();
+  }
+  last_loop_start_ = 0;
+  loop_period_sum_ = 0;
+  loop_periods_ = 0;
+}
+
+void LoopProfiler::Add(const Section section, const uint32_t start, const uint32_t cycles) {
+  auto &statistics = sections_[static_cast<uint8_t>(section)];
+  if (section == Section::kLoop) {
+    if (statistics.count > 0) {
+      loop_period_sum_ += start - last_loop_start_;
+      loop_periods_++;
+    }
+    last_loop_start_ = start;
+  }
+  statistics.count++;
+  statistics.sum += cycles;
+  if (cycles < statistics.min) {
+    statistics.min = cycles;
+  }
+  if (cycles > statistics.max) {
+    statistics.max = cycles;
+  }
+  statistics.histogram[GetHistogramBucket(cycle_counter::ToMicroseconds(cycles))]++;
+}
+
+float LoopProfiler::GetLoopFrequency() const {
+  if (loop_period_sum_ == 0) {
+    return 0.f;
+  }
+  return static_cast<float>(loop_periods_) * cycle_counter::kFrequency / loop_period_sum_;
+}
+
+const SectionStatistics &LoopProfiler::GetStatistics(const Section section) const {
+  return sections_[static_cast<uint8_t>(section)];
+}
+
+LoopProfileSummary LoopProfiler::GetSummary() const {
+  LoopProfileSummary summary;
+  summary.loops = sections_[static_cast<uint8_t>(Section::kLoop)].count;
+  summary.loop_frequency = static_cast<uint32_t>(GetLoopFrequency() * 10.f);
+  for (uint8_t i = 0; i < kNumSections; i++) {
+    const auto &statistics = sections_[i];
+    summary.mean[i] =
+        (statistics.count > 0)
+            ? Saturate(cycle_counter::ToMicroseconds(statistics.sum / statistics.count))
+            : 0;
+    summary.max[i] = Saturate(cycle_counter::ToMicroseconds(statistics.max));
+  }
+  return summary;
+}
+
+#ifdef ARDUINO
+void LoopProfiler::Print() const {
+  Serial.println("\n============================================");
+  Serial.printf("loop: %.1f Hz (%lu loops)\n", GetLoopFrequency(),
+                static_cast<unsigned long>(sections_[0].count));
+  Serial.println("--------------------------------------------");
+  Serial.println("section          count   min[us]  mean[us]   max[us]");
+  for (uint8_t i = 0; i < kNumSections; i++) {
+    const auto &statistics = sections_[i];
+    if (statistics.count == 0) {
+      Serial.printf("%-13s %8d         -         -         -\n", kSectionNames[i], 0);
+      continue;
+    }
+    Serial.printf("%-13s %8lu %9lu %9lu %9lu\n", kSectionNames[i],
+                  static_cast<unsigned long>(statistics.count),
+                  static_cast<unsigned long>(cycle_counter::ToMicroseconds(statistics.min)),
+                  static_cast<unsigned long>(
+                      cycle_counter::ToMicroseconds(statistics.sum / statistics.count)),
+                  static_cast<unsigned long>(cycle_counter::ToMicroseconds(statistics.max)));
+  }
+  Serial.println("--------------------------------------------");
+  Serial.println("histogram [us]: <1, <2, <4, ..., >=16384");
+  for (uint8_t i = 0; i < kNumSections; i++) {
+    Serial.printf("%-13s", kSectionNames[i]);
+    for (const auto count : sections_[i].histogram) {
+      Serial.printf(" %lu", static_cast<unsigned long>(count));
+    }
+    Serial.println();
+  }
+  Serial.println("============================================\n");
+}
+#endif  // ARDUINO
+
+}  // namespace loop_profiler
+}  // namespace sensint
@@ -0,0 +1,133 @@
+#ifndef __SENSINT_LOOP_PROFILER_H__
+#define __SENSINT_LOOP_PROFILER_H__
+
+#include <cstddef>
+#include <cstdint>
+
+#include "cycle_counter.h"
+
+namespace sensint {
+namespace loop_profiler {
+
+/**
+ * @brief The sections of the loop() function of the signal generator. The loop itself is a
+ * section, too, which is used to measure the loop frequency.
+ */
+enum class Section : uint8_t {
+  kLoop = 0,
+  kSensorA,
+  kSensorB,
+  kAugmentation,
+  kUpdateConfig,
+  kControlPins,
+  kNumSections
+};
+
+static constexpr uint8_t kNumSections = static_cast<uint8_t>(Section::kNumSections);
+//! bucket 0 counts durations below 1us, bucket i (i > 0) durations of [2^(i-1), 2^i) us, and the
+//! last bucket all longer durations
+static constexpr uint8_t kNumHistogramBuckets = 16;
+//! the profile is printed when this character is received via serial
+static constexpr int kReportCommand = 'p';
+
+/**
+ * @brief The binary summary of the profile which is sent via I2C on request (see
+ * communication::kLoopProfileRegister). All durations are given in microseconds.
+ *
+ * //! The size must not exceed the I2C buffer of 32 bytes.
+ */
+struct __attribute__((packed)) LoopProfileSummary {
+  uint32_t loops;
+  //! loop frequency in 1/10 Hz
+  uint32_t loop_frequency;
+  uint16_t mean[kNumSections];
+  uint16_t max[kNumSections];
+};
+static_assert(sizeof(LoopProfileSummary) <= 32, "the summary must fit into the I2C buffer");
+
+struct SectionStatistics {
+  uint32_t count = 0;
+  uint32_t min = UINT32_MAX;
+  uint32_t max = 0;
+  uint64_t sum = 0;
+  uint32_t histogram[kNumHistogramBuckets] = {0};
+};
+
+/**
+ * @brief Collects the durations (in cycles) of the sections of the loop. The statistics are
+ * collected since the last reset.
+ *
+ * Use @ref SENSINT_PROFILE_SECTION to profile a scope. The macro is empty unless the profiler is
+ * enabled with SENSINT_PROFILE=1, hence it has no costs in the default build.
+ */
+class LoopProfiler {
+ public:
+  LoopProfiler();
+  ~LoopProfiler();
+
+  void Reset();
+
+  /**
+   * @brief Add the duration of a section.
+   *
+   * @param section the profiled section
+   * @param start cycle count at the start of the section
+   * @param cycles duration of the section
+   */
+  void Add(const Section section, const uint32_t start, const uint32_t cycles);
+
+  /**
+   * @brief The loop frequency is calculated from the time between the starts of the loops.
+   *
+   * @return loop frequency in Hz
+   */
+  float GetLoopFrequency() const;
+
+  const SectionStatistics &GetStatistics(const Section section) const;
+
+  LoopProfileSummary GetSummary() const;
+
+#ifdef ARDUINO
+  /**
+   * @brief Print the statistics and the histograms of all sections to the serial port.
+   */
+  void Print() const;
+#endif  // ARDUINO
+
+ private:
+  SectionStatistics sections_[kNumSections];
+  uint32_t last_loop_start_ = 0;
+  uint64_t loop_period_sum_ = 0;
+  uint32_t loop_periods_ = 0;
+};
+
+/**
+ * @brief Adds the duration of the enclosing scope to the profiler.
+ */
+class ScopedSection {
+ public:
+  ScopedSection(LoopProfiler &profiler, const Section section)
+      : profiler_(profiler), section_(section), start_(cycle_counter::Get()) {}
+  ~ScopedSection() { profiler_.Add(section_, start_, cycle_counter::Get() - start_); }
+
+ private:
+  LoopProfiler &profiler_;
+  const Section section_;
+  const uint32_t start_;
+};
+
+}  // namespace loop_profiler
+}  // namespace sensint
+
+#define SENSINT_PROFILE_CONCAT_INNER(a, b) a##b
+#define SENSINT_PROFILE_CONCAT(a, b) SENSINT_PROFILE_CONCAT_INNER(a, b)
+
+#ifdef SENSINT_LOOP_PROFILER
+#define SENSINT_PROFILE_SECTION(profiler, section)                                    \
+  sensint::loop_profiler::ScopedSection SENSINT_PROFILE_CONCAT(profile_section_, __LINE__)( \
+      profiler, section)
+#else
+#define SENSINT_PROFILE_SECTION(profiler, section)
+#endif  // SENSINT_LOOP_PROFILER
+
+#endif  // __SENSINT_LOOP_PROFILER_H__
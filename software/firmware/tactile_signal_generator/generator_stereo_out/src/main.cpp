@@ -17,6 +17,13 @@
 #include <global_settings.h>
 #include <helper.h>
 #include <i2c.h>
+#ifdef SENSINT_LATENCY_TRACE
+#include <latency_trace.h>
+#endif  // SENSINT_LATENCY_TRACE
+#include <library_buffer.h>
+#include <library_image.h>
+#include <library_storage.h>
+#include <loop_profiler.h>
 #include <material_lib.h>
 #include <sequence_lib.h>
 #include <state_management.h>
@@ -62,15 +69,44 @@ sensint::tactile_audio::StereoAudioChain signal_chain;
 //   |    \____/        |        \____/     |
 //   |__________________|___________________|
 
+#ifdef SENSINT_LATENCY_TRACE
+// The probe is created after the signal chain, thus it is updated after the envelopes which feed
+// the output (see SetupAudio).
+latency_trace::LatencyTracer tracer;
+latency_trace::AudioTraceProbe trace_probe(tracer);
+AudioConnection trace_cord_left(signal_chain.audio_left.envelope, 0, trace_probe,
+                                latency_trace::kLeftChannel);
+AudioConnection trace_cord_right(signal_chain.audio_right.envelope, 0, trace_probe,
+                                 latency_trace::kRightChannel);
+#endif  // SENSINT_LATENCY_TRACE
+
+#ifdef SENSINT_LOOP_PROFILER
+loop_profiler::LoopProfiler profiler;
+// The summary is published by the loop and read by the I2C interrupt, hence it is double
+// buffered. It covers the time since the previous read of the controller.
+SerializableStruct<loop_profiler::LoopProfileSummary> loop_profiles[2];
+volatile uint8_t loop_profile_idx = 0;
+volatile bool is_loop_profile_selected = false;
+volatile bool was_loop_profile_read = false;
+constexpr uint32_t kLoopProfilePublishPeriod = 100;  // [ms]
+elapsedMillis loop_profile_timer;
+#endif  // SENSINT_LOOP_PROFILER
+
 // augmentation
-MaterialLib material_lib;
-SequenceLib sequence_lib;
+LibraryBuffer libraries;
+LibraryStorage library_storage;
+uint32_t presets_crc = 0;
 AugmentationState state_a;
 AugmentationState state_b;
 
 // sensor
 sensor::AnalogSensor sensor_a;
 sensor::AnalogSensor sensor_b;
+#if SENSINT_SENSOR == 0  // FSR
+constexpr float kSensorFilterWeight = 0.015;
+#else   // slider, potentiometer
+constexpr float kSensorFilterWeight = sensor::AnalogSensor::kDefaultFilterWeight;
+#endif  // SENSINT_SENSOR
 
 SerializableStruct<Vector2D<analog_sensor_t>> sensor_data = {.data = {.x = 0, .y = 0}};
 
@@ -95,6 +131,15 @@ inline void SetupAugmentation() __attribute__((always_inline));
 inline void LoadPresets() __attribute__((always_inline));
 inline void HandleAugmentation() __attribute__((always_inline));
 inline void UpdateConfig() __attribute__((always_inline));
+inline void CommitLibraries() __attribute__((always_inline));
+inline void SaveLibraries() __attribute__((always_inline));
+inline void CheckLibraryUpdateTimeout() __attribute__((always_inline));
+#if defined(SENSINT_LOOP_PROFILER) && !defined(SENSINT_PARALLEL_DATA)
+inline void PublishLoopProfile() __attribute__((always_inline));
+#endif  // SENSINT_LOOP_PROFILER && !SENSINT_PARALLEL_DATA
+#if defined(SENSINT_LATENCY_TRACE) || defined(SENSINT_LOOP_PROFILER)
+inline void HandleSerialCommand() __attribute__((always_inline));
+#endif  // SENSINT_LATENCY_TRACE || SENSINT_LOOP_PROFILER
 
 #ifdef SENSINT_DEVELOPMENT
 /**
@@ -125,6 +170,13 @@ void PrintConfig() {
 #ifdef SENSINT_PARALLEL_DATA
   Log("use parallel communication for control signals");
 #endif  // SENSINT_PARALLEL_DATA
+#ifdef SENSINT_LATENCY_TRACE
+  Log("latency trace enabled - send '" + String((char)latency_trace::kDumpCommand) + "' to dump");
+#endif  // SENSINT_LATENCY_TRACE
+#ifdef SENSINT_LOOP_PROFILER
+  Log("loop profiler enabled - send '" + String((char)loop_profiler::kReportCommand) +
+      "' to print");
+#endif  // SENSINT_LOOP_PROFILER
   Serial.println("============================================\n\n");
 }
 #endif  // SENSINT_DEVELOPMENT
@@ -137,6 +189,16 @@ void PrintConfig() {
  * @param number_of_bytes The number of bytes available for reading.
  */
 void HandleI2COnReceive(int number_of_bytes) {
+#ifdef SENSINT_LOOP_PROFILER
+  // the register byte selects the loop profile for the following read only
+  is_loop_profile_selected = false;
+  if (number_of_bytes == 1 && !input_msg_start_found &&
+      SENSINT_I2C.peek() == communication::kLoopProfileRegister) {
+    SENSINT_I2C.read();
+    is_loop_profile_selected = true;
+    return;
+  }
+#endif  // SENSINT_LOOP_PROFILER
   if (communication::GetSerializedDataFrameFromI2C(serialized_input_msg, input_msg_start_found)) {
     state_a.should_update_config = true;
     input_msg_start_found = false;
@@ -152,6 +214,15 @@ void HandleI2COnReceive(int number_of_bytes) {
  * data).
  */
 void HandleI2COnRequest() {
+#ifdef SENSINT_LOOP_PROFILER
+  if (is_loop_profile_selected) {
+    const auto& profile = loop_profiles[loop_profile_idx];
+    SENSINT_I2C.write(profile.serialized, sizeof(profile.serialized));
+    is_loop_profile_selected = false;
+    was_loop_profile_read = true;
+    return;
+  }
+#endif  // SENSINT_LOOP_PROFILER
   if (state_a.should_send_sensor_data) {
     return;
   }
@@ -161,11 +232,9 @@ void HandleI2COnRequest() {
   size_t data_len = sizeof(sensor_data.serialized);
   auto write_len = SENSINT_I2C.write(sensor_data.serialized, data_len);
 #ifdef SENSINT_DEBUG
-  debug::Log("HandleI2COnRequest", "send sensor data", debug::DebugLevel::verbose);
-  if (debug::kDebugLevel == debug::DebugLevel::verbose) {
-    Serial.printf("bytes written: %d/%d\n", write_len, data_len);
-    PrintVector2D<analog_sensor_t>(sensor_data.data, false);
-  }
+  debug::LogTokenized<debug::LogToken::kSendSensorData>(debug::DebugLevel::verbose, write_len,
+                                                        data_len, sensor_data.data.x,
+                                                        sensor_data.data.y);
 #endif  // SENSINT_DEBUG
   state_a.should_send_sensor_data = false;
 }
@@ -248,23 +317,36 @@ void SetupAudio() {
  * only called once in the setup function.
  */
 void SetupAugmentation() {
+  const auto& material_lib = libraries.GetMaterialLib();
+  const auto& sequence_lib = libraries.GetSequenceLib();
+  // both channels start with the default material and sequence (i.e. null handles)
   // set up the left channel (A/a)
-  state_a.current_material = &material_lib.GetDefaultMaterial();
+  state_management::SelectSequence(state_a, SequenceHandle(), sequence_lib);
+  state_management::ResolveHandles(state_a, material_lib, sequence_lib);
   tactile_audio::ApplyGrainParameters(state_a.current_material->grain_params,
                                       signal_chain.audio_left);
-  state_a.current_sequence = &sequence_lib.GetDefaultSequence();
-  state_a.closest_grain = &state_a.current_sequence->grains.front();
-  state_a.last_grain = state_a.closest_grain;
   // set up the right channel (B/b)
-  state_b.current_material = &material_lib.GetDefaultMaterial();
+  state_management::SelectSequence(state_b, SequenceHandle(), sequence_lib);
+  state_management::ResolveHandles(state_b, material_lib, sequence_lib);
   tactile_audio::ApplyGrainParameters(state_b.current_material->grain_params,
                                       signal_chain.audio_right);
-  state_b.current_sequence = &sequence_lib.GetDefaultSequence();
-  state_b.closest_grain = &state_a.current_sequence->grains.front();
-  state_b.last_grain = state_b.closest_grain;
 }
 
 void LoadPresets() {
+#ifdef SENSINT_DEBUG
+  elapsedMicros load_time = 0;
+#endif  // SENSINT_DEBUG
+  presets_crc = library_image::GetPresetsCrc(settings::local::presets::kMaterials,
+                                             settings::local::presets::kSequences);
+  // the stored library replaces the presets, e.g. a library uploaded in a previous session
+  if (library_image::Load(library_storage, presets_crc, libraries)) {
+    CommitLibraries();
+#ifdef SENSINT_DEBUG
+    debug::Log("LoadPresets", "loaded the stored library in " + String((uint32_t)load_time) +
+                                  " us");
+#endif  // SENSINT_DEBUG
+    return;
+  }
   for (const auto& material : settings::local::presets::kMaterials) {
     serialized_input_msg = material;
     UpdateConfig();
@@ -273,16 +355,24 @@ void LoadPresets() {
     serialized_input_msg = sequence;
     UpdateConfig();
   }
+  CommitLibraries();
+#ifdef SENSINT_DEBUG
+  debug::Log("LoadPresets", "loaded the presets in " + String((uint32_t)load_time) + " us");
+#endif  // SENSINT_DEBUG
 }
 
 void HandleAugmentation() {
   using namespace sensint;
   using namespace sensint::debug;
 
-  auto grain_idx_a = tactile_audio::FindClosestGrainIndex(state_a.current_sequence->grains,
+  auto grain_idx_a = tactile_audio::FindClosestGrainIndex(*state_a.current_sequence,
                                                           state_a.current_sensor_value);
-  auto grain_idx_b = tactile_audio::FindClosestGrainIndex(state_b.current_sequence->grains,
+  auto grain_idx_b = tactile_audio::FindClosestGrainIndex(*state_b.current_sequence,
                                                           state_b.current_sensor_value);
+#ifdef SENSINT_LATENCY_TRACE
+  tracer.Stamp(latency_trace::kLeftChannel, latency_trace::Stage::kGrainResolved);
+  tracer.Stamp(latency_trace::kRightChannel, latency_trace::Stage::kGrainResolved);
+#endif  // SENSINT_LATENCY_TRACE
 
   state_management::CheckAndStopContinuousVibration(grain_idx_a, state_a, signal_chain.audio_left);
   state_management::CheckAndStopContinuousVibration(grain_idx_b, state_b, signal_chain.audio_right);
@@ -290,24 +380,24 @@ void HandleAugmentation() {
   state_management::CheckAndStopGrain(grain_idx_a, state_a, signal_chain.audio_left);
   state_management::CheckAndStopGrain(grain_idx_b, state_b, signal_chain.audio_right);
 
-  state_a.closest_grain = &state_a.current_sequence->grains[grain_idx_a];
-  state_b.closest_grain = &state_b.current_sequence->grains[grain_idx_b];
+  state_a.closest_grain = (*state_a.current_sequence)[grain_idx_a];
+  state_b.closest_grain = (*state_b.current_sequence)[grain_idx_b];
 
-  if (state_a.closest_grain->pos_start != state_a.closest_grain->pos_end) {
-    state_management::CheckAndStartContinuousVibration(grain_idx_a, state_a,
-                                                       signal_chain.audio_left, material_lib);
-  } else {
-    state_management::CheckAndStartGrain(grain_idx_a, state_a, signal_chain.audio_left,
-                                         material_lib);
+#ifdef SENSINT_LATENCY_TRACE
+  if (state_management::CheckAndStartClosestGrain(grain_idx_a, state_a, signal_chain.audio_left,
+                                                  libraries.GetMaterialLib())) {
+    tracer.Stamp(latency_trace::kLeftChannel, latency_trace::Stage::kNoteOn);
   }
-
-  if (state_b.closest_grain->pos_start != state_b.closest_grain->pos_end) {
-    state_management::CheckAndStartContinuousVibration(grain_idx_b, state_b,
-                                                       signal_chain.audio_right, material_lib);
-  } else {
-    state_management::CheckAndStartGrain(grain_idx_b, state_b, signal_chain.audio_right,
-                                         material_lib);
+  if (state_management::CheckAndStartClosestGrain(grain_idx_b, state_b, signal_chain.audio_right,
+                                                  libraries.GetMaterialLib())) {
+    tracer.Stamp(latency_trace::kRightChannel, latency_trace::Stage::kNoteOn);
   }
+#else
+  state_management::CheckAndStartClosestGrain(grain_idx_a, state_a, signal_chain.audio_left,
+                                              libraries.GetMaterialLib());
+  state_management::CheckAndStartClosestGrain(grain_idx_b, state_b, signal_chain.audio_right,
+                                              libraries.GetMaterialLib());
+#endif  // SENSINT_LATENCY_TRACE
 }
 
 void UpdateConfig() {
@@ -335,10 +425,94 @@ void UpdateConfig() {
   }
 
   auto msg_type = static_cast<MessageTypes>(atoi(tokens[1].c_str()));
-  state_management::UpdateConfig(msg_type, tokens, state_a, material_lib, sequence_lib);
+  state_management::UpdateConfig(msg_type, tokens, state_a, libraries);
+  // the right channel plays the sequence of the left one, but keeps its own material
+  const auto& sequence_lib = libraries.GetSequenceLib();
+  if (state_b.sequence != state_a.sequence) {
+    state_management::SelectSequence(state_b, state_a.sequence, sequence_lib);
+  }
+  state_management::ResolveHandles(state_b, libraries.GetMaterialLib(), sequence_lib);
   state_a.should_update_config = false;
 }
 
+/**
+ * @brief Make the edited libraries active. This is called between two iterations
+ * of the augmentation, hence a grain is never played from a partially updated
+ * library.
+ */
+void CommitLibraries() {
+  if (!libraries.Commit()) {
+    return;
+  }
+  state_management::HandleLibraryCommit(state_a, libraries);
+  state_management::HandleLibraryCommit(state_b, libraries);
+}
+
+/**
+ * @brief Save the active libraries to the EEPROM on request of the controller. A write to the
+ * EEPROM blocks the loop for a few milliseconds, hence the save waits until the augmentation is
+ * stopped.
+ */
+void SaveLibraries() {
+  if (!state_a.should_save_libraries || state_a.should_augment) {
+    return;
+  }
+  library_image::Save(libraries, presets_crc, library_storage);
+  state_a.should_save_libraries = false;
+}
+
+/**
+ * @brief Discard an open update of the libraries if no message was received for too long.
+ */
+void CheckLibraryUpdateTimeout() {
+  if (!libraries.CheckUpdateTimeout(millis())) {
+    return;
+  }
+#ifdef SENSINT_DEBUG
+  debug::Log("CheckLibraryUpdateTimeout", "discarded the library update");
+#endif  // SENSINT_DEBUG
+}
+
+#if defined(SENSINT_LOOP_PROFILER) && !defined(SENSINT_PARALLEL_DATA)
+/**
+ * @brief Publish the summary of the loop profile for the controller (see kLoopProfileRegister).
+ * The profile starts over after the controller read it.
+ */
+void PublishLoopProfile() {
+  if (was_loop_profile_read) {
+    was_loop_profile_read = false;
+    profiler.Reset();
+  }
+  if (loop_profile_timer < kLoopProfilePublishPeriod) {
+    return;
+  }
+  const uint8_t idx = loop_profile_idx ^ 1;
+  loop_profiles[idx].data = profiler.GetSummary();
+  loop_profile_idx = idx;
+  loop_profile_timer = 0;
+}
+#endif  // SENSINT_LOOP_PROFILER && !SENSINT_PARALLEL_DATA
+
+#if defined(SENSINT_LATENCY_TRACE) || defined(SENSINT_LOOP_PROFILER)
+void HandleSerialCommand() {
+  if (!Serial.available()) {
+    return;
+  }
+  const auto command = Serial.read();
+#ifdef SENSINT_LATENCY_TRACE
+  if (command == latency_trace::kDumpCommand) {
+    tracer.Dump();
+  }
+#endif  // SENSINT_LATENCY_TRACE
+#ifdef SENSINT_LOOP_PROFILER
+  if (command == loop_profiler::kReportCommand) {
+    profiler.Print();
+    profiler.Reset();
+  }
+#endif  // SENSINT_LOOP_PROFILER
+}
+#endif  // SENSINT_LATENCY_TRACE || SENSINT_LOOP_PROFILER
+
 }  // namespace
 
 void setup() {
@@ -360,11 +534,21 @@ void setup() {
 
   SetupSensors();
   SetupAudio();
+#ifdef SENSINT_LATENCY_TRACE
+  tracer.Init();
+#endif  // SENSINT_LATENCY_TRACE
+#ifdef SENSINT_LOOP_PROFILER
+  cycle_counter::Enable();
+#endif  // SENSINT_LOOP_PROFILER
   SetupAugmentation();
   LoadPresets();
+#ifdef SENSINT_DEBUG
+  debug::Log("setup", "ready after " + String(micros()) + " us");
+#endif  // SENSINT_DEBUG
 }
 
 void loop() {
+  SENSINT_PROFILE_SECTION(profiler, loop_profiler::Section::kLoop);
 #ifdef SENSINT_DEVELOPMENT
   using namespace sensint::communication;
   //! For testing only - comment if you want to use I2C communication!
@@ -373,24 +557,51 @@ void loop() {
   // }
 #endif  // SENSINT_DEVELOPMENT
 
-#if SENSINT_SENSOR == 0  // FSR
-  state_a.current_sensor_value = sensor_a.ReadFiltered(0.015);
-  state_b.current_sensor_value = sensor_b.ReadFiltered(0.015);
-#else   // slider, potentiometer
-  state_a.current_sensor_value = sensor_a.ReadFiltered();
-  state_b.current_sensor_value = sensor_b.ReadFiltered();
-#endif  // SENSINT_SENSOR
+#if defined(SENSINT_LATENCY_TRACE) || defined(SENSINT_LOOP_PROFILER)
+  HandleSerialCommand();
+#endif  // SENSINT_LATENCY_TRACE || SENSINT_LOOP_PROFILER
+
+  {
+    SENSINT_PROFILE_SECTION(profiler, loop_profiler::Section::kSensorA);
+#ifdef SENSINT_LATENCY_TRACE
+    tracer.Stamp(latency_trace::kLeftChannel, latency_trace::Stage::kAdcSample);
+#endif  // SENSINT_LATENCY_TRACE
+    state_a.current_sensor_value = sensor_a.ReadFiltered(kSensorFilterWeight);
+#ifdef SENSINT_LATENCY_TRACE
+    tracer.Stamp(latency_trace::kLeftChannel, latency_trace::Stage::kFilterOutput);
+#endif  // SENSINT_LATENCY_TRACE
+  }
+  {
+    SENSINT_PROFILE_SECTION(profiler, loop_profiler::Section::kSensorB);
+#ifdef SENSINT_LATENCY_TRACE
+    tracer.Stamp(latency_trace::kRightChannel, latency_trace::Stage::kAdcSample);
+#endif  // SENSINT_LATENCY_TRACE
+    state_b.current_sensor_value = sensor_b.ReadFiltered(kSensorFilterWeight);
+#ifdef SENSINT_LATENCY_TRACE
+    tracer.Stamp(latency_trace::kRightChannel, latency_trace::Stage::kFilterOutput);
+#endif  // SENSINT_LATENCY_TRACE
+  }
 
   if (state_a.should_augment) {
+    SENSINT_PROFILE_SECTION(profiler, loop_profiler::Section::kAugmentation);
     HandleAugmentation();
   }
 
 #ifndef SENSINT_PARALLEL_DATA
   if (state_a.should_update_config) {
+    SENSINT_PROFILE_SECTION(profiler, loop_profiler::Section::kUpdateConfig);
     UpdateConfig();
+    CommitLibraries();
+    libraries.KeepAlive(millis());
   }
+  CheckLibraryUpdateTimeout();
+  SaveLibraries();
+#ifdef SENSINT_LOOP_PROFILER
+  PublishLoopProfile();
+#endif  // SENSINT_LOOP_PROFILER
 #else
   if (control_update_timer > 1000) {
+    SENSINT_PROFILE_SECTION(profiler, loop_profiler::Section::kControlPins);
     state_a.should_augment = digitalRead(sensint::settings::local::pins::kAugmentation) == 1;
     // compose sequence id as 4bit value and set digital pins accordingly
     // LSB = pins::kSequence[0]
@@ -399,9 +610,11 @@ void loop() {
     seq_id |= digitalRead(sensint::settings::local::pins::kSequence[2]) << 2;
     seq_id |= digitalRead(sensint::settings::local::pins::kSequence[3]) << 3;
 
+    const auto& sequence_lib = libraries.GetSequenceLib();
     if (seq_id != state_a.current_sequence->id && sequence_lib.SequenceExists(seq_id)) {
-      sequence_lib.GetSequenceByID(seq_id, *state_a.current_sequence);
-      state_a.should_reinitialize_material = true;
+      const auto sequence = sequence_lib.GetSequenceHandle(seq_id);
+      state_management::SelectSequence(state_a, sequence, sequence_lib);
+      state_management::SelectSequence(state_b, sequence, sequence_lib);
 #ifdef SENSINT_DEBUG
       debug::Log("======== Active Sequence ========");
       PrintGrainSequence(*state_a.current_sequence);
@@ -410,4 +623,9 @@ void loop() {
     control_update_timer = 0;
   }
 #endif  // SENSINT_PARALLEL_DATA
+
+#ifdef SENSINT_DEBUG
+  // the tokenized log messages are written after all time critical work of the loop is done
+  debug::DrainLog();
+#endif  // SENSINT_DEBUG
 }
@@ -69,6 +69,8 @@ String serialPortName = "";
 boolean serialPortConnected = false;
 
 PrintWriter output;
+// every sample of the shoes' streams (see kShoeStreamData in communication.h)
+PrintWriter streamOutput;
 int fileIterator = 1;
 boolean recordActive = false;
 
@@ -446,7 +448,9 @@ void recording(boolean active) {
       fileIterator = 1;
     }
     output = createWriter(path);
-    output.println("timestamp,shoeL_on,shoeR_on,shoeL_experience,shoeR_experience,shoeL_fsr_VT,shoeL_fsr_VB,shoeL_fsr_HI,shoeL_fsr_HO,shoeL_IMU_rot_W,shoeL_IMU_rot_X,shoeL_IMU_rot_Y,shoeL_IMU_rot_Z,shoeL_IMU_acc_X,shoeL_IMU_acc_Y,shoeL_IMU_acc_Z,shoeL_IMU_calib,shoeL_IMU_dt,shoeR_fsr_VT,shoeR_fsr_VB,shoeR_fsr_HI,shoeR_fsr_HO,shoeR_IMU_rot_W,shoeR_IMU_rot_X,shoeR_IMU_rot_Y,shoeR_IMU_rot_Z,shoeR_IMU_acc_X,shoeR_IMU_acc_Y,shoeR_IMU_acc_Z,shoeR_IMU_calib,shoeR_IMU_dt");
+    output.println("timestamp,subject,shoeL_on,shoeR_on,shoeL_experience,shoeR_experience,shoeL_fsr_VT,shoeL_fsr_VB,shoeL_fsr_HI,shoeL_fsr_HO,shoeL_IMU_rot_W,shoeL_IMU_rot_X,shoeL_IMU_rot_Y,shoeL_IMU_rot_Z,shoeL_IMU_acc_X,shoeL_IMU_acc_Y,shoeL_IMU_acc_Z,shoeL_IMU_calib,shoeL_IMU_dt,shoeR_fsr_VT,shoeR_fsr_VB,shoeR_fsr_HI,shoeR_fsr_HO,shoeR_IMU_rot_W,shoeR_IMU_rot_X,shoeR_IMU_rot_Y,shoeR_IMU_rot_Z,shoeR_IMU_acc_X,shoeR_IMU_acc_Y,shoeR_IMU_acc_Z,shoeR_IMU_calib,shoeR_IMU_dt");
+    streamOutput = createWriter(path.replace(".csv", "_stream.csv"));
+    streamOutput.println("timestamp,shoe,subject,sample_type,shoe_timestamp_us,values");
     timer.reset();
     serialPort.write("<0,18,1," + recordInterval + ">");
     serialPort.write("<2,16,0,->");
@@ -454,6 +458,8 @@ void recording(boolean active) {
     serialPort.write("<2,17,0,->");
     output.flush();
     output.close();
+    streamOutput.flush();
+    streamOutput.close();
 
     leftShoeFsrChart.setData("v_top", new float[visNumDataPoints]);
     leftShoeFsrChart.setData("v_bottom", new float[visNumDataPoints]);
@@ -479,25 +485,68 @@ void rec_interval(float val) {
 void serialEvent(Serial port) {
   String data = match(port.readString(), "<(.*?)>")[1];
   String[] tokens = split(data, ',');
+  // single sample: <1,70,1,shoe,subject,type,timestamp_us,values...>
+  if (parseInt(tokens[1]) == 70) {
+    if (recordActive) {
+      streamOutput.println(timer.time() + "," + join(subset(tokens, 3), ','));
+    }
+    return;
+  }
+  // stream counters: <1,71,1,shoe,subject,packets,samples,bytes/s,lost,dropped,missing>
+  if (parseInt(tokens[1]) == 71) {
+    println("stream " + tokens[3] + "/" + tokens[4] + ": " + tokens[7] + " B/s, lost " + tokens[8] + ", dropped " + tokens[9] + ", missing " + tokens[10]);
+    return;
+  }
+  // missing samples: <1,74,1,shoe,subject,first_sample,num_samples,next_timestamp_us>
+  // the gap is marked in the stream file right before the next sample
+  if (parseInt(tokens[1]) == 74) {
+    if (recordActive) {
+      streamOutput.println(timer.time() + "," + tokens[3] + "," + tokens[4] + ",gap," + tokens[7] + "," + tokens[5] + "," + tokens[6]);
+    }
+    println("gap " + tokens[3] + "/" + tokens[4] + ": " + tokens[6] + " samples missing");
+    return;
+  }
+  // round trip time of a command: <1,72,1,shoe,subject,command,rtt_us>
+  if (parseInt(tokens[1]) == 72) {
+    println("round trip " + tokens[3] + "/" + tokens[4] + ": command " + tokens[5] + " took " + tokens[6] + " us");
+    return;
+  }
+  // clock synchronization: <1,73,1,shoe,subject,synchronized,offset_us,drift_ppb,residual_us,rtt_us>
+  if (parseInt(tokens[1]) == 73) {
+    println("clock " + tokens[3] + "/" + tokens[4] + ": synchronized " + tokens[5] + ", drift " + tokens[7] + " ppb, residual " + tokens[8] + " us");
+    return;
+  }
+  // throughput of all shoes: <1,75,1,subjects,connected_shoes,samples/s,bytes/s,dropped>
+  if (parseInt(tokens[1]) == 75) {
+    println("throughput " + tokens[4] + " shoes: " + tokens[5] + " samples/s, " + tokens[6] + " B/s, dropped " + tokens[7]);
+    return;
+  }
+  // shoe data of one subject: <1,68,1,subject,left...,right...>
   if (parseInt(tokens[1]) != 68) {
     return;
   }
   String logMsg = timer.time() + ","
+                + tokens[3] + ","
                 + augmentation_left + ","
                 + augmentation_right + ","
                 + experience_left + ","
                 + experience_right + ","
-                + join(subset(tokens, 3), ',');
+                + join(subset(tokens, 4), ',');
   output.println(logMsg);
 
-  fsrLeftVT = (parseInt(tokens[3]) <= sensorLimitTop) ? parseInt(tokens[3]) : fsrLeftVT;
-  fsrLeftVB = (parseInt(tokens[4]) <= sensorLimitTop) ? parseInt(tokens[4]) : fsrLeftVB;
-  fsrLeftHI = (parseInt(tokens[5]) <= sensorLimitTop) ? parseInt(tokens[5]) : fsrLeftHI;
-  fsrLeftHO = (parseInt(tokens[6]) <= sensorLimitTop) ? parseInt(tokens[6]) : fsrLeftHO;
-  fsrRightVT = (parseInt(tokens[16]) <= sensorLimitTop) ? parseInt(tokens[16]) : fsrRightVT;
-  fsrRightVB = (parseInt(tokens[17]) <= sensorLimitTop) ? parseInt(tokens[17]) : fsrRightVB;
-  fsrRightHI = (parseInt(tokens[18]) <= sensorLimitTop) ? parseInt(tokens[18]) : fsrRightHI;
-  fsrRightHO = (parseInt(tokens[19]) <= sensorLimitTop) ? parseInt(tokens[19]) : fsrRightHO;
+  // only the first subject is visualized
+  if (parseInt(tokens[3]) != 0) {
+    return;
+  }
+
+  fsrLeftVT = (parseInt(tokens[4]) <= sensorLimitTop) ? parseInt(tokens[4]) : fsrLeftVT;
+  fsrLeftVB = (parseInt(tokens[5]) <= sensorLimitTop) ? parseInt(tokens[5]) : fsrLeftVB;
+  fsrLeftHI = (parseInt(tokens[6]) <= sensorLimitTop) ? parseInt(tokens[6]) : fsrLeftHI;
+  fsrLeftHO = (parseInt(tokens[7]) <= sensorLimitTop) ? parseInt(tokens[7]) : fsrLeftHO;
+  fsrRightVT = (parseInt(tokens[17]) <= sensorLimitTop) ? parseInt(tokens[17]) : fsrRightVT;
+  fsrRightVB = (parseInt(tokens[18]) <= sensorLimitTop) ? parseInt(tokens[18]) : fsrRightVB;
+  fsrRightHI = (parseInt(tokens[19]) <= sensorLimitTop) ? parseInt(tokens[19]) : fsrRightHI;
+  fsrRightHO = (parseInt(tokens[20]) <= sensorLimitTop) ? parseInt(tokens[20]) : fsrRightHO;
 
   leftShoeFsrChart.push("v_top", fsrLeftVT);
   leftShoeFsrChart.push("v_bottom", fsrLeftVB);
@@ -0,0 +1,144 @@
+"""Report the latency percentiles of the tactile signal generator.
+
+The generator has to be built with the latency tracer enabled (see the [trace] section in its
+platformio.ini). The traces are requested by sending 't' via serial, or they are read from a file
+that contains a dump.
+
+EXAMPLE:
+  python latency_trace.py --port /dev/cu.usbmodem114860201
+  python latency_trace.py --file dump.txt
+"""
+
+import argparse
+import sys
+import time
+
+STAGES = ["adc", "filter", "grain", "note_on", "first_block"]
+
+
+def parse_frames(lines):
+    """Return the header and the traces of a dump. A trace is a tuple of the channel, the raw
+    cycle counts of all stages, and the index of the first non-zero sample."""
+    header = None
+    traces = []
+    for line in lines:
+        line = line.strip()
+        if not (line.startswith("<") and line.endswith(">")):
+            continue
+        tokens = line[1:-1].split(",")
+        if tokens[0] == "T" and len(tokens) == 6:
+            header = {
+                "cpu_hz": int(tokens[1]),
+                "sample_rate": int(tokens[2]),
+                "block_samples": int(tokens[3]),
+                "num_traces": int(tokens[4]),
+                "dropped": int(tokens[5]),
+            }
+        elif tokens[0] == "t" and len(tokens) == len(STAGES) + 3:
+            values = [int(token) for token in tokens[1:]]
+            traces.append((values[0], values[1:-1], values[-1]))
+    return header, traces
+
+
+def read_serial(port, baud_rate, timeout_s):
+    import serial  # pyserial
+
+    with serial.Serial(port, baud_rate, timeout=0.2) as connection:
+        connection.reset_input_buffer()
+        connection.write(b"t")
+        lines = []
+        expected = None
+        deadline = time.time() + timeout_s
+        while time.time() < deadline:
+            line = connection.readline().decode("ascii", errors="ignore")
+            if not line:
+                continue
+            lines.append(line)
+            if line.startswith("<T,"):
+                expected = int(line.strip()[1:-1].split(",")[4])
+            elif expected is not None and sum(l.startswith("<t,") for l in lines) >= expected:
+                break
+    return lines
+
+
+def percentile(values, p):
+    values = sorted(values)
+    index = min(len(values) - 1, max(0, int(round(p / 100.0 * (len(values) - 1)))))
+    return values[index]
+
+
+def print_row(name, values):
+    print(
+        "%-24s %8.1f %8.1f %8.1f %8.1f %8.1f"
+        % (
+            name,
+            percentile(values, 50),
+            percentile(values, 90),
+            percentile(values, 99),
+            min(values),
+            max(values),
+        )
+    )
+
+
+def report(header, traces, channel):
+    if channel is not None:
+        traces = [trace for trace in traces if trace[0] == channel]
+    print("traces: %d, dropped: %d" % (len(traces), header["dropped"]))
+    if not traces:
+        return
+    us_per_cycle = 1e6 / header["cpu_hz"]
+    us_per_sample = 1e6 / header["sample_rate"]
+
+    # the cycle counter wraps around after 2^32 cycles
+    def elapsed_us(start, end):
+        return ((end - start) & 0xFFFFFFFF) * us_per_cycle
+
+    print("%-24s %8s %8s %8s %8s %8s" % ("[us]", "p50", "p90", "p99", "min", "max"))
+    for i in range(1, len(STAGES)):
+        print_row(
+            "%s -> %s" % (STAGES[i - 1], STAGES[i]),
+            [elapsed_us(cycles[i - 1], cycles[i]) for _, cycles, _ in traces],
+        )
+    for i in range(2, len(STAGES)):
+        print_row(
+            "adc -> %s" % STAGES[i], [elapsed_us(cycles[0], cycles[i]) for _, cycles, _ in traces]
+        )
+    # The output plays a block after it was rendered. The first non-zero sample is played
+    # `first_sample` samples after the start of that block.
+    print_row(
+        "adc -> output (est.)",
+        [
+            elapsed_us(cycles[0], cycles[-1])
+            + (header["block_samples"] + first_sample) * us_per_sample
+            for _, cycles, first_sample in traces
+        ],
+    )
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    source = parser.add_mutually_exclusive_group(required=True)
+    source.add_argument("--port", help="serial port of the generator")
+    source.add_argument("--file", help="file with a dump, '-' for stdin")
+    parser.add_argument("--baud-rate", type=int, default=115200)
+    parser.add_argument("--timeout", type=float, default=5.0, help="serial timeout in seconds")
+    parser.add_argument("--channel", type=int, choices=[0, 1], help="0: left (A/a), 1: right (B/b)")
+    args = parser.parse_args()
+
+    if args.port:
+        lines = read_serial(args.port, args.baud_rate, args.timeout)
+    elif args.file == "-":
+        lines = sys.stdin.readlines()
+    else:
+        with open(args.file) as dump:
+            lines = dump.readlines()
+
+    header, traces = parse_frames(lines)
+    if header is None:
+        sys.exit("no dump found - is the latency tracer enabled?")
+    report(header, traces, args.channel)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,132 @@
+"""Decode the tokenized log of the firmware.
+
+The firmware writes tokenized messages (see debug::LogTokenized) as binary frames. The format
+strings are read from the token table (shared_libs/system/log_tokens.h), which has to match the
+firmware that produced the log. All other output of the serial port is passed through.
+
+EXAMPLE:
+  python decode_log.py --port /dev/cu.usbmodem114860201
+  python decode_log.py --file capture.bin
+"""
+
+import argparse
+import os
+import re
+import struct
+import sys
+
+FRAME_START = 0x1E
+MAX_ARGUMENTS = 6
+DEFAULT_TABLE = os.path.join(
+    os.path.dirname(os.path.abspath(__file__)),
+    "..",
+    "firmware",
+    "shared_libs",
+    "system",
+    "log_tokens.h",
+)
+CONVERSION = re.compile(r"%[-+ #0]*\d*(?:\.\d+)?[hlL]*([diuxXcfeEgG%])")
+
+
+def load_table(path):
+    """Return the list of (token, function, format) of the X-macro table in the given order."""
+    with open(path) as header:
+        source = header.read().replace("\\\n", " ")
+    table = []
+    for match in re.finditer(r"X\(\s*(\w+)\s*,\s*\"([^\"]*)\"\s*,\s*((?:\"[^\"]*\"\s*)+)\)", source):
+        fmt = "".join(re.findall(r"\"([^\"]*)\"", match.group(3)))
+        table.append((match.group(1), match.group(2), fmt))
+    return table
+
+
+def format_message(fmt, words):
+    values = []
+    for conversion, word in zip(CONVERSION.findall(fmt), words):
+        if conversion in "di":
+            values.append(struct.unpack("<i", struct.pack("<I", word))[0])
+        elif conversion in "feEgG":
+            values.append(struct.unpack("<f", struct.pack("<I", word))[0])
+        elif conversion == "c":
+            values.append(chr(word & 0xFF))
+        else:
+            values.append(word)
+    return fmt % tuple(values)
+
+
+class Decoder:
+    def __init__(self, table, output):
+        self.table = table
+        self.output = output
+        self.buffer = bytearray()
+
+    def feed(self, data):
+        self.buffer.extend(data)
+        self.decode_buffer()
+        self.output.flush()
+
+    def decode_buffer(self):
+        while self.buffer:
+            start = self.buffer.find(FRAME_START)
+            if start != 0:
+                text = bytes(self.buffer if start < 0 else self.buffer[:start])
+                self.output.write(text.decode("ascii", errors="replace"))
+                del self.buffer[: len(text)]
+                continue
+            if len(self.buffer) < 2:
+                return
+            num_arguments = self.buffer[1]
+            length = 8 + 4 * num_arguments
+            if num_arguments > MAX_ARGUMENTS:
+                # not a frame, but a control character of the text output
+                self.output.write(chr(self.buffer[0]))
+                del self.buffer[0]
+                continue
+            if len(self.buffer) < length:
+                return
+            token, timestamp = struct.unpack_from("<HI", self.buffer, 2)
+            words = struct.unpack_from("<%dI" % num_arguments, self.buffer, 8)
+            del self.buffer[:length]
+            self.output.write(self.decode(token, timestamp, words) + "\n")
+
+    def decode(self, token, timestamp, words):
+        if token >= len(self.table):
+            return "[%10u] unknown token %d: %s" % (timestamp, token, list(words))
+        name, function, fmt = self.table[token]
+        if len(CONVERSION.findall(fmt)) != len(words):
+            return "[%10u] %s has %d instead of %d arguments - does the table match the firmware?" % (
+                timestamp,
+                name,
+                len(words),
+                len(CONVERSION.findall(fmt)),
+            )
+        return "[%10u] %s >>> %s" % (timestamp, function, format_message(fmt, words))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    source = parser.add_mutually_exclusive_group(required=True)
+    source.add_argument("--port", help="serial port of the device")
+    source.add_argument("--file", help="file with the raw output of the serial port, '-' for stdin")
+    parser.add_argument("--baud-rate", type=int, default=115200)
+    parser.add_argument("--table", default=DEFAULT_TABLE, help="path of log_tokens.h")
+    args = parser.parse_args()
+
+    decoder = Decoder(load_table(args.table), sys.stdout)
+    if args.port:
+        import serial  # pyserial
+
+        with serial.Serial(args.port, args.baud_rate, timeout=0.1) as connection:
+            try:
+                while True:
+                    decoder.feed(connection.read(256))
+            except KeyboardInterrupt:
+                pass
+    elif args.file == "-":
+        decoder.feed(sys.stdin.buffer.read())
+    else:
+        with open(args.file, "rb") as capture:
+            decoder.feed(capture.read())
+
+
+if __name__ == "__main__":
+    main()